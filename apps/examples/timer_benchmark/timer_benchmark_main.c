@@ -0,0 +1,326 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file timer_benchmark_main.c
+/// @brief Measure the cost of arming, cancelling and expiring POSIX timers
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef CONFIG_EXAMPLES_TIMER_BENCHMARK_FRT
+#include <tinyara/timer.h>
+#endif
+
+#define TIMER_BENCHMARK_SIGNO     SIGRTMIN
+#define TIMER_BENCHMARK_LOOPS     CONFIG_EXAMPLES_TIMER_BENCHMARK_LOOPS
+#define TIMER_BENCHMARK_EXPIRES   100
+
+/* Timers armed and cancelled together in one measured batch */
+
+#define TIMER_BENCHMARK_NPROBES   16
+
+/* Background timers expire long after the benchmark is over, spread over
+ * the same range as the probes so that the probes land among them.
+ */
+
+#define TIMER_BENCHMARK_BASE_MS   60000
+#define TIMER_BENCHMARK_STEP_MS   10
+
+#define TIMER_BENCHMARK_MAX       1000
+
+/* Number of timers armed in the background of each run */
+
+static const int g_nbackground[] = { 0, 100, TIMER_BENCHMARK_MAX };
+
+static timer_t g_background[TIMER_BENCHMARK_MAX];
+static timer_t g_probes[TIMER_BENCHMARK_NPROBES];
+
+#ifdef CONFIG_EXAMPLES_TIMER_BENCHMARK_FRT
+static int g_frt_fd = -1;
+#endif
+
+/*
+ * @fn                   :elapsed_usec
+ * @description          :Return the time between two clock samples in usec
+ */
+static long elapsed_usec(FAR const struct timespec *start, FAR const struct timespec *end)
+{
+	return (end->tv_sec - start->tv_sec) * 1000000L + (end->tv_nsec - start->tv_nsec) / 1000L;
+}
+
+/*
+ * @fn                   :now_usec
+ * @description          :Sample the benchmark clock, in usec.  This is the
+ *                        free run timer if it is configured, which counts
+ *                        microseconds, or else the system clock, which only
+ *                        advances on ticks.
+ */
+static uint32_t now_usec(void)
+{
+#ifdef CONFIG_EXAMPLES_TIMER_BENCHMARK_FRT
+	struct timer_status_s status;
+
+	ioctl(g_frt_fd, TCIOC_GETSTATUS, (unsigned long)(uintptr_t)&status);
+	return status.timeleft;
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (uint32_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+#ifdef CONFIG_EXAMPLES_TIMER_BENCHMARK_FRT
+/*
+ * @fn                   :frt_start
+ * @description          :Open and start the free run timer
+ */
+static int frt_start(void)
+{
+	g_frt_fd = open(CONFIG_EXAMPLES_TIMER_BENCHMARK_FRT_DEVPATH, O_RDONLY);
+	if (g_frt_fd < 0) {
+		printf("Failed to open %s: %d\n", CONFIG_EXAMPLES_TIMER_BENCHMARK_FRT_DEVPATH, errno);
+		return ERROR;
+	}
+
+	if (ioctl(g_frt_fd, TCIOC_SETFREERUN, TRUE) < 0 || ioctl(g_frt_fd, TCIOC_START, TRUE) < 0) {
+		printf("Failed to start the free run timer: %d\n", errno);
+		close(g_frt_fd);
+		return ERROR;
+	}
+
+	return OK;
+}
+
+/*
+ * @fn                   :frt_stop
+ * @description          :Stop and close the free run timer
+ */
+static void frt_stop(void)
+{
+	ioctl(g_frt_fd, TCIOC_STOP, 0);
+	close(g_frt_fd);
+}
+#endif
+
+/*
+ * @fn                   :create_timer
+ * @description          :Create a timer notifying TIMER_BENCHMARK_SIGNO
+ */
+static int create_timer(FAR timer_t *timerid)
+{
+	struct sigevent ev;
+
+	memset(&ev, 0, sizeof(struct sigevent));
+	ev.sigev_notify = SIGEV_SIGNAL;
+	ev.sigev_signo = TIMER_BENCHMARK_SIGNO;
+
+	return timer_create(CLOCK_REALTIME, &ev, timerid);
+}
+
+/*
+ * @fn                   :arm_timer
+ * @description          :Arm a one-shot timer, or disarm it if nsec is zero
+ */
+static int arm_timer(timer_t timerid, long long nsec)
+{
+	struct itimerspec its;
+
+	memset(&its, 0, sizeof(struct itimerspec));
+	its.it_value.tv_sec = nsec / 1000000000LL;
+	its.it_value.tv_nsec = nsec % 1000000000LL;
+
+	return timer_settime(timerid, 0, &its, NULL);
+}
+
+#ifdef CONFIG_EXAMPLES_TIMER_BENCHMARK_FRT
+/*
+ * @fn                   :measure_expire
+ * @description          :Return the average time from the tick which
+ *                        expires a timer to the return of sigwaitinfo()
+ */
+static long measure_expire(void)
+{
+	struct timespec res;
+	struct timespec tick;
+	struct timespec now;
+	struct siginfo info;
+	sigset_t set;
+	uint32_t start;
+	long tick_usec;
+	long ticks;
+	long total = 0;
+	int i;
+
+	clock_getres(CLOCK_REALTIME, &res);
+	tick_usec = res.tv_sec * 1000000L + res.tv_nsec / 1000L;
+	sigemptyset(&set);
+	sigaddset(&set, TIMER_BENCHMARK_SIGNO);
+
+	for (i = 0; i < TIMER_BENCHMARK_EXPIRES; i++) {
+		/* Start right after a tick, which the system clock tells */
+
+		clock_gettime(CLOCK_REALTIME, &tick);
+		do {
+			clock_gettime(CLOCK_REALTIME, &now);
+		} while (now.tv_sec == tick.tv_sec && now.tv_nsec == tick.tv_nsec);
+		start = now_usec();
+		tick = now;
+
+		/* The timer expires on a later tick.  Whatever exceeds the whole
+		 * ticks which passed is the cost of expiring it and waking up.
+		 */
+
+		arm_timer(g_probes[0], (long long)res.tv_sec * 1000000000LL + res.tv_nsec);
+		sigwaitinfo(&set, &info);
+		total += (long)(now_usec() - start);
+		clock_gettime(CLOCK_REALTIME, &now);
+		ticks = (elapsed_usec(&tick, &now) + tick_usec / 2) / tick_usec;
+		total -= ticks * tick_usec;
+	}
+
+	return total / TIMER_BENCHMARK_EXPIRES;
+}
+#endif
+
+/*
+ * @fn                   :timer_benchmark_run
+ * @description          :Measure with nbackground timers armed in the background
+ */
+static void timer_benchmark_run(int nbackground)
+{
+	uint32_t start;
+	long arm_usec = 0;
+	long cancel_usec = 0;
+	int narmed;
+	int round;
+	int i;
+
+	/* Arm the background timers.  The probes come on top of them */
+
+	for (narmed = 0; narmed < nbackground; narmed++) {
+		if (create_timer(&g_background[narmed]) != OK) {
+			break;
+		}
+
+		if (arm_timer(g_background[narmed], (TIMER_BENCHMARK_BASE_MS + (long long)narmed * TIMER_BENCHMARK_STEP_MS) * 1000000LL) != OK) {
+			timer_delete(g_background[narmed]);
+			break;
+		}
+	}
+
+	if (narmed < nbackground) {
+		printf("Only %d of %d timers could be armed\n", narmed, nbackground);
+	}
+
+	/* Arm then cancel batches of probes.  Summing many short intervals
+	 * gives an unbiased average even with a coarse clock.
+	 */
+
+	for (round = 0; round < TIMER_BENCHMARK_LOOPS / TIMER_BENCHMARK_NPROBES; round++) {
+		start = now_usec();
+		for (i = 0; i < TIMER_BENCHMARK_NPROBES; i++) {
+			arm_timer(g_probes[i], (TIMER_BENCHMARK_BASE_MS + (long long)((round * TIMER_BENCHMARK_NPROBES + i) % (narmed + 1)) * TIMER_BENCHMARK_STEP_MS + 5) * 1000000LL);
+		}
+		arm_usec += (long)(now_usec() - start);
+
+		start = now_usec();
+		for (i = 0; i < TIMER_BENCHMARK_NPROBES; i++) {
+			arm_timer(g_probes[i], 0);
+		}
+		cancel_usec += (long)(now_usec() - start);
+	}
+
+	printf("%4d + %2d active | arm %4ld.%03ld usec | cancel %4ld.%03ld usec", narmed, TIMER_BENCHMARK_NPROBES,
+		   arm_usec / TIMER_BENCHMARK_LOOPS, (arm_usec % TIMER_BENCHMARK_LOOPS) * 1000 / TIMER_BENCHMARK_LOOPS,
+		   cancel_usec / TIMER_BENCHMARK_LOOPS, (cancel_usec % TIMER_BENCHMARK_LOOPS) * 1000 / TIMER_BENCHMARK_LOOPS);
+
+	/* A single probe is armed at a time to be expired */
+
+#ifdef CONFIG_EXAMPLES_TIMER_BENCHMARK_FRT
+	printf(" | %4d + 1 active | expire %4ld usec\n", narmed, measure_expire());
+#else
+	printf("\n");
+#endif
+
+	for (i = 0; i < narmed; i++) {
+		timer_delete(g_background[i]);
+	}
+}
+
+/****************************************************************************
+ * Name: timer_benchmark_main
+ ****************************************************************************/
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int timer_benchmark_main(int argc, char *argv[])
+#endif
+{
+	sigset_t set;
+	int nprobes;
+	int i;
+
+	/* Expirations are collected with sigwaitinfo() */
+
+	sigemptyset(&set);
+	sigaddset(&set, TIMER_BENCHMARK_SIGNO);
+	sigprocmask(SIG_BLOCK, &set, NULL);
+
+#ifdef CONFIG_EXAMPLES_TIMER_BENCHMARK_FRT
+	if (frt_start() != OK) {
+		goto errout_with_mask;
+	}
+#endif
+
+	for (nprobes = 0; nprobes < TIMER_BENCHMARK_NPROBES; nprobes++) {
+		if (create_timer(&g_probes[nprobes]) != OK) {
+			printf("Failed to create timer\n");
+			goto errout;
+		}
+	}
+
+	printf("Timer benchmark, %d arm and cancel operations per run\n", TIMER_BENCHMARK_LOOPS);
+	printf("Active timers are shown as background + probes\n");
+	for (i = 0; i < sizeof(g_nbackground) / sizeof(g_nbackground[0]); i++) {
+		timer_benchmark_run(g_nbackground[i]);
+	}
+
+errout:
+	while (--nprobes >= 0) {
+		timer_delete(g_probes[nprobes]);
+	}
+
+#ifdef CONFIG_EXAMPLES_TIMER_BENCHMARK_FRT
+	frt_stop();
+
+errout_with_mask:
+#endif
+	sigprocmask(SIG_UNBLOCK, &set, NULL);
+	return 0;
+}
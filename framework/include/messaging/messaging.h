@@ -28,6 +28,8 @@
 #ifndef __MESSAGING_H__
 #define __MESSAGING_H__
 
+#include <tinyara/config.h>
+
 /**
  * @brief These configs are used internally for getting receivers information before send.
  * @details MSG_READ_YET : There are more than CONFIG_MESSAGING_RECV_LIST_SIZE receivers, messaging f/w tries to read information again.\n
@@ -203,6 +205,134 @@ int messaging_recv_nonblock(const char *port_name, msg_recv_buf_t *recv_buf, msg
  */
 int messaging_cleanup(const char *port_name);
 
+#ifdef CONFIG_MESSAGING_CHANNEL
+/**
+ * @brief The structure of a channel which sends messages to one message port.
+ */
+typedef struct msg_channel_s msg_channel_t;
+
+/**
+ * @brief Open a channel to a message port.
+ * @details @b #include <messaging/messaging.h>\n
+ * A channel keeps the message queue of the receiver open between sends when the receiver\n
+ * receives through messaging_channel_recv, so sending many messages to the same port costs one mq_send each.\n
+ * The port name can be up to 60 characters long.
+ * @param[in] port_name The message port name to send or to receive.
+ * @return On success, the channel is returned. On failure, NULL is returned.
+ * @since TizenRT v3.1 PRE
+ */
+msg_channel_t *messaging_channel_open(const char *port_name);
+/**
+ * @brief Send(unicast) message through a channel, without waiting the reply.
+ * @details @b #include <messaging/messaging.h>\n
+ * @param[in] channel The channel opened by messaging_channel_open.
+ * @param[in] send_data\n
+ *		  msg          : The message to be sent.\n
+ *		  msglen       : The length of message to be sent.\n
+ *		  priority     : A non-negative integer that specifies the priority of this message.
+ * @return On success, OK is returned. On failure, ERROR is returned.
+ * @since TizenRT v3.1 PRE
+ */
+int messaging_channel_send(msg_channel_t *channel, msg_send_data_t *send_data);
+/**
+ * @brief Send(unicast) message through a channel, and wait the reply.
+ * @details @b #include <messaging/messaging.h>\n
+ * The reply port is kept open by the channel for the thread which first sent a sync message through it,\n
+ * and other threads cannot send sync messages through the same channel.\n
+ * While the channel is open, that thread should not call messaging_send_sync to the same port.
+ * @param[in] channel The channel opened by messaging_channel_open.
+ * @param[in] send_data\n
+ *		  msg          : The message to be sent.\n
+ *		  msglen       : The length of message to be sent.\n
+ *		  priority     : A non-negative integer that specifies the priority of this message.
+ * @param reply_buf\n
+ *		  [out] buf         : The buffer to receive the reply\n
+ *		  [in] buflen       : The length of the reply to receive\n
+ *		  [out] sender_pid  : The pid who sends the reply\n
+ * @return On success, OK is returned. On failure, ERROR is returned.
+ * @since TizenRT v3.1 PRE
+ */
+int messaging_channel_send_sync(msg_channel_t *channel, msg_send_data_t *send_data, msg_recv_buf_t *reply_buf);
+/**
+ * @brief Receive(blocking) message through a channel.
+ * @details @b #include <messaging/messaging.h>\n
+ * Unlike messaging_recv_block, the message port is kept open and the receiver information is kept\n
+ * after the message is received, until messaging_channel_close.\n
+ * The first call fixes the message size of the port, and only the thread which first received\n
+ * through the channel can receive through it.
+ * @param[in] channel The channel opened by messaging_channel_open.
+ * @param recv_buf\n
+ *		  [out] buf         : The buffer to receive the message\n
+ *		  [in] buflen       : The length of the message to receive\n
+ *		  [out] sender_pid  : The pid who sends the message\n
+ * @return On success, MSG_REPLY_REQUIRED or MSG_REPLY_NO_REQUIRED is returned. On failure, ERROR is returned.
+ * @since TizenRT v3.1 PRE
+ */
+int messaging_channel_recv(msg_channel_t *channel, msg_recv_buf_t *recv_buf);
+/**
+ * @brief Send a buffer allocated by messaging_buf_alloc without copying its contents.
+ * @details @b #include <messaging/messaging.h>\n
+ * Only the handle of the buffer is sent, and a reference is taken for the receiver.\n
+ * The receiver gets the buffer with messaging_buf_get and releases it with messaging_buf_free.\n
+ * The handle is only valid where sender and receiver share the address space,\n
+ * that is in the flat build or between the threads of one application.
+ * @param[in] channel The channel opened by messaging_channel_open.
+ * @param[in] buf The buffer to be sent.
+ * @param[in] priority A non-negative integer that specifies the priority of this message.
+ * @return On success, OK is returned. On failure, ERROR is returned.
+ * @since TizenRT v3.1 PRE
+ */
+int messaging_channel_send_buf(msg_channel_t *channel, void *buf, int priority);
+/**
+ * @brief Close a channel opened by messaging_channel_open, with the ports it keeps open.
+ * @details @b #include <messaging/messaging.h>\n
+ * @param[in] channel The channel to close.
+ * @return On success, OK is returned. On failure, ERROR is returned.
+ * @since TizenRT v3.1 PRE
+ */
+int messaging_channel_close(msg_channel_t *channel);
+/**
+ * @brief Allocate a reference counted buffer to be sent by messaging_channel_send_buf.
+ * @details @b #include <messaging/messaging.h>\n
+ * @param[in] size The size of the buffer.
+ * @return On success, the buffer holding one reference is returned. On failure, NULL is returned.
+ * @since TizenRT v3.1 PRE
+ */
+void *messaging_buf_alloc(int size);
+/**
+ * @brief Take one more reference of a buffer allocated by messaging_buf_alloc.
+ * @details @b #include <messaging/messaging.h>\n
+ * @param[in] buf The buffer.
+ * @since TizenRT v3.1 PRE
+ */
+void messaging_buf_ref(void *buf);
+/**
+ * @brief Release one reference of a buffer. The buffer is freed with its last reference.
+ * @details @b #include <messaging/messaging.h>\n
+ * @param[in] buf The buffer.
+ * @since TizenRT v3.1 PRE
+ */
+void messaging_buf_free(void *buf);
+/**
+ * @brief Get the size of a buffer allocated by messaging_buf_alloc.
+ * @details @b #include <messaging/messaging.h>\n
+ * @param[in] buf The buffer.
+ * @return The size given to messaging_buf_alloc.
+ * @since TizenRT v3.1 PRE
+ */
+int messaging_buf_size(void *buf);
+/**
+ * @brief Get the buffer sent by messaging_channel_send_buf from a received message.
+ * @details @b #include <messaging/messaging.h>\n
+ * The buffer holds the reference taken for this receiver, to be released with messaging_buf_free.
+ * @param[in] recv_buf The receive buffer filled by messaging_recv_block or the receive callback.
+ * @return On success, the buffer is returned. On failure, NULL is returned.
+ * @since TizenRT v3.1 PRE
+ */
+void *messaging_buf_get(msg_recv_buf_t *recv_buf);
+#endif
+
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -103,6 +103,33 @@ size_t Decoder::pushData(unsigned char *buf, size_t size)
 #endif
 }
 
+/**
+ * @brief   Get a contiguous free span in decoder's input ring-buffer
+ * @remarks Caller can read compressed data into the span directly, and then
+ *          hand it over to decoder via commitData(), instead of pushData() a copy.
+ * @param   buf:  output, pointer to the free span
+ * @param   size: maximum size of the span wanted, in bytes.
+ * @return  size of the span, it can be smaller than getAvailSpace() when the free space wraps.
+ * @see     commitData()
+ */
+size_t Decoder::reserveData(unsigned char **buf, size_t size)
+{
+#ifdef CONFIG_AUDIO_CODEC
+	return audio_decoder_reservedata(&mDecoder, (void **)buf, size);
+#else
+	return 0;
+#endif
+}
+
+size_t Decoder::commitData(size_t size)
+{
+#ifdef CONFIG_AUDIO_CODEC
+	return audio_decoder_commitdata(&mDecoder, size);
+#else
+	return 0;
+#endif
+}
+
 /**
  * @brief   Get decoded PCM sample frames
  * @remarks
@@ -40,6 +40,8 @@ public:
 	static std::shared_ptr<Decoder> create(audio_type_t audioType, unsigned short channels, unsigned int sampleRate);
 	bool init(void);
 	size_t pushData(unsigned char *buf, size_t size);
+	size_t reserveData(unsigned char **buf, size_t size);
+	size_t commitData(size_t size);
 	bool getFrame(unsigned char *buf, size_t *size, unsigned int *sampleRate, unsigned short *channels);
 	bool empty();
 	size_t getAvailSpace();
@@ -85,15 +85,22 @@ public:
 	 */
 	virtual bool initialize(void) = 0;
 	/**
-	 * @brief Push stream data into demuxer buffer
+	 * @brief Reserve a contiguous span in demuxer buffer to put stream data in place
 	 *        Derived class should implement it
-	 * @param[in] buf: pointer to the buffer of stream data for input
-	 * @param[in] size: length in bytes of the data in buffer
-	 * @return number of bytes of data accepted by demuxer on success
-	 *         (it may be less than `size` when demuxer buffer is full),
-	 *         negative value (see demuxer_error_t) on failure.
+	 * @param[out] buf: pointer to the span
+	 * @param[in] size: expected size in bytes of the span
+	 * @return size in bytes of the span, it may be less than `size` when the space wraps,
+	 *         0 means there's no space now.
+	 * Note: call commitData() after the data was put into the span.
 	 */
-	virtual ssize_t pushData(unsigned char *buf, size_t size) = 0;
+	virtual size_t reserveData(unsigned char **buf, size_t size) = 0;
+	/**
+	 * @brief Commit stream data put in the span reserved by reserveData()
+	 *        Derived class should implement it
+	 * @param[in] size: length in bytes of the data, no more than the span size
+	 * @return number of bytes of data committed
+	 */
+	virtual size_t commitData(size_t size) = 0;
 	/**
 	 * @brief Pull audio elementary stream data from demuxer
 	 *        Derived class should implement it
@@ -121,32 +121,148 @@ bool InputHandler::processWorker()
 {
 	size_t size = getAvailSpace();
 	if (size > 0) {
-		auto buf = new unsigned char[size];
-		if (!buf) {
-			meddbg("run out of memory! size: 0x%x\n", size);
-			return false;
+		if (mDemuxer) {
+			// Read source data into demuxer buffer, and demux ES data into decoder directly.
+			return demuxToBufferDirectly(size);
+		}
+
+		// Read source data into decoder or stream buffer directly, without a temporary buffer.
+		return readToBufferDirectly(size);
+	}
+
+	return true;
+}
+
+bool InputHandler::demuxToBufferDirectly(size_t size)
+{
+	unsigned char *span = nullptr;
+	size_t spanSize = mDemuxer->reserveData(&span, size);
+	if (spanSize == 0) {
+		// Space was not available actually, try again later.
+		return true;
+	}
+
+	ssize_t readLen = readFromSource(span, spanSize);
+	if (readLen <= 0) {
+		// Error occurred, or inputting finished
+		mBufferWriter->setEndOfStream();
+		return false;
+	}
+	mDemuxer->commitData((size_t)readLen);
+
+	while (1) {
+		unsigned char *es = nullptr;
+		size_t esSize = mDecoder->reserveData(&es, mDecoder->getAvailSpace());
+		if (esSize == 0) {
+			// Decoder buffer is full, decode some frames to make space.
+			if (!decodeToStreamBuffer()) {
+				meddbg("write to stream buffer failed!\n");
+				mBufferWriter->setEndOfStream();
+				return false;
+			}
+			esSize = mDecoder->reserveData(&es, mDecoder->getAvailSpace());
+			if (esSize == 0) {
+				// Decoder can not consume data now, try again later.
+				return true;
+			}
 		}
 
-		ssize_t readLen = readFromSource(buf, size);
-		if (readLen <= 0) {
-			// Error occurred, or inputting finished
+		// Pull ES data into decoder buffer directly
+		ssize_t ret = mDemuxer->pullData(es, esSize);
+		if (ret < 0) {
+			if (ret == DEMUXER_ERROR_WANT_DATA) {
+				// normal case: demuxer want more data
+				return true;
+			}
+			meddbg("pull data from demuxer failed! error: %d\n", ret);
 			mBufferWriter->setEndOfStream();
-			delete[] buf;
 			return false;
 		}
 
-		ssize_t writeLen = writeToStreamBuffer(buf, (size_t)readLen);
-		delete[] buf;
-		if (writeLen <= 0) {
+		mDecoder->commitData((size_t)ret);
+		if (!decodeToStreamBuffer()) {
 			meddbg("write to stream buffer failed!\n");
 			mBufferWriter->setEndOfStream();
 			return false;
 		}
 	}
+}
+
+bool InputHandler::readToBufferDirectly(size_t size)
+{
+	unsigned char *span = nullptr;
+	size_t spanSize;
+
+	if (mDecoder) {
+		spanSize = mDecoder->reserveData(&span, size);
+	} else {
+		spanSize = mBufferWriter->reserve(&span, size, false);
+	}
+
+	if (spanSize == 0) {
+		// Space was not available actually, try again later.
+		return true;
+	}
+
+	ssize_t readLen = readFromSource(span, spanSize);
+	if (readLen <= 0) {
+		// Error occurred, or inputting finished
+		mBufferWriter->setEndOfStream();
+		return false;
+	}
+
+	if (!mDecoder) {
+		// PCM data, it's in stream buffer already.
+		mBufferWriter->commit((size_t)readLen);
+		return true;
+	}
+
+	mDecoder->commitData((size_t)readLen);
+	if (!decodeToStreamBuffer()) {
+		meddbg("write to stream buffer failed!\n");
+		mBufferWriter->setEndOfStream();
+		return false;
+	}
 
 	return true;
 }
 
+bool InputHandler::decodeToStreamBuffer()
+{
+	while (1) {
+		unsigned char *pcm = nullptr;
+		size_t pcmSize = mBufferWriter->reserve(&pcm, mStreamBuffer->getBufferSize());
+		if (pcmSize == 0) {
+			meddbg("End of writting!\n");
+			return false;
+		}
+
+		// Decoder outputs 16bit-PCM frames
+		pcmSize &= ~0x1;
+		if (pcmSize == 0) {
+			// Only one byte left before the end of stream buffer, go through a small buffer.
+			unsigned char frame[2];
+			size_t frameSize = sizeof(frame);
+			if (!getDecodeFrames(frame, &frameSize)) {
+				// normal case: decoder want more data
+				return true;
+			}
+			if (mBufferWriter->write(frame, frameSize) != frameSize) {
+				meddbg("End of writting!\n");
+				return false;
+			}
+			continue;
+		}
+
+		// Decode PCM data into stream buffer directly
+		if (!getDecodeFrames(pcm, &pcmSize)) {
+			// normal case: decoder want more data
+			return true;
+		}
+		mBufferWriter->commit(pcmSize);
+	}
+}
+
 void InputHandler::sleepWorker()
 {
 	bool bEOS = mBufferReader->isEndOfStream();
@@ -235,47 +351,6 @@ size_t InputHandler::getAvailSpace()
 	return mBufferWriter->sizeOfSpace();
 }
 
-ssize_t InputHandler::writeToStreamBuffer(unsigned char *buf, size_t size)
-{
-	size_t used = 0;
-	while (1) {
-		unsigned char *buffES = nullptr;
-		size_t sizeES = mDecoder ? mDecoder->getAvailSpace() : mBufferWriter->sizeOfSpace();
-		ssize_t ret = getElementaryStream(buf, size, &used, &buffES, &sizeES);
-		if (ret < 0) {
-			meddbg("getElementaryStream failed! error: %d\n", ret);
-			return ret;
-		}
-		if (ret == 0) {
-			// want more data
-			break;
-		}
-
-		size_t usedES = 0;
-		while (1) {
-			unsigned char *buffPCM = buf;
-			size_t sizePCM = used;
-			ret = getPCM(buffES, sizeES, &usedES, &buffPCM, &sizePCM);
-			if (ret < 0) {
-				meddbg("getPCM failed! error: %d\n", ret);
-				return ret;
-			}
-			if (ret == 0) {
-				// want more data
-				break;
-			}
-
-			// write PCM data to stream buffer
-			size_t written = mBufferWriter->write(buffPCM, sizePCM);
-			if (written != sizePCM) {
-				meddbg("End of writting!\n");
-				return EOF;
-			}
-		}
-	}
-	return size;
-}
-
 bool InputHandler::registerCodec(audio_type_t audioType, unsigned int channels, unsigned int sampleRate)
 {
 	if (mDecoder) {
@@ -319,20 +394,18 @@ bool InputHandler::registerCodec(audio_type_t audioType, unsigned int channels,
 		}
 		/* Prepare demuxer (probe the datasource to get audio informations) */
 		do {
-			size_t size = demuxer->getAvailSpace() / 4;
-			unsigned char *buf = new unsigned char[size];
-			if (!buf) {
-				meddbg("Run out of memory! bytes: 0x%x\n", size);
+			unsigned char *buf = nullptr;
+			size_t size = demuxer->reserveData(&buf, demuxer->getAvailSpace() / 4);
+			if (size == 0) {
+				meddbg("Demuxer buffer is full, but it's still not ready!\n");
 				return false;
 			}
 			ssize_t readLen = readFromSource(buf, size);
 			if (readLen <= 0) {
 				meddbg("Read source failed! error: %d\n", readLen);
-				delete[] buf;
 				return false;
 			}
-			demuxer->pushData(buf, (size_t)readLen);
-			delete[] buf;
+			demuxer->commitData((size_t)readLen);
 			int ret = demuxer->prepare();
 			if (ret < 0) {
 				if (ret == DEMUXER_ERROR_WANT_DATA) {
@@ -374,97 +447,6 @@ size_t InputHandler::getDecodeFrames(unsigned char *buf, size_t *size)
 	return 0;
 }
 
-ssize_t InputHandler::getElementaryStream(unsigned char *buf, size_t size, size_t *used, unsigned char **out, size_t *expect)
-{
-	if (mDemuxer) {
-		ssize_t ret;
-		if (*used < size) {
-			ret = mDemuxer->pushData(buf + *used, size - *used);
-			if (ret <= 0) {
-				meddbg("push data to demuxer failed! error: %d\n", ret);
-				return EOF;
-			}
-			*used += (size_t)ret;
-		}
-
-		if (*out == nullptr) {
-			*out = buf;
-			if (*expect > *used) {
-				*expect = *used;
-			}
-		}
-
-		ret = mDemuxer->pullData(*out, *expect);
-		if (ret < 0) {
-			if (ret == DEMUXER_ERROR_WANT_DATA) {
-				// normal case: demuxer want more data
-				return 0;
-			}
-			meddbg("pull data from demuxer failed! error: %d\n", ret);
-			return EOF;
-		}
-		*expect = (size_t)ret;
-	} else {
-		fetchData(buf, size, used, out, expect);
-	}
-
-	return (ssize_t)(*expect);
-}
-
-ssize_t InputHandler::getPCM(unsigned char *buf, size_t size, size_t *used, unsigned char **out, size_t *expect)
-{
-	if (mDecoder) {
-		ssize_t ret;
-		if (*used < size) {
-			ret = mDecoder->pushData(buf + *used, size - *used);
-			if (ret <= 0) {
-				meddbg("push data to decoder failed! error: %d\n", ret);
-				return EOF;
-			}
-			*used += (size_t)ret;
-		}
-
-		if (*out == nullptr) {
-			*out = buf;
-			if (*expect > *used) {
-				*expect = *used;
-			}
-		}
-
-		*expect &= ~0x1;
-		if (!getDecodeFrames(*out, expect)) {
-			// normal case: decoder want more data
-			return 0;
-		}
-	} else {
-		fetchData(buf, size, used, out, expect);
-	}
-
-	return (ssize_t)(*expect);
-}
-
-size_t InputHandler::fetchData(unsigned char *buf, size_t size, size_t *used, unsigned char **out, size_t *expect)
-{
-	if (*used < size) {
-		size_t remained = size - *used;
-		if (*expect > remained) {
-			*expect = remained;
-		}
-		if (*out == nullptr) {
-			// Point to unused data in `buf`
-			*out = buf + *used;
-		} else{
-			// Copy data to the given output buffer
-			memcpy(*out, buf + *used, *expect);
-		}
-		*used += *expect;
-	} else {
-		// no more data
-		*expect = 0;
-	}
-	return *expect;
-}
-
 ssize_t InputHandler::readFromSource(unsigned char *buf, size_t size)
 {
 	// Read from pre-loaded buffer
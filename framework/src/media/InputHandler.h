@@ -60,7 +60,6 @@ public:
 	std::shared_ptr<MediaPlayerImpl> getPlayer() { return mPlayer.lock(); }
 
 	size_t getAvailSpace();
-	ssize_t writeToStreamBuffer(unsigned char *buf, size_t size);
 
 private:
 	bool probeDataSource() override;
@@ -72,10 +71,10 @@ private:
 	void sleepWorker() override;
 	bool processWorker() override;
 	const char *getWorkerName(void) const override { return "InputHandler"; };
-	ssize_t getElementaryStream(unsigned char *buf, size_t size, size_t *used, unsigned char **out, size_t *expect);
-	ssize_t getPCM(unsigned char *buf, size_t size, size_t *used, unsigned char **out, size_t *expect);
-	size_t fetchData(unsigned char *buf, size_t size, size_t *used, unsigned char **out, size_t *expect);
 	ssize_t readFromSource(unsigned char *buf, size_t size);
+	bool readToBufferDirectly(size_t size);
+	bool demuxToBufferDirectly(size_t size);
+	bool decodeToStreamBuffer();
 
 	std::mutex mMutex;
 	std::condition_variable mCondv;
@@ -16,31 +16,95 @@
  *
  ******************************************************************/
 
+#include <debug.h>
 #include "MediaQueue.h"
 
 namespace media {
-MediaQueue::MediaQueue()
+MediaCommand::MediaCommand(MediaCommand &&cmd) : mOps(cmd.mOps)
+{
+	if (mOps) {
+		mOps->move(&mStorage, &cmd.mStorage);
+		cmd.reset();
+	}
+}
+
+MediaCommand &MediaCommand::operator=(MediaCommand &&cmd)
+{
+	if (this != &cmd) {
+		reset();
+		mOps = cmd.mOps;
+		if (mOps) {
+			mOps->move(&mStorage, &cmd.mStorage);
+			cmd.reset();
+		}
+	}
+	return *this;
+}
+
+MediaCommand::~MediaCommand()
+{
+	reset();
+}
+
+void MediaCommand::reset()
+{
+	if (mOps) {
+		mOps->destroy(&mStorage);
+		mOps = nullptr;
+	}
+}
+
+MediaQueue::MediaQueue() : mHead(0), mCount(0), mOverflowCount(0)
 {
 }
 MediaQueue::~MediaQueue()
 {
 }
 
-std::function<void()> MediaQueue::deQueue()
+void MediaQueue::push(MediaCommand &&cmd)
+{
+	// Once spilled, keep FIFO order by spilling until the overflow queue is drained.
+	if (mCount < CONFIG_MEDIA_QUEUE_DEPTH && mOverflowData.empty()) {
+		mQueueData[(mHead + mCount) % CONFIG_MEDIA_QUEUE_DEPTH] = std::move(cmd);
+		mCount++;
+		return;
+	}
+
+	mOverflowCount++;
+	medwdbg("command queue overflow, count %u\n", mOverflowCount);
+	mOverflowData.push(std::move(cmd));
+}
+
+MediaCommand MediaQueue::deQueue()
 {
 	std::unique_lock<std::mutex> lock(mQueueMtx);
-	if (mQueueData.empty()) {
+	while (mCount == 0) {
 		mQueueCv.wait(lock);
 	}
 
-	auto data = std::move(mQueueData.front());
-	mQueueData.pop();
+	MediaCommand data(std::move(mQueueData[mHead]));
+	mHead = (mHead + 1) % CONFIG_MEDIA_QUEUE_DEPTH;
+	mCount--;
+
+	// Refill the ring from overflowed commands
+	if (!mOverflowData.empty()) {
+		mQueueData[(mHead + mCount) % CONFIG_MEDIA_QUEUE_DEPTH] = std::move(mOverflowData.front());
+		mOverflowData.pop();
+		mCount++;
+	}
+
 	return data;
 }
 
 bool MediaQueue::isEmpty()
 {
 	std::unique_lock<std::mutex> lock(mQueueMtx);
-	return mQueueData.empty();
+	return mCount == 0;
+}
+
+size_t MediaQueue::getOverflowCount()
+{
+	std::unique_lock<std::mutex> lock(mQueueMtx);
+	return mOverflowCount;
 }
 } // namespace media
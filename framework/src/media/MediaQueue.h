@@ -19,14 +19,88 @@
 #ifndef __MEDIA_QUEUE_H
 #define __MEDIA_QUEUE_H
 
+#include <tinyara/config.h>
 #include <mutex>
 #include <condition_variable>
 #include <queue>
 #include <atomic>
 #include <iostream>
 #include <functional>
+#include <new>
+#include <type_traits>
+
+#ifndef CONFIG_MEDIA_QUEUE_DEPTH
+#define CONFIG_MEDIA_QUEUE_DEPTH 16
+#endif
+
+#if CONFIG_MEDIA_QUEUE_DEPTH < 1
+#error "CONFIG_MEDIA_QUEUE_DEPTH must be at least 1"
+#endif
+
+#ifndef CONFIG_MEDIA_QUEUE_COMMAND_WORDS
+#define CONFIG_MEDIA_QUEUE_COMMAND_WORDS 12
+#endif
 
 namespace media {
+/**
+ * Callable object stored in place, without heap allocation.
+ * The callable (e.g. result of std::bind) must fit in STORAGE_SIZE bytes.
+ */
+class MediaCommand
+{
+public:
+	static const size_t STORAGE_SIZE = CONFIG_MEDIA_QUEUE_COMMAND_WORDS * sizeof(void *);
+
+	MediaCommand() : mOps(nullptr) {}
+	template <typename _Fn>
+	explicit MediaCommand(_Fn &&fn) {
+		typedef typename std::decay<_Fn>::type _Fd;
+		static_assert(sizeof(_Fd) <= STORAGE_SIZE, "Command is too large, increase CONFIG_MEDIA_QUEUE_COMMAND_WORDS");
+		static_assert(alignof(_Fd) <= alignof(Storage), "Command alignment is not supported");
+		new (&mStorage) _Fd(std::forward<_Fn>(fn));
+		mOps = &Ops<_Fd>::table;
+	}
+	MediaCommand(MediaCommand &&cmd);
+	MediaCommand &operator=(MediaCommand &&cmd);
+	MediaCommand(const MediaCommand &) = delete;
+	MediaCommand &operator=(const MediaCommand &) = delete;
+	~MediaCommand();
+
+	void operator()() { mOps->invoke(&mStorage); }
+	explicit operator bool() const { return mOps != nullptr; }
+	void reset();
+
+private:
+	typedef typename std::aligned_storage<STORAGE_SIZE>::type Storage;
+	struct OpsTable {
+		void (*invoke)(void *);
+		void (*move)(void *dst, void *src);
+		void (*destroy)(void *);
+	};
+	template <typename _Fd>
+	struct Ops {
+		static void invoke(void *p) { (*static_cast<_Fd *>(p))(); }
+		static void move(void *dst, void *src) { new (dst) _Fd(std::move(*static_cast<_Fd *>(src))); }
+		static void destroy(void *p) { static_cast<_Fd *>(p)->~_Fd(); }
+		static const OpsTable table;
+	};
+
+	Storage mStorage;
+	const OpsTable *mOps;
+};
+
+template <typename _Fd>
+const MediaCommand::OpsTable MediaCommand::Ops<_Fd>::table = {
+	&MediaCommand::Ops<_Fd>::invoke,
+	&MediaCommand::Ops<_Fd>::move,
+	&MediaCommand::Ops<_Fd>::destroy
+};
+
+/**
+ * Command queue backed by a fixed ring of CONFIG_MEDIA_QUEUE_DEPTH commands.
+ * Commands are only spilled to a heap allocated queue when the ring is full,
+ * which is counted as an overflow event.
+ */
 class MediaQueue
 {
 public:
@@ -34,16 +108,23 @@ public:
 	~MediaQueue();
 	template <typename _Callable, typename... _Args>
 	void enQueue(_Callable &&__f, _Args &&... __args) {
+		MediaCommand cmd(std::bind(std::forward<_Callable>(__f), std::forward<_Args>(__args)...));
 		std::unique_lock<std::mutex> lock(mQueueMtx);
-		std::function<void()> func = std::bind(std::forward<_Callable>(__f), std::forward<_Args>(__args)...);
-		mQueueData.push(func);
+		push(std::move(cmd));
 		mQueueCv.notify_one();
 	}
-	std::function<void()> deQueue();
+	MediaCommand deQueue();
 	bool isEmpty();
+	size_t getOverflowCount();
 
 private:
-	std::queue<std::function<void()>> mQueueData;
+	void push(MediaCommand &&cmd);
+
+	MediaCommand mQueueData[CONFIG_MEDIA_QUEUE_DEPTH];
+	size_t mHead;
+	size_t mCount;
+	std::queue<MediaCommand> mOverflowData;
+	size_t mOverflowCount;
 	std::condition_variable mQueueCv;
 	std::mutex mQueueMtx;
 };
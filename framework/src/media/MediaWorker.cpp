@@ -81,11 +81,16 @@ void MediaWorker::stopWorker()
 	}
 }
 
-std::function<void()> MediaWorker::deQueue()
+MediaCommand MediaWorker::deQueue()
 {
 	return mWorkerQueue.deQueue();
 }
 
+size_t MediaWorker::getQueueOverflowCount()
+{
+	return mWorkerQueue.getOverflowCount();
+}
+
 bool MediaWorker::processLoop()
 {
 	return false;
@@ -99,9 +104,9 @@ void *MediaWorker::mediaLooper(void *arg)
 	while (worker->mIsRunning) {
 		while (worker->processLoop() && worker->mWorkerQueue.isEmpty());
 
-		std::function<void()> run = worker->deQueue();
+		MediaCommand run = worker->deQueue();
 		medvdbg("MediaWorker : deQueue\n");
-		if (run != nullptr) {
+		if (run) {
 			run();
 		}
 	}
@@ -39,8 +39,9 @@ public:
 	void enQueue(_Callable &&__f, _Args &&... __args) {
 		mWorkerQueue.enQueue(__f, __args...);
 	}
-	std::function<void()> deQueue();
+	MediaCommand deQueue();
 	bool isAlive();
+	size_t getQueueOverflowCount();
 
 protected:
 	long mStacksize;
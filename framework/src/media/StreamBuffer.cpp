@@ -46,7 +46,7 @@ namespace media {
 namespace stream {
 
 StreamBuffer::StreamBuffer(size_t bufferSize, size_t threshold)
-	: mObserver(nullptr), mEOS(false), mBufferSize(bufferSize), mThreshold(threshold)
+	: mObserver(nullptr), mEOS(false), mWaiters(0), mBufferSize(bufferSize), mThreshold(threshold)
 {
 	mRingBuf.buf = nullptr;
 	mRingBuf.depth = 0;
@@ -92,6 +92,26 @@ size_t StreamBuffer::write(unsigned char *buf, size_t size)
 	return rb_write(&mRingBuf, buf, size);
 }
 
+size_t StreamBuffer::reserve(unsigned char **buf, size_t size)
+{
+	return rb_reserve(&mRingBuf, (void **)buf, size);
+}
+
+size_t StreamBuffer::commit(size_t size)
+{
+	return rb_commit(&mRingBuf, size);
+}
+
+size_t StreamBuffer::peek(unsigned char **buf, size_t size)
+{
+	return rb_peek(&mRingBuf, (void **)buf, size);
+}
+
+size_t StreamBuffer::consume(size_t size)
+{
+	return rb_consume(&mRingBuf, size);
+}
+
 size_t StreamBuffer::sizeOfSpace()
 {
 	return rb_avail(&mRingBuf);
@@ -112,6 +132,38 @@ bool StreamBuffer::isEndOfStream()
 	return mEOS;
 }
 
+void StreamBuffer::waitForData()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mWaiters++;
+	// Pairs with the fence in wakeUp(): either we see the new data here, or the peer sees us waiting.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (sizeOfData() == 0 && !isEndOfStream()) {
+		mCondv.wait(lock);
+	}
+	mWaiters--;
+}
+
+void StreamBuffer::waitForSpace()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mWaiters++;
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (sizeOfSpace() == 0 && !isEndOfStream()) {
+		mCondv.wait(lock);
+	}
+	mWaiters--;
+}
+
+void StreamBuffer::wakeUp()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (mWaiters > 0) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mCondv.notify_all();
+	}
+}
+
 void StreamBuffer::setObserver(BufferObserverInterface *observer)
 {
 	mObserver = observer;
@@ -119,6 +171,10 @@ void StreamBuffer::setObserver(BufferObserverInterface *observer)
 
 void StreamBuffer::notifyObserver(State st, ...)
 {
+#ifdef CONFIG_STREAM_BUFFER_LOCKFREE
+	// Reader and writer notify without holding mMutex, keep the observer single threaded.
+	std::lock_guard<std::mutex> lock(mNotifyMutex);
+#endif
 	if (mObserver) {
 		switch (st) {
 		case State::OVERRUN:
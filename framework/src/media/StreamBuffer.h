@@ -20,6 +20,7 @@
 #define __MEDIA_STREAMBUFFER_H
 
 #include <memory>
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include "utils/rb.h"
@@ -87,6 +88,24 @@ public:
 	 * Write(push) data into stream buffer.
 	 */
 	size_t write(unsigned char *buf, size_t size);
+	/**
+	 * Get a contiguous free span in stream buffer to write into directly.
+	 * Data written into the span is pushed after commit().
+	 */
+	size_t reserve(unsigned char **buf, size_t size);
+	/**
+	 * Push data written into the span returned by reserve().
+	 */
+	size_t commit(size_t size);
+	/**
+	 * Get a contiguous span of data in stream buffer to read in place.
+	 * Data is popped after consume().
+	 */
+	size_t peek(unsigned char **buf, size_t size);
+	/**
+	 * Pop data read in place via peek().
+	 */
+	size_t consume(size_t size);
 	/**
 	 * Get bytes of data available in stream buffer.
 	 */
@@ -103,15 +122,32 @@ public:
 	 * Check if the end-of-stream flag was set.
 	 */
 	bool isEndOfStream();
+	/**
+	 * Wait until there's data in stream buffer or end-of-stream flag was set.
+	 * Used by lock-free reader only when stream buffer is empty.
+	 */
+	void waitForData();
+	/**
+	 * Wait until there's space in stream buffer or end-of-stream flag was set.
+	 * Used by lock-free writer only when stream buffer is full.
+	 */
+	void waitForSpace();
+	/**
+	 * Wake up the lock-free reader or writer waiting in waitForData()/waitForSpace().
+	 * The mutex is taken only if there's someone waiting.
+	 */
+	void wakeUp();
 	size_t getBufferSize() { return mBufferSize; }
 	size_t getThreshold() { return mThreshold; }
 
 private:
 	std::mutex mMutex;
 	std::condition_variable mCondv;
+	std::mutex mNotifyMutex;
 	BufferObserverInterface *mObserver;
 	rb_t mRingBuf;
-	bool mEOS;
+	std::atomic<bool> mEOS;
+	std::atomic<int> mWaiters;
 	size_t mBufferSize;
 	size_t mThreshold;
 };
@@ -16,6 +16,7 @@
  *
  ******************************************************************/
 
+#include <tinyara/config.h>
 #include <iostream>
 #include <stdio.h>
 #include <assert.h>
@@ -33,6 +34,107 @@ StreamBufferReader::StreamBufferReader(std::shared_ptr<StreamBuffer> stream)
 	assert(mStream);
 }
 
+#ifdef CONFIG_STREAM_BUFFER_LOCKFREE
+size_t StreamBufferReader::copy(unsigned char *buf, size_t size, size_t offset)
+{
+	medvdbg("offset %lu, size %lu\n", offset, size);
+	size_t len = mStream->copy(buf, size, offset);
+	medvdbg("copied %lu\n", len);
+	return len;
+}
+
+size_t StreamBufferReader::read(unsigned char *buf, size_t size, bool sync)
+{
+	medvdbg("size %lu sync %c\n", size, sync ? 'Y' : 'N');
+
+	size_t rlen = 0;
+
+	if (sync) {
+		while (rlen < size) {
+			// Check EOS before reading, writer may put the last data just before setting EOS.
+			bool eos = mStream->isEndOfStream();
+			// Read data from stream as much as possible
+			size_t temp = mStream->read(buf + rlen, size - rlen);
+			mStream->notifyObserver(StreamBuffer::State::UPDATED, -((ssize_t) temp));
+			if (temp > 0) {
+				// Writer may be waiting for more spaces
+				mStream->wakeUp();
+			}
+			rlen += temp;
+			if (rlen < size) {
+				// There's not enough data
+				if (eos) {
+					// End of stream, break reading
+					medvdbg("EOS break\n");
+					break;
+				}
+
+				medvdbg("read %lu/%lu\n", rlen, size);
+				// Notify observer, shouldn't be blocked.
+				mStream->notifyObserver(StreamBuffer::State::UNDERRUN);
+				// Then wait for writer, only at the empty edge.
+				mStream->waitForData();
+			}
+		}
+
+		assert(rlen == size || mStream->isEndOfStream());
+	} else {
+		rlen = mStream->read(buf, size);
+		mStream->notifyObserver(StreamBuffer::State::UPDATED, -((ssize_t) rlen));
+		if (rlen > 0) {
+			mStream->wakeUp();
+		}
+	}
+
+	medvdbg("read %lu\n", rlen);
+	return rlen;
+}
+
+size_t StreamBufferReader::peek(unsigned char **buf, size_t size, bool sync)
+{
+	medvdbg("size %lu sync %c\n", size, sync ? 'Y' : 'N');
+
+	size_t len = 0;
+
+	while (true) {
+		bool eos = mStream->isEndOfStream();
+		len = mStream->peek(buf, size);
+		if (len > 0 || !sync || eos) {
+			break;
+		}
+
+		// There's no data, notify observer and wait for writer.
+		mStream->notifyObserver(StreamBuffer::State::UNDERRUN);
+		mStream->waitForData();
+	}
+
+	medvdbg("peeked %lu\n", len);
+	return len;
+}
+
+size_t StreamBufferReader::consume(size_t size)
+{
+	size_t len = mStream->consume(size);
+	mStream->notifyObserver(StreamBuffer::State::UPDATED, -((ssize_t) len));
+	if (len > 0) {
+		// Writer may be waiting for more spaces
+		mStream->wakeUp();
+	}
+
+	medvdbg("consumed %lu\n", len);
+	return len;
+}
+
+size_t StreamBufferReader::sizeOfData()
+{
+	return mStream->sizeOfData();
+}
+
+bool StreamBufferReader::isEndOfStream()
+{
+	return mStream->isEndOfStream();
+}
+#else
 size_t StreamBufferReader::copy(unsigned char *buf, size_t size, size_t offset)
 {
 	medvdbg("offset %lu, size %lu\n", offset, size);
@@ -86,6 +188,38 @@ size_t StreamBufferReader::read(unsigned char *buf, size_t size, bool sync)
 	return rlen;
 }
 
+size_t StreamBufferReader::peek(unsigned char **buf, size_t size, bool sync)
+{
+	medvdbg("size %lu sync %c\n", size, sync ? 'Y' : 'N');
+	std::unique_lock<std::mutex> lock(mStream->getMutex());
+
+	size_t len = mStream->peek(buf, size);
+	while (len == 0 && sync && !mStream->isEndOfStream()) {
+		// There's no data, notify observer.
+		mStream->notifyObserver(StreamBuffer::State::UNDERRUN);
+		// Writer may be waiting for more spaces, then wait notification from writer.
+		mStream->getCondv().notify_one();
+		mStream->getCondv().wait(lock);
+		len = mStream->peek(buf, size);
+	}
+
+	medvdbg("peeked %lu\n", len);
+	return len;
+}
+
+size_t StreamBufferReader::consume(size_t size)
+{
+	std::lock_guard<std::mutex> lock(mStream->getMutex());
+	size_t len = mStream->consume(size);
+	mStream->notifyObserver(StreamBuffer::State::UPDATED, -((ssize_t) len));
+
+	// Writer may be waiting for more spaces, so it's necessary to notify after reading.
+	mStream->getCondv().notify_one();
+
+	medvdbg("consumed %lu\n", len);
+	return len;
+}
+
 size_t StreamBufferReader::sizeOfData()
 {
 	std::lock_guard<std::mutex> lock(mStream->getMutex());
@@ -97,6 +231,7 @@ bool StreamBufferReader::isEndOfStream()
 	std::lock_guard<std::mutex> lock(mStream->getMutex());
 	return mStream->isEndOfStream();
 }
+#endif
 
 } // namespace stream
 } // namespace media
@@ -33,6 +33,13 @@ public:
 public:
 	virtual size_t copy(unsigned char *buf, size_t size, size_t offset = 0);
 	virtual size_t read(unsigned char *buf, size_t size, bool sync = true);
+	/**
+	 * Get a contiguous span of data to read in place, without copying.
+	 * In sync mode, it waits until there's some data or end-of-stream.
+	 * Call consume() after using the data.
+	 */
+	virtual size_t peek(unsigned char **buf, size_t size, bool sync = true);
+	virtual size_t consume(size_t size);
 	virtual size_t sizeOfData();
 
 public:
@@ -16,6 +16,7 @@
  *
  ******************************************************************/
 
+#include <tinyara/config.h>
 #include <iostream>
 #include <stdio.h>
 #include <assert.h>
@@ -33,6 +34,100 @@ StreamBufferWriter::StreamBufferWriter(std::shared_ptr<StreamBuffer> stream)
 	assert(mStream);
 }
 
+#ifdef CONFIG_STREAM_BUFFER_LOCKFREE
+size_t StreamBufferWriter::write(unsigned char *buf, size_t size, bool sync)
+{
+	medvdbg("size %lu sync %c\n", size, sync ? 'Y' : 'N');
+
+	size_t wlen = 0;
+
+	if (sync) {
+		while (wlen < size) {
+			// Streaming may be stopped (EOS was set)
+			if (mStream->isEndOfStream()) {
+				// Don't need to write anymore
+				medvdbg("EOS break\n");
+				break;
+			}
+
+			// Write data into stream as much as possible
+			size_t temp = mStream->write(buf + wlen, size - wlen);
+			mStream->notifyObserver(StreamBuffer::State::UPDATED, (ssize_t) temp);
+			if (temp > 0) {
+				// Reader may be waiting for more data
+				mStream->wakeUp();
+			}
+			wlen += temp;
+			if (wlen < size) {
+				medvdbg("written %lu/%lu\n", wlen, size);
+				// There's not enough space
+				// Notify observer, shouldn't be blocked.
+				mStream->notifyObserver(StreamBuffer::State::OVERRUN);
+				// Then wait for reader, only at the full edge.
+				mStream->waitForSpace();
+			}
+		}
+	} else {
+		wlen = mStream->write(buf, size);
+		mStream->notifyObserver(StreamBuffer::State::UPDATED, (ssize_t) wlen);
+		if (wlen > 0) {
+			mStream->wakeUp();
+		}
+	}
+
+	medvdbg("written %lu\n", wlen);
+	return wlen;
+}
+
+size_t StreamBufferWriter::reserve(unsigned char **buf, size_t size, bool sync)
+{
+	medvdbg("size %lu sync %c\n", size, sync ? 'Y' : 'N');
+
+	size_t len = 0;
+
+	// Streaming may be stopped (EOS was set)
+	while (!mStream->isEndOfStream()) {
+		len = mStream->reserve(buf, size);
+		if (len > 0 || !sync) {
+			break;
+		}
+
+		// There's no space, notify observer and wait for reader.
+		mStream->notifyObserver(StreamBuffer::State::OVERRUN);
+		mStream->waitForSpace();
+	}
+
+	medvdbg("reserved %lu\n", len);
+	return len;
+}
+
+size_t StreamBufferWriter::commit(size_t size)
+{
+	size_t len = mStream->commit(size);
+	mStream->notifyObserver(StreamBuffer::State::UPDATED, (ssize_t) len);
+	if (len > 0) {
+		// Reader may be waiting for more data
+		mStream->wakeUp();
+	}
+
+	medvdbg("committed %lu\n", len);
+	return len;
+}
+
+size_t StreamBufferWriter::sizeOfSpace()
+{
+	return mStream->sizeOfSpace();
+}
+
+void StreamBufferWriter::setEndOfStream()
+{
+	// Set EOS flag in stream.
+	mStream->setEndOfStream();
+
+	// Reader may be waiting for more data, so it's necessary to wake it up.
+	mStream->wakeUp();
+}
+#else
 size_t StreamBufferWriter::write(unsigned char *buf, size_t size, bool sync)
 {
 	medvdbg("size %lu sync %c\n", size, sync ? 'Y' : 'N');
@@ -76,6 +171,44 @@ size_t StreamBufferWriter::write(unsigned char *buf, size_t size, bool sync)
 	return wlen;
 }
 
+size_t StreamBufferWriter::reserve(unsigned char **buf, size_t size, bool sync)
+{
+	medvdbg("size %lu sync %c\n", size, sync ? 'Y' : 'N');
+	std::unique_lock<std::mutex> lock(mStream->getMutex());
+
+	size_t len = 0;
+
+	// Streaming may be stopped (EOS was set)
+	while (!mStream->isEndOfStream()) {
+		len = mStream->reserve(buf, size);
+		if (len > 0 || !sync) {
+			break;
+		}
+
+		// There's no space, notify observer.
+		mStream->notifyObserver(StreamBuffer::State::OVERRUN);
+		// Reader may be waiting for more data, then wait notification from reader.
+		mStream->getCondv().notify_one();
+		mStream->getCondv().wait(lock);
+	}
+
+	medvdbg("reserved %lu\n", len);
+	return len;
+}
+
+size_t StreamBufferWriter::commit(size_t size)
+{
+	std::lock_guard<std::mutex> lock(mStream->getMutex());
+	size_t len = mStream->commit(size);
+	mStream->notifyObserver(StreamBuffer::State::UPDATED, (ssize_t) len);
+
+	// Reader may be waiting for more data, so it's necessary to notify after writing.
+	mStream->getCondv().notify_one();
+
+	medvdbg("committed %lu\n", len);
+	return len;
+}
+
 size_t StreamBufferWriter::sizeOfSpace()
 {
 	std::lock_guard<std::mutex> lock(mStream->getMutex());
@@ -92,6 +225,7 @@ void StreamBufferWriter::setEndOfStream()
 	// Reader may be waiting for more data, so it's necessary to notify.
 	mStream->getCondv().notify_one();
 }
+#endif
 
 } // namespace stream
 } // namespace media
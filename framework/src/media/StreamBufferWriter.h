@@ -32,6 +32,13 @@ public:
 
 public:
 	virtual size_t write(unsigned char *buf, size_t size, bool sync = true);
+	/**
+	 * Get a contiguous free span to write into directly, without copying.
+	 * In sync mode, it waits until there's some space or end-of-stream.
+	 * Call commit() after writing the data.
+	 */
+	virtual size_t reserve(unsigned char **buf, size_t size, bool sync = true);
+	virtual size_t commit(size_t size);
 	virtual size_t sizeOfSpace();
 
 public:
@@ -41,6 +41,21 @@
 #define CONFIG_AUDIO_DEV_PATH "/dev/audio"
 #endif
 
+#ifdef CONFIG_AUDIO_RESAMPLER_POLYPHASE
+#define AUDIO_RESAMPLER_CONVERTER SRC_CONVERTER_POLYPHASE
+#else
+#define AUDIO_RESAMPLER_CONVERTER SRC_CONVERTER_LINEAR
+#endif
+
+#ifdef CONFIG_AUDIO_SOFTWARE_VOLUME
+#define AUDIO_SOFTWARE_VOLUME_ENABLED true
+#else
+#define AUDIO_SOFTWARE_VOLUME_ENABLED false
+#endif
+
+/* Stream out is converted in one pass by src_process(), its internal buffer is only a sliding window */
+#define AUDIO_RESAMPLER_WINDOW_SIZE 1024
+
 #define AUDIO_DEV_PATH_LENGTH 11
 #define AUDIO_PCM_PATH_LENGTH 9	//length of pcmC%uD%u%c + 1;
 #define AUDIO_DEVICE_FULL_PATH_LENGTH (AUDIO_DEV_PATH_LENGTH + AUDIO_PCM_PATH_LENGTH)
@@ -76,6 +91,13 @@
 
 #define AUDIO_DEVICE_MAX_VOLUME 10
 
+#ifdef CONFIG_AUDIO_SOFTWARE_VOLUME
+/* Q15 gain for each volume step, 3dB per step */
+static const int g_audio_volume_gain[AUDIO_DEVICE_MAX_VOLUME + 1] = {
+	0, 1465, 2068, 2920, 4125, 5827, 8231, 11627, 16423, 23197, SRC_GAIN_UNITY
+};
+#endif
+
 #ifndef CONFIG_AUDIO_MAX_INPUT_CARD_NUM
 #define CONFIG_AUDIO_MAX_INPUT_CARD_NUM 2
 #endif
@@ -125,7 +147,7 @@ struct audio_device_config_s {
 };
 
 struct audio_resample_s {
-	bool necessary;             // if resampling/rechanneling is needed (format-converting is not supported now)
+	bool necessary;             // if resampling/rechanneling is needed (format-converting is supported for stream out only)
 	void *buffer;               // pointer to the buffer used for resampling
 	uint32_t buffer_size;       // size in bytes of the buffer
 	uint32_t frames;            // number of frames in the buffer
@@ -135,6 +157,7 @@ struct audio_resample_s {
 	uint32_t user_sample_rate;  // sample rate from a user
 	uint32_t user_channel;      // channel info from a user
 	uint8_t user_format;        // bytes per sample of user format
+	enum pcm_format user_pcm_format;    // pcm format from a user
 	/* card supported */
 	uint8_t samprate_types;     // sample rate types supported by card
 };
@@ -187,8 +210,12 @@ static audio_manager_result_t get_supported_process_type(int card_id, int device
 static uint32_t get_closest_samprate(unsigned origin_samprate, audio_io_direction_t direct);
 static unsigned int resample_stream_in(audio_card_info_t *card, void *data, unsigned int frames);
 static unsigned int resample_stream_out(audio_card_info_t *card, void *data, unsigned int frames);
+static int get_sample_width(enum pcm_format format);
 static audio_manager_result_t get_audio_volume(audio_io_direction_t direct);
 static audio_manager_result_t set_audio_volume(audio_io_direction_t direct, uint8_t volume);
+#ifdef CONFIG_AUDIO_SOFTWARE_VOLUME
+static int get_software_gain(audio_config_t *config);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -454,6 +481,20 @@ static unsigned int resample_stream_in(audio_card_info_t *card, void *data, unsi
 	return resampled_frames;
 }
 
+/*
+ * format: pcm format of user data or audio card
+ * return: sample width for the resampler, 24bits in 32bits sample of
+ *         PCM_FORMAT_S24_LE is distinguished from PCM_FORMAT_S32_LE.
+ */
+static int get_sample_width(enum pcm_format format)
+{
+	if (format == PCM_FORMAT_S24_LE) {
+		return SAMPLE_WIDTH_24BITS_IN_32BITS;
+	}
+
+	return pcm_format_to_bits(format);
+}
+
 /*
  * card: Pointer to audio card information structure
  *       card->resample.buffer retrieves generated frames for output,
@@ -472,10 +513,10 @@ static unsigned int resample_stream_out(audio_card_info_t *card, void *data, uns
 
 	srcData.origin_channel_num = card->resample.user_channel;
 	srcData.origin_sample_rate = card->resample.user_sample_rate;
-	srcData.origin_sample_width = SAMPLE_WIDTH_16BITS; // TODO: support user format later
+	srcData.origin_sample_width = get_sample_width(card->resample.user_pcm_format);
 	srcData.desired_channel_num = pcm_get_channels(card->pcm);
 	srcData.desired_sample_rate = pcm_get_rate(card->pcm);
-	srcData.desired_sample_width = SAMPLE_WIDTH_16BITS;
+	srcData.desired_sample_width = get_sample_width(pcm_get_format(card->pcm));
 
 	while (frames > used_frames) {
 		srcData.data_in = (const void *)((char *)data + get_user_output_frames_to_byte(used_frames));
@@ -485,7 +526,8 @@ static unsigned int resample_stream_out(audio_card_info_t *card, void *data, uns
 		medvdbg("data_in 0x%x, input_frames %d\n", srcData.data_in, srcData.input_frames);
 		medvdbg("data_out 0x%x, out_buf_length %d\n", srcData.data_out, srcData.out_buf_length);
 
-		int src_ret = src_simple(card->resample.handle, &srcData);
+		// Remix, resample, apply gain and convert format in one pass, straight into resample.buffer
+		int src_ret = src_process(card->resample.handle, &srcData);
 		if (src_ret < 0) {
 			meddbg("Fail to resample in:%u/%u, error %d\n", used_frames, frames, src_ret);
 			return AUDIO_MANAGER_RESAMPLE_FAIL;
@@ -505,6 +547,22 @@ static unsigned int resample_stream_out(audio_card_info_t *card, void *data, uns
 	return resampled_frames;
 }
 
+#ifdef CONFIG_AUDIO_SOFTWARE_VOLUME
+/*
+ * Output volume is not sent to the device, it's applied as a gain in src_process().
+ * Volume starts at max, as the device would play at full scale.
+ */
+static int get_software_gain(audio_config_t *config)
+{
+	if (config->max_volume == 0) {
+		config->max_volume = AUDIO_DEVICE_MAX_VOLUME;
+		config->volume = AUDIO_DEVICE_MAX_VOLUME;
+	}
+
+	return g_audio_volume_gain[config->volume];
+}
+#endif
+
 static audio_manager_result_t get_audio_volume(audio_io_direction_t direct)
 {
 	audio_manager_result_t ret = AUDIO_MANAGER_SUCCESS;
@@ -527,6 +585,12 @@ static audio_manager_result_t get_audio_volume(audio_io_direction_t direct)
 		caps_desc.caps.ac_subtype = AUDIO_FU_VOLUME;
 		card = &g_audio_out_cards[g_actual_audio_out_card_id];
 		card_mutex = &g_audio_out_cards[g_actual_audio_out_card_id].card_mutex;
+#ifdef CONFIG_AUDIO_SOFTWARE_VOLUME
+		pthread_mutex_lock(card_mutex);
+		get_software_gain(&card->config[card->device_id]);
+		pthread_mutex_unlock(card_mutex);
+		return AUDIO_MANAGER_SUCCESS;
+#endif
 	}
 	get_card_path(card_path, card->card_id, card->device_id, direct);
 
@@ -583,6 +647,18 @@ static audio_manager_result_t set_audio_volume(audio_io_direction_t direct, uint
 	}
 
 	config = &card->config[card->device_id];
+#ifdef CONFIG_AUDIO_SOFTWARE_VOLUME
+	if (direct == OUTPUT) {
+		pthread_mutex_lock(card_mutex);
+		config->volume = volume;
+		if (card->resample.handle) {
+			src_set_gain(card->resample.handle, get_software_gain(config));
+		}
+		medvdbg("Volume = %d (software)\n", volume);
+		pthread_mutex_unlock(card_mutex);
+		return AUDIO_MANAGER_SUCCESS;
+	}
+#endif
 	caps_desc.caps.ac_controls.hw[0] = volume * (config->max_volume / AUDIO_DEVICE_MAX_VOLUME);
 	caps_desc.caps.ac_len = sizeof(struct audio_caps_s);
 	caps_desc.caps.ac_type = AUDIO_TYPE_FEATURE;
@@ -698,13 +774,14 @@ audio_manager_result_t set_audio_stream_in(unsigned int channels, unsigned int s
 	card->resample.user_channel = channels;
 	card->resample.user_sample_rate = sample_rate;
 	card->resample.user_format = pcm_format_to_bits((enum pcm_format)format) >> 3;
+	card->resample.user_pcm_format = (enum pcm_format)format;
 
 	// Check if resampling is required
 	if ((config.channels != card->resample.user_channel) || (config.rate != card->resample.user_sample_rate)) {
 		// Yes, resampling is necessary, and it would be processed in src_simple().
 		card->resample.necessary = true;
 		card->resample.buffer = NULL;
-		card->resample.handle = src_init(CONFIG_AUDIO_RESAMPLER_BUFSIZE);
+		card->resample.handle = src_init_ext(CONFIG_AUDIO_RESAMPLER_BUFSIZE, AUDIO_RESAMPLER_CONVERTER);
 		if (!card->resample.handle) {
 			meddbg("src_init failed\n");
 			ret = AUDIO_MANAGER_RESAMPLE_FAIL;
@@ -801,18 +878,23 @@ audio_manager_result_t set_audio_stream_out(unsigned int channels, unsigned int
 	card->resample.user_channel = channels;
 	card->resample.user_sample_rate = sample_rate;
 	card->resample.user_format = pcm_format_to_bits((enum pcm_format)format) >> 3;
+	card->resample.user_pcm_format = (enum pcm_format)format;
 
-	// Check if resampling is required
-	if ((config.channels != card->resample.user_channel) || (config.rate != card->resample.user_sample_rate)) {
-		// Yes, resampling is necessary, and it would be processed in src_simple().
+	// Check if resampling or format converting is required, software volume is applied in the same pass
+	if ((config.channels != card->resample.user_channel) || (config.rate != card->resample.user_sample_rate) || \
+		(pcm_get_format(card->pcm) != card->resample.user_pcm_format) || AUDIO_SOFTWARE_VOLUME_ENABLED) {
+		// Yes, resampling is necessary, and it would be processed in src_process().
 		card->resample.necessary = true;
 		card->resample.buffer = NULL;
-		card->resample.handle = src_init(CONFIG_AUDIO_RESAMPLER_BUFSIZE);
+		card->resample.handle = src_init_ext(AUDIO_RESAMPLER_WINDOW_SIZE, AUDIO_RESAMPLER_CONVERTER);
 		if (!card->resample.handle) {
 			meddbg("src_init failed\n");
 			ret = AUDIO_MANAGER_RESAMPLE_FAIL;
 			goto error_with_pcm;
 		}
+#ifdef CONFIG_AUDIO_SOFTWARE_VOLUME
+		src_set_gain(card->resample.handle, get_software_gain(card_config));
+#endif
 
 		// Calculate the buffer size required for resampling.
 		float resample_buffer_frames = (float)get_output_frame_count();
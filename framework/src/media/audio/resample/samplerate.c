@@ -29,6 +29,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
 #include "samplerate.h"
 #include "../../utils/remix.h"
 
@@ -86,10 +89,34 @@
 		} \
 	} while (0)
 
+// Taps of each polyphase filter branch, multiple of 8 for the vectorized kernels
+#define POLYPHASE_TAPS          (24)
+
+// Maximum number of polyphase branches, e.g. 160 for 44.1K<->16K/32K/48K.
+// Ratios needing more branches (e.g. 8K->44.1K) fall back to linear converter.
+#define POLYPHASE_MAX_PHASES    (160)
+
+// Passband edge relative to the Nyquist frequency of the lower sample rate
+#define POLYPHASE_ROLLOFF       (0.90f)
+
+// Kaiser window shape parameter, about 70dB stopband attenuation
+#define POLYPHASE_KAISER_BETA   (7.0f)
+
+// Coefficients are stored in Q15 format
+#define POLYPHASE_Q15_ONE       (1 << 15)
+
 // Count bytes of the given frames
 #define OLD_FRAMES_TO_BYTES(src, frames) ((frames) * (src)->old_channel_num * BYTES_PER_SAMPLE((src)->old_sample_width))
 #define NEW_FRAMES_TO_BYTES(src, frames) ((frames) * (src)->new_channel_num * BYTES_PER_SAMPLE((src)->new_sample_width))
 
+// Count bytes of the given frames in internal buffer, which always keeps 16bits samples in new channel layout
+#define BUF_FRAMES_TO_BYTES(src, frames) ((frames) * (src)->new_channel_num * (int)sizeof(int16_t))
+
+// Check if the sample width is supported or not
+#define IS_VALID_SAMPLE_WIDTH(w) (((w) == SAMPLE_WIDTH_8BITS) || ((w) == SAMPLE_WIDTH_16BITS) || \
+								((w) == SAMPLE_WIDTH_24BITS) || ((w) == SAMPLE_WIDTH_32BITS) || \
+								((w) == SAMPLE_WIDTH_24BITS_IN_32BITS))
+
 // Check src context initialized or not
 #define CHECK_SRC_CONTEXT_INIT(src) ((src)->in_buffer != NULL)
 
@@ -103,7 +130,7 @@
  */
 struct src_context_s {
 	int16_t *in_buffer;     // pointer to the internal input buffer allocated
-	int16_t *out_buffer;    // pointer to the external output buffer assigned
+	void *out_buffer;       // pointer to the external output buffer assigned
 	int in_buffer_bytes;    // internal input buffer capability in bytes
 	int in_buffer_frames;   // internal input buffer capability in frames
 	int left_frames;        // number of frames remained in internal input buffer
@@ -118,7 +145,14 @@ struct src_context_s {
 	int overlap_frames;     // number of overlap frames reserved in internal buffer
 	float ratio;            // (float)new_sample_rate / (float)old_sample_rate
 	float inverse_ratio;    // (float)old_sample_rate / (float)new_sample_rate
-	uint32_t fp_frac;       // fraction part value of last fixed point index
+	uint32_t fp_frac;       // fixed point index of next frame, relative to the first frame in internal buffer
+	int converter;          // converter type given in src_init_ext()
+	int out_buffer_frames;  // capability in frames of the external output buffer assigned
+	int16_t *poly_coeff;    // polyphase filter table, POLYPHASE_TAPS coefficients per phase
+	int poly_up;            // polyphase interpolation factor (number of phases)
+	int poly_down;          // polyphase decimation factor
+	int poly_phase;         // current phase, range [0, poly_up)
+	int gain;               // Q15 gain applied to output samples, SRC_GAIN_UNITY means no gain
 	/**
 	 * @brief   Function pointer to resampling process function
 	 * @param   src_context_t *: pointer to resampler object.
@@ -184,33 +218,122 @@ static int16_t clip(int32_t x)
 	return x;
 }
 
+/**
+ * @brief   Store one output sample, with gain and format converting.
+ * @remarks Gain is applied after clipping, so (int16 * Q15) never overflows.
+ *          24bits sample is packed in 3 bytes, 32bits sample is left-justified,
+ *          24bits in 32bits sample is right-justified and sign-extended.
+ * @param   src: pointer to resampler object.
+ * @param   output: pointer to the output position, advanced by one sample.
+ * @param   x: sample value in 16bits range, it's clipped here.
+ */
+static inline void put_sample(src_context_t *src, uint8_t **output, int32_t x)
+{
+	int32_t sample = clip(x);
+	if (src->gain != SRC_GAIN_UNITY) {
+		sample = (sample * src->gain + (1 << 14)) >> 15;
+	}
+
+	switch (src->new_sample_width) {
+	case SAMPLE_WIDTH_16BITS:
+		*(int16_t *)*output = (int16_t)sample;
+		*output += 2;
+		break;
+	case SAMPLE_WIDTH_8BITS:
+		*(int8_t *)*output = (int8_t)(sample >> 8);
+		*output += 1;
+		break;
+	case SAMPLE_WIDTH_24BITS:
+		(*output)[0] = 0;
+		(*output)[1] = (uint8_t)sample;
+		(*output)[2] = (uint8_t)(sample >> 8);
+		*output += 3;
+		break;
+	case SAMPLE_WIDTH_24BITS_IN_32BITS:
+		*(int32_t *)*output = sample * (1 << 8);
+		*output += 4;
+		break;
+	default:
+		*(int32_t *)*output = sample * (1 << 16);
+		*output += 4;
+		break;
+	}
+}
+
+/**
+ * @brief   Append input frames to internal buffer, with format converting and channel remixing.
+ * @remarks Samples are converted to 16bits in old channel layout first, and then remixed
+ *          in place, so internal buffer must hold frames of the wider layout.
+ * @param   src: pointer to resampler object.
+ * @param   input: pointer to the input frames in old format/layout.
+ * @param   frames: number of frames to append.
+ * @param   output: pointer to the internal buffer position.
+ * @return  number of frames appended.
+ */
+static int32_t get_frames(src_context_t *src, const void *input, int32_t frames, int16_t *output)
+{
+	const uint8_t *in = (const uint8_t *)input;
+	int32_t samples = frames * src->old_channel_num;
+	int32_t i;
+
+	if (src->old_sample_width != SAMPLE_WIDTH_16BITS) {
+		for (i = 0; i < samples; i++) {
+			switch (src->old_sample_width) {
+			case SAMPLE_WIDTH_8BITS:
+				output[i] = (int16_t)((int8_t)in[i] * (1 << 8));
+				break;
+			case SAMPLE_WIDTH_24BITS:
+				output[i] = (int16_t)(in[i * 3 + 1] | (in[i * 3 + 2] << 8));
+				break;
+			case SAMPLE_WIDTH_24BITS_IN_32BITS:
+				output[i] = (int16_t)(((const int32_t *)in)[i] >> 8);
+				break;
+			default:
+				output[i] = (int16_t)(((const int32_t *)in)[i] >> 16);
+				break;
+			}
+		}
+		in = (const uint8_t *)output;
+	}
+
+	return rechannel(ch2layout(src->old_channel_num), ch2layout(src->new_channel_num), \
+					(const int16_t *)in, frames, output, frames);
+}
+
 /**
  * It handles sample rate up scaling in all ratio cases (i.e. inverse ratio 0.*)
  * and sample rate down scaling cases in inverse ratio 1.* and 2.* with fraction.
  */
 static int32_t resample_frac(src_context_t *src, int32_t *num_frames_in)
 {
-	int32_t num_frames_out = (int32_t)((float)*num_frames_in * src->ratio);
 	const int16_t *input = src->in_buffer;
-	int16_t *output = src->out_buffer;
+	uint8_t *output = (uint8_t *)src->out_buffer;
 	int32_t channels_num = src->new_channel_num;
 	uint32_t step = TO_16_16_FIXED(src->inverse_ratio);
 	uint32_t fp_index = src->fp_frac;
+	uint32_t fp_limit = (uint32_t)(*num_frames_in - 1) << FRACBITS;
 	uint32_t whole, frac;
 	int32_t i, j, s1, s2;
 
+	// Generate frames whose s1 and s2 are both inside of the given frames,
+	// overlap frames are not filtered yet in convolution_filtering().
+	int32_t num_frames_out = (fp_index < fp_limit) ? (int32_t)((fp_limit - fp_index + step - 1) / step) : 0;
+	num_frames_out = MINIMUM(num_frames_out, src->out_buffer_frames);
+
 	for (i = 0; i < num_frames_out; ++i, fp_index += step) {
 		whole = INTPART_VALUE(fp_index);
 		frac = FRACPART_VALUE(fp_index);
 		for (j = 0; j < channels_num; j++) {
 			s1 = input[whole * channels_num + j];
 			s2 = input[(whole + 1) * channels_num + j];
-			*output++ = clip(CALC_NEW_SAMPLE(s1, s2, frac));
+			put_sample(src, &output, CALC_NEW_SAMPLE(s1, s2, frac));
 		}
 	}
 
-	*num_frames_in = INTPART_VALUE(fp_index);
-	src->fp_frac = FRACPART_VALUE(fp_index);;
+	// Position of next frame may be beyond the given frames when down scaling, keep the rest in fp_frac.
+	whole = MINIMUM(INTPART_VALUE(fp_index), (uint32_t)*num_frames_in);
+	*num_frames_in = whole;
+	src->fp_frac = fp_index - (whole << FRACBITS);
 	return num_frames_out;
 }
 
@@ -227,7 +350,7 @@ static int32_t downresample_int(src_context_t *src, int32_t *num_frames_in)
 	int32_t num_frames_out = *num_frames_in / quotient;
 
 	const int16_t *input = src->in_buffer;
-	int16_t *output = src->out_buffer;
+	uint8_t *output = (uint8_t *)src->out_buffer;
 	int32_t channels_num = src->new_channel_num;
 	uint32_t step = TO_16_16_FIXED(quotient);
 	uint32_t fp_index = 0;
@@ -237,13 +360,281 @@ static int32_t downresample_int(src_context_t *src, int32_t *num_frames_in)
 	for (i = 0; i < num_frames_out; ++i, fp_index += step) {
 		whole = INTPART_VALUE(fp_index);
 		for (j = 0; j < channels_num; j++) {
-			*output++ = input[whole * channels_num + j];
+			put_sample(src, &output, input[whole * channels_num + j]);
 		}
 	}
 
 	return num_frames_out;
 }
 
+/**
+ * It handles the case without sample rate converting, used by src_process() only,
+ * which still needs remixing, gain and format converting.
+ */
+static int32_t resample_none(src_context_t *src, int32_t *num_frames_in)
+{
+	int32_t num_frames_out = MINIMUM(*num_frames_in, src->out_buffer_frames);
+	int32_t samples = num_frames_out * src->new_channel_num;
+	const int16_t *input = src->in_buffer;
+	uint8_t *output = (uint8_t *)src->out_buffer;
+	int32_t i;
+
+	for (i = 0; i < samples; i++) {
+		put_sample(src, &output, input[i]);
+	}
+
+	*num_frames_in = num_frames_out;
+	return num_frames_out;
+}
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+/**
+ * NEON kernels: 8 taps per step, vld2 de-interleaves stereo samples.
+ */
+static void polyphase_kernel_mono(const int16_t *input, const int16_t *coeff, int32_t *out)
+{
+	int32x4_t acc = vdupq_n_s32(0);
+	int32_t i;
+	for (i = 0; i < POLYPHASE_TAPS; i += 8) {
+		int16x8_t x = vld1q_s16(input + i);
+		int16x8_t c = vld1q_s16(coeff + i);
+		acc = vmlal_s16(acc, vget_low_s16(x), vget_low_s16(c));
+		acc = vmlal_s16(acc, vget_high_s16(x), vget_high_s16(c));
+	}
+	int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+	out[0] = vget_lane_s32(vpadd_s32(sum, sum), 0);
+}
+
+static void polyphase_kernel_stereo(const int16_t *input, const int16_t *coeff, int32_t *out)
+{
+	int32x4_t acc_l = vdupq_n_s32(0);
+	int32x4_t acc_r = vdupq_n_s32(0);
+	int32_t i;
+	for (i = 0; i < POLYPHASE_TAPS; i += 8) {
+		int16x8x2_t x = vld2q_s16(input + i * 2);
+		int16x8_t c = vld1q_s16(coeff + i);
+		acc_l = vmlal_s16(acc_l, vget_low_s16(x.val[0]), vget_low_s16(c));
+		acc_l = vmlal_s16(acc_l, vget_high_s16(x.val[0]), vget_high_s16(c));
+		acc_r = vmlal_s16(acc_r, vget_low_s16(x.val[1]), vget_low_s16(c));
+		acc_r = vmlal_s16(acc_r, vget_high_s16(x.val[1]), vget_high_s16(c));
+	}
+	int32x2_t sum_l = vadd_s32(vget_low_s32(acc_l), vget_high_s32(acc_l));
+	int32x2_t sum_r = vadd_s32(vget_low_s32(acc_r), vget_high_s32(acc_r));
+	int32x2_t sum = vpadd_s32(sum_l, sum_r);
+	out[0] = vget_lane_s32(sum, 0);
+	out[1] = vget_lane_s32(sum, 1);
+}
+#elif defined(__ARM_FEATURE_DSP)
+/**
+ * Cortex-M DSP extension kernels: SMLAD does two 16x16 MACs at once,
+ * PKHBT/PKHTB gather two samples of the same channel from stereo frames.
+ */
+static inline uint32_t load_pair(const int16_t *p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline int32_t smlad(uint32_t x, uint32_t y, int32_t acc)
+{
+	__asm__("smlad %0, %1, %2, %3" : "=r"(acc) : "r"(x), "r"(y), "r"(acc));
+	return acc;
+}
+
+static inline uint32_t pkhbt(uint32_t x, uint32_t y)
+{
+	uint32_t r;
+	__asm__("pkhbt %0, %1, %2, lsl #16" : "=r"(r) : "r"(x), "r"(y));
+	return r;
+}
+
+static inline uint32_t pkhtb(uint32_t x, uint32_t y)
+{
+	uint32_t r;
+	__asm__("pkhtb %0, %1, %2, asr #16" : "=r"(r) : "r"(x), "r"(y));
+	return r;
+}
+
+static void polyphase_kernel_mono(const int16_t *input, const int16_t *coeff, int32_t *out)
+{
+	int32_t acc = 0;
+	int32_t i;
+	for (i = 0; i < POLYPHASE_TAPS; i += 4) {
+		acc = smlad(load_pair(input + i), load_pair(coeff + i), acc);
+		acc = smlad(load_pair(input + i + 2), load_pair(coeff + i + 2), acc);
+	}
+	out[0] = acc;
+}
+
+static void polyphase_kernel_stereo(const int16_t *input, const int16_t *coeff, int32_t *out)
+{
+	int32_t acc_l = 0;
+	int32_t acc_r = 0;
+	int32_t i;
+	for (i = 0; i < POLYPHASE_TAPS; i += 2) {
+		// f0 = [R0:L0], f1 = [R1:L1]
+		uint32_t f0 = load_pair(input + i * 2);
+		uint32_t f1 = load_pair(input + i * 2 + 2);
+		uint32_t c = load_pair(coeff + i);
+		acc_l = smlad(pkhbt(f0, f1), c, acc_l);
+		acc_r = smlad(pkhtb(f1, f0), c, acc_r);
+	}
+	out[0] = acc_l;
+	out[1] = acc_r;
+}
+#else
+/**
+ * @brief   Multiply-accumulate one polyphase branch for one channel.
+ * @remarks Portable version of the kernel, input samples have a stride of 'channels_num'.
+ * @param   input: pointer to the first input sample of the branch window.
+ * @param   coeff: pointer to Q15 coefficients of the branch.
+ * @param   channels_num: num of channels of input samples.
+ * @return  accumulated value in Q15.
+ */
+static int32_t polyphase_dot(const int16_t *input, const int16_t *coeff, int32_t channels_num)
+{
+	int32_t sum = 0;
+	int32_t i;
+	for (i = 0; i < POLYPHASE_TAPS; ++i) {
+		sum += input[i * channels_num] * coeff[i];
+	}
+	return sum;
+}
+
+static void polyphase_kernel_mono(const int16_t *input, const int16_t *coeff, int32_t *out)
+{
+	out[0] = polyphase_dot(input, coeff, 1);
+}
+
+static void polyphase_kernel_stereo(const int16_t *input, const int16_t *coeff, int32_t *out)
+{
+	out[0] = polyphase_dot(input, coeff, 2);
+	out[1] = polyphase_dot(input + 1, coeff, 2);
+}
+#endif
+
+/**
+ * It handles all conversion ratios with polyphase FIR filtering, which does
+ * interpolation and anti-aliasing at once. Each output frame takes POLYPHASE_TAPS
+ * input frames, starting at the current input position, with filter branch 'poly_phase'.
+ */
+static int32_t resample_polyphase(src_context_t *src, int32_t *num_frames_in)
+{
+	const int16_t *input = src->in_buffer;
+	uint8_t *output = (uint8_t *)src->out_buffer;
+	int32_t channels_num = src->new_channel_num;
+	int32_t up = src->poly_up;
+	int32_t down = src->poly_down;
+	int32_t phase = src->poly_phase;
+	int32_t pos = 0;
+	int32_t num_frames_out = 0;
+	int32_t acc[SRC_MAX_CH];
+	int32_t j;
+
+	while ((pos < *num_frames_in) && (num_frames_out < src->out_buffer_frames)) {
+		const int16_t *coeff = src->poly_coeff + phase * POLYPHASE_TAPS;
+		if (channels_num == 1) {
+			polyphase_kernel_mono(input + pos, coeff, acc);
+		} else {
+			polyphase_kernel_stereo(input + pos * 2, coeff, acc);
+		}
+		for (j = 0; j < channels_num; j++) {
+			put_sample(src, &output, (acc[j] + (1 << 14)) >> 15);
+		}
+		num_frames_out++;
+
+		// Advance down/up input frames
+		phase += down;
+		pos += phase / up;
+		phase %= up;
+	}
+
+	*num_frames_in = pos;
+	src->poly_phase = phase;
+	return num_frames_out;
+}
+
+/**
+ * @brief   Zeroth order modified Bessel function of the first kind, for Kaiser window.
+ */
+static float bessel_i0(float x)
+{
+	float sum = 1.0f;
+	float term = 1.0f;
+	float half = x / 2.0f;
+	int k;
+	for (k = 1; k < 32; k++) {
+		term *= (half / k) * (half / k);
+		sum += term;
+		if (term < sum * 1e-9f) {
+			break;
+		}
+	}
+	return sum;
+}
+
+static int gcd(int a, int b)
+{
+	while (b != 0) {
+		int t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+/**
+ * @brief   Build polyphase filter table for the conversion ratio of src.
+ * @remarks Prototype filter is a Kaiser windowed sinc with POLYPHASE_TAPS * up taps,
+ *          branch 'p' takes taps p + (POLYPHASE_TAPS - 1 - k) * up, k in [0, POLYPHASE_TAPS).
+ *          Each branch is normalized to unity DC gain, then quantized to Q15.
+ * @param   src: pointer to resampler object.
+ * @return  0 on success, negative value means failure.
+ */
+static int init_polyphase(src_context_t *src)
+{
+	int divisor = gcd(src->old_sample_rate, src->new_sample_rate);
+	int up = src->new_sample_rate / divisor;
+	int down = src->old_sample_rate / divisor;
+	RETURN_VAL_IF_FAIL((up <= POLYPHASE_MAX_PHASES), SRC_ERR_NOT_SUPPORT);
+
+	src->poly_coeff = (int16_t *)malloc(up * POLYPHASE_TAPS * sizeof(int16_t));
+	RETURN_VAL_IF_FAIL((src->poly_coeff != NULL), SRC_ERR_MALLOC_FAILED);
+
+	// Cutoff frequency normalized to the up-sampled rate (old_sample_rate * up)
+	int low_rate = MINIMUM(src->old_sample_rate, src->new_sample_rate);
+	float cutoff = POLYPHASE_ROLLOFF * 0.5f * (float)low_rate / ((float)src->old_sample_rate * (float)up);
+	int length = up * POLYPHASE_TAPS;
+	float center = (float)(length - 1) / 2.0f;
+	float i0_beta = bessel_i0(POLYPHASE_KAISER_BETA);
+	float taps[POLYPHASE_TAPS];
+	int p, k;
+
+	for (p = 0; p < up; p++) {
+		float sum = 0.0f;
+		for (k = 0; k < POLYPHASE_TAPS; k++) {
+			int n = p + (POLYPHASE_TAPS - 1 - k) * up;
+			float t = (float)n - center;
+			float x = 2.0f * cutoff * t;
+			float sinc = (fabsf(x) < FLOAT_ACCURACY) ? 1.0f : sinf((float)M_PI * x) / ((float)M_PI * x);
+			float r = t / (center + 1.0f);
+			float window = bessel_i0(POLYPHASE_KAISER_BETA * sqrtf(MAXIMUM(0.0f, 1.0f - r * r))) / i0_beta;
+			taps[k] = sinc * window;
+			sum += taps[k];
+		}
+		for (k = 0; k < POLYPHASE_TAPS; k++) {
+			long q = LRINTPF(taps[k] / sum * (float)POLYPHASE_Q15_ONE + 32768.0f) - 32768;
+			src->poly_coeff[p * POLYPHASE_TAPS + k] = clip((int32_t)q);
+		}
+	}
+
+	src->poly_up = up;
+	src->poly_down = down;
+	src->poly_phase = 0;
+	return SRC_ERR_NO_ERROR;
+}
+
 /**
  * @brief   Do filtering once new frames added to internal buffer.
  * @param   src: pointer to resampler object.
@@ -258,7 +649,7 @@ static void convolution_filtering(src_context_t *src, int32_t num_frames_add)
 			input = src->in_buffer;
 			samples = (num_frames_add - src->overlap_frames) * src->new_channel_num;
 		} else {
-			input = src->in_buffer + src->left_frames - num_frames_add - src->overlap_frames;
+			input = src->in_buffer + (src->left_frames - num_frames_add - src->overlap_frames) * src->new_channel_num;
 			samples = num_frames_add * src->new_channel_num;
 		}
 
@@ -269,6 +660,35 @@ static void convolution_filtering(src_context_t *src, int32_t num_frames_add)
 	}
 }
 
+/**
+ * @brief   Move remaining frames to the head of internal buffer.
+ * @param   src: pointer to resampler object.
+ */
+static void shift_buffer(src_context_t *src)
+{
+	if ((src->used_frames > 0) && (src->left_frames > 0)) {
+		memmove((void *)src->in_buffer, \
+			(const void *)((int8_t *)src->in_buffer + BUF_FRAMES_TO_BYTES(src, src->used_frames)), \
+			BUF_FRAMES_TO_BYTES(src, src->left_frames));
+	}
+	src->used_frames = 0;
+}
+
+/**
+ * @brief   Calculate how many input frames needed to fill up the given output frames.
+ * @param   src: pointer to resampler object.
+ * @param   out_frames: number of output frames.
+ * @return  number of input frames, rounded up.
+ */
+static int input_frames_need(src_context_t *src, int out_frames)
+{
+	float frames = (float)out_frames / src->ratio;
+	if (frames - (int)frames > 0) {
+		frames = (int)frames + 1;
+	}
+	return (int)frames;
+}
+
 /**
  * @brief   Check validation of the given src_data.
  * @param   src: pointer to resampler object.
@@ -289,10 +709,9 @@ static int check_src_data(src_context_t *src, src_data_t *src_data)
 		RETURN_VAL_IF_FAIL(((src_data->origin_channel_num >= 1) && (src_data->origin_channel_num <= 6)), SRC_ERR_BAD_CHANNEL_COUNT);
 		// Check supported output channel: 1-Mono/2-Stereo
 		RETURN_VAL_IF_FAIL(((src_data->desired_channel_num == 1) || (src_data->desired_channel_num == 2)), SRC_ERR_BAD_CHANNEL_COUNT);
-		// Check supported sample width: SAMPLE_WIDTH_16BITS
-		RETURN_VAL_IF_FAIL((src_data->origin_sample_width == SAMPLE_WIDTH_16BITS), SRC_ERR_NOT_SUPPORT);
-		// Check supported format conversion: Not support!
-		RETURN_VAL_IF_FAIL((src_data->origin_sample_width == src_data->desired_sample_width), SRC_ERR_NOT_SUPPORT);
+		// Check supported sample width: SAMPLE_WIDTH_8BITS/16BITS/24BITS/32BITS
+		RETURN_VAL_IF_FAIL(IS_VALID_SAMPLE_WIDTH(src_data->origin_sample_width), SRC_ERR_NOT_SUPPORT);
+		RETURN_VAL_IF_FAIL(IS_VALID_SAMPLE_WIDTH(src_data->desired_sample_width), SRC_ERR_NOT_SUPPORT);
 	} else {
 		// Old/New sample rate, sample width and channel number must stay the same.
 		RETURN_VAL_IF_FAIL((src->old_sample_rate == src_data->origin_sample_rate), SRC_ERR_NOT_SUPPORT);
@@ -325,7 +744,8 @@ static int init_src_context(src_context_t *src, src_data_t *src_data)
 	src->new_sample_width = src_data->desired_sample_width;
 	src->old_sample_rate = src_data->origin_sample_rate;
 	src->new_sample_rate = src_data->desired_sample_rate;
-	src->in_buffer_frames = src->in_buffer_bytes / OLD_FRAMES_TO_BYTES(src, 1);
+	// Internal buffer keeps 16bits samples, and input frames are remixed in place
+	src->in_buffer_frames = src->in_buffer_bytes / ((int)sizeof(int16_t) * MAXIMUM(src->old_channel_num, src->new_channel_num));
 	src->left_frames = 0;
 	src->used_frames = 0;
 	src->fp_frac = 0;
@@ -334,6 +754,22 @@ static int init_src_context(src_context_t *src, src_data_t *src_data)
 	src->ratio = (float)src->new_sample_rate / (float)src->old_sample_rate;
 	src->inverse_ratio = (float)src->old_sample_rate / (float)src->new_sample_rate;
 
+	// Same sample rate, only src_process() goes here
+	if (src->old_sample_rate == src->new_sample_rate) {
+		src->filter_coeff = NULL;
+		src->overlap_frames = 0;
+		src->src_func = resample_none;
+		return SRC_ERR_NO_ERROR;
+	}
+
+	// Polyphase converter handles any ratio with the filter table, if it's not too large.
+	if ((src->converter == SRC_CONVERTER_POLYPHASE) && (init_polyphase(src) == SRC_ERR_NO_ERROR)) {
+		src->filter_coeff = NULL;
+		src->overlap_frames = POLYPHASE_TAPS - 1;
+		src->src_func = resample_polyphase;
+		return SRC_ERR_NO_ERROR;
+	}
+
 	// Set overlap frame number and converting function as per converting ratio
 	if (src->old_sample_rate > src->new_sample_rate) {
 		// down resampling
@@ -369,6 +805,13 @@ static int init_src_context(src_context_t *src, src_data_t *src_data)
  ****************************************************************************/
 src_handle_t src_init(int size)
 {
+	return src_init_ext(size, SRC_CONVERTER_LINEAR);
+}
+
+src_handle_t src_init_ext(int size, int converter)
+{
+	RETURN_VAL_IF_FAIL(((converter == SRC_CONVERTER_LINEAR) || (converter == SRC_CONVERTER_POLYPHASE)), NULL);
+
 	src_context_t *src = (src_context_t *)malloc(sizeof(src_context_t));
 	RETURN_VAL_IF_FAIL((src != NULL), NULL);
 
@@ -378,6 +821,9 @@ src_handle_t src_init(int size)
 	src->in_buffer_bytes = (((size + max_frame_size - 1) / max_frame_size) * max_frame_size);
 	src->in_buffer_frames = 0;
 	src->in_buffer = NULL;
+	src->converter = converter;
+	src->poly_coeff = NULL;
+	src->gain = SRC_GAIN_UNITY;
 	// Other members will be initilized before first use,
 	// as soon as in_buffer allocated in init_src_context().
 
@@ -392,6 +838,9 @@ int src_destroy(src_handle_t handle)
 	free(src->in_buffer);
 	src->in_buffer = NULL;
 
+	free(src->poly_coeff);
+	src->poly_coeff = NULL;
+
 	free(src);
 	return SRC_ERR_NO_ERROR;
 }
@@ -414,6 +863,9 @@ int src_simple(src_handle_t handle, src_data_t *src_data)
 	// Check validation of src_data
 	int ret = check_src_data(src, src_data);
 	RETURN_VAL_IF_FAIL((ret == SRC_ERR_NO_ERROR), ret);
+	// Format converting is supported in src_process() only
+	RETURN_VAL_IF_FAIL((src_data->origin_sample_width == SAMPLE_WIDTH_16BITS), SRC_ERR_NOT_SUPPORT);
+	RETURN_VAL_IF_FAIL((src_data->origin_sample_width == src_data->desired_sample_width), SRC_ERR_NOT_SUPPORT);
 
 	// Calculate output buffer capability
 	int bps = BYTES_PER_SAMPLE(src_data->origin_sample_width);
@@ -441,41 +893,95 @@ int src_simple(src_handle_t handle, src_data_t *src_data)
 	}
 
 	// Update output buffer to src context (used in converting proccess functions)
-	src->out_buffer = (int16_t *)src_data->data_out;
+	src->out_buffer = src_data->data_out;
+	src->out_buffer_frames = out_buffer_frames;
 
 	// Move remaining frames in internal buffer
-	if ((src->used_frames > 0) && (src->left_frames > 0)) {
-		memcpy((void *)src->in_buffer, \
-			(const void *)((int8_t *)src->in_buffer + NEW_FRAMES_TO_BYTES(src, src->used_frames)), \
-			NEW_FRAMES_TO_BYTES(src, src->left_frames));
-		src->used_frames = 0;
-	}
+	shift_buffer(src);
 
 	// Accept input frames as much as possible, append (rechannel/copy) input frames to internal buffer
 	int input_frames_used = MINIMUM(src_data->input_frames, (src->in_buffer_frames - src->left_frames));
 	frames = rechannel(ch2layout(src->old_channel_num), ch2layout(src->new_channel_num), \
 					(const int16_t *)src_data->data_in, input_frames_used, \
-					(int16_t *)((int8_t *)src->in_buffer + NEW_FRAMES_TO_BYTES(src, src->left_frames)), input_frames_used);
+					(int16_t *)((int8_t *)src->in_buffer + BUF_FRAMES_TO_BYTES(src, src->left_frames)), input_frames_used);
 	RETURN_VAL_IF_FAIL((frames == input_frames_used), SRC_ERR_UNKNOWN);
 	src->left_frames += input_frames_used;
 
 	// Filtering on new appended frames
 	convolution_filtering(src, input_frames_used);
 
-	// Calculate how many input frames needed if fill up out buffer
-	float input_frames_need = (float)out_buffer_frames / src->ratio;
-	if (input_frames_need - (int)input_frames_need > 0) {
-		input_frames_need = (int)input_frames_need + 1;
-	}
-
 	int output_frames_gen = 0;
 	// Reserve overlap frames, then do converting process with available frames
-	frames = MINIMUM(src->left_frames - src->overlap_frames, (int)input_frames_need);
+	frames = MINIMUM(src->left_frames - src->overlap_frames, input_frames_need(src, out_buffer_frames));
 	if (frames > 0) {
 		output_frames_gen = src->src_func(src, &frames);
-		if (output_frames_gen != 0) {
-			src->used_frames = frames;
-			src->left_frames -= frames;
+		// Frames may be used even if no frame generated, e.g. down scaling with a few frames.
+		src->used_frames = frames;
+		src->left_frames -= frames;
+	}
+
+	src_data->input_frames_used = input_frames_used;
+	src_data->output_frames_gen = output_frames_gen;
+	return SRC_ERR_NO_ERROR;
+}
+
+int src_process(src_handle_t handle, src_data_t *src_data)
+{
+	// Convert and check src_handle
+	src_context_t *src = (src_context_t *)handle;
+	RETURN_VAL_IF_FAIL((src != NULL), SRC_ERR_BAD_PARAMS);
+
+	// Check validation of src_data
+	int ret = check_src_data(src, src_data);
+	RETURN_VAL_IF_FAIL((ret == SRC_ERR_NO_ERROR), ret);
+
+	// Initialize src context before first use
+	if (!CHECK_SRC_CONTEXT_INIT(src)) {
+		ret = init_src_context(src, src_data);
+		RETURN_VAL_IF_FAIL((ret == SRC_ERR_NO_ERROR), ret);
+		RETURN_VAL_IF_FAIL((src->src_func != NULL), SRC_ERR_UNKNOWN);
+		RETURN_VAL_IF_FAIL((src->in_buffer_frames > src->overlap_frames), SRC_ERR_BAD_PARAMS);
+	}
+
+	// Calculate output buffer capability
+	int out_buffer_frames = src_data->out_buf_length / NEW_FRAMES_TO_BYTES(src, 1);
+	RETURN_VAL_IF_FAIL((out_buffer_frames > 0), SRC_ERR_BAD_PARAMS);
+
+	const int8_t *input = (const int8_t *)src_data->data_in;
+	int8_t *output = (int8_t *)src_data->data_out;
+	int input_frames_used = 0;
+	int output_frames_gen = 0;
+
+	// Internal buffer works as a sliding window: each input sample is remixed and
+	// format converted into it once, then filtered straight into the output buffer.
+	while (output_frames_gen < out_buffer_frames) {
+		shift_buffer(src);
+
+		int frames = MINIMUM(src_data->input_frames - input_frames_used, src->in_buffer_frames - src->left_frames);
+		if (frames > 0) {
+			ret = get_frames(src, input + OLD_FRAMES_TO_BYTES(src, input_frames_used), frames, \
+							src->in_buffer + src->left_frames * src->new_channel_num);
+			RETURN_VAL_IF_FAIL((ret == frames), SRC_ERR_UNKNOWN);
+			src->left_frames += frames;
+			input_frames_used += frames;
+			convolution_filtering(src, frames);
+		}
+
+		int avail = MINIMUM(src->left_frames - src->overlap_frames, \
+							input_frames_need(src, out_buffer_frames - output_frames_gen));
+		int generated = 0;
+		if (avail > 0) {
+			src->out_buffer = (void *)(output + NEW_FRAMES_TO_BYTES(src, output_frames_gen));
+			src->out_buffer_frames = out_buffer_frames - output_frames_gen;
+			generated = src->src_func(src, &avail);
+			src->used_frames = avail;
+			src->left_frames -= avail;
+			output_frames_gen += generated;
+		}
+
+		// Stop if no more input can be taken and no more output can be generated
+		if ((frames <= 0) && (generated == 0)) {
+			break;
 		}
 	}
 
@@ -483,3 +989,13 @@ int src_simple(src_handle_t handle, src_data_t *src_data)
 	src_data->output_frames_gen = output_frames_gen;
 	return SRC_ERR_NO_ERROR;
 }
+
+int src_set_gain(src_handle_t handle, int gain)
+{
+	src_context_t *src = (src_context_t *)handle;
+	RETURN_VAL_IF_FAIL((src != NULL), SRC_ERR_BAD_PARAMS);
+	RETURN_VAL_IF_FAIL(((gain >= 0) && (gain <= SRC_GAIN_UNITY)), SRC_ERR_BAD_PARAMS);
+
+	src->gain = gain;
+	return SRC_ERR_NO_ERROR;
+}
@@ -64,9 +64,25 @@ enum {
 	SAMPLE_WIDTH_16BITS = 16,
 	SAMPLE_WIDTH_24BITS = 24,
 	SAMPLE_WIDTH_32BITS = 32,
+	SAMPLE_WIDTH_24BITS_IN_32BITS = SAMPLE_WIDTH_32BITS + 1,	// 24bits sample in low 3 bytes of 32bits, sign-extended
 	SAMPLE_WIDTH_MAX = SAMPLE_WIDTH_32BITS,
 };
 
+/**
+ * @enum  Define sample rate converter types, selected in src_init_ext().
+ * @brief SRC_CONVERTER_LINEAR needs least memory, SRC_CONVERTER_POLYPHASE gives
+ *        much better quality with a precomputed int16 coefficient table.
+ */
+enum {
+	SRC_CONVERTER_LINEAR = 0,   // linear interpolation (with simple FIR pre-filter for downsampling)
+	SRC_CONVERTER_POLYPHASE,    // polyphase FIR, falls back to linear if the ratio needs too many phases
+};
+
+/**
+ * @brief Q15 gain value which keeps samples unchanged, see src_set_gain().
+ */
+#define SRC_GAIN_UNITY (1 << 15)
+
 /**
  * @typedef src_handle_t, SRC(Sample Rate Convertor) hanlde type declaration.
  * @brief   NULL means invalid handle.
@@ -84,14 +100,14 @@ struct src_data_s {
 	const void *data_in;        // pointer to input sample frames buffer (user buffer)
 	int input_frames;           // number of input frames
 	int origin_sample_rate;     // original sample rate
-	int origin_sample_width;    // original sample width (bits per sample), only support SAMPLE_WIDTH_16BITS now.
+	int origin_sample_width;    // original sample width (bits per sample), src_simple() supports SAMPLE_WIDTH_16BITS only.
 	int origin_channel_num;     // original channel number (1-mono/2-stereo/3-surround/4-quad/5-5.0/6-5.1)
 	void *data_out;             // pointer to output sample buffer (user buffer)
 	int out_buf_length;         // length of data_out buffer (bytes)
 
 	/* input params - specify desired output */
 	int desired_sample_rate;    // target sample rate
-	int desired_sample_width;   // target sample width (bits per sample), only support SAMPLE_WIDTH_16BITS now.
+	int desired_sample_width;   // target sample width (bits per sample), src_simple() supports SAMPLE_WIDTH_16BITS only.
 	int desired_channel_num;    // target channel number (1-mono/2-stereo)
 
 	/* output */
@@ -116,6 +132,31 @@ typedef struct src_data_s src_data_t;
  */
 int src_simple(src_handle_t handle, src_data_t *data);
 
+/**
+ * @brief   PCM converting function, does channel remixing, sample rate converting,
+ *          gain and format converting in one pass.
+ * @remarks Unlike src_simple(), input frames are consumed as much as possible in one call,
+ *          internal buffer is only a sliding window over input, so its size given to
+ *          src_init() can be small, e.g. a few hundred frames.
+ *          Sample width 8/16/24(packed)/32 bits are supported for input and output,
+ *          samples are processed in 16bits internally.
+ *          Do not mix calls of src_simple() and src_process() with the same handle.
+ * @param   handle: pointer to a SRC instance, returned by src_init().
+ * @param   data: pointer to object of struture src_data_t, see detail description above.
+ * @return  0 on success, otherwise, it means failure.
+ * @see     src_data_t, src_set_gain()
+ */
+int src_process(src_handle_t handle, src_data_t *data);
+
+/**
+ * @brief   Set gain applied to output samples in src_process().
+ * @param   handle: pointer to a SRC instance, returned by src_init().
+ * @param   gain: Q15 gain in range [0, SRC_GAIN_UNITY], SRC_GAIN_UNITY by default.
+ * @return  0 on success, otherwise, it means failure.
+ * @see     src_process()
+ */
+int src_set_gain(src_handle_t handle, int gain);
+
 /**
  * @brief   SRC (Sample Rate Convertor) initialize.
  * @remarks Internal buffer will be allocated in src_simple().
@@ -126,6 +167,17 @@ int src_simple(src_handle_t handle, src_data_t *data);
  */
 src_handle_t src_init(int size);
 
+/**
+ * @brief   SRC (Sample Rate Convertor) initialize with the given converter type.
+ * @remarks Same as src_init(), besides the converter type can be chosen.
+ *          Polyphase filter table is allocated in src_simple() as per conversion ratio.
+ * @param   size: buffer size in bytes, see src_init().
+ * @param   converter: SRC_CONVERTER_LINEAR or SRC_CONVERTER_POLYPHASE.
+ * @return  SRC handle, if NULL, it means failure.
+ * @see     src_init(), src_destroy()
+ */
+src_handle_t src_init_ext(int size, int converter);
+
 /**
  * @brief   Release buffers allocated by SRC in src_init().
  * @remarks This function must be called in pairs with src_init(), to avoid mem leak.
@@ -965,16 +965,35 @@ bool audio_decoder_check_audio_type(int audio_type)
 	}
 }
 
+static pthread_mutex_t s_pushdata_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 size_t audio_decoder_pushdata(audio_decoder_p decoder, const void *data, size_t len)
 {
 	assert(decoder != NULL);
 	assert(data != NULL);
 
-	static pthread_mutex_t s_mutex = PTHREAD_MUTEX_INITIALIZER;
-
-	pthread_mutex_lock(&s_mutex);
+	pthread_mutex_lock(&s_pushdata_mutex);
 	len = rbs_write(data, 1, len, decoder->rbsp);
-	pthread_mutex_unlock(&s_mutex);
+	pthread_mutex_unlock(&s_pushdata_mutex);
+
+	return len;
+}
+
+size_t audio_decoder_reservedata(audio_decoder_p decoder, void **data, size_t len)
+{
+	assert(decoder != NULL);
+	assert(data != NULL);
+
+	return rbs_reserve(data, len, decoder->rbsp);
+}
+
+size_t audio_decoder_commitdata(audio_decoder_p decoder, size_t len)
+{
+	assert(decoder != NULL);
+
+	pthread_mutex_lock(&s_pushdata_mutex);
+	len = rbs_commit(len, decoder->rbsp);
+	pthread_mutex_unlock(&s_pushdata_mutex);
 
 	return len;
 }
@@ -90,6 +90,27 @@ int audio_decoder_finish(audio_decoder_p decoder);
  */
 size_t audio_decoder_pushdata(audio_decoder_p decoder, const void *data, size_t len);
 
+/**
+ * @brief  get a contiguous free span in internal ring-buffer of decoder, so that user
+ *         can read audio source data into it directly instead of pushing a copy.
+ *         Data is accepted by decoder after audio_decoder_commitdata() called.
+ *
+ * @param  decoder : Pointer to decoder object
+ * @param  data: Output, pointer to the free span.
+ * @param  len: maximum size in bytes wanted.
+ * @return size in bytes of the free span, range[0, len].
+ */
+size_t audio_decoder_reservedata(audio_decoder_p decoder, void **data, size_t len);
+
+/**
+ * @brief  commit audio source data written into the span from audio_decoder_reservedata().
+ *
+ * @param  decoder : Pointer to decoder object
+ * @param  len: size in bytes of audio source data written into the span.
+ * @return size in bytes of data actually accepted by decoder.
+ */
+size_t audio_decoder_commitdata(audio_decoder_p decoder, size_t len);
+
 /**
  * @brief  get free data space in decoder, which means the maximum of data to push.
  *
@@ -16,21 +16,30 @@
  *
  ******************************************************************/
 
+#include <string.h>
 #include <debug.h>
 #include "Mpeg2TsTypes.h"
 #include "PESParser.h"
-#include "PESPacket.h"
 
 #define PES_PACKET_HEAD_BYTES               (6) // packet_start_code_prefix + stream_id + packet length fields
 #define PES_STREAM_HEAD_BYTES               (3) // stream info + 7 flags + PES head data length fields
+#define PES_HEAD_BYTES                      (PES_PACKET_HEAD_BYTES + PES_STREAM_HEAD_BYTES)
 #define PACKET_START_CODE_PREFIX(buffer)    ((buffer[0] << 16) | (buffer[1] << 8) | buffer[2])
 #define STREAM_ID(buffer)                   (buffer[3])
 #define PACKET_LENGTH(buffer)               ((buffer[4] << 8) | buffer[5])
+#define CONTINUITY_COUNTER_MOD              (16)   // Continuity counter's module value
+#define INVALID_CC                          (0xFF) // Continuity counter take 4 bits, 0xFF is invalid
 
 PESParser::PESParser()
-	: mPacketStartCodePrefix(0)
+	: mState(STATE_IDLE)
+	, mContinuityCounter(INVALID_CC)
+	, mHeadLen(0)
+	, mSkipLen(0)
+	, mRemainLen(0)
+	, mPacketStartCodePrefix(0)
 	, mStreamId(0)
 	, mPacketLength(0)
+	, mPESHeaderDataLength(0)
 {
 }
 
@@ -38,37 +47,124 @@ PESParser::~PESParser()
 {
 }
 
-bool PESParser::parse(std::shared_ptr<PESPacket> pPESPacket)
+bool PESParser::parse(bool unitStart, uint8_t continuityCounter, uint8_t *pData, uint8_t size, uint8_t **ppESData, uint8_t *pESDataLen)
 {
-	if (!pPESPacket) {
-		meddbg("pPESPacket is null!\n");
-		reset();
+	uint8_t pos = 0;
+	uint8_t len;
+
+	if (mContinuityCounter != INVALID_CC) {
+		if (continuityCounter == mContinuityCounter) {
+			// duplicate packet, ignore it
+			medvdbg("duplicate packet, continuity counter 0x%x\n", continuityCounter);
+			return false;
+		}
+
+		if (continuityCounter != ((mContinuityCounter + 1) % CONTINUITY_COUNTER_MOD)) {
+			meddbg("continuity counter(0x%x) do not match, current 0x%x\n", continuityCounter, mContinuityCounter);
+			// packets lost, drop data until next PES packet start
+			mState = STATE_IDLE;
+		}
+	}
+	mContinuityCounter = continuityCounter;
+
+	if (unitStart) {
+		if (mState == STATE_PAYLOAD && mPacketLength != 0) {
+			meddbg("Drop incomplete PES packet!\n");
+		}
+		// new PES packet start
+		mState = STATE_HEAD;
+		mHeadLen = 0;
+	}
+
+	if (mState == STATE_HEAD) {
+		len = PES_HEAD_BYTES - mHeadLen;
+		if (len > size - pos) {
+			len = size - pos;
+		}
+		memcpy(&mHead[mHeadLen], &pData[pos], len);
+		mHeadLen += len;
+		pos += len;
+
+		if (mHeadLen < PES_HEAD_BYTES) {
+			// head is split, wait for next packet
+			return false;
+		}
+
+		if (!parseHead(mHead)) {
+			mState = STATE_IDLE;
+			return false;
+		}
+		mState = STATE_SKIP;
+	}
+
+	if (mState == STATE_SKIP) {
+		len = mSkipLen;
+		if (len > size - pos) {
+			len = size - pos;
+		}
+		mSkipLen -= len;
+		pos += len;
+
+		if (mSkipLen != 0) {
+			return false;
+		}
+		mState = STATE_PAYLOAD;
+	}
+
+	if (mState != STATE_PAYLOAD) {
 		return false;
 	}
 
-	mPESPacket = pPESPacket;
+	len = size - pos;
+	if (mPacketLength != 0) {
+		if (len > mRemainLen) {
+			len = mRemainLen;
+		}
+		mRemainLen -= len;
+		if (mRemainLen == 0) {
+			// all ES data in this PES packet have been parsed
+			mState = STATE_IDLE;
+		}
+	}
+
+	if (len == 0) {
+		return false;
+	}
+
+	*ppESData = &pData[pos];
+	*pESDataLen = len;
+	return true;
+}
 
-	uint8_t *pData = mPESPacket->getDataPtr();
+bool PESParser::parseHead(uint8_t *pData)
+{
 	mPacketStartCodePrefix = PACKET_START_CODE_PREFIX(pData);
 	mStreamId = STREAM_ID(pData);
 	mPacketLength = PACKET_LENGTH(pData);
 
-	if (mPacketStartCodePrefix != PES_PACKET_START_CODE_PREFIX){
+	if (mPacketStartCodePrefix != PES_PACKET_START_CODE_PREFIX) {
 		meddbg("Invalid PES packet, not match PES_PACKET_START_CODE_PREFIX!\n");
-		reset();
 		return false;
 	}
 
-	if ((size_t)PES_PACKET_HEAD_BYTES + mPacketLength > mPESPacket->getDataLen()) {
-		meddbg("Packet length overflow!\n");
-		reset();
+	if (!parseStream(&pData[PES_PACKET_HEAD_BYTES])) {
 		return false;
 	}
 
-	return parseStream(&pData[PES_PACKET_HEAD_BYTES], mPacketLength);
+	mSkipLen = mPESHeaderDataLength;
+	if (mPacketLength != 0) {
+		// PES packet length 0 is allowed for unbounded stream, ES data end at next PES packet start.
+		if (mPacketLength < PES_STREAM_HEAD_BYTES + mPESHeaderDataLength) {
+			meddbg("Invalid PES packet length %u!\n", mPacketLength);
+			return false;
+		}
+		mRemainLen = mPacketLength - PES_STREAM_HEAD_BYTES - mPESHeaderDataLength;
+	}
+
+	return true;
 }
 
-bool PESParser::parseStream(uint8_t *pData, uint32_t size)
+bool PESParser::parseStream(uint8_t *pData)
 {
 	if (mStreamId >= 0xc0 && mStreamId <= 0xdf) {
 		// stream id = 110xxxxx means audio streams
@@ -90,34 +186,17 @@ bool PESParser::parseStream(uint8_t *pData, uint32_t size)
 	}
 
 	meddbg("stream_id: 0x%x is not supported!\n", mStreamId);
-	reset();
 	return false;
 }
 
-uint8_t *PESParser::getESData(void)
-{
-	if (!mPESPacket) {
-		// no PES packet, it's normal case.
-		return nullptr;
-	}
-
-	return mPESPacket->getDataPtr() + PES_PACKET_HEAD_BYTES + PES_STREAM_HEAD_BYTES + mPESHeaderDataLength;
-}
-
-uint16_t PESParser::getESDataLen(void)
-{
-	if (!mPESPacket) {
-		meddbg("There's no valid PES packet!\n");
-		return 0;
-	}
-
-	return mPacketLength - PES_STREAM_HEAD_BYTES - mPESHeaderDataLength;
-}
-
 void PESParser::reset(void)
 {
-	medvdbg("reset PES packet!\n");
-	mPESPacket = nullptr;
+	medvdbg("reset PES parser!\n");
+	mState = STATE_IDLE;
+	mContinuityCounter = INVALID_CC;
+	mHeadLen = 0;
+	mSkipLen = 0;
+	mRemainLen = 0;
 	mPacketStartCodePrefix = 0;
 	mStreamId = 0;
 	mPacketLength = 0;
@@ -19,10 +19,10 @@
 #ifndef __PES_PARSER_H
 #define __PES_PARSER_H
 
-#include <memory>
 #include "Mpeg2TsTypes.h"
 
-class PESPacket;
+// PES parser works on the TS packet payloads of a PES stream one by one,
+// it never assembles a whole PES packet, ES data are located in place.
 class PESParser
 {
 public:
@@ -32,27 +32,45 @@ public:
 
 	PESParser();
 	virtual ~PESParser();
-	// parse PES packet, and the parser will add reference to the packet.
-	bool parse(std::shared_ptr<PESPacket> pPESPacket);
-	// get ES data in PES
-	uint8_t *getESData(void);
-	// get ES data length
-	uint16_t getESDataLen(void);
-	// reset PES parser, to remove reference of the PES packet
+	// parse a TS packet payload of the PES stream
+	// unitStart, payload unit start indicator of the TS packet
+	// continuityCounter, continuity counter of the TS packet
+	// ppESData and pESDataLen, output ES data location in the given payload
+	// return true if there's ES data in the payload, otherwise return false.
+	bool parse(bool unitStart, uint8_t continuityCounter, uint8_t *pData, uint8_t size, uint8_t **ppESData, uint8_t *pESDataLen);
+	// reset PES parser, drop the PES packet in parsing
 	void reset(void);
 
 protected:
+	// parse PES packet head and the stream head
+	bool parseHead(uint8_t *pData);
 	// parse stream data in PES
-	bool parseStream(uint8_t *pData, uint32_t size);
+	bool parseStream(uint8_t *pData);
 
 private:
-	// PES packet reference
-	std::shared_ptr<PESPacket> mPESPacket;
+	enum parse_state_e : uint8_t {
+		STATE_IDLE,     // waiting for the start of a PES packet
+		STATE_HEAD,     // collecting packet head and stream head
+		STATE_SKIP,     // skipping optional fields of PES head
+		STATE_PAYLOAD,  // ES data in PES
+	};
+
+	// parsing state
+	uint8_t mState;
+	// continuity counter of the last TS packet
+	uint8_t mContinuityCounter;
+	// head data collected, they may be split in TS packets
+	uint8_t mHead[9];
+	uint8_t mHeadLen;
+	// optional fields length to skip
+	uint8_t mSkipLen;
+	// ES data length remained in current PES packet
+	uint16_t mRemainLen;
 	// packet start code prefix
 	uint32_t mPacketStartCodePrefix;
 	// stream id
 	uint8_t mStreamId;
-	// PES packet length
+	// PES packet length, 0 means the length is not specified
 	uint16_t mPacketLength;
 	/// for audio streams
 	//{ optional PES header
@@ -27,7 +27,6 @@
 #include "PATParser.h"
 #include "ParseManager.h"
 #include "PMTElementary.h"
-#include "PESPacket.h"
 #include "PESParser.h"
 #include "TSDemuxer.h"
 
@@ -45,7 +44,10 @@ namespace media {
 TSDemuxer::TSDemuxer()
 	: Demuxer(AUDIO_TYPE_MP2T)
 	, mPESPid(INVALID_PID)
-	, mPESDataUsed(0)
+	, mESData(nullptr)
+	, mESDataLen(0)
+	, mSyncLocked(false)
+	, mPrepareOffset(0)
 {
 }
 
@@ -110,13 +112,14 @@ size_t TSDemuxer::getAvailSpace(void)
 	return mBufferWriter->sizeOfSpace();
 }
 
-ssize_t TSDemuxer::pushData(uint8_t *buf, size_t size)
+size_t TSDemuxer::reserveData(uint8_t **buf, size_t size)
 {
-	size_t written = 0;
-	if (mBufferWriter) {
-		written += mBufferWriter->write(buf, size);
-	}
-	return (ssize_t)written;
+	return mBufferWriter->reserve(buf, size, false);
+}
+
+size_t TSDemuxer::commitData(size_t size)
+{
+	return mBufferWriter->commit(size);
 }
 
 ssize_t TSDemuxer::pullData(uint8_t *buf, size_t size, void *param)
@@ -144,49 +147,36 @@ ssize_t TSDemuxer::pullData(uint8_t *buf, size_t size, void *param)
 	size_t fill = 0;
 	size_t need;
 	while (fill < size) {
-		need = size - fill;
-		if (mPESParser->getESData() != nullptr) {
-			// get remaining payload in last PES packet
-			if (need > mPESParser->getESDataLen() - mPESDataUsed) {
-				need = mPESParser->getESDataLen() - mPESDataUsed;
+		if (mESDataLen > 0) {
+			// get remaining ES data in the TS packet
+			need = size - fill;
+			if (need > mESDataLen) {
+				need = mESDataLen;
 			}
 
-			memcpy(&buf[fill], mPESParser->getESData() + mPESDataUsed, need);
-			mPESDataUsed += need;
+			memcpy(&buf[fill], mESData, need);
+			mESData += need;
+			mESDataLen -= need;
 			fill += need;
 			medvdbg("Got ES data %u(%u)/%u\n", fill, need, size);
 
-			if (mPESDataUsed == mPESParser->getESDataLen()) {
-				// all ES data in PES parser have been read.
-				medvdbg("All ES data (%u) in PES parser have been read!\n", mPESParser->getESDataLen());
-				mPESParser->reset();
-				mPESDataUsed = 0;
+			if (mESDataLen == 0) {
+				// all ES data in the TS packet have been read, release it.
+				mBufferReader->consume(TSPacket::PACKET_SIZE);
 			}
 			continue;
-		} else {
-			medvdbg("Need to get new PES packet!\n");
 		}
 
-		// get new PES packet
-		std::shared_ptr<PESPacket> pPESPacket = nullptr;
-		ret = getPESPacket(pPESPacket);
+		ret = getESData();
 		if (ret == DEMUXER_ERROR_WANT_DATA) {
-			medvdbg("Push more data to get PES packet\n");
+			medvdbg("Push more data to get ES data\n");
 			break;
 		}
 
 		if (ret != DEMUXER_ERROR_NONE) {
-			meddbg("Get PES packet failed! error: %d\n", ret);
+			meddbg("Get ES data failed! error: %d\n", ret);
 			break;
 		}
-
-		// parse PES packet
-		if (mPESParser->parse(pPESPacket)) {
-			mPESDataUsed = 0;
-		} else {
-			meddbg("PES parse failed!\n");
-			continue;
-		}
 	} // end while
 
 	if (fill == 0) {
@@ -333,49 +323,6 @@ std::shared_ptr<Section> TSDemuxer::PSIUnpack(std::shared_ptr<TSPacket> pTSPacke
 	return pSection;
 }
 
-std::shared_ptr<PESPacket> TSDemuxer::PESUnpack(std::shared_ptr<TSPacket> pTSPacket)
-{
-	std::shared_ptr<PESPacket> pPESPacket = nullptr;
-	uint8_t  lenPayload = 0;
-	uint8_t *ptrPayload = pTSPacket->getPayloadData(&lenPayload);
-
-	if (!ptrPayload) {
-		// no payload
-		return pPESPacket;
-	}
-
-	if (pTSPacket->payloadUnitStartIndicator()) {
-		// new PES packet start
-		medvdbg("new PES packet (PID:%u) start...\n", pTSPacket->getPid());
-		auto newPacket = PESPacket::create(pTSPacket->getPid(), pTSPacket->continuityCounter(), ptrPayload, lenPayload);
-		if (newPacket->isCompleted()) {
-			medvdbg("PES packet (PID:%u) complete\n", pTSPacket->getPid());
-			pPESPacket = newPacket;
-		} else {
-			auto it = mPidPESPacketMap.find(pTSPacket->getPid());
-			if (it != mPidPESPacketMap.end()) {
-				// incomplete PES packet with same PID exist, remove it!
-				mPidPESPacketMap.erase(it);
-			}
-			mPidPESPacketMap.insert(std::pair<uint16_t, std::shared_ptr<PESPacket>>(pTSPacket->getPid(), newPacket));
-		}
-	} else {
-		// PES packet appending
-		auto it = mPidPESPacketMap.find(pTSPacket->getPid());
-		if (it != mPidPESPacketMap.end()) {
-			auto prePacket = it->second;
-			prePacket->appendData(pTSPacket->getPid(), pTSPacket->continuityCounter(), ptrPayload, lenPayload);
-			if (prePacket->isCompleted()) {
-				medvdbg("PES packet (PID:%u) complete\n", pTSPacket->getPid());
-				pPESPacket = prePacket;
-				mPidPESPacketMap.erase(it);
-			}
-		}
-	}
-
-	return pPESPacket;
-}
-
 bool TSDemuxer::isPsiPid(uint16_t pid)
 {
 	switch (pid) {
@@ -431,19 +378,56 @@ int TSDemuxer::loadTSPacket(std::shared_ptr<TSPacket> pTSPacket, bool sync, size
 	return DEMUXER_ERROR_NONE;
 }
 
+int TSDemuxer::peekTSPacket(std::shared_ptr<TSPacket> pTSPacket)
+{
+	uint8_t buffLen; // TSPacket::PACKET_SIZE
+	uint8_t *pData;
+	int syncOffset;
+
+	while (mBufferReader->sizeOfData() >= TSPacket::PACKET_SIZE) {
+		if (mBufferReader->peek(&pData, TSPacket::PACKET_SIZE, false) < TSPacket::PACKET_SIZE) {
+			// packet wraps around the end of stream buffer, copy it out.
+			pData = pTSPacket->getPacketBuffer(&buffLen);
+			mBufferReader->copy(pData, buffLen);
+		}
+
+		// once sync locked, it's enough to check sync byte of each packet
+		if (mSyncLocked && pTSPacket->parse(pData)) {
+			return DEMUXER_ERROR_NONE;
+		}
+
+		mSyncLocked = false;
+		syncOffset = resync(pData, 0);
+		if (syncOffset < 0) {
+			// sync failed, negative value means error code.
+			return syncOffset;
+		}
+
+		// drop data before sync byte, and then parse packet again
+		mBufferReader->consume((size_t)syncOffset);
+		mSyncLocked = true;
+	}
+
+	return DEMUXER_ERROR_WANT_DATA;
+}
+
 // return demuxer_error_e
-int TSDemuxer::getPESPacket(std::shared_ptr<PESPacket> &pPESPacket)
+int TSDemuxer::getESData(void)
 {
 	int ret;
+	uint8_t lenPayload;
+	uint8_t *ptrPayload;
 
-	while ((ret = loadTSPacket(mTSPacket)) == DEMUXER_ERROR_NONE) {
+	while ((ret = peekTSPacket(mTSPacket)) == DEMUXER_ERROR_NONE) {
 		if (isPESPid(mTSPacket->getPid())) {
-			pPESPacket = PESUnpack(mTSPacket);
-			if (pPESPacket) {
-				medvdbg("got new PES packet\n");
+			ptrPayload = mTSPacket->getPayloadData(&lenPayload);
+			if (ptrPayload && mPESParser->parse(mTSPacket->payloadUnitStartIndicator(), mTSPacket->continuityCounter(), ptrPayload, lenPayload, &mESData, &mESDataLen)) {
+				// ES data are read from the packet in stream buffer directly
 				return DEMUXER_ERROR_NONE;
 			}
 		}
+		// drop packets of other PIDs, PSI tables have been parsed in prepare()
+		mBufferReader->consume(TSPacket::PACKET_SIZE);
 	}
 
 	return ret;
@@ -459,7 +443,6 @@ bool TSDemuxer::isReady(void)
 int TSDemuxer::prepare(void)
 {
 	ssize_t ret;
-	size_t readOffset = 0;
 
 	medvdbg("called!\n");
 
@@ -468,8 +451,9 @@ int TSDemuxer::prepare(void)
 		return DEMUXER_ERROR_NONE;
 	}
 
+	// Preparse goes on from the last packet parsed, data before it are never parsed again.
 	// Load 1st ts packet with force sync
-	ret = loadTSPacket(mTSPacket, true, &readOffset);
+	ret = loadTSPacket(mTSPacket, (mPrepareOffset == 0), &mPrepareOffset);
 	while (ret == DEMUXER_ERROR_NONE) {
 		if (isPsiPid(mTSPacket->getPid())) {
 			// packet of PSI table section
@@ -485,7 +469,12 @@ int TSDemuxer::prepare(void)
 				}
 			}
 		}
-		ret = loadTSPacket(mTSPacket, false, &readOffset);
+		ret = loadTSPacket(mTSPacket, false, &mPrepareOffset);
+	}
+
+	if (ret == DEMUXER_ERROR_WANT_DATA) {
+		medvdbg("want more data, parsed %u bytes\n", mPrepareOffset);
+		return ret;
 	}
 
 	// return error code
@@ -33,7 +33,6 @@ class ParserManager;
 class Section;
 class TSPacket;
 class PESParser;
-class PESPacket;
 
 namespace media {
 namespace stream {
@@ -56,8 +55,10 @@ public:
 	virtual bool initialize(void) override;
 	// space size available for push
 	virtual size_t getAvailSpace(void) override;
-	// push TS data into demux buffer
-	virtual ssize_t pushData(uint8_t *buf, size_t size) override;
+	// reserve span in demux buffer to put TS data in place
+	virtual size_t reserveData(uint8_t **buf, size_t size) override;
+	// commit TS data put in the reserved span
+	virtual size_t commitData(size_t size) override;
 	// pull audio elementary stream data of the given program number
 	// param, pointer to program nubmer of uint16, nullptr means first program as default
 	virtual ssize_t pullData(uint8_t *buf, size_t size, void *param = nullptr) override;
@@ -77,10 +78,15 @@ private:
 	bool isPsiPid(uint16_t pid);
 	// check if the given PID is PES packet's PID we need
 	bool isPESPid(uint16_t pid);
-	// extract a PES packet from the input transport stream
+	// locate ES data in the next TS packet of the PES stream
+	// the TS packet is kept in stream buffer until all ES data are read
 	// on success, return 0
 	// on failure, return negative value (see demuxer_error_e)
-	int getPESPacket(std::shared_ptr<PESPacket> &pPESPacket);
+	int getESData(void);
+	// parse the TS packet at the head of stream buffer in place, without copying
+	// on success, return 0
+	// on failure, return negative value (see demuxer_error_e)
+	int peekTSPacket(std::shared_ptr<TSPacket> pTSPacket);
 	// load a valid TS packet from the input data stream
 	// sync, request to do force resync
 	// offset, if not null, just copy data from stream buffer
@@ -90,16 +96,12 @@ private:
 	int loadTSPacket(std::shared_ptr<TSPacket> pTSPacket, bool sync = false, size_t *offset = nullptr);
 	// Unpack a TS packet and return a section if get a completed one
 	std::shared_ptr<Section> PSIUnpack(std::shared_ptr<TSPacket> pTSPacket);
-	// Unpack a TS packet and return a PES packet if get a completed one
-	std::shared_ptr<PESPacket> PESUnpack(std::shared_ptr<TSPacket> pTSPacket);
 	// resync TS packet by TSPacket::SYNC_BYTE
 	int resync(uint8_t *pPacketData, size_t offset);
 
 private:
 	// <pid, section_ptr> pairs in map to take incomplete sections
 	std::map<uint16_t, std::shared_ptr<Section>> mPidSectionMap;
-	// <pid, pespacket_ptr> pairs in map to take incomplete PES packets
-	std::map<uint16_t, std::shared_ptr<PESPacket>> mPidPESPacketMap;
 	// PSI table pasers manager
 	std::shared_ptr<ParserManager> mParserManager;
 	// stream buffer to held inputing TS stream data
@@ -113,7 +115,13 @@ private:
 	// TS packet
 	std::shared_ptr<TSPacket> mTSPacket;
 	uint16_t mPESPid;
-	size_t mPESDataUsed;
+	// ES data remained in the TS packet at the head of stream buffer
+	uint8_t *mESData;
+	uint8_t mESDataLen;
+	// sync state of the TS packet at the head of stream buffer
+	bool mSyncLocked;
+	// offset in stream buffer of the next TS packet to preparse
+	size_t mPrepareOffset;
 };
 
 } // namespace media
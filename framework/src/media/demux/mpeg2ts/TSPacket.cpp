@@ -102,7 +102,8 @@ bool TSPacket::AdaptationField::parse(const uint8_t *pData)
 }
 
 TSPacket::TSPacket()
-	: mSyncByte(0)
+	: mPacket(mData)
+	, mSyncByte(0)
 	, mTransportErrorIndicator(0)
 	, mPayloadUnitStartIndicator(0)
 	, mTransportPriority(0)
@@ -119,8 +120,12 @@ TSPacket::~TSPacket()
 
 bool TSPacket::parse(void)
 {
-	const uint8_t *pData = mData;
+	return parse(mData);
+}
 
+bool TSPacket::parse(uint8_t *pData)
+{
+	mPacket = pData;
 	mSyncByte = pData[0];
 	if (mSyncByte != SYNC_BYTE) {
 		return false;
@@ -153,7 +158,7 @@ uint8_t *TSPacket::getPacketBuffer(uint8_t *packetBuffLen)
 uint8_t *TSPacket::getPayloadData(uint8_t *payloadDataLen)
 {
 	uint8_t lenPayload = PACKET_SIZE - HEAD_BYTES;
-	uint8_t *ptrPayload = mData + HEAD_BYTES;
+	uint8_t *ptrPayload = mPacket + HEAD_BYTES;
 
 	if (mSyncByte != SYNC_BYTE) {
 		meddbg("Invalid packet\n");
@@ -178,7 +183,7 @@ uint8_t *TSPacket::getPayloadData(uint8_t *payloadDataLen)
 	if (adaptationFieldControl() == CONTROL_ADAPTATION_PLAYLOAD) {
 		// 0~182 bytes adaption field + playload
 		lenPayload = PACKET_SIZE - HEAD_BYTES - (LENGTH_BYTES + adaptationField().adaptationFieldLength());
-		ptrPayload = mData + (PACKET_SIZE - lenPayload);
+		ptrPayload = mPacket + (PACKET_SIZE - lenPayload);
 	}
 
 	if (payloadDataLen) {
@@ -69,6 +69,9 @@ public:
 	// parse transport packet stored in packet data buffer
 	// get packet buffer and put data in the buffer firstly
 	bool parse(void);
+	// parse transport packet in place, e.g. in the demux stream buffer
+	// the data must stay valid until the packet is not used any more
+	bool parse(uint8_t *pData);
 
 	// getters
 	ts_pid_t getPid(void) { return mPid; }
@@ -79,6 +82,8 @@ public:
 	AdaptationField &adaptationField(void) { return mAdaptationField; }
 	// get pointer to the packet data buffer (188 bytes)
 	uint8_t *getPacketBuffer(uint8_t *packetBuffLen);
+	// get pointer to the packet data parsed
+	uint8_t *getPacketData(void) { return mPacket; }
 	// get pointer to the payload data start address
 	// return nullptr if there's no payload
 	uint8_t *getPayloadData(uint8_t *payloadDataLen);
@@ -87,6 +92,8 @@ public:
 private:
 	// packet data array
 	uint8_t mData[PACKET_SIZE];
+	// packet data parsed, points to mData or the data given in parse()
+	uint8_t *mPacket;
 	// sync byte
 	uint8_t mSyncByte;
 	// transport error indicator
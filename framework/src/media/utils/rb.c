@@ -24,8 +24,11 @@
 #include "rb.h"
 #include "internal_defs.h"
 
-#define IS_EMPTY(rbp) (rbp->rd_idx == rbp->wr_idx)
-#define IS_FULL(rbp) ((rbp->rd_idx & IDX_MASK) == (rbp->wr_idx & IDX_MASK) && (rbp->rd_idx & MSB_MASK) != (rbp->wr_idx & MSB_MASK))
+/* Indexes are loaded with acquire and stored with release semantics, so that
+ * one writer and one reader may use the ring-buffer without any lock.
+ */
+#define LOAD_IDX(idx) __atomic_load_n(&(idx), __ATOMIC_ACQUIRE)
+#define STORE_IDX(idx, val) __atomic_store_n(&(idx), (val), __ATOMIC_RELEASE)
 
 /**
  * @brief  Increase the buffer index while writing or reading the ring-buffer.
@@ -64,12 +67,16 @@ size_t rb_used(rb_p rbp)
 {
 	RETURN_VAL_IF_FAIL(rbp != NULL, SIZE_ZERO);
 
-	if (IS_EMPTY(rbp)) {
+	// Take a snapshot of both indexes, the other side may update its own one meanwhile.
+	size_t wr_raw = LOAD_IDX(rbp->wr_idx);
+	size_t rd_raw = LOAD_IDX(rbp->rd_idx);
+
+	if (wr_raw == rd_raw) {
 		return SIZE_ZERO;
 	}
 
-	size_t wr_idx = (rbp->wr_idx & IDX_MASK);
-	size_t rd_idx = (rbp->rd_idx & IDX_MASK);
+	size_t wr_idx = (wr_raw & IDX_MASK);
+	size_t rd_idx = (rd_raw & IDX_MASK);
 
 	if (wr_idx > rd_idx) {
 		return (wr_idx - rd_idx);
@@ -155,12 +162,62 @@ size_t rb_read_ext(rb_p rbp, void *ptr, size_t len, size_t offset)
 	return len;
 }
 
+size_t rb_reserve(rb_p rbp, void **ptr, size_t len)
+{
+	RETURN_VAL_IF_FAIL(rbp != NULL, SIZE_ZERO);
+	RETURN_VAL_IF_FAIL(ptr != NULL, SIZE_ZERO);
+
+	size_t avail = rb_avail(rbp);
+	size_t wr_idx = (rbp->wr_idx & IDX_MASK);
+
+	// Free space is contiguous up to the end of buffer at most.
+	len = MINIMUM(len, avail);
+	len = MINIMUM(len, rbp->depth - wr_idx);
+
+	*ptr = (void *)((uint8_t *)rbp->buf + wr_idx);
+	return len;
+}
+
+size_t rb_commit(rb_p rbp, size_t len)
+{
+	RETURN_VAL_IF_FAIL(rbp != NULL, SIZE_ZERO);
+
+	size_t wr_idx = (rbp->wr_idx & IDX_MASK);
+	len = MINIMUM(len, rb_avail(rbp));
+	len = MINIMUM(len, rbp->depth - wr_idx);
+
+	_incr(rbp, &rbp->wr_idx, len);
+	return len;
+}
+
+size_t rb_peek(rb_p rbp, void **ptr, size_t len)
+{
+	RETURN_VAL_IF_FAIL(rbp != NULL, SIZE_ZERO);
+	RETURN_VAL_IF_FAIL(ptr != NULL, SIZE_ZERO);
+
+	size_t used = rb_used(rbp);
+	size_t rd_idx = (rbp->rd_idx & IDX_MASK);
+
+	// Data is contiguous up to the end of buffer at most.
+	len = MINIMUM(len, used);
+	len = MINIMUM(len, rbp->depth - rd_idx);
+
+	*ptr = (void *)((uint8_t *)rbp->buf + rd_idx);
+	return len;
+}
+
+size_t rb_consume(rb_p rbp, size_t len)
+{
+	// Same as reading without output
+	return rb_read(rbp, NULL, len);
+}
+
 bool rb_reset(rb_p rbp)
 {
 	RETURN_VAL_IF_FAIL(rbp != NULL, false);
 
-	rbp->rd_idx = 0;
-	rbp->wr_idx = 0;
+	STORE_IDX(rbp->rd_idx, 0);
+	STORE_IDX(rbp->wr_idx, 0);
 
 	return true;
 }
@@ -176,5 +233,6 @@ static void _incr(rb_p rbp, volatile size_t *p_idx, size_t len)
 		idx -= rbp->depth;
 	}
 
-	*p_idx = msb | idx;
+	// Publish the new index after the data copy has completed.
+	STORE_IDX(*p_idx, msb | idx);
 }
@@ -30,7 +30,10 @@ extern "C" {
 #define IDX_MASK (SIZE_MAX>>1)
 #define MSB_MASK (~IDX_MASK)    /* also the maximum value of the buffer depth */
 
-/* ring buffer structure */
+/* ring buffer structure
+ * Writing only updates wr_idx and reading only updates rd_idx, so one writer
+ * and one reader may access the ring-buffer concurrently without a lock.
+ */
 struct rb_s {
 	void *buf;                  /* pointer to the buffer allocated   */
 	size_t depth;               /* maximum size of the ring buffer   */
@@ -102,6 +105,43 @@ size_t rb_read(rb_p rbp, void *ptr, size_t len);
  */
 size_t rb_read_ext(rb_p rbp, void *ptr, size_t len, size_t offset);
 
+/**
+ * @brief  Get a contiguous free span at the ring-buffer tail to write into directly.
+ *         Data written to the span becomes visible only after rb_commit().
+ * @param  rbp: Pointer to the ring-buffer object
+ * @param  ptr: Output, pointer to the start of the free span
+ * @param  len: maximum length of the span wanted
+ * @return size of the span, range[0, len]. It may be shorter than the free
+ *         space when the free space wraps around the end of the buffer.
+ */
+size_t rb_reserve(rb_p rbp, void **ptr, size_t len);
+
+/**
+ * @brief  Commit data written into the span returned by rb_reserve().
+ * @param  rbp: Pointer to the ring-buffer object
+ * @param  len: length of the data written, should not exceed the reserved size
+ * @return size of data committed, range[0, len]
+ */
+size_t rb_commit(rb_p rbp, size_t len);
+
+/**
+ * @brief  Get a contiguous span of data at the ring-buffer head to read in place.
+ * @param  rbp: Pointer to the ring-buffer object
+ * @param  ptr: Output, pointer to the start of the data span
+ * @param  len: maximum length of the span wanted
+ * @return size of the span, range[0, len]. It may be shorter than the data
+ *         in the buffer when the data wraps around the end of the buffer.
+ */
+size_t rb_peek(rb_p rbp, void **ptr, size_t len);
+
+/**
+ * @brief  Drop data read in place by rb_peek() from the ring-buffer head.
+ * @param  rbp: Pointer to the ring-buffer object
+ * @param  len: length of the data consumed
+ * @return size of data consumed, range[0, len]
+ */
+size_t rb_consume(rb_p rbp, size_t len);
+
 /**
  * @brief  Reset ring-buffer, data in ring-buffer will be dropped.
  * @param  rbp: Pointer to the ring-buffer object
@@ -112,6 +112,28 @@ size_t rbs_write(const void *ptr, size_t size, size_t nmemb, rbstream_p rbsp)
 	return wlen;
 }
 
+size_t rbs_reserve(void **ptr, size_t len, rbstream_p rbsp)
+{
+	medvdbg("[%s] len %lu\n", __FUNCTION__, len);
+	RETURN_VAL_IF_FAIL(ptr != NULL, SIZE_ZERO);
+	RETURN_VAL_IF_FAIL(rbsp != NULL, SIZE_ZERO);
+
+	return rb_reserve(rbsp->rbp, ptr, len);
+}
+
+size_t rbs_commit(size_t len, rbstream_p rbsp)
+{
+	medvdbg("[%s] len %lu\n", __FUNCTION__, len);
+	RETURN_VAL_IF_FAIL(rbsp != NULL, SIZE_ZERO);
+
+	size_t wlen = rb_commit(rbsp->rbp, len);
+	// increase wr_size
+	rbsp->wr_size += wlen;
+
+	medvdbg("[%s] done, wlen %lu\n", __FUNCTION__, wlen);
+	return wlen;
+}
+
 int rbs_seek(rbstream_p rbsp, ssize_t offset, int whence)
 {
 	medvdbg("[%s] offset %ld, whence %d\n", __FUNCTION__, offset, whence);
@@ -117,6 +117,26 @@ size_t rbs_read(void *ptr, size_t size, size_t nmemb, rbstream_p stream);
  */
 size_t rbs_write(const void *ptr, size_t size, size_t nmemb, rbstream_p stream);
 
+/**
+ * @brief  Gets a contiguous free span at the ring-buffer end, so that data can
+ *         be written into it directly. Call rbs_commit() after writing.
+ *
+ * @param  ptr : Output, pointer to the start of the free span
+ * @param  len : Maximum size in bytes of the span wanted
+ * @param  stream : Pointer to the ring-buffer stream
+ * @return the size in bytes of the span, range[0, len].
+ */
+size_t rbs_reserve(void **ptr, size_t len, rbstream_p stream);
+
+/**
+ * @brief  Appends data written into the span returned by rbs_reserve().
+ *
+ * @param  len : Size in bytes of data written into the span
+ * @param  stream : Pointer to the ring-buffer stream
+ * @return the number of bytes committed.
+ */
+size_t rbs_commit(size_t len, rbstream_p stream);
+
 /**
  * @brief  Sets the current read position indicator (cur_pos) for the stream.
  *
@@ -0,0 +1,685 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <debug.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <messaging/messaging.h>
+#include "messaging_internal.h"
+
+#define MSG_RECV_NOT_INIT (-1)
+
+/* Receivers which keep their port open through a channel are also saved
+ * under the port name with this suffix, so that senders know they can keep
+ * the port of such a receiver open between sends.
+ */
+
+#define MSG_CHANNEL_MARK "#ch"
+
+/* Shared buffers keep their reference count in front of the payload */
+
+#define MSG_BUF_HEADER(buf) ((msg_buf_header_t *)((char *)(buf) - sizeof(msg_buf_header_t)))
+
+/* A channel keeps open, until it is closed, the port of a receiver which
+ * receives through a channel, the reply port of the thread which sends
+ * sync messages through it and the port of the thread which receives
+ * through it.
+ */
+
+struct msg_channel_s {
+	char port_name[MAX_PORT_NAME_SIZE];
+	char mark_name[MAX_PORT_NAME_SIZE];
+	pid_t recv_pid;
+	mqd_t mqdes;
+	char *packet;
+	int packet_size;
+	pid_t reply_pid;
+	mqd_t reply_mqdes;
+	char *reply_packet;
+	int reply_size;
+	pid_t listen_pid;
+	mqd_t listen_mqdes;
+	char *listen_packet;
+	int listen_size;
+};
+
+struct msg_buf_header_s {
+	int refs;
+	int size;
+};
+typedef struct msg_buf_header_s msg_buf_header_t;
+
+/****************************************************************************
+ * private functions
+ ****************************************************************************/
+/****************************************************************************
+ * Name : messaging_channel_marked
+ *
+ * Description:
+ *  Tell if a receiver keeps its port open through a channel.  Receivers
+ *  of messaging_recv_block unlink their port after each message, so their
+ *  port must be opened again for each send.
+ ****************************************************************************/
+static bool messaging_channel_marked(msg_channel_t *channel, pid_t recv_pid)
+{
+	int recv_arr[CONFIG_MESSAGING_RECV_LIST_SIZE];
+	int recv_cnt;
+	int read_status;
+	bool marked = false;
+	int arr_idx;
+
+	do {
+		read_status = READ_MSG_RECEIVER(channel->mark_name, recv_arr, recv_cnt);
+		if (read_status == ERROR) {
+			return false;
+		}
+
+		for (arr_idx = 0; arr_idx < CONFIG_MESSAGING_RECV_LIST_SIZE && arr_idx < recv_cnt; arr_idx++) {
+			if (recv_arr[arr_idx] == recv_pid) {
+				marked = true;
+			}
+		}
+	} while (read_status != MSG_READ_ALL);
+
+	return marked;
+}
+
+/****************************************************************************
+ * Name : messaging_channel_connect
+ *
+ * Description:
+ *  Open the port of the receiver of a channel.  The receiver is looked up
+ *  on every send as it may come and go, and its port is kept open only
+ *  if the receiver keeps it too.
+ ****************************************************************************/
+static int messaging_channel_connect(msg_channel_t *channel)
+{
+	int recv_arr[CONFIG_MESSAGING_RECV_LIST_SIZE];
+	int recv_cnt;
+	int read_status;
+	char *private_portname;
+	bool marked;
+	int arr_idx;
+
+	for (arr_idx = 0; arr_idx < CONFIG_MESSAGING_RECV_LIST_SIZE; arr_idx++) {
+		recv_arr[arr_idx] = MSG_RECV_NOT_INIT;
+	}
+
+	do {
+		read_status = READ_MSG_RECEIVER(channel->port_name, recv_arr, recv_cnt);
+		if (read_status == ERROR) {
+			msgdbg("[Messaging] channel send fail : no receiver.\n");
+			return ERROR;
+		}
+	} while (read_status != MSG_READ_ALL);
+
+	if (recv_cnt != 1 || recv_arr[0] == MSG_RECV_NOT_INIT) {
+		msgdbg("[Messaging] channel send fail : %d receivers are waiting.\n", recv_cnt);
+		return ERROR;
+	}
+
+	marked = messaging_channel_marked(channel, recv_arr[0]);
+	if (marked && channel->recv_pid == recv_arr[0]) {
+		return OK;
+	}
+
+	if (channel->recv_pid != MSG_RECV_NOT_INIT) {
+		mq_close(channel->mqdes);
+		channel->recv_pid = MSG_RECV_NOT_INIT;
+	}
+
+	MSG_ASPRINTF(&private_portname, "%s%d", channel->port_name, recv_arr[0]);
+	if (private_portname == NULL) {
+		msgdbg("[Messaging] channel send fail : out of memory for private portname.\n");
+		return ERROR;
+	}
+
+	channel->mqdes = mq_open(private_portname, O_WRONLY);
+	MSG_FREE(private_portname);
+	if (channel->mqdes == (mqd_t)ERROR) {
+		msgdbg("[Messaging] channel send fail : open fail, errno %d.\n", errno);
+		return ERROR;
+	}
+
+	/* An unmarked port is closed after the send */
+	if (marked) {
+		channel->recv_pid = recv_arr[0];
+	}
+
+	return OK;
+}
+
+static int messaging_channel_send_packet(msg_channel_t *channel, msg_send_type_t msg_type, const char *msg, int msglen, int priority)
+{
+	messaging_packet_t *header;
+	char *packet;
+	int send_size;
+	int ret;
+
+	ret = messaging_channel_connect(channel);
+	if (ret != OK) {
+		return ERROR;
+	}
+
+	/* The packet buffer is kept and only grows */
+	send_size = MSG_HEADER_SIZE + msglen;
+	if (send_size > channel->packet_size) {
+		packet = (char *)MSG_REALLOC(channel->packet, send_size);
+		if (packet == NULL) {
+			msgdbg("[Messaging] channel send fail : out of memory for including header.\n");
+			return ERROR;
+		}
+		channel->packet = packet;
+		channel->packet_size = send_size;
+	}
+
+	header = (messaging_packet_t *)channel->packet;
+	header->version = messaging_get_version();
+	header->offset = MSG_HEADER_SIZE;
+	header->sender_pid = getpid();
+	header->msg_type = (msg_type == MSG_SEND_SYNC) ? MSG_REPLY_REQUIRED : MSG_REPLY_NO_REQUIRED;
+	memcpy(channel->packet + MSG_HEADER_SIZE, msg, msglen);
+
+	ret = mq_send(channel->mqdes, channel->packet, send_size, priority);
+	if (ret != OK) {
+		/* Open the port again on the next send */
+		msgdbg("[Messaging] channel send fail : errno %d.\n", errno);
+		mq_close(channel->mqdes);
+		channel->recv_pid = MSG_RECV_NOT_INIT;
+		return ERROR;
+	}
+
+	if (channel->recv_pid == MSG_RECV_NOT_INIT) {
+		mq_close(channel->mqdes);
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name : messaging_channel_reply_close
+ *
+ * Description:
+ *  Close and unlink the reply port of a channel.
+ ****************************************************************************/
+static void messaging_channel_reply_close(msg_channel_t *channel)
+{
+	char *reply_portname;
+
+	if (channel->reply_pid == MSG_RECV_NOT_INIT) {
+		return;
+	}
+
+	mq_close(channel->reply_mqdes);
+	MSG_ASPRINTF(&reply_portname, "%s%d%s", channel->port_name, channel->reply_pid, "_r");
+	if (reply_portname != NULL) {
+		mq_unlink(reply_portname);
+		MSG_FREE(reply_portname);
+	}
+
+	MSG_FREE(channel->reply_packet);
+	channel->reply_packet = NULL;
+	channel->reply_size = 0;
+	channel->reply_pid = MSG_RECV_NOT_INIT;
+}
+
+/****************************************************************************
+ * Name : messaging_channel_reply_open
+ *
+ * Description:
+ *  Open the reply port of a channel on its first sync send, or again if a
+ *  larger reply is expected.  The receiver replies to "port_name + pid + _r"
+ *  of the sender, so the port is only kept for the thread which opened it.
+ ****************************************************************************/
+static int messaging_channel_reply_open(msg_channel_t *channel, int reply_size)
+{
+	struct mq_attr attr;
+	char *reply_portname;
+	pid_t my_pid = getpid();
+
+	if (channel->reply_pid == my_pid && channel->reply_size >= reply_size) {
+		return OK;
+	}
+
+	if (channel->reply_pid != MSG_RECV_NOT_INIT && channel->reply_pid != my_pid) {
+		msgdbg("[Messaging] channel send sync fail : reply port belongs to %d.\n", channel->reply_pid);
+		return ERROR;
+	}
+
+	messaging_channel_reply_close(channel);
+
+	MSG_ASPRINTF(&reply_portname, "%s%d%s", channel->port_name, my_pid, "_r");
+	if (reply_portname == NULL) {
+		msgdbg("[Messaging] channel send sync fail : out of memory for reply portname.\n");
+		return ERROR;
+	}
+
+	attr.mq_maxmsg = CONFIG_MESSAGING_MAXMSG;
+	attr.mq_msgsize = reply_size;
+	attr.mq_flags = 0;
+	channel->reply_mqdes = mq_open(reply_portname, O_RDONLY | O_CREAT, 0666, &attr);
+	if (channel->reply_mqdes == (mqd_t)ERROR) {
+		msgdbg("[Messaging] channel send sync fail : reply open fail, errno %d.\n", errno);
+		MSG_FREE(reply_portname);
+		return ERROR;
+	}
+	channel->reply_pid = my_pid;
+
+	/* The queue may have been there already with larger messages */
+	if (mq_getattr(channel->reply_mqdes, &attr) == OK && attr.mq_msgsize > reply_size) {
+		reply_size = attr.mq_msgsize;
+	}
+
+	channel->reply_packet = (char *)MSG_ALLOC(reply_size);
+	if (channel->reply_packet == NULL) {
+		msgdbg("[Messaging] channel send sync fail : out of memory for reply.\n");
+		MSG_FREE(reply_portname);
+		messaging_channel_reply_close(channel);
+		return ERROR;
+	}
+	channel->reply_size = reply_size;
+
+	MSG_FREE(reply_portname);
+	return OK;
+}
+
+/****************************************************************************
+ * Name : messaging_channel_reply_flush
+ *
+ * Description:
+ *  Drop the replies left in the reply port of a channel, for example one
+ *  which came after its sender stopped waiting.
+ ****************************************************************************/
+static void messaging_channel_reply_flush(msg_channel_t *channel)
+{
+	struct mq_attr attr;
+
+	if (mq_getattr(channel->reply_mqdes, &attr) != OK || attr.mq_curmsgs == 0) {
+		return;
+	}
+
+	attr.mq_flags = O_NONBLOCK;
+	mq_setattr(channel->reply_mqdes, &attr, NULL);
+	while (mq_receive(channel->reply_mqdes, channel->reply_packet, channel->reply_size, 0) >= 0) {
+		msgdbg("[Messaging] channel : drop a stale reply.\n");
+	}
+	attr.mq_flags = 0;
+	mq_setattr(channel->reply_mqdes, &attr, NULL);
+}
+
+/****************************************************************************
+ * Name : messaging_channel_listen_close
+ *
+ * Description:
+ *  Stop receiving through a channel: remove the receiver information and
+ *  close and unlink the port.
+ ****************************************************************************/
+static void messaging_channel_listen_close(msg_channel_t *channel)
+{
+	char *private_portname;
+
+	if (channel->listen_pid == MSG_RECV_NOT_INIT) {
+		return;
+	}
+
+	(void)FREE_MSG_RECEIVER(channel->mark_name);
+	(void)FREE_MSG_RECEIVER(channel->port_name);
+	mq_close(channel->listen_mqdes);
+	MSG_ASPRINTF(&private_portname, "%s%d", channel->port_name, channel->listen_pid);
+	if (private_portname != NULL) {
+		mq_unlink(private_portname);
+		MSG_FREE(private_portname);
+	}
+
+	MSG_FREE(channel->listen_packet);
+	channel->listen_packet = NULL;
+	channel->listen_size = 0;
+	channel->listen_pid = MSG_RECV_NOT_INIT;
+}
+
+/****************************************************************************
+ * Name : messaging_channel_listen_open
+ *
+ * Description:
+ *  Open the port of the calling thread on the first receive through a
+ *  channel, and save it as a receiver of the port which keeps its port.
+ ****************************************************************************/
+static int messaging_channel_listen_open(msg_channel_t *channel, int recv_size)
+{
+	struct mq_attr attr;
+	char *private_portname;
+	pid_t my_pid = getpid();
+
+	if (channel->listen_pid == my_pid) {
+		return OK;
+	}
+
+	if (channel->listen_pid != MSG_RECV_NOT_INIT) {
+		msgdbg("[Messaging] channel recv fail : port belongs to %d.\n", channel->listen_pid);
+		return ERROR;
+	}
+
+	MSG_ASPRINTF(&private_portname, "%s%d", channel->port_name, my_pid);
+	if (private_portname == NULL) {
+		msgdbg("[Messaging] channel recv fail : out of memory for private portname.\n");
+		return ERROR;
+	}
+
+	attr.mq_maxmsg = CONFIG_MESSAGING_MAXMSG;
+	attr.mq_msgsize = recv_size;
+	attr.mq_flags = 0;
+	channel->listen_mqdes = mq_open(private_portname, O_RDONLY | O_CREAT, 0666, &attr);
+	MSG_FREE(private_portname);
+	if (channel->listen_mqdes == (mqd_t)ERROR) {
+		msgdbg("[Messaging] channel recv fail : open fail, errno %d.\n", errno);
+		return ERROR;
+	}
+	channel->listen_pid = my_pid;
+
+	/* The queue may have been there already with larger messages */
+	if (mq_getattr(channel->listen_mqdes, &attr) == OK && attr.mq_msgsize > recv_size) {
+		recv_size = attr.mq_msgsize;
+	}
+
+	channel->listen_packet = (char *)MSG_ALLOC(recv_size);
+	if (channel->listen_packet == NULL) {
+		msgdbg("[Messaging] channel recv fail : out of memory for packet.\n");
+		messaging_channel_listen_close(channel);
+		return ERROR;
+	}
+	channel->listen_size = recv_size;
+
+	/* Save the receiver information last, once the port can be used */
+	if (SAVE_MSG_RECEIVER(channel->port_name) != OK || SAVE_MSG_RECEIVER(channel->mark_name) != OK) {
+		messaging_channel_listen_close(channel);
+		return ERROR;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * public functions
+ ****************************************************************************/
+/****************************************************************************
+ * messaging_channel_open
+ ****************************************************************************/
+msg_channel_t *messaging_channel_open(const char *port_name)
+{
+	msg_channel_t *channel;
+
+	if (port_name == NULL || strlen(port_name) + strlen(MSG_CHANNEL_MARK) >= MAX_PORT_NAME_SIZE) {
+		msgdbg("[Messaging] channel open fail : invalid port name.\n");
+		return NULL;
+	}
+
+	channel = (msg_channel_t *)MSG_ALLOC(sizeof(msg_channel_t));
+	if (channel == NULL) {
+		msgdbg("[Messaging] channel open fail : out of memory.\n");
+		return NULL;
+	}
+
+	strncpy(channel->port_name, port_name, MAX_PORT_NAME_SIZE);
+	snprintf(channel->mark_name, MAX_PORT_NAME_SIZE, "%s%s", port_name, MSG_CHANNEL_MARK);
+	channel->recv_pid = MSG_RECV_NOT_INIT;
+	channel->mqdes = (mqd_t)ERROR;
+	channel->packet = NULL;
+	channel->packet_size = 0;
+	channel->reply_pid = MSG_RECV_NOT_INIT;
+	channel->reply_mqdes = (mqd_t)ERROR;
+	channel->reply_packet = NULL;
+	channel->reply_size = 0;
+	channel->listen_pid = MSG_RECV_NOT_INIT;
+	channel->listen_mqdes = (mqd_t)ERROR;
+	channel->listen_packet = NULL;
+	channel->listen_size = 0;
+
+	return channel;
+}
+
+/****************************************************************************
+ * messaging_channel_send
+ ****************************************************************************/
+int messaging_channel_send(msg_channel_t *channel, msg_send_data_t *send_data)
+{
+	if (channel == NULL || send_data == NULL || send_data->msg == NULL || send_data->msglen <= 0 || send_data->priority < 0) {
+		msgdbg("[Messaging] channel send fail : invalid param.\n");
+		return ERROR;
+	}
+
+	return messaging_channel_send_packet(channel, MSG_SEND_NOREPLY, send_data->msg, send_data->msglen, send_data->priority);
+}
+
+/****************************************************************************
+ * messaging_channel_send_sync
+ ****************************************************************************/
+int messaging_channel_send_sync(msg_channel_t *channel, msg_send_data_t *send_data, msg_recv_buf_t *reply_buf)
+{
+	int ret;
+	int msg_type;
+
+	if (channel == NULL || send_data == NULL || send_data->msg == NULL || send_data->msglen <= 0 || send_data->priority < 0) {
+		msgdbg("[Messaging] channel send sync fail : invalid param.\n");
+		return ERROR;
+	}
+
+	if (reply_buf == NULL || reply_buf->buf == NULL || reply_buf->buflen <= 0) {
+		msgdbg("[Messaging] channel send sync fail : invalid param of reply buf\n");
+		return ERROR;
+	}
+
+	/* The reply port is opened before sending so that the reply cannot
+	 * come before it exists.
+	 */
+	ret = messaging_channel_reply_open(channel, MSG_HEADER_SIZE + reply_buf->buflen);
+	if (ret != OK) {
+		return ERROR;
+	}
+
+	messaging_channel_reply_flush(channel);
+
+	ret = messaging_channel_send_packet(channel, MSG_SEND_SYNC, send_data->msg, send_data->msglen, send_data->priority);
+	if (ret != OK) {
+		return ERROR;
+	}
+
+	if (mq_receive(channel->reply_mqdes, channel->reply_packet, channel->reply_size, 0) < 0) {
+		/* Do not let a late reply be taken for the reply of the next call */
+		msgdbg("[Messaging] channel send sync fail : recv fail %d.\n", errno);
+		messaging_channel_reply_close(channel);
+		return ERROR;
+	}
+
+	ret = messaging_parse_packet(channel->reply_packet, reply_buf->buf, reply_buf->buflen, &reply_buf->sender_pid, &msg_type);
+	if (ret != OK) {
+		return ERROR;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * messaging_channel_recv
+ ****************************************************************************/
+int messaging_channel_recv(msg_channel_t *channel, msg_recv_buf_t *recv_buf)
+{
+	int ret;
+	int msg_type;
+
+	if (channel == NULL || recv_buf == NULL || recv_buf->buf == NULL || recv_buf->buflen <= 0) {
+		msgdbg("[Messaging] channel recv fail : invalid param.\n");
+		return ERROR;
+	}
+
+	ret = messaging_channel_listen_open(channel, MSG_HEADER_SIZE + recv_buf->buflen);
+	if (ret != OK) {
+		return ERROR;
+	}
+
+	ret = mq_receive(channel->listen_mqdes, channel->listen_packet, channel->listen_size, 0);
+	if (ret < 0) {
+		msgdbg("[Messaging] channel recv fail : errno %d.\n", errno);
+		return ERROR;
+	}
+
+	ret = messaging_parse_packet(channel->listen_packet, recv_buf->buf, recv_buf->buflen, &recv_buf->sender_pid, &msg_type);
+	if (ret != OK) {
+		return ERROR;
+	}
+
+	return msg_type == MSG_SEND_NOREPLY ? MSG_REPLY_NO_REQUIRED : MSG_REPLY_REQUIRED;
+}
+
+/****************************************************************************
+ * messaging_channel_send_buf
+ ****************************************************************************/
+int messaging_channel_send_buf(msg_channel_t *channel, void *buf, int priority)
+{
+	int ret;
+
+	if (channel == NULL || buf == NULL || priority < 0) {
+		msgdbg("[Messaging] channel send buf fail : invalid param.\n");
+		return ERROR;
+	}
+
+	/* The reference taken here belongs to the receiver */
+	messaging_buf_ref(buf);
+	ret = messaging_channel_send_packet(channel, MSG_SEND_NOREPLY, (const char *)&buf, sizeof(void *), priority);
+	if (ret != OK) {
+		messaging_buf_free(buf);
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * messaging_channel_close
+ ****************************************************************************/
+int messaging_channel_close(msg_channel_t *channel)
+{
+	if (channel == NULL) {
+		msgdbg("[Messaging] channel close fail : invalid param.\n");
+		return ERROR;
+	}
+
+	if (channel->recv_pid != MSG_RECV_NOT_INIT) {
+		mq_close(channel->mqdes);
+	}
+
+	messaging_channel_reply_close(channel);
+	messaging_channel_listen_close(channel);
+	MSG_FREE(channel->packet);
+	MSG_FREE(channel);
+	return OK;
+}
+
+/****************************************************************************
+ * messaging_buf_alloc
+ ****************************************************************************/
+void *messaging_buf_alloc(int size)
+{
+	msg_buf_header_t *header;
+
+	if (size <= 0) {
+		msgdbg("[Messaging] buf alloc fail : invalid size.\n");
+		return NULL;
+	}
+
+	header = (msg_buf_header_t *)MSG_ALLOC(sizeof(msg_buf_header_t) + size);
+	if (header == NULL) {
+		msgdbg("[Messaging] buf alloc fail : out of memory.\n");
+		return NULL;
+	}
+
+	header->refs = 1;
+	header->size = size;
+	return (void *)(header + 1);
+}
+
+/****************************************************************************
+ * messaging_buf_ref
+ ****************************************************************************/
+void messaging_buf_ref(void *buf)
+{
+	if (buf == NULL) {
+		return;
+	}
+
+	sched_lock();
+	MSG_BUF_HEADER(buf)->refs++;
+	sched_unlock();
+}
+
+/****************************************************************************
+ * messaging_buf_free
+ ****************************************************************************/
+void messaging_buf_free(void *buf)
+{
+	int refs;
+
+	if (buf == NULL) {
+		return;
+	}
+
+	sched_lock();
+	refs = --MSG_BUF_HEADER(buf)->refs;
+	sched_unlock();
+
+	if (refs == 0) {
+		MSG_FREE(MSG_BUF_HEADER(buf));
+	}
+}
+
+/****************************************************************************
+ * messaging_buf_size
+ ****************************************************************************/
+int messaging_buf_size(void *buf)
+{
+	if (buf == NULL) {
+		return ERROR;
+	}
+
+	return MSG_BUF_HEADER(buf)->size;
+}
+
+/****************************************************************************
+ * messaging_buf_get
+ ****************************************************************************/
+void *messaging_buf_get(msg_recv_buf_t *recv_buf)
+{
+	void *buf;
+
+	if (recv_buf == NULL || recv_buf->buf == NULL || recv_buf->buflen < (int)sizeof(void *)) {
+		msgdbg("[Messaging] buf get fail : invalid param.\n");
+		return NULL;
+	}
+
+	memcpy(&buf, recv_buf->buf, sizeof(void *));
+	return buf;
+}
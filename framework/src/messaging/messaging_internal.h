@@ -15,6 +15,7 @@
  * language governing permissions and limitations under the License.
  *
  ****************************************************************************/
+#include <tinyara/config.h>
 #include <tinyara/compiler.h>
 #include <mqueue.h>
 #include <stdio.h>
@@ -28,6 +29,7 @@
  */
 #define MSG_ALLOC(a) malloc(a)
 #define MSG_FREE(a) free(a)
+#define MSG_REALLOC(p, a) realloc(p, a)
 #ifdef CONFIG_CPP_HAVE_VARARGS
 #define MSG_ASPRINTF(p, f, ...) asprintf(p, f, ##__VA_ARGS__)
 #else
@@ -142,6 +144,10 @@ int messaging_parse_packet(char *packet, char *buf, int buflen, pid_t *sender_pi
  * @brief Internal function for getting g_port_info_list
  */
 sq_queue_t *messaging_get_port_info_list(void);
+/**
+ * @brief Internal function for getting the messaging packet version
+ */
+int messaging_get_version(void);
 /*
  *@endcond
  */
@@ -81,6 +81,7 @@ static int messaging_sync_recv(const char *port_name, msg_recv_buf_t *reply_buf)
 		msgdbg("message send fail : out of memory for including header\n");
 		mq_close(sync_mqdes);
 		mq_unlink(sync_portname);
+		MSG_FREE(sync_portname);
 		return ERROR;
 	}
 
@@ -62,6 +62,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include "string/lib_string.h"
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -75,6 +77,68 @@ FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
 	FAR unsigned char *pout = (FAR unsigned char *)dest;
 	FAR unsigned char *pin = (FAR unsigned char *)src;
+
+#ifdef CONFIG_LIBC_STRING_OPTIMIZE
+	if (n >= LIBC_STRING_THRESHOLD) {
+		FAR uintptr_t *wout;
+		FAR const uintptr_t *win;
+		uintptr_t lo;
+		uintptr_t hi;
+		unsigned int shift;
+
+		/* Copy bytes until the destination is aligned */
+
+		while (LIBC_UNALIGNED(pout)) {
+			*pout++ = *pin++;
+			n--;
+		}
+
+		wout = (FAR uintptr_t *)pout;
+
+		if (!LIBC_UNALIGNED(pin)) {
+			/* Both are aligned, copy four words per loop */
+
+			win = (FAR const uintptr_t *)pin;
+			while (n >= 4 * LIBC_WORDSIZE) {
+				wout[0] = win[0];
+				wout[1] = win[1];
+				wout[2] = win[2];
+				wout[3] = win[3];
+				wout += 4;
+				win += 4;
+				n -= 4 * LIBC_WORDSIZE;
+			}
+
+			while (n >= LIBC_WORDSIZE) {
+				*wout++ = *win++;
+				n -= LIBC_WORDSIZE;
+			}
+
+			pin = (FAR unsigned char *)win;
+		} else {
+			/* The source is not aligned.  Read aligned source words and
+			 * shift them into place so that the buses only see aligned
+			 * accesses.  Each source word read holds bytes still to be
+			 * copied, so this never reads beyond the source.
+			 */
+
+			shift = 8 * ((uintptr_t)pin & LIBC_WORDMASK);
+			win = (FAR const uintptr_t *)((uintptr_t)pin & ~(uintptr_t)LIBC_WORDMASK);
+			lo = *win++;
+			while (n >= LIBC_WORDSIZE) {
+				hi = *win++;
+				*wout++ = LIBC_MERGE(lo, hi, shift);
+				lo = hi;
+				n -= LIBC_WORDSIZE;
+			}
+
+			pin = (FAR unsigned char *)win - LIBC_WORDSIZE + shift / 8;
+		}
+
+		pout = (FAR unsigned char *)wout;
+	}
+#endif
+
 	while (n-- > 0) {
 		*pout++ = *pin++;
 	}
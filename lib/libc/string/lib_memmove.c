@@ -62,6 +62,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include "string/lib_string.h"
+
 /************************************************************
  * Global Functions
  ************************************************************/
@@ -70,15 +72,73 @@
 FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
 {
 	char *tmp, *s;
+#ifdef CONFIG_LIBC_STRING_OPTIMIZE
+	/* memcpy() also handles sources which cannot be aligned with the
+	 * destination, use it when the buffers do not overlap.
+	 */
+
+	if ((FAR char *)dest + count <= (FAR const char *)src || (FAR const char *)src + count <= (FAR char *)dest) {
+		return memcpy(dest, src, count);
+	}
+#endif
 	if (dest <= src) {
 		tmp = (char *)dest;
 		s = (char *)src;
+#ifdef CONFIG_LIBC_STRING_OPTIMIZE
+		/* Copy words forward when both pointers can be aligned together.
+		 * The buffers are then apart by a multiple of the word size, so
+		 * each source word is read before it can be overwritten.
+		 */
+
+		if (count >= LIBC_STRING_THRESHOLD && (((uintptr_t)tmp ^ (uintptr_t)s) & LIBC_WORDMASK) == 0) {
+			uintptr_t *wd;
+			const uintptr_t *ws;
+
+			while (LIBC_UNALIGNED(tmp)) {
+				*tmp++ = *s++;
+				count--;
+			}
+
+			wd = (uintptr_t *)tmp;
+			ws = (const uintptr_t *)s;
+			while (count >= LIBC_WORDSIZE) {
+				*wd++ = *ws++;
+				count -= LIBC_WORDSIZE;
+			}
+
+			tmp = (char *)wd;
+			s = (char *)ws;
+		}
+#endif
 		while (count--) {
 			*tmp++ = *s++;
 		}
 	} else {
 		tmp = (char *)dest + count;
 		s = (char *)src + count;
+#ifdef CONFIG_LIBC_STRING_OPTIMIZE
+		/* Likewise backward, from the aligned end of the buffers */
+
+		if (count >= LIBC_STRING_THRESHOLD && (((uintptr_t)tmp ^ (uintptr_t)s) & LIBC_WORDMASK) == 0) {
+			uintptr_t *wd;
+			const uintptr_t *ws;
+
+			while (LIBC_UNALIGNED(tmp)) {
+				*--tmp = *--s;
+				count--;
+			}
+
+			wd = (uintptr_t *)tmp;
+			ws = (const uintptr_t *)s;
+			while (count >= LIBC_WORDSIZE) {
+				*--wd = *--ws;
+				count -= LIBC_WORDSIZE;
+			}
+
+			tmp = (char *)wd;
+			s = (char *)ws;
+		}
+#endif
 		while (count--) {
 			*--tmp = *--s;
 		}
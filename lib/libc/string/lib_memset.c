@@ -63,6 +63,8 @@
 #include <string.h>
 #include <assert.h>
 
+#include "string/lib_string.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -82,7 +84,44 @@
 #ifndef CONFIG_ARCH_MEMSET
 void *memset(void *s, int c, size_t n)
 {
-#ifdef CONFIG_MEMSET_OPTSPEED
+#if defined(CONFIG_LIBC_STRING_OPTIMIZE)
+	unsigned char *p = (unsigned char *)s;
+
+	if (n >= LIBC_STRING_THRESHOLD) {
+		uintptr_t val = LIBC_REPEAT(c);
+		uintptr_t *w;
+
+		/* Set bytes until the address is aligned, then four words per
+		 * loop.
+		 */
+
+		while (LIBC_UNALIGNED(p)) {
+			*p++ = (unsigned char)c;
+			n--;
+		}
+
+		w = (uintptr_t *)p;
+		while (n >= 4 * LIBC_WORDSIZE) {
+			w[0] = val;
+			w[1] = val;
+			w[2] = val;
+			w[3] = val;
+			w += 4;
+			n -= 4 * LIBC_WORDSIZE;
+		}
+
+		while (n >= LIBC_WORDSIZE) {
+			*w++ = val;
+			n -= LIBC_WORDSIZE;
+		}
+
+		p = (unsigned char *)w;
+	}
+
+	while (n-- > 0) {
+		*p++ = (unsigned char)c;
+	}
+#elif defined(CONFIG_MEMSET_OPTSPEED)
 	/* This version is optimized for speed (you could do better
 	 * still by exploiting processor caching or memory burst
 	 * knowledge.)
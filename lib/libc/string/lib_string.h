@@ -0,0 +1,68 @@
+/****************************************************************************
+ *
+ * Copyright 2026 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __LIBC_STRING_LIB_STRING_H
+#define __LIBC_STRING_LIB_STRING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+
+#ifdef CONFIG_LIBC_STRING_OPTIMIZE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The word-at-a-time string functions move one uintptr_t at a time once
+ * the pointers are aligned.  Buffers shorter than LIBC_STRING_THRESHOLD
+ * are handled byte by byte, aligning them would cost more than it saves.
+ */
+
+#define LIBC_WORDSIZE          sizeof(uintptr_t)
+#define LIBC_WORDMASK          (LIBC_WORDSIZE - 1)
+#define LIBC_UNALIGNED(p)      (((uintptr_t)(p) & LIBC_WORDMASK) != 0)
+#define LIBC_STRING_THRESHOLD  (4 * LIBC_WORDSIZE)
+
+/* LIBC_REPEAT(c) is a word with every byte set to c.  LIBC_HASZERO(w) is
+ * non-zero if any byte of w is zero.
+ */
+
+#define LIBC_ONES              ((uintptr_t)-1 / 0xff)
+#define LIBC_HIGHS             (LIBC_ONES << 7)
+#define LIBC_REPEAT(c)         (LIBC_ONES * (uint8_t)(c))
+#define LIBC_HASZERO(w)        (((w) - LIBC_ONES) & ~(w) & LIBC_HIGHS)
+
+/* LIBC_MERGE(lo, hi, shift) picks the word which starts 'shift' bits into
+ * the aligned word 'lo' and continues into the next aligned word 'hi'.
+ */
+
+#ifdef CONFIG_ENDIAN_BIG
+#define LIBC_MERGE(lo, hi, shift) \
+	(((lo) << (shift)) | ((hi) >> (8 * LIBC_WORDSIZE - (shift))))
+#else
+#define LIBC_MERGE(lo, hi, shift) \
+	(((lo) >> (shift)) | ((hi) << (8 * LIBC_WORDSIZE - (shift))))
+#endif
+
+#endif /* CONFIG_LIBC_STRING_OPTIMIZE */
+#endif /* __LIBC_STRING_LIB_STRING_H */
@@ -58,6 +58,8 @@
 #include <sys/types.h>
 #include <string.h>
 
+#include "string/lib_string.h"
+
 /****************************************************************************
  * Global Functions
  ****************************************************************************/
@@ -66,7 +68,28 @@
 size_t strlen(const char *s)
 {
 	const char *sc;
-	for (sc = s; *sc != '\0'; ++sc);
+
+#ifdef CONFIG_LIBC_STRING_OPTIMIZE
+	const uintptr_t *w;
+
+	/* Check bytes until the string is aligned, then a word at a time.  An
+	 * aligned word never crosses a page or a memory region boundary, so
+	 * reading the whole word that holds the terminator is safe.
+	 */
+
+	for (sc = s; LIBC_UNALIGNED(sc); ++sc) {
+		if (*sc == '\0') {
+			return sc - s;
+		}
+	}
+
+	for (w = (const uintptr_t *)sc; !LIBC_HASZERO(*w); w++);
+	sc = (const char *)w;
+#else
+	sc = s;
+#endif
+
+	for (; *sc != '\0'; ++sc);
 	return sc - s;
 }
 #endif
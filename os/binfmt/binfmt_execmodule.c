@@ -64,6 +64,7 @@
 #include <errno.h>
 
 #include <tinyara/arch.h>
+#include <tinyara/clock.h>
 #include <tinyara/kmalloc.h>
 #include <tinyara/mm/shm.h>
 #include <tinyara/binfmt/binfmt.h>
@@ -113,9 +114,12 @@
 #ifdef CONFIG_BINFMT_CONSTRUCTORS
 static void exec_ctors(FAR void *arg)
 {
-	FAR const struct binary_s *binp = (FAR const struct binary_s *)arg;
+	FAR struct binary_s *binp = (FAR struct binary_s *)arg;
 	binfmt_ctor_t *ctor = binp->ctors;
 	int i;
+#ifdef CONFIG_BINMGR_LOAD_STATS
+	clock_t start_time = clock_systimer();
+#endif
 
 	/* Execute each constructor */
 
@@ -125,6 +129,10 @@ static void exec_ctors(FAR void *arg)
 		(*ctor)();
 		ctor++;
 	}
+
+#ifdef CONFIG_BINMGR_LOAD_STATS
+	binp->ctor_ticks = clock_systimer() - start_time;
+#endif
 }
 #endif
 
@@ -167,7 +175,7 @@ int exec_module(FAR const struct binary_s *binp)
 
 	/* Allocate a TCB for the new task. */
 
-	tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+	tcb = (FAR struct task_tcb_s *)sched_tcballoc(TCB_FLAG_TTYPE_TASK);
 	if (!tcb) {
 		return -ENOMEM;
 	}
@@ -336,7 +344,7 @@ errout_with_addrenv:
 
 errout_with_tcb:
 #endif
-	kmm_free(tcb);
+	sched_tcbfree(&tcb->cmn, TCB_FLAG_TTYPE_TASK);
 	return ret;
 }
 
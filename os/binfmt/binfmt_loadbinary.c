@@ -206,6 +206,10 @@ int load_binary(int binary_idx, FAR const char *filename, load_attr_t *load_attr
 
 	BIN_ID(binary_idx) = pid;
 	BIN_STATE(binary_idx) = BINARY_LOADING_DONE;
+#ifdef CONFIG_BINMGR_LOAD_STATS
+	BIN_LOADSTAT(binary_idx).load = bin->load_ticks;
+	BIN_LOADSTAT(binary_idx).bind = bin->bind_ticks;
+#endif
 
 	sched_unlock();
 	return pid;
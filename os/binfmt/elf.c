@@ -63,6 +63,7 @@
 #include <errno.h>
 
 #include <tinyara/arch.h>
+#include <tinyara/clock.h>
 #include <tinyara/binfmt/binfmt.h>
 #include <tinyara/binfmt/elf.h>
 
@@ -233,6 +234,11 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 {
 	struct elf_loadinfo_s loadinfo;	/* Contains globals for libelf */
 	int ret;
+#ifdef CONFIG_BINMGR_LOAD_STATS
+	clock_t start_time;
+
+	start_time = clock_systimer();
+#endif
 
 	binfo("Loading file: %s\n", binp->filename);
 
@@ -265,6 +271,11 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 		goto errout_with_init;
 	}
 
+#ifdef CONFIG_BINMGR_LOAD_STATS
+	binp->load_ticks = clock_systimer() - start_time;
+	start_time = clock_systimer();
+#endif
+
 	/* Bind the program to the exported symbol table */
 
 	ret = elf_bind(&loadinfo, binp->exports, binp->nexports);
@@ -273,6 +284,10 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 		goto errout_with_load;
 	}
 
+#ifdef CONFIG_BINMGR_LOAD_STATS
+	binp->bind_ticks = clock_systimer() - start_time;
+#endif
+
 	/* Return the load information */
 
 	binp->entrypt = (main_t)(loadinfo.textalloc + loadinfo.ehdr.e_entry);
@@ -151,7 +151,7 @@ int elf_findsymtab(FAR struct elf_loadinfo_s *loadinfo);
  * Name: elf_readsymtab
  *
  * Description:
- *   Read the ELF symbol table into memory.
+ *   Read the ELF symbol table and its string table into memory.
  *
  * Input Parameters:
  *   loadinfo - Load state information
@@ -160,6 +160,19 @@ int elf_findsymtab(FAR struct elf_loadinfo_s *loadinfo);
 
 void elf_readsymtab(FAR struct elf_loadinfo_s *loadinfo);
 
+/****************************************************************************
+ * Name: elf_freesymtab
+ *
+ * Description:
+ *   Release the copies of the symbol table and its string table.
+ *
+ * Input Parameters:
+ *   loadinfo - Load state information
+ *
+ ****************************************************************************/
+
+void elf_freesymtab(FAR struct elf_loadinfo_s *loadinfo);
+
 /****************************************************************************
  * Name: elf_readsym
  *
@@ -179,6 +192,22 @@ void elf_readsymtab(FAR struct elf_loadinfo_s *loadinfo);
 
 int elf_readsym(FAR struct elf_loadinfo_s *loadinfo, int index, FAR Elf32_Sym *sym);
 
+/****************************************************************************
+ * Name: elf_savesym
+ *
+ * Description:
+ *   Save a resolved symbol in the copy of the symbol table, so that later
+ *   relocations against it do not resolve it again.
+ *
+ * Input Parameters:
+ *   loadinfo - Load state information
+ *   index    - Symbol table index
+ *   sym      - The resolved symbol table entry
+ *
+ ****************************************************************************/
+
+void elf_savesym(FAR struct elf_loadinfo_s *loadinfo, int index, FAR const Elf32_Sym *sym);
+
 /****************************************************************************
  * Name: elf_symvalue
  *
@@ -117,6 +117,8 @@ static inline void elf_readreltab(FAR struct elf_loadinfo_s *loadinfo, FAR const
 
 	if (elf_read(loadinfo, (FAR uint8_t *)loadinfo->reltab, relsec->sh_size, relsec->sh_offset) < 0) {
 		berr("ERROR: Failed to read relocation table into memory\n");
+		kmm_free((FAR void *)loadinfo->reltab);
+		loadinfo->reltab = 0;
 	}
 }
 
@@ -135,7 +137,7 @@ static inline int elf_readrel(FAR struct elf_loadinfo_s *loadinfo, FAR const Elf
 
 	/* Verify that the symbol table index lies within symbol table */
 
-	if (index < 0 || index > (relsec->sh_size / sizeof(Elf32_Rel))) {
+	if (index < 0 || index >= (relsec->sh_size / sizeof(Elf32_Rel))) {
 		berr("Bad relocation symbol index: %d\n", index);
 		return -EINVAL;
 	}
@@ -238,12 +240,15 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx, FAR con
 				berr("Section %d reloc %d: Failed to get value of symbol[%d]: %d\n", relidx, i, symidx, ret);
 				goto ret_err;
 			}
+		} else {
+			elf_savesym(loadinfo, symidx, &sym);
 		}
 
 		/* Calculate the relocation address. */
 
 		if (rel.r_offset > dstsec->sh_size - sizeof(uint32_t)) {
 			berr("Section %d reloc %d: Relocation address out of range, offset %d size %d\n", relidx, i, rel.r_offset, dstsec->sh_size);
+			ret = -EINVAL;
 			goto ret_err;
 		}
 
@@ -259,7 +264,8 @@ static int elf_relocate(FAR struct elf_loadinfo_s *loadinfo, int relidx, FAR con
 	}
 
 ret_err:
-	kmm_free(loadinfo->reltab);
+	kmm_free((FAR void *)loadinfo->reltab);
+	loadinfo->reltab = 0;
 	return ret;
 }
 
@@ -301,7 +307,7 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo, FAR const struct symtab_s *exp
 		return ret;
 	}
 
-	/* Read the symbol table into memory */
+	/* Read the symbol table and its string table into memory */
 	elf_readsymtab(loadinfo);
 
 	/* Allocate an I/O buffer.  This buffer is used by elf_symname() to
@@ -391,6 +397,6 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo, FAR const struct symtab_s *exp
 #endif
 
 ret_err:
-	kmm_free(loadinfo->symtab);
+	elf_freesymtab(loadinfo);
 	return ret;
 }
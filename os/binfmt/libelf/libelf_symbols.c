@@ -83,7 +83,8 @@
  * Name: elf_symname
  *
  * Description:
- *   Get the symbol name in loadinfo->iobuffer[].
+ *   Get the symbol name.  It is taken from the copy of the string table if
+ *   it was read into memory, or read into loadinfo->iobuffer[] otherwise.
  *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
@@ -95,8 +96,9 @@
  *
  ****************************************************************************/
 
-static int elf_symname(FAR struct elf_loadinfo_s *loadinfo, FAR const Elf32_Sym *sym)
+static int elf_symname(FAR struct elf_loadinfo_s *loadinfo, FAR const Elf32_Sym *sym, FAR const char **name)
 {
+	FAR Elf32_Shdr *strtab = &loadinfo->shdr[loadinfo->strtabidx];
 	FAR uint8_t *buffer;
 	off_t offset;
 	size_t readlen;
@@ -112,7 +114,20 @@ static int elf_symname(FAR struct elf_loadinfo_s *loadinfo, FAR const Elf32_Sym
 		return -ESRCH;
 	}
 
-	offset = loadinfo->shdr[loadinfo->strtabidx].sh_offset + sym->st_name;
+	if (loadinfo->strtab) {
+		/* The name must be terminated within the string table */
+
+		if (sym->st_name >= strtab->sh_size || memchr((FAR const char *)loadinfo->strtab + sym->st_name, '\0', strtab->sh_size - sym->st_name) == NULL) {
+			berr("Bad symbol name offset: %u\n", sym->st_name);
+			return -EINVAL;
+		}
+
+		*name = (FAR const char *)loadinfo->strtab + sym->st_name;
+		return OK;
+	}
+
+	*name = (FAR const char *)loadinfo->iobuffer;
+	offset = strtab->sh_offset + sym->st_name;
 
 	/* Loop until we get the entire symbol name into memory */
 
@@ -147,6 +162,7 @@ static int elf_symname(FAR struct elf_loadinfo_s *loadinfo, FAR const Elf32_Sym
 		if (memchr(buffer, '\0', readlen) != NULL) {
 			/* Yes, the buffer contains a NUL terminator. */
 
+			*name = (FAR const char *)loadinfo->iobuffer;
 			return OK;
 		}
 
@@ -208,7 +224,9 @@ int elf_findsymtab(FAR struct elf_loadinfo_s *loadinfo)
  * Name: elf_readsymtab
  *
  * Description:
- *   Read the ELF symbol table into memory.
+ *   Read the ELF symbol table and its string table into memory, each with
+ *   a single read.  A table which cannot be read is left in the file and
+ *   accessed one entry at a time.
  *
  * Input Parameters:
  *   loadinfo - Load state information
@@ -217,16 +235,53 @@ int elf_findsymtab(FAR struct elf_loadinfo_s *loadinfo)
 void elf_readsymtab(FAR struct elf_loadinfo_s *loadinfo)
 {
 	FAR Elf32_Shdr *symtab = &loadinfo->shdr[loadinfo->symtabidx];
+	FAR Elf32_Shdr *strtab = &loadinfo->shdr[loadinfo->strtabidx];
 
 	loadinfo->symtab = (uintptr_t)kmm_malloc(symtab->sh_size);
 
 	if (!loadinfo->symtab) {
 		berr("ERROR: Failed to allocate space for sym table. Size = %u\n", symtab->sh_size);
+	} else if (elf_read(loadinfo, (FAR uint8_t *)loadinfo->symtab, symtab->sh_size, symtab->sh_offset) < 0) {
+		berr("ERROR: Failed to load symbol table into memory\n");
+		kmm_free((FAR void *)loadinfo->symtab);
+		loadinfo->symtab = 0;
+	}
+
+	if (loadinfo->strtabidx == 0 || loadinfo->strtabidx >= loadinfo->ehdr.e_shnum) {
 		return;
 	}
 
-	if (elf_read(loadinfo, loadinfo->symtab, symtab->sh_size, symtab->sh_offset) < 0) {
-		berr("ERROR: Failed to load symbol table into memory\n");
+	loadinfo->strtab = (uintptr_t)kmm_malloc(strtab->sh_size);
+
+	if (!loadinfo->strtab) {
+		berr("ERROR: Failed to allocate space for string table. Size = %u\n", strtab->sh_size);
+	} else if (elf_read(loadinfo, (FAR uint8_t *)loadinfo->strtab, strtab->sh_size, strtab->sh_offset) < 0) {
+		berr("ERROR: Failed to load string table into memory\n");
+		kmm_free((FAR void *)loadinfo->strtab);
+		loadinfo->strtab = 0;
+	}
+}
+
+/****************************************************************************
+ * Name: elf_freesymtab
+ *
+ * Description:
+ *   Release the copies of the symbol table and its string table.
+ *
+ * Input Parameters:
+ *   loadinfo - Load state information
+ *
+ ****************************************************************************/
+void elf_freesymtab(FAR struct elf_loadinfo_s *loadinfo)
+{
+	if (loadinfo->symtab) {
+		kmm_free((FAR void *)loadinfo->symtab);
+		loadinfo->symtab = 0;
+	}
+
+	if (loadinfo->strtab) {
+		kmm_free((FAR void *)loadinfo->strtab);
+		loadinfo->strtab = 0;
 	}
 }
 
@@ -254,7 +309,7 @@ int elf_readsym(FAR struct elf_loadinfo_s *loadinfo, int index, FAR Elf32_Sym *s
 
 	/* Verify that the symbol table index lies within symbol table */
 
-	if (index < 0 || index > (symtab->sh_size / sizeof(Elf32_Sym))) {
+	if (index < 0 || index >= (symtab->sh_size / sizeof(Elf32_Sym))) {
 		berr("Bad relocation symbol index: %d\n", index);
 		return -EINVAL;
 	}
@@ -280,6 +335,34 @@ int elf_readsym(FAR struct elf_loadinfo_s *loadinfo, int index, FAR Elf32_Sym *s
 	}
 }
 
+/****************************************************************************
+ * Name: elf_savesym
+ *
+ * Description:
+ *   Save the value of a symbol resolved by elf_symvalue() in the copy of
+ *   the symbol table, as an absolute symbol.  The next relocations against
+ *   this symbol then take the value without looking up its name again.
+ *
+ * Input Parameters:
+ *   loadinfo - Load state information
+ *   index    - Symbol table index
+ *   sym      - The resolved symbol table entry
+ *
+ ****************************************************************************/
+
+void elf_savesym(FAR struct elf_loadinfo_s *loadinfo, int index, FAR const Elf32_Sym *sym)
+{
+	FAR Elf32_Sym *entry;
+
+	if (!loadinfo->symtab || sym->st_shndx == SHN_ABS) {
+		return;
+	}
+
+	entry = (FAR Elf32_Sym *)loadinfo->symtab + index;
+	*entry = *sym;
+	entry->st_shndx = SHN_ABS;
+}
+
 /****************************************************************************
  * Name: elf_symvalue
  *
@@ -306,6 +389,7 @@ int elf_readsym(FAR struct elf_loadinfo_s *loadinfo, int index, FAR Elf32_Sym *s
 int elf_symvalue(FAR struct elf_loadinfo_s *loadinfo, FAR Elf32_Sym *sym, FAR const struct symtab_s *exports, int nexports)
 {
 	FAR const struct symtab_s *symbol;
+	FAR const char *name;
 	uintptr_t secbase;
 	int ret;
 
@@ -327,7 +411,7 @@ int elf_symvalue(FAR struct elf_loadinfo_s *loadinfo, FAR Elf32_Sym *sym, FAR co
 	case SHN_UNDEF: {
 		/* Get the name of the undefined symbol */
 
-		ret = elf_symname(loadinfo, sym);
+		ret = elf_symname(loadinfo, sym, &name);
 		if (ret < 0) {
 			/* There are a few relocations for a few architectures that do
 			 * no depend upon a named symbol.  We don't know if that is the
@@ -342,18 +426,18 @@ int elf_symvalue(FAR struct elf_loadinfo_s *loadinfo, FAR Elf32_Sym *sym, FAR co
 		/* Check if the base code exports a symbol of this name */
 
 #ifdef CONFIG_SYMTAB_ORDEREDBYNAME
-		symbol = symtab_findorderedbyname(exports, (FAR char *)loadinfo->iobuffer, nexports);
+		symbol = symtab_findorderedbyname(exports, name, nexports);
 #else
-		symbol = symtab_findbyname(exports, (FAR char *)loadinfo->iobuffer, nexports);
+		symbol = symtab_findbyname(exports, name, nexports);
 #endif
 		if (!symbol) {
-			berr("SHN_UNDEF: Exported symbol \"%s\" not found\n", loadinfo->iobuffer);
+			berr("SHN_UNDEF: Exported symbol \"%s\" not found\n", name);
 			return -ENOENT;
 		}
 
 		/* Yes... add the exported symbol value to the ELF symbol table entry */
 
-		binfo("SHN_UNDEF: name=%s %08x+%08x=%08x\n", loadinfo->iobuffer, sym->st_value, symbol->sym_value, sym->st_value + symbol->sym_value);
+		binfo("SHN_UNDEF: name=%s %08x+%08x=%08x\n", name, sym->st_value, symbol->sym_value, sym->st_value + symbol->sym_value);
 
 		sym->st_value += (Elf32_Word)((uintptr_t)symbol->sym_value);
 	}
@@ -41,8 +41,21 @@
  * Private Declarations
  ****************************************************************************/
 
+#ifndef CONFIG_COMPRESSION_CACHE_BLOCKS
+#define CONFIG_COMPRESSION_CACHE_BLOCKS 1
+#endif
+
+/* A decompressed block kept for later reads */
+struct s_cached_block {
+	int block_number;			/* Block in 'data', -1 if none */
+	unsigned int stamp;			/* Last use, the oldest block is replaced first */
+	unsigned char *data;		/* Decompressed block, part of buffers.out_buffer */
+};
+
 static struct s_header *compression_header;
 static struct s_buffer buffers;
+static struct s_cached_block cached_blocks[CONFIG_COMPRESSION_CACHE_BLOCKS];
+static unsigned int cache_stamp;
 
 /****************************************************************************
  * Private Functions
@@ -52,7 +65,9 @@ static struct s_buffer buffers;
  * Name: compress_decompress_block
  *
  * Description:
- *   Decompress block in 'read_buffer' of readsize into 'out_buffer' of writesize
+ *   Decompress block in 'read_buffer' of readsize into 'out_buffer' of writesize.
+ *   On entry, 'writesize' is the room in 'out_buffer', no more than that is
+ *   written.
  *
  * Returned Value:
  *   Non-negative value on Success.
@@ -69,7 +84,6 @@ static int compress_decompress_block(unsigned char *out_buffer, long unsigned in
 #if CONFIG_COMPRESSION_TYPE == LZMA
 	if (compression_header->compression_format == COMPRESSION_TYPE_LZMA) {
 		/* LZMA specific logic for decompression */
-		*writesize = compression_header->blocksize;
 		*size -= (LZMA_PROPS_SIZE);
 
 		ret = LzmaUncompress(&out_buffer[0], writesize, &read_buffer[LZMA_PROPS_SIZE], size, &read_buffer[0], LZMA_PROPS_SIZE);
@@ -81,8 +95,6 @@ static int compress_decompress_block(unsigned char *out_buffer, long unsigned in
 #elif CONFIG_COMPRESSION_TYPE == MINIZ
 		if (compression_header->compression_format == COMPRESSION_TYPE_MINIZ) {
 			/* Miniz specific logic for decompression */
-			*writesize = compression_header->blocksize;
-	
 			ret = mz_uncompress(out_buffer, writesize, read_buffer, *size);
 			if (ret != Z_OK) {
 				bcmpdbg("Failure to decompress with Miniz's uncompress API; ret = %d\n", ret);
@@ -278,6 +290,113 @@ static off_t compress_read_block(int filfd, uint16_t binary_header_size, FAR uin
 	return nbytes;
 }
 
+/****************************************************************************
+ * Name: compress_load_block
+ *
+ * Description:
+ *   Read 'block_number' block from compressed file and decompress it into
+ *   'out_buffer', which has room for 'room' bytes.  'length' is the
+ *   uncompressed size of this block, which must not be more than 'room'
+ *
+ * Returned Value:
+ *   OK (0) on Success
+ *   Negative value on Failure
+ ****************************************************************************/
+static int compress_load_block(int filfd, uint16_t binary_header_size, unsigned char *out_buffer, int room, int length, int block_number)
+{
+	off_t nbytes;
+	int ret;
+#if CONFIG_COMPRESSION_TYPE == LZMA
+	unsigned int writesize;
+	unsigned int size;
+#elif CONFIG_COMPRESSION_TYPE == MINIZ
+	long unsigned int writesize;
+	long unsigned int size;
+#endif
+
+	/* Read compressed 'block_number' block into read_buffer */
+	nbytes = compress_read_block(filfd, binary_header_size, buffers.read_buffer, block_number);
+	if (nbytes < 0) {
+		bcmpdbg("Read for compressed block %d failed\n", block_number);
+		return (int)nbytes;
+	}
+
+	/* Decompress block in read_buffer to out_buffer */
+	size = nbytes;
+	writesize = room;
+	ret = compress_decompress_block(out_buffer, &writesize, buffers.read_buffer, &size, block_number);
+	if (ret != OK) {
+		bcmpdbg("Failed to decompress %d block of this binary\n", block_number);
+		return ret < 0 ? ret : -ret;
+	}
+
+	/* Every block but the last one decompresses to a whole blocksize */
+	if (writesize != length) {
+		bcmpdbg("Block %d decompressed to %d bytes instead of %d\n", block_number, (int)writesize, length);
+		return -EIO;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Name: compress_find_block
+ *
+ * Description:
+ *   Look up 'block_number' block in the cache of decompressed blocks
+ *
+ * Returned Value:
+ *   Address of the cached block if it is cached
+ *   NULL otherwise
+ ****************************************************************************/
+static struct s_cached_block *compress_find_block(int block_number)
+{
+	int index;
+
+	for (index = 0; index < CONFIG_COMPRESSION_CACHE_BLOCKS; index++) {
+		if (cached_blocks[index].block_number == block_number) {
+			cached_blocks[index].stamp = ++cache_stamp;
+			return &cached_blocks[index];
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: compress_cache_block
+ *
+ * Description:
+ *   Decompress 'block_number' block into the cache in place of the least
+ *   recently used block
+ *
+ * Returned Value:
+ *   Address of the cached block on Success
+ *   NULL on Failure
+ ****************************************************************************/
+static struct s_cached_block *compress_cache_block(int filfd, uint16_t binary_header_size, int length, int block_number)
+{
+	struct s_cached_block *cached;
+	int index;
+
+	cached = &cached_blocks[0];
+	for (index = 1; index < CONFIG_COMPRESSION_CACHE_BLOCKS; index++) {
+		if (cached_blocks[index].stamp < cached->stamp) {
+			cached = &cached_blocks[index];
+		}
+	}
+
+	cached->block_number = -1;
+	cached->stamp = 0;
+	if (compress_load_block(filfd, binary_header_size, cached->data, compression_header->blocksize, length, block_number) != OK) {
+		return NULL;
+	}
+
+	cached->block_number = block_number;
+	cached->stamp = ++cache_stamp;
+	return cached;
+}
+
 /****************************************************************************
  * Name: compress_read
  *
@@ -287,91 +406,85 @@ static off_t compress_read_block(int filfd, uint16_t binary_header_size, FAR uin
  *   value here is offset from start of uncompressed binary (excluding binary
  *   header).
  *
+ *   Blocks only partly covered by the read are decompressed into the block
+ *   cache, so that the next read of the same block does not decompress it
+ *   again.  Blocks covered entirely are decompressed straight into 'buffer'
+ *   unless they are already cached.
+ *
  * Returned Value:
  *   Number of bytes read into buffer on Success
  *   Negative value on failure
  ****************************************************************************/
 int compress_read(int filfd, uint16_t binary_header_size, FAR uint8_t *buffer, size_t readsize, off_t offset)
 {
+	struct s_cached_block *cached;
 	int first_block;
 	int last_block;
 	int no_blocks;
 	int index;
-	int ret;
-	int actual_offset;			/* Offset from start of uncompressed file */
+	int block_start;			/* Offset of this block in uncompressed file */
+	int block_length;			/* Uncompressed size of this block */
+	int copy_start;				/* Offset in this block of the first byte to read */
 	int block_size_to_write;	/* Size to write into buffer from decompressed block */
 	int buffer_index;
 	int blocksize;
-#if CONFIG_COMPRESSION_TYPE == LZMA
-	unsigned int writesize;
-	unsigned int size;
-#elif CONFIG_COMPRESSION_TYPE == MINIZ
-	long unsigned int writesize;
-	long unsigned int size;
-#endif
+
+	/* Nothing can be read beyond the end of uncompressed file */
+	if (offset >= compression_header->binary_size) {
+		return 0;
+	}
+
+	if (offset + readsize > compression_header->binary_size) {
+		readsize = compression_header->binary_size - offset;
+	}
 
 	/* Setting first block, end block and number of blocks to read and decompressed */
 	blocksize = compression_header->blocksize;
 	compress_blocks_to_read(&first_block, &last_block, &no_blocks, offset, readsize);
 	if (first_block < 0 || no_blocks < 0) {
 		bcmpdbg("Incorrect first_block, no_blocks info\n");
-		buffer_index = ERROR;
-		goto error_compress_read;
+		return ERROR;
 	}
 
-	index = first_block;
 	buffer_index = 0;
-	/* Actual Offset in uncompressed file is same as Offset passed to this function */
-	actual_offset = offset;
 
 	/* Reading and decompressing blocks from first_block to last_block. Then writing to buffer. */
-	for (; index < first_block + no_blocks; index++) {
-		/* Read compressed 'index' block into read_buffer */
-		size = compress_read_block(filfd, binary_header_size, buffers.read_buffer, index);
-		if (size < 0) {
-			bcmpdbg("Read for compressed block %d failed\n", index);
-			buffer_index = size;
-			goto error_compress_read;
+	for (index = first_block; index <= last_block; index++) {
+		block_start = index * blocksize;
+		block_length = compression_header->binary_size - block_start;
+		if (block_length > blocksize) {
+			block_length = blocksize;
 		}
 
-		/* Decompress block in read_buffer to out_buffer */
-		ret = compress_decompress_block(buffers.out_buffer, &writesize, buffers.read_buffer, &size, index);
-		if (ret == ERROR) {
-			bcmpdbg("Failed to decompress %d block of this binary\n", index);
-			buffer_index = ret;
-			goto error_compress_read;
+		copy_start = offset > block_start ? offset - block_start : 0;
+		block_size_to_write = block_length - copy_start;
+		if (block_size_to_write > readsize - buffer_index) {
+			block_size_to_write = readsize - buffer_index;
 		}
 
-		if (index == first_block) {
-			/*
-			 * Read appropriate number of bytes to buffer from this block using readsize and offset info.
-			 * If start_offset + readsize < end_offset, write from start_offset to start_offset + readsize.
-			 * Otherwise, write from start_offset to end_offset into buffer.
-			 */
-			block_size_to_write = ((index + 1) * blocksize - 1 > actual_offset + readsize - 1 ? readsize : (index + 1) * blocksize - actual_offset);
-			memcpy(&buffer[buffer_index], &buffers.out_buffer[actual_offset - (index * blocksize)], block_size_to_write);
-			buffer_index += block_size_to_write;
-		} else if (index == last_block) {
-			/*
-			 * Read appropriate number of bytes to buffer from this block using readsize and offset info.
-			 * Calculate end_offset (Offset of last byte to write from this block).
-			 * Write from start_offset to end_offset from this block into buffer.
-			 */
-			block_size_to_write = actual_offset + readsize - (index * blocksize);
-			memcpy(&buffer[buffer_index], &buffers.out_buffer[0], block_size_to_write);
-			buffer_index += block_size_to_write;
-		} else {
-			/*
-			 * This is not the first or last block. This is intermediary block.
-			 * So, write entire block into buffer.
+		cached = compress_find_block(index);
+		if (cached == NULL && block_size_to_write == block_length) {
+			/* Whole block is needed, decompress it straight into buffer.  The
+			 * decoder is given only the room left in buffer, a block which
+			 * doesn't fit in it is decompressed into the cache below.
 			 */
-			block_size_to_write = blocksize;
-			memcpy(&buffer[buffer_index], &buffers.out_buffer[0], block_size_to_write);
-			buffer_index += block_size_to_write;
+			if (compress_load_block(filfd, binary_header_size, &buffer[buffer_index], readsize - buffer_index, block_length, index) == OK) {
+				buffer_index += block_size_to_write;
+				continue;
+			}
+		}
+
+		if (cached == NULL) {
+			cached = compress_cache_block(filfd, binary_header_size, block_length, index);
+			if (cached == NULL) {
+				return ERROR;
+			}
 		}
+
+		memcpy(&buffer[buffer_index], &cached->data[copy_start], block_size_to_write);
+		buffer_index += block_size_to_write;
 	}
 
-error_compress_read:
 	return buffer_index;
 }
 
@@ -387,6 +500,7 @@ error_compress_read:
  ****************************************************************************/
 int compress_init(int filfd, uint16_t offset, off_t *filelen)
 {
+	int index;
 	int ret;
 
 	/* Parsing compression header for compressed file */
@@ -403,15 +517,29 @@ int compress_init(int filfd, uint16_t offset, off_t *filelen)
 	/* Allocating memory for read and out buffer to be used for LZMA decompression */
 	if (compression_header->compression_format == COMPRESSION_TYPE_LZMA) {
 		buffers.read_buffer = (unsigned char *)kmm_malloc(compression_header->blocksize + 5);
-		buffers.out_buffer = (unsigned char *)kmm_malloc(compression_header->blocksize);
+		buffers.out_buffer = (unsigned char *)kmm_malloc(compression_header->blocksize * CONFIG_COMPRESSION_CACHE_BLOCKS);
 	}
 #elif CONFIG_COMPRESSION_TYPE == MINIZ
 	/* Allocating memory for read and out buffer to be used for Miniz decompression */
 	if (compression_header->compression_format == COMPRESSION_TYPE_MINIZ) {
 		buffers.read_buffer = (unsigned char *)kmm_malloc(compression_header->blocksize);
-		buffers.out_buffer = (unsigned char *)kmm_malloc(compression_header->blocksize);
+		buffers.out_buffer = (unsigned char *)kmm_malloc(compression_header->blocksize * CONFIG_COMPRESSION_CACHE_BLOCKS);
 	}
 #endif
+	if (!buffers.read_buffer || !buffers.out_buffer) {
+		bcmpdbg("Failed kmm_malloc for decompression buffers\n");
+		ret = -ENOMEM;
+		goto error_compress_init;
+	}
+
+	/* The out buffer is divided into the blocks of the block cache */
+	for (index = 0; index < CONFIG_COMPRESSION_CACHE_BLOCKS; index++) {
+		cached_blocks[index].block_number = -1;
+		cached_blocks[index].stamp = 0;
+		cached_blocks[index].data = &buffers.out_buffer[index * compression_header->blocksize];
+	}
+
+	cache_stamp = 0;
 
 error_compress_init:
 	return ret;
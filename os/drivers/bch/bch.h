@@ -68,21 +68,55 @@
  ****************************************************************************/
 #define bchlib_semgive(d)	sem_post(&(d)->sem)	/* To match bchlib_semtake */
 #define MAX_OPENCNT			(255)				/* Limit of uint8_t */
+#define BCH_NOSECTOR		((size_t)-1)		/* Cache entry holds no sector */
+
+#ifndef CONFIG_BCH_CACHE_SECTORS
+#define CONFIG_BCH_CACHE_SECTORS	1
+#endif
+
+#ifndef CONFIG_BCH_READAHEAD
+#define CONFIG_BCH_READAHEAD	0
+#endif
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BCH)
+#define BCH_HAVE_PROCFS		1
+#endif
 
 /****************************************************************************
  * Public Types
  ****************************************************************************/
+struct bch_cache_s {
+	size_t sector;				/* The sector in the buffer or BCH_NOSECTOR */
+	uint32_t stamp;				/* Last access, the oldest entry is reused first */
+	bool dirty;					/* true: Data has been written to the buffer */
+	FAR uint8_t *buffer;		/* One sector buffer */
+};
+
 struct bchlib_s {
 	FAR struct inode *inode;	/* I-node of the block driver */
 	uint32_t sectsize;			/* The size of one sector on the device */
 	size_t nsectors;			/* Number of sectors supported by the device */
-	size_t sector;				/* The current sector in the buffer */
+	size_t lastsector;			/* The last sector read into the cache */
 	sem_t sem;					/* For atomic accesses to this structure */
 	uint8_t refs;				/* Number of references */
-	bool dirty;					/* true: Data has been written to the buffer */
 	bool readonly;				/* true: Only read operations are supported */
 	bool unlinked;				/* true: The driver has been unlinked */
-	FAR uint8_t *buffer;		/* One sector buffer */
+	FAR uint8_t *buffer;		/* Buffers of all cache entries */
+	FAR struct bch_cache_s *current;	/* The entry of the current sector */
+	uint32_t stamp;				/* Access counter for the cache entries */
+	struct bch_cache_s cache[CONFIG_BCH_CACHE_SECTORS];
+
+	/* Cache statistics */
+
+	uint32_t hits;				/* Sectors found in the cache */
+	uint32_t misses;			/* Sectors read from the device */
+	uint32_t readaheads;		/* Sectors read ahead of a sequential miss */
+	uint32_t writebacks;		/* Dirty sectors written to the device */
+
+#ifdef BCH_HAVE_PROCFS
+	FAR char *name;				/* Path of the block driver */
+	FAR struct bchlib_s *flink;	/* Next registered BCH device */
+#endif
 
 #if defined(CONFIG_BCH_ENCRYPTION)
 	uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];	/* Encryption key */
@@ -108,6 +142,12 @@ EXTERN const struct file_operations bch_fops;
 EXTERN void bchlib_semtake(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+EXTERN int  bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector, size_t nsectors);
+EXTERN void bchlib_discardrange(FAR struct bchlib_s *bch, size_t sector, size_t nsectors);
+#ifdef BCH_HAVE_PROCFS
+EXTERN void bch_procfs_register(FAR struct bchlib_s *bch);
+EXTERN void bch_procfs_unregister(FAR struct bchlib_s *bch);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
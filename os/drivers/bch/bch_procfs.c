@@ -0,0 +1,337 @@
+/****************************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * drivers/bch/bch_procfs.c
+ *
+ * Cache statistics of the BCH devices in /proc/bch
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#include "bch.h"
+
+#ifdef BCH_HAVE_PROCFS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BCH_LINELEN 96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+/* This structure describes one open "file" */
+
+struct bch_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	char line[BCH_LINELEN];		/* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+/* File system methods */
+
+static int bch_procfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int bch_procfs_close(FAR struct file *filep);
+static ssize_t bch_procfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int bch_procfs_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int bch_procfs_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations bch_procfsoperations = {
+	bch_procfs_open,			/* open */
+	bch_procfs_close,			/* close */
+	bch_procfs_read,			/* read */
+	NULL,						/* write */
+
+	bch_procfs_dup,				/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	bch_procfs_stat				/* stat */
+};
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+/* The list of set-up BCH devices */
+
+static FAR struct bchlib_s *g_bchhead;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bch_procfs_open
+ ****************************************************************************/
+
+static int bch_procfs_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct bch_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only.  Any attempt to open with any kind of write
+	 * access is not permitted.
+	 */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	/* "bch" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "bch") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* Allocate a container to hold the file attributes */
+
+	attr = (FAR struct bch_file_s *)kmm_zalloc(sizeof(struct bch_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Save the attributes as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: bch_procfs_close
+ ****************************************************************************/
+
+static int bch_procfs_close(FAR struct file *filep)
+{
+	FAR struct bch_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct bch_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: bch_procfs_read
+ ****************************************************************************/
+
+static ssize_t bch_procfs_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct bch_file_s *attr;
+	FAR struct bchlib_s *bch;
+	size_t linesize;
+	size_t copysize;
+	size_t totalsize;
+	off_t offset;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct bch_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Output a header and then one line per device, skipping the lines that
+	 * were returned by earlier reads.
+	 */
+
+	offset = filep->f_pos;
+	linesize = snprintf(attr->line, BCH_LINELEN, "%-16s%8s%10s%10s%10s%10s\n",
+						"Device", "Cached", "Hits", "Misses", "Ahead", "Written");
+	totalsize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+	/* The list may not change while it is walked */
+
+	sched_lock();
+	for (bch = g_bchhead; bch != NULL && totalsize < buflen; bch = bch->flink) {
+		linesize = snprintf(attr->line, BCH_LINELEN, "%-16s%8d%10u%10u%10u%10u\n",
+							bch->name, CONFIG_BCH_CACHE_SECTORS,
+							(unsigned int)bch->hits, (unsigned int)bch->misses,
+							(unsigned int)bch->readaheads, (unsigned int)bch->writebacks);
+		copysize = procfs_memcpy(attr->line, linesize, &buffer[totalsize], buflen - totalsize, &offset);
+		totalsize += copysize;
+	}
+
+	sched_unlock();
+
+	/* Update the file offset */
+
+	if (totalsize > 0) {
+		filep->f_pos += totalsize;
+	}
+
+	return totalsize;
+}
+
+/****************************************************************************
+ * Name: bch_procfs_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int bch_procfs_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct bch_file_s *oldattr;
+	FAR struct bch_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct bch_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the task and attribute selection */
+
+	newattr = (FAR struct bch_file_s *)kmm_zalloc(sizeof(struct bch_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* The copy the file attributes from the old attributes to the new */
+
+	memcpy(newattr, oldattr, sizeof(struct bch_file_s));
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: bch_procfs_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int bch_procfs_stat(const char *relpath, struct stat *buf)
+{
+	/* "bch" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "bch") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* File/directory size, access block size */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bch_procfs_register
+ *
+ * Description:
+ *   Add a BCH device to the list shown in /proc/bch
+ *
+ ****************************************************************************/
+
+void bch_procfs_register(FAR struct bchlib_s *bch)
+{
+	sched_lock();
+	bch->flink = g_bchhead;
+	g_bchhead = bch;
+	sched_unlock();
+}
+
+/****************************************************************************
+ * Name: bch_procfs_unregister
+ *
+ * Description:
+ *   Remove a BCH device from the list shown in /proc/bch
+ *
+ ****************************************************************************/
+
+void bch_procfs_unregister(FAR struct bchlib_s *bch)
+{
+	FAR struct bchlib_s **pprev;
+
+	sched_lock();
+	for (pprev = &g_bchhead; *pprev != NULL; pprev = &(*pprev)->flink) {
+		if (*pprev == bch) {
+			*pprev = bch->flink;
+			break;
+		}
+	}
+
+	sched_unlock();
+}
+
+#endif							/* BCH_HAVE_PROCFS */
@@ -331,6 +331,22 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
 		bchlib_semgive(bch);
 	}
+	/* Is this a request to write the cached sectors to the media? */
+	else if (cmd == BIOC_FLUSH) {
+		FAR struct inode *bchinode = bch->inode;
+
+		bchlib_semtake(bch);
+		ret = bchlib_flushsector(bch);
+		bchlib_semgive(bch);
+
+		/* Then let the block driver flush its own buffers */
+		if (ret >= 0 && bchinode->u.i_bops->ioctl != NULL) {
+			ret = bchinode->u.i_bops->ioctl(bchinode, cmd, arg);
+			if (ret == -ENOTTY) {
+				ret = OK;
+			}
+		}
+	}
 #ifdef CONFIG_BCH_ENCRYPTION
 	/* Is this a request to set the encryption key? */
 	else if (cmd == DIOC_SETKEY) {
@@ -56,6 +56,7 @@
 #include <tinyara/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <assert.h>
@@ -88,16 +89,16 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  * Name: bch_cypher
  ****************************************************************************/
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR struct bch_cache_s *entry, int encrypt)
 {
 	int blocks = bch->sectsize / 16;
-	FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+	FAR uint32_t *buffer = (FAR uint32_t *)entry->buffer;
 	int i;
 
 	for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t)) {
 		uint32_t T[4];
 		uint32_t X[4] = {
-			bch->sector, 0, 0, i
+			entry->sector, 0, 0, i
 		};
 
 		aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -115,19 +116,13 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 #endif
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-/****************************************************************************
- * Name: bchlib_flushsector
+ * Name: bch_writeentry
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
- *
- * Assumptions:
- *   Caller must assume mutual exclusion
+ *   Write one cache entry back to the media if it is dirty
  *
  ****************************************************************************/
-int bchlib_flushsector(FAR struct bchlib_s *bch)
+static int bch_writeentry(FAR struct bchlib_s *bch, FAR struct bch_cache_s *entry)
 {
 	FAR struct inode *inode;
 	ssize_t ret = OK;
@@ -136,18 +131,18 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 	 * Check if the sector has been modified and is out of sync with the
 	 * media.
 	 */
-	if (bch->dirty) {
+	if (entry->dirty) {
 		inode = bch->inode;
 
 #if defined(CONFIG_BCH_ENCRYPTION)
 		/* Encrypt data as necessary */
-		bch_cypher(bch, CYPHER_ENCRYPT);
+		bch_cypher(bch, entry, CYPHER_ENCRYPT);
 #endif
 
 		/* Write the sector to the media */
-		ret = inode->u.i_bops->write(inode, bch->buffer, bch->sector, 1);
+		ret = inode->u.i_bops->write(inode, entry->buffer, entry->sector, 1);
 		if (ret < 0) {
-			fdbg("Write failed: %d\n");
+			fdbg("Write failed: %d\n", ret);
 		}
 
 #if defined(CONFIG_BCH_ENCRYPTION)
@@ -155,21 +150,168 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 		 * Computation overhead to save memory for extra sector buffer
 		 * TODO: Add configuration switch for extra sector buffer
 		 */
-		bch_cypher(bch, CYPHER_DECRYPT);
+		bch_cypher(bch, entry, CYPHER_DECRYPT);
 #endif
 
 		/* The sector is now in sync with the media */
-		bch->dirty = false;
+		entry->dirty = false;
+		bch->writebacks++;
 	}
 
 	return (int)ret;
 }
 
+/****************************************************************************
+ * Name: bch_findentry
+ *
+ * Description:
+ *   Return the cache entry holding 'sector' or NULL if it is not cached
+ *
+ ****************************************************************************/
+static FAR struct bch_cache_s *bch_findentry(FAR struct bchlib_s *bch, size_t sector)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_BCH_CACHE_SECTORS; i++) {
+		if (bch->cache[i].sector == sector) {
+			return &bch->cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: bch_reuseentries
+ *
+ * Description:
+ *   Select 'count' adjacent cache entries, so that they can be filled with
+ *   a single read, whose most recent access is the oldest.  Dirty entries
+ *   are written back and all of them are emptied.
+ *
+ ****************************************************************************/
+static FAR struct bch_cache_s *bch_reuseentries(FAR struct bchlib_s *bch, int count)
+{
+	FAR struct bch_cache_s *entry;
+	uint32_t newest;
+	uint32_t oldest = UINT32_MAX;
+	int first = 0;
+	int i;
+	int j;
+
+	for (i = 0; i + count <= CONFIG_BCH_CACHE_SECTORS; i++) {
+		newest = 0;
+		for (j = i; j < i + count; j++) {
+			if (bch->cache[j].sector != BCH_NOSECTOR && bch->cache[j].stamp > newest) {
+				newest = bch->cache[j].stamp;
+			}
+		}
+
+		if (newest < oldest) {
+			oldest = newest;
+			first = i;
+		}
+	}
+
+	entry = &bch->cache[first];
+	for (i = 0; i < count; i++) {
+		(void)bch_writeentry(bch, &entry[i]);
+		entry[i].sector = BCH_NOSECTOR;
+	}
+
+	return entry;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+/****************************************************************************
+ * Name: bchlib_flushsector
+ *
+ * Description:
+ *   Flush the contents of all dirty sectors in the cache
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+int bchlib_flushsector(FAR struct bchlib_s *bch)
+{
+	int ret = OK;
+	int i;
+
+	for (i = 0; i < CONFIG_BCH_CACHE_SECTORS; i++) {
+		int result = bch_writeentry(bch, &bch->cache[i]);
+		if (result < 0) {
+			ret = result;
+		}
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: bchlib_flushrange
+ *
+ * Description:
+ *   Flush the dirty cached sectors in a range before it is read directly
+ *   from the media
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+int bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector, size_t nsectors)
+{
+	FAR struct bch_cache_s *entry;
+	int ret = OK;
+	int i;
+
+	for (i = 0; i < CONFIG_BCH_CACHE_SECTORS; i++) {
+		entry = &bch->cache[i];
+		if (entry->dirty && entry->sector >= sector && entry->sector - sector < nsectors) {
+			int result = bch_writeentry(bch, entry);
+			if (result < 0) {
+				ret = result;
+			}
+		}
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: bchlib_discardrange
+ *
+ * Description:
+ *   Drop the cached sectors in a range after it was written directly to
+ *   the media
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+void bchlib_discardrange(FAR struct bchlib_s *bch, size_t sector, size_t nsectors)
+{
+	FAR struct bch_cache_s *entry;
+	int i;
+
+	for (i = 0; i < CONFIG_BCH_CACHE_SECTORS; i++) {
+		entry = &bch->cache[i];
+		if (entry->sector != BCH_NOSECTOR && entry->sector >= sector && entry->sector - sector < nsectors) {
+			entry->sector = BCH_NOSECTOR;
+			entry->dirty = false;
+		}
+	}
+}
+
 /****************************************************************************
  * Name: bchlib_readsector
  *
  * Description:
- *   Flush the current contents of the sector buffer (if dirty)
+ *   Make 'sector' the current sector, reading it into the cache if it is not
+ *   already there.  A miss on the sector after the last one read also reads
+ *   up to CONFIG_BCH_READAHEAD following sectors with the same request.
  *
  * Assumptions:
  *   Caller must assume mutual exclusion
@@ -178,23 +320,52 @@ int bchlib_flushsector(FAR struct bchlib_s *bch)
 int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 {
 	FAR struct inode *inode;
-	ssize_t ret = OK;
+	FAR struct bch_cache_s *entry;
+	ssize_t ret;
+	int count = 1;
+	int i;
 
-	if (bch->sector != sector) {
+	entry = bch_findentry(bch, sector);
+	if (entry != NULL) {
+		bch->hits++;
+	} else {
 		inode = bch->inode;
 
-		(void)bchlib_flushsector(bch);
-		bch->sector = (size_t)-1;
+#if CONFIG_BCH_READAHEAD > 0
+		/* Read ahead on sequential access, but only up to the next sector
+		 * that is already cached.
+		 */
+		if (sector == bch->lastsector + 1) {
+			while (count <= CONFIG_BCH_READAHEAD && count < CONFIG_BCH_CACHE_SECTORS &&
+				   sector + count < bch->nsectors && bch_findentry(bch, sector + count) == NULL) {
+				count++;
+			}
+		}
+#endif
+
+		entry = bch_reuseentries(bch, count);
 
-		ret = inode->u.i_bops->read(inode, bch->buffer, sector, 1);
+		ret = inode->u.i_bops->read(inode, entry->buffer, sector, count);
 		if (ret < 0) {
-			fdbg("Read failed: %d\n");
+			fdbg("Read failed: %d\n", ret);
+			return (int)ret;
 		}
-		bch->sector = sector;
+
+		/* Older stamps for the sectors read ahead than for the current one */
+		for (i = count - 1; i >= 0; i--) {
+			entry[i].sector = sector + i;
+			entry[i].stamp = ++bch->stamp;
 #if defined(CONFIG_BCH_ENCRYPTION)
-		bch_cypher(bch, CYPHER_DECRYPT);
+			bch_cypher(bch, &entry[i], CYPHER_DECRYPT);
 #endif
+		}
+
+		bch->misses++;
+		bch->readaheads += count - 1;
+		bch->lastsector = sector + count - 1;
 	}
-	return (int)ret;
-}
 
+	entry->stamp = ++bch->stamp;
+	bch->current = entry;
+	return OK;
+}
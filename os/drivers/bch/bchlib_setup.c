@@ -61,6 +61,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -87,6 +88,7 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
 	FAR struct bchlib_s *bch;
 	struct geometry geo;
 	int ret;
+	int i;
 
 	DEBUGASSERT(blkdev);
 
@@ -128,20 +130,46 @@ int bchlib_setup(const char *blkdev, bool readonly, FAR void **handle)
 	sem_init(&bch->sem, 0, 1);
 	bch->nsectors = geo.geo_nsectors;
 	bch->sectsize = geo.geo_sectorsize;
-	bch->sector   = (size_t)-1;
+	bch->lastsector = BCH_NOSECTOR;
 	bch->readonly = readonly;
 
-	/* Allocate the sector I/O buffer */
-	bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize);
+	/* Allocate the sector I/O buffers of the cache as one block, so that
+	 * adjacent entries can be filled with a single read.
+	 */
+	bch->buffer = (FAR uint8_t *)kmm_malloc(bch->sectsize * CONFIG_BCH_CACHE_SECTORS);
 	if (!bch->buffer) {
 		fdbg("ERROR: Failed to allocate sector buffer\n");
 		ret = -ENOMEM;
 		goto errout_with_bch;
 	}
 
+	for (i = 0; i < CONFIG_BCH_CACHE_SECTORS; i++) {
+		bch->cache[i].sector = BCH_NOSECTOR;
+		bch->cache[i].buffer = &bch->buffer[i * bch->sectsize];
+	}
+
+	bch->current = &bch->cache[0];
+
+#ifdef BCH_HAVE_PROCFS
+	/* Keep the name of the block driver for the procfs statistics */
+	bch->name = (FAR char *)kmm_malloc(strlen(blkdev) + 1);
+	if (!bch->name) {
+		fdbg("ERROR: Failed to allocate name\n");
+		ret = -ENOMEM;
+		goto errout_with_buffer;
+	}
+
+	strcpy(bch->name, blkdev);
+	bch_procfs_register(bch);
+#endif
+
 	*handle = bch;
 	return OK;
 
+#ifdef BCH_HAVE_PROCFS
+errout_with_buffer:
+	kmm_free(bch->buffer);
+#endif
 errout_with_bch:
 	kmm_free(bch);
 	return ret;
@@ -87,6 +87,10 @@ int bchlib_teardown(FAR void *handle)
 		return -EBUSY;
 	}
 
+#ifdef BCH_HAVE_PROCFS
+	bch_procfs_unregister(bch);
+#endif
+
 	/* Flush any pending data to the block driver */
 	bchlib_flushsector(bch);
 
@@ -98,6 +102,12 @@ int bchlib_teardown(FAR void *handle)
 		kmm_free(bch->buffer);
 	}
 
+#ifdef BCH_HAVE_PROCFS
+	if (bch->name) {
+		kmm_free(bch->name);
+	}
+#endif
+
 	sem_destroy(&bch->sem);
 	kmm_free(bch);
 	return OK;
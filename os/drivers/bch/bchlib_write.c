@@ -107,7 +107,10 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 	byteswritten = 0;
 	if (sectoffset > 0) {
 		/* Read the full sector into the sector buffer */
-		bchlib_readsector(bch, sector);
+		ret = bchlib_readsector(bch, sector);
+		if (ret < 0) {
+			return ret;
+		}
 
 		/* Copy the tail end of the sector from the user buffer */
 		if (sectoffset + len > bch->sectsize) {
@@ -116,8 +119,8 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 			nbytes = len;
 		}
 
-		memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-		bch->dirty = true;
+		memcpy(&bch->current->buffer[sectoffset], buffer, nbytes);
+		bch->current->dirty = true;
 
 		/* Adjust pointers and counts */
 		sector++;
@@ -149,6 +152,9 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 			return ret;
 		}
 
+		/* Any cached copies of these sectors are stale now */
+		bchlib_discardrange(bch, sector, nsectors);
+
 		/* Adjust pointers and counts */
 		sector       += nsectors;
 		nbytes        = nsectors * bch->sectsize;
@@ -165,22 +171,27 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset, si
 	/* Then write any partial final sector */
 	if (len > 0) {
 		/* Read the sector into the sector buffer */
-		bchlib_readsector(bch, sector);
+		ret = bchlib_readsector(bch, sector);
+		if (ret < 0) {
+			return ret;
+		}
 
 		/* Copy the head end of the sector from the user buffer */
-		memcpy(bch->buffer, buffer, len);
-		bch->dirty = true;
+		memcpy(bch->current->buffer, buffer, len);
+		bch->current->dirty = true;
 
 		/* Adjust counts */
 		byteswritten += len;
 	}
 
+#ifndef CONFIG_BCH_WRITEBACK
 	/* Finally, flush any cached writes to the device as well */
 	ret = bchlib_flushsector(bch);
 	if (ret < 0) {
 		fdbg("ERROR: Flush failed: %d\n", ret);
 		return ret;
 	}
+#endif
 
 	return byteswritten;
 }
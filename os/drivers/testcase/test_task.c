@@ -91,7 +91,7 @@ static int test_task_init(main_t entry)
 	uint32_t *stack;
 	int ret;
 
-	tcb = (struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+	tcb = (struct task_tcb_s *)sched_tcballoc(TCB_FLAG_TTYPE_TASK);
 	if (!tcb) {
 		berr("Failed: no memory for tcb\n");
 		return -ENOMEM;
@@ -139,7 +139,7 @@ errout_with_stack:
 	kumm_free(stack);
 
 errout_with_tcb:
-	kmm_free(tcb);
+	sched_tcbfree((struct tcb_s *)tcb, TCB_FLAG_TTYPE_TASK);
 	return ret;
 }
 
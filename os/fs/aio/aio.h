@@ -90,6 +90,46 @@
 #error AIO needs file and/or socket descriptors
 #endif
 
+#if !defined(CONFIG_FS_AIO_POOL) && !defined(CONFIG_SCHED_LPWORK)
+#error AIO needs the low priority work queue or CONFIG_FS_AIO_POOL
+#endif
+
+/* The low priority work queue runs each request at the priority of the
+ * requester.  The AIO worker threads boost themselves instead.
+ */
+
+#if defined(CONFIG_PRIORITY_INHERITANCE) && !defined(CONFIG_FS_AIO_POOL)
+#define AIO_BOOST_LPWORK 1
+#endif
+
+#ifdef CONFIG_FS_AIO_POOL
+#ifndef CONFIG_FS_AIO_NTHREADS
+#define CONFIG_FS_AIO_NTHREADS 2
+#endif
+
+#ifndef CONFIG_FS_AIO_PRIORITY
+#define CONFIG_FS_AIO_PRIORITY 50
+#endif
+
+#ifndef CONFIG_FS_AIO_STACKSIZE
+#define CONFIG_FS_AIO_STACKSIZE 2048
+#endif
+
+#ifndef CONFIG_FS_AIO_MAXBATCH
+#define CONFIG_FS_AIO_MAXBATCH 8
+#endif
+
+#ifndef CONFIG_FS_AIO_BOUNCE_SIZE
+#define CONFIG_FS_AIO_BOUNCE_SIZE 0
+#endif
+
+/* States of a container on the pending list */
+
+#define AIOC_CONTAINED  0		/* Not yet given to the worker threads */
+#define AIOC_QUEUED     1		/* Waiting for a worker thread */
+#define AIOC_STARTED    2		/* Taken by a worker thread */
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -108,7 +148,13 @@ struct aio_container_s {
 #endif
 		FAR void *ptr;			/* Generic pointer to FAR data */
 	} u;
+#ifdef CONFIG_FS_AIO_POOL
+	worker_t aioc_worker;		/* Performs the I/O of this request alone */
+	uint8_t aioc_state;			/* See AIOC_* definitions */
+	uint8_t aioc_opcode;		/* LIO_READ and LIO_WRITE may be merged */
+#else
 	struct work_s aioc_work;	/* Used to defer I/O to the work thread */
+#endif
 	pid_t aioc_pid;				/* ID of the waiting task */
 #ifdef CONFIG_PRIORITY_INHERITANCE
 	uint8_t aioc_prio;			/* Priority of the waiting task */
@@ -250,7 +296,8 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the low priority work queue or on the
+ *   AIO worker threads
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -264,6 +311,58 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove an asynchronous I/O that has not been started from the queue of
+ *   its worker thread.  The caller holds the lock on the pending list.
+ *
+ * Input Parameters:
+ *   aioc - The container of the I/O
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O will not be performed.  Otherwise, a negated errno
+ *   value is returned and the I/O is (or soon will be) in progress.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc);
+
+#ifdef CONFIG_FS_AIO_POOL
+/****************************************************************************
+ * Name: aio_pool_start
+ *
+ * Description:
+ *   Start the AIO worker threads, if they have not been started yet
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int aio_pool_start(void);
+
+/****************************************************************************
+ * Name: aio_pool_post
+ *
+ * Description:
+ *   Wake up one AIO worker thread for a newly queued request
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aio_pool_post(void);
+#endif
+
 /****************************************************************************
  * Name: aio_signal
  *
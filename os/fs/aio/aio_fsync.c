@@ -109,8 +109,11 @@ static void aio_fsync_worker(FAR void *arg)
 {
 	FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
 	FAR struct aiocb *aiocbp;
+#ifdef AIO_HAVE_FILEP
+	FAR struct file *filep;
+#endif
 	pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_BOOST_LPWORK
 	uint8_t prio;
 #endif
 	int ret;
@@ -122,14 +125,17 @@ static void aio_fsync_worker(FAR void *arg)
 
 	DEBUGASSERT(aioc && aioc->aioc_aiocbp);
 	pid = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_BOOST_LPWORK
 	prio = aioc->aioc_prio;
+#endif
+#ifdef AIO_HAVE_FILEP
+	filep = aioc->u.aioc_filep;
 #endif
 	aiocbp = aioc_decant(aioc);
 
 	/* Perform the fsync using u.aioc_filep */
 
-	ret = file_fsync(aioc->u.aioc_filep);
+	ret = file_fsync(filep);
 	if (ret < 0) {
 		int errcode = get_errno();
 		fdbg("ERROR: fsync failed: %d\n", errcode);
@@ -143,7 +149,7 @@ static void aio_fsync_worker(FAR void *arg)
 
 	(void)aio_signal(pid, aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_BOOST_LPWORK
 	/* Restore the low priority worker thread default priority */
 
 	lpwork_restorepriority(prio);
@@ -0,0 +1,478 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/aio/aio_pool.c
+ *
+ * Worker threads that perform the asynchronous I/O, merging requests for
+ * adjacent parts of a file into one transfer
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <aio.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/kthread.h>
+#include <tinyara/fs/fs.h>
+
+#include "aio/aio.h"
+
+#if defined(CONFIG_FS_AIO) && defined(CONFIG_FS_AIO_POOL)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A set of requests merged into one transfer, in the order of their file
+ * offsets
+ */
+
+struct aio_batch_s {
+	FAR struct file *filep;		/* The file of all requests */
+	uint8_t opcode;				/* LIO_READ or LIO_WRITE */
+	bool contig;				/* true: The user buffers follow each other */
+	int count;					/* Number of requests */
+	size_t nbytes;				/* Total length of the transfer */
+	FAR struct aio_container_s *aioc[CONFIG_FS_AIO_MAXBATCH];
+	FAR struct aiocb *aiocbp[CONFIG_FS_AIO_MAXBATCH];
+	pid_t pid[CONFIG_FS_AIO_MAXBATCH];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* This counting semaphore is posted once for each queued request */
+
+static sem_t g_aio_poolsem;
+
+/* The file each worker thread is working on.  The requests for one file are
+ * performed one at a time and in order.  Protected by aio_lock().
+ */
+
+static FAR struct file *g_aio_active[CONFIG_FS_AIO_NTHREADS];
+
+static bool g_aio_started;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_take
+ *
+ * Description:
+ *   Take the oldest queued request for a file that no other worker thread
+ *   is working on.  The caller holds the lock on the pending list.
+ *
+ ****************************************************************************/
+
+static FAR struct aio_container_s *aio_take(int index)
+{
+	FAR struct aio_container_s *aioc;
+	int i;
+
+	for (aioc = (FAR struct aio_container_s *)g_aio_pending.head; aioc; aioc = (FAR struct aio_container_s *)aioc->aioc_link.flink) {
+		if (aioc->aioc_state != AIOC_QUEUED) {
+			continue;
+		}
+
+		for (i = 0; i < CONFIG_FS_AIO_NTHREADS; i++) {
+			if (g_aio_active[i] == aioc->u.aioc_filep) {
+				break;
+			}
+		}
+
+		if (i == CONFIG_FS_AIO_NTHREADS) {
+			aioc->aioc_state = AIOC_STARTED;
+			g_aio_active[index] = aioc->u.aioc_filep;
+			return aioc;
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: aio_mergeable
+ *
+ * Description:
+ *   Return true if the request may be part of a merged transfer
+ *
+ ****************************************************************************/
+
+static bool aio_mergeable(FAR struct aio_container_s *aioc)
+{
+	if (aioc->aioc_opcode != LIO_READ && aioc->aioc_opcode != LIO_WRITE) {
+		return false;
+	}
+
+	/* Appending writes go to the end of the file, not to aio_offset */
+
+	if (aioc->aioc_opcode == LIO_WRITE && (aioc->u.aioc_filep->f_oflags & O_APPEND) != 0) {
+		return false;
+	}
+
+	return aioc->aioc_aiocbp->aio_nbytes > 0;
+}
+
+/****************************************************************************
+ * Name: aio_gather
+ *
+ * Description:
+ *   Add the requests queued after the first one of 'batch' for the same file
+ *   while each continues the transfer at either end.  Stopping at the first
+ *   one that does not keeps the requests for a file in their queued order.
+ *   Requests whose user buffers do not follow each other are only added
+ *   while the whole transfer fits in the bounce buffer.  The caller holds
+ *   the lock on the pending list.
+ *
+ ****************************************************************************/
+
+static void aio_gather(FAR struct aio_batch_s *batch, size_t bouncesize)
+{
+	FAR struct aio_container_s *aioc;
+	FAR struct aiocb *first;
+	FAR struct aiocb *last;
+	FAR struct aiocb *aiocbp;
+	bool contig;
+
+	aioc = (FAR struct aio_container_s *)batch->aioc[0]->aioc_link.flink;
+	for (; aioc && batch->count < CONFIG_FS_AIO_MAXBATCH; aioc = (FAR struct aio_container_s *)aioc->aioc_link.flink) {
+		if (aioc->aioc_state != AIOC_QUEUED || aioc->u.aioc_filep != batch->filep) {
+			continue;
+		}
+
+		if (aioc->aioc_opcode != batch->opcode || !aio_mergeable(aioc)) {
+			break;
+		}
+
+		aiocbp = aioc->aioc_aiocbp;
+		first = batch->aioc[0]->aioc_aiocbp;
+		last = batch->aioc[batch->count - 1]->aioc_aiocbp;
+
+		if (aiocbp->aio_offset == last->aio_offset + (off_t)last->aio_nbytes) {
+			/* Continues the transfer after its end */
+
+			contig = batch->contig && (FAR uint8_t *)last->aio_buf + last->aio_nbytes == (FAR uint8_t *)aiocbp->aio_buf;
+			if (!contig && batch->nbytes + aiocbp->aio_nbytes > bouncesize) {
+				break;
+			}
+
+			batch->aioc[batch->count] = aioc;
+		} else if (aiocbp->aio_offset + (off_t)aiocbp->aio_nbytes == first->aio_offset) {
+			/* Continues the transfer before its start */
+
+			contig = batch->contig && (FAR uint8_t *)aiocbp->aio_buf + aiocbp->aio_nbytes == (FAR uint8_t *)first->aio_buf;
+			if (!contig && batch->nbytes + aiocbp->aio_nbytes > bouncesize) {
+				break;
+			}
+
+			memmove(&batch->aioc[1], &batch->aioc[0], batch->count * sizeof(batch->aioc[0]));
+			batch->aioc[0] = aioc;
+		} else {
+			break;
+		}
+
+		aioc->aioc_state = AIOC_STARTED;
+		batch->contig = contig;
+		batch->nbytes += aiocbp->aio_nbytes;
+		batch->count++;
+	}
+}
+
+/****************************************************************************
+ * Name: aio_transfer
+ *
+ * Description:
+ *   Perform the merged transfer of a batch and complete all of its requests
+ *
+ ****************************************************************************/
+
+static void aio_transfer(FAR struct aio_batch_s *batch, FAR uint8_t *bounce)
+{
+	FAR struct aiocb *aiocbp;
+	FAR uint8_t *buffer;
+	off_t offset;
+	size_t remaining;
+	size_t pos;
+	size_t nbytes;
+	ssize_t result;
+	int i;
+
+	offset = batch->aiocbp[0]->aio_offset;
+	buffer = batch->contig ? (FAR uint8_t *)batch->aiocbp[0]->aio_buf : bounce;
+
+	if (batch->opcode == LIO_WRITE) {
+		if (!batch->contig) {
+			for (i = 0, pos = 0; i < batch->count; pos += batch->aiocbp[i]->aio_nbytes, i++) {
+				memcpy(&bounce[pos], (FAR const void *)batch->aiocbp[i]->aio_buf, batch->aiocbp[i]->aio_nbytes);
+			}
+		}
+
+		result = file_pwrite(batch->filep, buffer, batch->nbytes, offset);
+	} else {
+		result = file_pread(batch->filep, buffer, batch->nbytes, offset);
+	}
+
+	if (result < 0) {
+		int errcode = get_errno();
+		fdbg("ERROR: merged transfer failed: %d\n", errcode);
+		DEBUGASSERT(errcode > 0);
+		result = -errcode;
+	}
+
+	/* A short transfer completes the requests at the start of the batch */
+
+	remaining = result < 0 ? 0 : (size_t)result;
+	for (i = 0, pos = 0; i < batch->count; i++) {
+		aiocbp = batch->aiocbp[i];
+
+		if (result < 0) {
+			aiocbp->aio_result = result;
+		} else {
+			nbytes = remaining < aiocbp->aio_nbytes ? remaining : aiocbp->aio_nbytes;
+			if (batch->opcode == LIO_READ && !batch->contig) {
+				memcpy((FAR void *)aiocbp->aio_buf, &bounce[pos], nbytes);
+			}
+
+			aiocbp->aio_result = nbytes;
+			remaining -= nbytes;
+		}
+
+		pos += aiocbp->aio_nbytes;
+		(void)aio_signal(batch->pid[i], aiocbp);
+	}
+}
+
+/****************************************************************************
+ * Name: aio_runone
+ *
+ * Description:
+ *   Take one request, with the requests adjacent to it if possible, and
+ *   perform it.  Returns false if there was no request to take.
+ *
+ ****************************************************************************/
+
+static bool aio_runone(int index, FAR uint8_t *bounce)
+{
+	FAR struct aio_container_s *aioc;
+	struct aio_batch_s batch;
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	struct sched_param param;
+	uint8_t prio;
+#endif
+	int i;
+
+	aio_lock();
+	aioc = aio_take(index);
+	if (!aioc) {
+		aio_unlock();
+		return false;
+	}
+
+	batch.filep = aioc->u.aioc_filep;
+	batch.opcode = aioc->aioc_opcode;
+	batch.contig = true;
+	batch.count = 1;
+	batch.nbytes = aioc->aioc_aiocbp->aio_nbytes;
+	batch.aioc[0] = aioc;
+
+	if (aio_mergeable(aioc)) {
+		aio_gather(&batch, bounce ? CONFIG_FS_AIO_BOUNCE_SIZE : 0);
+	}
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	/* Run at the priority of the most important requester */
+
+	prio = CONFIG_FS_AIO_PRIORITY;
+	for (i = 0; i < batch.count; i++) {
+		if (batch.aioc[i]->aioc_prio > prio) {
+			prio = batch.aioc[i]->aioc_prio;
+		}
+	}
+
+	if (prio != CONFIG_FS_AIO_PRIORITY) {
+		param.sched_priority = prio;
+		(void)sched_setparam(0, &param);
+	}
+#endif
+
+	if (batch.count > 1) {
+		/* Decant all of the merged requests before starting the I/O */
+
+		for (i = 0; i < batch.count; i++) {
+			batch.pid[i] = batch.aioc[i]->aioc_pid;
+			batch.aiocbp[i] = aioc_decant(batch.aioc[i]);
+		}
+
+		aio_unlock();
+		aio_transfer(&batch, bounce);
+	} else {
+		/* A request on its own is performed by its usual worker */
+
+		aio_unlock();
+		aioc->aioc_worker(aioc);
+	}
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+	if (prio != CONFIG_FS_AIO_PRIORITY) {
+		param.sched_priority = CONFIG_FS_AIO_PRIORITY;
+		(void)sched_setparam(0, &param);
+	}
+#endif
+
+	aio_lock();
+	g_aio_active[index] = NULL;
+	aio_unlock();
+	return true;
+}
+
+/****************************************************************************
+ * Name: aio_pool_thread
+ *
+ * Description:
+ *   The body of an AIO worker thread.  argv[1] is its index.
+ *
+ ****************************************************************************/
+
+static int aio_pool_thread(int argc, FAR char *argv[])
+{
+	FAR uint8_t *bounce = NULL;
+	int index;
+
+	DEBUGASSERT(argc > 1);
+	index = atoi(argv[1]);
+
+#if CONFIG_FS_AIO_BOUNCE_SIZE > 0
+	/* Without the bounce buffer only requests with adjacent buffers merge */
+
+	bounce = (FAR uint8_t *)kmm_malloc(CONFIG_FS_AIO_BOUNCE_SIZE);
+	if (!bounce) {
+		fdbg("ERROR: Failed to allocate bounce buffer\n");
+	}
+#endif
+
+	for (;;) {
+		while (sem_wait(&g_aio_poolsem) < 0) {
+			DEBUGASSERT(get_errno() == EINTR);
+		}
+
+		/* Keep going while there is work.  A request that another thread
+		 * skipped because this one was busy with the same file is taken
+		 * here.
+		 */
+
+		while (aio_runone(index, bounce)) ;
+	}
+
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_pool_start
+ *
+ * Description:
+ *   Start the AIO worker threads, if they have not been started yet
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int aio_pool_start(void)
+{
+	FAR char *argv[2];
+	char arg[8];
+	pid_t pid;
+	int ret = OK;
+	int i;
+
+	aio_lock();
+	if (!g_aio_started) {
+		(void)sem_init(&g_aio_poolsem, 0, 0);
+
+		for (i = 0; i < CONFIG_FS_AIO_NTHREADS; i++) {
+			snprintf(arg, sizeof(arg), "%d", i);
+			argv[0] = arg;
+			argv[1] = NULL;
+
+			pid = kernel_thread("aio", CONFIG_FS_AIO_PRIORITY, CONFIG_FS_AIO_STACKSIZE, aio_pool_thread, (FAR char *const *)argv);
+			if (pid < 0) {
+				ret = -get_errno();
+				fdbg("ERROR: Failed to start AIO thread %d: %d\n", i, ret);
+				break;
+			}
+		}
+
+		/* Go on with the threads that could be started */
+
+		if (i > 0) {
+			g_aio_started = true;
+			ret = OK;
+		}
+	}
+
+	aio_unlock();
+	return ret;
+}
+
+/****************************************************************************
+ * Name: aio_pool_post
+ *
+ * Description:
+ *   Wake up one AIO worker thread for a newly queued request
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aio_pool_post(void)
+{
+	sem_post(&g_aio_poolsem);
+}
+
+#endif							/* CONFIG_FS_AIO && CONFIG_FS_AIO_POOL */
@@ -91,7 +91,8 @@
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the low priority work queue or on the
+ *   AIO worker threads
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -103,6 +104,36 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_FS_AIO_POOL
+int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
+{
+	int ret;
+
+	/* Start the worker threads with the first request */
+
+	ret = aio_pool_start();
+	if (ret < 0) {
+		FAR struct aiocb *aiocbp = aioc_decant(aioc);
+		DEBUGASSERT(aiocbp);
+
+		aiocbp->aio_result = ret;
+		set_errno(-ret);
+		return ERROR;
+	}
+
+	/* The container is already on the pending list.  Let the worker threads
+	 * take it from there.
+	 */
+
+	aio_lock();
+	aioc->aioc_worker = worker;
+	aioc->aioc_state = AIOC_QUEUED;
+	aio_unlock();
+
+	aio_pool_post();
+	return OK;
+}
+#else
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 {
 	int ret;
@@ -137,5 +168,40 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 #endif
 	return ret;
 }
+#endif
+
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove an asynchronous I/O that has not been started from the queue of
+ *   its worker thread.  The caller holds the lock on the pending list.
+ *
+ * Input Parameters:
+ *   aioc - The container of the I/O
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O will not be performed.  Otherwise, a negated errno
+ *   value is returned and the I/O is (or soon will be) in progress.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc)
+{
+#ifdef CONFIG_FS_AIO_POOL
+	/* A worker thread only takes queued requests with the lock held, so a
+	 * request that is still queued can simply be decanted by the caller.
+	 */
+
+	return aioc->aioc_state == AIOC_STARTED ? -EBUSY : OK;
+#else
+	/* The work has either already been started and is no longer queued or
+	 * it is still in the work queue.  work_cancel() will return -ENOENT in
+	 * the first case.
+	 */
+
+	return work_cancel(LPWORK, &aioc->aioc_work);
+#endif
+}
 
 #endif							/* CONFIG_FS_AIO */
@@ -109,8 +109,11 @@ static void aio_read_worker(FAR void *arg)
 {
 	FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
 	FAR struct aiocb *aiocbp;
+#ifdef AIO_HAVE_FILEP
+	FAR struct file *filep;
+#endif
 	pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_BOOST_LPWORK
 	uint8_t prio;
 #endif
 	ssize_t nread = 0;
@@ -122,8 +125,11 @@ static void aio_read_worker(FAR void *arg)
 
 	DEBUGASSERT(aioc && aioc->aioc_aiocbp);
 	pid = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_BOOST_LPWORK
 	prio = aioc->aioc_prio;
+#endif
+#ifdef AIO_HAVE_FILEP
+	filep = aioc->u.aioc_filep;
 #endif
 	aiocbp = aioc_decant(aioc);
 
@@ -137,7 +143,7 @@ static void aio_read_worker(FAR void *arg)
 		 *   aio_offset   - File offset
 		 */
 
-		nread = file_pread(aioc->u.aioc_filep, (FAR void *)aiocbp->aio_buf, aiocbp->aio_nbytes, aiocbp->aio_offset);
+		nread = file_pread(filep, (FAR void *)aiocbp->aio_buf, aiocbp->aio_nbytes, aiocbp->aio_offset);
 	}
 #endif
 
@@ -156,7 +162,7 @@ static void aio_read_worker(FAR void *arg)
 
 	(void)aio_signal(pid, aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_BOOST_LPWORK
 	/* Restore the low priority worker thread default priority */
 
 	lpwork_restorepriority(prio);
@@ -287,6 +293,12 @@ int aio_read(FAR struct aiocb *aiocbp)
 		return ERROR;
 	}
 
+#ifdef CONFIG_FS_AIO_POOL
+	/* Let the AIO worker threads merge this with adjacent reads */
+
+	aioc->aioc_opcode = LIO_READ;
+
+#endif
 	/* Defer the work to the worker thread */
 
 	ret = aio_queue(aioc, aio_read_worker);
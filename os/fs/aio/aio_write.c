@@ -126,8 +126,11 @@ static void aio_write_worker(FAR void *arg)
 {
 	FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
 	FAR struct aiocb *aiocbp;
+#ifdef AIO_HAVE_FILEP
+	FAR struct file *filep;
+#endif
 	pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_BOOST_LPWORK
 	uint8_t prio;
 #endif
 	ssize_t nwritten = 0;
@@ -142,8 +145,11 @@ static void aio_write_worker(FAR void *arg)
 
 	DEBUGASSERT(aioc && aioc->aioc_aiocbp);
 	pid = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_BOOST_LPWORK
 	prio = aioc->aioc_prio;
+#endif
+#ifdef AIO_HAVE_FILEP
+	filep = aioc->u.aioc_filep;
 #endif
 	aiocbp = aioc_decant(aioc);
 
@@ -151,7 +157,7 @@ static void aio_write_worker(FAR void *arg)
 	{
 		/* Call fcntl(F_GETFL) to get the file open mode. */
 
-		oflags = file_fcntl(aioc->u.aioc_filep, F_GETFL);
+		oflags = file_fcntl(filep, F_GETFL);
 		if (oflags < 0) {
 			int errcode = get_errno();
 			fdbg("ERROR: fcntl failed: %d\n", errcode);
@@ -172,9 +178,9 @@ static void aio_write_worker(FAR void *arg)
 		if ((oflags & O_APPEND) != 0) {
 			/* Append to the current file position */
 
-			nwritten = file_write(aioc->u.aioc_filep, (FAR const void *)aiocbp->aio_buf, aiocbp->aio_nbytes);
+			nwritten = file_write(filep, (FAR const void *)aiocbp->aio_buf, aiocbp->aio_nbytes);
 		} else {
-			nwritten = file_pwrite(aioc->u.aioc_filep, (FAR const void *)aiocbp->aio_buf, aiocbp->aio_nbytes, aiocbp->aio_offset);
+			nwritten = file_pwrite(filep, (FAR const void *)aiocbp->aio_buf, aiocbp->aio_nbytes, aiocbp->aio_offset);
 		}
 	}
 #endif
@@ -198,7 +204,7 @@ errout:
 
 	(void)aio_signal(pid, aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
+#ifdef AIO_BOOST_LPWORK
 	/* Restore the low priority worker thread default priority */
 
 	lpwork_restorepriority(prio);
@@ -331,6 +337,12 @@ int aio_write(FAR struct aiocb *aiocbp)
 		return ERROR;
 	}
 
+#ifdef CONFIG_FS_AIO_POOL
+	/* Let the AIO worker threads merge this with adjacent writes */
+
+	aioc->aioc_opcode = LIO_WRITE;
+
+#endif
 	/* Defer the work to the worker thread */
 
 	ret = aio_queue(aioc, aio_write_worker);
@@ -74,6 +74,11 @@
 #include <crc32.h>
 #include <tinyara/math.h>
 #include <tinyara/kmalloc.h>
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+#include <semaphore.h>
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
+#endif
 #include <tinyara/fs/fs.h>
 #include <tinyara/fs/ioctl.h>
 #include <tinyara/fs/mtd.h>
@@ -126,6 +131,10 @@
 #define SMART_FMT_VERSION_POS     (SMART_FMT_POS1 + 4)
 #define SMART_FMT_NAMESIZE_POS    (SMART_FMT_POS1 + 5)
 #define SMART_FMT_ROOTDIRS_POS    (SMART_FMT_POS1 + 6)
+#define SMART_FMT_MAP_POS         (SMART_FMT_POS1 + 7)
+#define SMART_FMT_MAP_SIG         'P'
+#define SMART_FMT_CP_POS          (SMART_FMT_POS1 + 8)
+#define SMART_FMT_CP_SIG          'C'
 #define SMARTFS_FMT_WEAR_POS      36
 #define SMART_WEAR_LEVEL_FORMAT_SIG 32
 #define SMART_PARTNAME_SIZE         4
@@ -141,6 +150,36 @@
 #define SMART_BAD_SECTOR_NUMBER         11
 #define SMART_GOOD_SECTOR_RETRY     8
 
+/* With CONFIG_MTD_SMART_MINIMIZE_RAM, the logical to physical sector map is
+ * kept in map pages which take the last logical sectors of the volume.  The
+ * map entries of a page start at SMART_MAP_OFFSET in the sector so that they
+ * are 16-bit aligned.
+ */
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+#define SMART_NSECTORS(dev)         ((dev)->mapsector)
+#define SMART_MAP_OFFSET            ((sizeof(struct smart_sect_header_s) + 1) & ~1)
+#define SMART_MAP_ENTRIES(buf)      ((FAR uint16_t *)&(buf)[SMART_MAP_OFFSET])
+#define SMART_MAP_NONE              0xFF	/* No cached map page */
+#define SMART_MAP_STALE             0x01	/* Map page on the device is out of date */
+#else
+#define SMART_NSECTORS(dev)         ((dev)->totalsectors)
+#endif
+
+/* With CONFIG_MTD_SMART_CHECKPOINT, the RAM state of the volume is saved in
+ * erase blocks reserved at the end of the device, so that a mount doesn't
+ * have to scan every sector.  The checkpoint header takes the first MTD
+ * block and the state follows.  The header is marked invalid before the
+ * volume is first modified after the checkpoint was written.
+ */
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+#define SMART_CP_MAGIC              "SCP1"
+#define SMART_CP_VALID              CONFIG_SMARTFS_ERASEDSTATE
+#define SMART_CP_INVALID            ((uint8_t)~CONFIG_SMARTFS_ERASEDSTATE)
+#define SMART_CP_MAXSEGS            6
+#endif
+
 #if defined(CONFIG_MTD_SMART_READAHEAD) || (defined(CONFIG_DRVR_WRITABLE) && \
 	defined(CONFIG_MTD_SMART_WRITEBUFFER))
 #define SMART_HAVE_RWBUFFER 1
@@ -268,10 +307,76 @@ static const uint8_t gWearBitToLevelMap4[] = {
  ****************************************************************************/
 
 #ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
-struct smart_cache_s {
-	uint16_t logical;			/* Logical sector number */
-	uint16_t physical;			/* Associated physical sector */
-	uint16_t birth;				/* The "birthday" of this entry */
+/* Directory entry of a map page */
+
+struct smart_mapdir_s {
+	uint16_t physical;			/* Physical sector holding the map page */
+	uint8_t cached;				/* Index of the cached copy or SMART_MAP_NONE */
+	uint8_t flags;				/* See SMART_MAP_STALE */
+};
+
+/* A map page cached in RAM.  The cached pages are linked in LRU order. */
+
+struct smart_mappage_s {
+	FAR uint8_t *buffer;		/* Sector image of the map page */
+	uint16_t page;				/* Map page number, 0xFFFF if unused */
+	uint8_t prev;				/* Next more recently used page */
+	uint8_t next;				/* Next less recently used page */
+	bool dirty;					/* Entries changed since the page was written */
+};
+
+/* An update of a map page which wasn't cached when a relocation changed
+ * the mapping.  It is applied when the map page is next cached.
+ */
+
+struct smart_mapupdate_s {
+	uint16_t logical;			/* Logical sector */
+	uint16_t physical;			/* New physical sector or 0xFFFF */
+	uint16_t next;				/* Next update of the same map page, or next free entry */
+};
+
+/* Signature of the mappings found in a map page's range during the scan */
+
+struct smart_mapsig_s {
+	uint32_t hash;				/* XOR of smart_map_hash() of the mappings */
+	uint16_t count;				/* Number of mappings */
+};
+#endif
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+/* Checkpoint header, at the start of the checkpoint blocks */
+
+struct smart_cphdr_s {
+	uint8_t magic[4];			/* SMART_CP_MAGIC */
+	uint8_t valid;				/* SMART_CP_VALID until the volume is modified */
+	uint8_t layout;				/* Options the state was saved with */
+	uint16_t sectorsize;		/* Sector size of the volume */
+	uint16_t totalsectors;		/* Total number of sectors of the volume */
+	uint16_t neraseblocks;		/* Number of erase blocks of the volume */
+	uint32_t length;			/* Bytes of state following the header */
+	uint32_t crc;				/* CRC-32 of the state and the header */
+};
+
+/* Scalar state saved in the checkpoint, followed by the arrays */
+
+struct smart_cpstate_s {
+	uint16_t freesectors;
+	uint16_t releasesectors;
+	uint16_t reservedsector;
+	uint8_t formatversion;
+	uint8_t namesize;
+	uint8_t rootdirentries;
+	uint8_t wearflags;
+	uint8_t minwearlevel;
+	uint8_t maxwearlevel;
+	uint32_t uneven_wearcount;
+};
+
+/* A piece of the RAM state saved in the checkpoint */
+
+struct smart_cpseg_s {
+	FAR uint8_t *ptr;
+	uint32_t len;
 };
 #endif
 
@@ -342,11 +447,35 @@ struct smart_struct_s {
 	FAR uint16_t *sMap;			/* Virtual to physical sector map */
 #else
 	FAR uint8_t *sBitMap;		/* Virtual sector used bit-map */
-	FAR struct smart_cache_s *sCache;	/* Sector cache */
-	uint16_t cache_entries;	/* Number of valid entries in the cache */
-	uint16_t cache_lastlog;	/* Keep track of the last sector accessed */
-	uint16_t cache_lastphys;	/* Keep the physical sector number also */
-	uint16_t cache_nextbirth;	/* Sector cache aging value */
+	FAR struct smart_mappage_s *mapcache;	/* Cached map pages */
+	FAR struct smart_mapdir_s *mapdir;	/* Map page directory */
+	FAR struct smart_mapupdate_s *mappend;	/* Updates of uncached map pages */
+	FAR uint16_t *mappendhead;	/* First entry in mappend of each map page */
+	uint16_t mappendfree;		/* First free entry in mappend */
+	uint16_t mappendsize;		/* Capacity of mappend */
+	uint16_t mappendcount;		/* Entries in mappend */
+	uint16_t mapsector;			/* Logical sector of the first map page */
+	uint16_t mapentries;		/* Number of map entries per map page */
+	uint16_t mappages;			/* Number of map pages */
+	uint8_t maphead;			/* Most recently used cached page */
+	uint8_t maptail;			/* Least recently used cached page */
+	uint8_t mapbusy;			/* Non-zero while sectors are relocated */
+#endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	uint16_t cpblock;			/* First erase block of the checkpoint */
+	uint16_t cpblocks;			/* Erase blocks reserved for the checkpoint */
+	uint16_t countsize;			/* Bytes of the free and release count arrays */
+	uint16_t cpwrites;			/* Modifications since the checkpoint was written */
+	bool cpvalid;				/* The checkpoint on the device is marked valid */
+	bool cpcurrent;				/* The checkpoint on the device matches the RAM state */
+#endif
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+	sem_t exclsem;				/* Serializes the ioctls with the GC worker */
+	struct work_s gcwork;		/* Background garbage collection work */
+	bool gcclosed;				/* The device is closed, don't collect */
+	uint32_t gcbgblocks;		/* Blocks collected by the GC worker */
+	uint32_t gcfgblocks;		/* Blocks collected inline by writes */
+	uint16_t gcfgmax;			/* Most blocks collected inline by one write */
 #endif
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 	FAR uint8_t *erasecounts;	/* Number of erases for each erase block */
@@ -446,6 +575,9 @@ static ssize_t smart_write(FAR struct inode *inode, const unsigned char *buffer,
 #endif
 static int smart_geometry(FAR struct inode *inode, struct geometry *geometry);
 static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg);
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void smart_gc_schedule(FAR struct smart_struct_s *dev, uint32_t delay);
+#endif
 
 static uint16_t smart_findfreephyssector(FAR struct smart_struct_s *dev, uint8_t canrelocate);
 
@@ -456,12 +588,24 @@ static int smart_readsector(FAR struct smart_struct_s *dev, unsigned long arg);
 
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
 static int smart_read_wearstatus(FAR struct smart_struct_s *dev);
+static int smart_write_wearstatus(FAR struct smart_struct_s *dev);
 static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t block);
 #endif
 static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev, uint16_t block, uint8_t forceerase);
 static int smart_relocate_sector(FAR struct smart_struct_s *dev, uint16_t oldsector, uint16_t newsector);
 static int smart_validate_crc(FAR struct smart_struct_s *dev);
 static crc_t smart_calc_sector_crc(FAR struct smart_struct_s *dev);
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static int smart_map_flush(FAR struct smart_struct_s *dev);
+static int smart_map_drain(FAR struct smart_struct_s *dev, uint16_t count);
+#endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_checkpoint_reserve(FAR struct smart_struct_s *dev);
+static int smart_checkpoint_signed(FAR struct smart_struct_s *dev, uint16_t sector);
+static int smart_checkpoint_check(FAR struct smart_struct_s *dev);
+static int smart_checkpoint_invalidate(FAR struct smart_struct_s *dev);
+static int smart_checkpoint_write(FAR struct smart_struct_s *dev);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -551,6 +695,33 @@ static void smart_free(FAR struct smart_struct_s *dev, FAR void *ptr)
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: smart_semtake / smart_semgive
+ *
+ * Description: Lock and unlock the device against the GC worker.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void smart_semtake(FAR struct smart_struct_s *dev)
+{
+	/* Take the semaphore (perhaps waiting) */
+
+	while (sem_wait(&dev->exclsem) != 0) {
+		/* The only case that an error should occur here is if the wait was
+		 * awakened by a signal.
+		 */
+
+		DEBUGASSERT(errno == EINTR);
+	}
+}
+
+static void smart_semgive(FAR struct smart_struct_s *dev)
+{
+	sem_post(&dev->exclsem);
+}
+#endif
+
 /****************************************************************************
  * Name: smart_open
  *
@@ -560,7 +731,23 @@ static void smart_free(FAR struct smart_struct_s *dev, FAR void *ptr)
 
 static int smart_open(FAR struct inode *inode)
 {
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+	FAR struct smart_struct_s *dev;
+#endif
+
 	fvdbg("Entry\n");
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+	dev = ((FAR struct smart_multiroot_device_s *)inode->i_private)->dev;
+#else
+	dev = (FAR struct smart_struct_s *)inode->i_private;
+#endif
+
+	smart_semtake(dev);
+	dev->gcclosed = false;
+	smart_semgive(dev);
+#endif
 	return OK;
 }
 
@@ -573,8 +760,48 @@ static int smart_open(FAR struct inode *inode)
 
 static int smart_close(FAR struct inode *inode)
 {
+#if defined(CONFIG_MTD_SMART_MINIMIZE_RAM) || defined(CONFIG_MTD_SMART_CHECKPOINT) || defined(CONFIG_MTD_SMART_BACKGROUND_GC)
+	FAR struct smart_struct_s *dev;
+#endif
+	int ret;
+
 	fvdbg("Entry\n");
-	return OK;
+
+#if defined(CONFIG_MTD_SMART_MINIMIZE_RAM) || defined(CONFIG_MTD_SMART_CHECKPOINT) || defined(CONFIG_MTD_SMART_BACKGROUND_GC)
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+	dev = ((FAR struct smart_multiroot_device_s *)inode->i_private)->dev;
+#else
+	dev = (FAR struct smart_struct_s *)inode->i_private;
+#endif
+#endif
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+	/* Stop the garbage collection of the unmounted volume.  A worker which
+	 * is already running waits for the semaphore, and then neither collects
+	 * nor queues itself again.
+	 */
+
+	smart_semtake(dev);
+	dev->gcclosed = true;
+	work_cancel(LPWORK, &dev->gcwork);
+#endif
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	/* Save the state of the volume so the next mount doesn't scan it. */
+
+	ret = smart_checkpoint_write(dev);
+#elif defined(CONFIG_MTD_SMART_MINIMIZE_RAM)
+	/* Write the modified map pages so the next scan finds them current. */
+
+	ret = smart_map_flush(dev);
+#else
+	ret = OK;
+#endif
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+	smart_semgive(dev);
+#endif
+	return ret;
 }
 
 /****************************************************************************
@@ -987,6 +1214,9 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 	uint32_t erasesize;
 	uint32_t totalsectors;
 	uint32_t allocsize;
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	int x;
+#endif
 
 #ifdef CONFIG_SMARTFS_BAD_SECTOR
 	int sector;
@@ -1043,9 +1273,10 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 		dev->sBitMap = NULL;
 	}
 
-	dev->cache_entries = 0;
-	dev->cache_lastlog = 0xFFFF;
-	dev->cache_nextbirth = 0;
+	if (dev->mapcache != NULL) {
+		smart_free(dev, dev->mapcache);
+		dev->mapcache = NULL;
+	}
 #endif
 
 	if (dev->rwbuffer != NULL) {
@@ -1146,18 +1377,37 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 	allocsize = dev->neraseblocks << 1;
 #endif
 
-	/* Allocate the sector cache. */
+	/* Size the map pages.  Enough of them are taken from the end of the
+	 * logical sector range to map all of the sectors below them.
+	 */
 
-	if (dev->sCache == NULL) {
-		dev->sCache = (FAR struct smart_cache_s *)smart_malloc(dev, CONFIG_MTD_SMART_SECTOR_CACHE_SIZE * sizeof(struct smart_cache_s) + allocsize, "Sector Cache");
-	}
+	dev->mapentries = (size - SMART_MAP_OFFSET) / sizeof(uint16_t);
+	dev->mappages = (totalsectors + dev->mapentries) / (dev->mapentries + 1);
+	dev->mapsector = totalsectors - dev->mappages;
 
-	if (!dev->sCache) {
-		fdbg("Error allocating SMART sector cache\n");
+	/* Allocate the map page cache and directory along with the sector
+	 * buffers of the cached pages.  A relocated block, and the static data
+	 * moved into it once it is erased, may update the map for up to two
+	 * blocks of sectors while no map page can be written.  Room is kept for
+	 * them, and for as many updates waiting for their map page.
+	 */
+
+	dev->mappendsize = dev->sectorsPerBlk << 2;
+	dev->mapcache = (FAR struct smart_mappage_s *)smart_malloc(dev, CONFIG_MTD_SMART_MAP_CACHE_PAGES * (sizeof(struct smart_mappage_s) + size) + dev->mappages * sizeof(struct smart_mapdir_s) + dev->mappendsize * sizeof(struct smart_mapupdate_s) + dev->mappages * sizeof(uint16_t) + allocsize, "Map pages");
+	if (!dev->mapcache) {
+		fdbg("Error allocating SMART map page cache\n");
 		goto errexit;
 	}
 
-	dev->releasecount = (FAR uint8_t *)dev->sCache + (CONFIG_MTD_SMART_SECTOR_CACHE_SIZE * sizeof(struct smart_cache_s));
+	dev->mapdir = (FAR struct smart_mapdir_s *)&dev->mapcache[CONFIG_MTD_SMART_MAP_CACHE_PAGES];
+	dev->mappend = (FAR struct smart_mapupdate_s *)&dev->mapdir[dev->mappages];
+	dev->mappendhead = (FAR uint16_t *)&dev->mappend[dev->mappendsize];
+	dev->mapcache[0].buffer = (FAR uint8_t *)&dev->mappendhead[dev->mappages];
+	for (x = 1; x < CONFIG_MTD_SMART_MAP_CACHE_PAGES; x++) {
+		dev->mapcache[x].buffer = dev->mapcache[x - 1].buffer + size;
+	}
+
+	dev->releasecount = dev->mapcache[CONFIG_MTD_SMART_MAP_CACHE_PAGES - 1].buffer + size;
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
 	if (dev->sectorsPerBlk > 16) {
@@ -1174,6 +1424,10 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 
 #endif							/* CONFIG_MTD_SMART_MINIMIZE_RAM */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	dev->countsize = allocsize;
+#endif
+
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
 	/* Allocate a buffer to hold the erase counts. */
 
@@ -1243,8 +1497,8 @@ errexit:
 		smart_free(dev, dev->sBitMap);
 	}
 
-	if (dev->sCache) {
-		smart_free(dev, dev->sCache);
+	if (dev->mapcache) {
+		smart_free(dev, dev->mapcache);
 	}
 #endif
 
@@ -1326,236 +1580,600 @@ errout:
 }
 
 /****************************************************************************
- * Name: smart_add_sector_to_cache
+ * Name: smart_map_reset
  *
- * Description: Adds a logical to physical sector mapping to the sector
- *              map cache.  The cache is used to minimize RAM by eliminating
- *              a one-to-one mapping of all logical sectors and only keeping
- *              a fixed number of mappings per the
- *              CONFIG_MTD_SMART_SECTOR_CACHE_SIZE parameter.  Sectors are
- *              automatically managed and removed based on the time since
- *              they were accessed last.
+ * Description: Forget the location of all map pages and empty the map page
+ *              cache.  Done before the device is scanned.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
-static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev, uint16_t logical, uint16_t physical, int line)
+static void smart_map_reset(FAR struct smart_struct_s *dev)
 {
-	uint16_t index, x;
-	uint16_t oldest;
+	uint16_t x;
 
-	/* If we aren't full yet, just add the sector to the end of the list. */
+	for (x = 0; x < dev->mappages; x++) {
+		dev->mapdir[x].physical = 0xFFFF;
+		dev->mapdir[x].cached = SMART_MAP_NONE;
+		dev->mapdir[x].flags = 0;
+		dev->mappendhead[x] = 0xFFFF;
+	}
 
-	index = 1;
-	if (dev->cache_entries < CONFIG_MTD_SMART_SECTOR_CACHE_SIZE) {
-		index = dev->cache_entries++;
-	} else {
-		/* Cache is full.  We must find the least accessed entry and replace it. */
+	for (x = 0; x < dev->mappendsize; x++) {
+		dev->mappend[x].next = x + 1;
+	}
 
-		oldest = 0xFFFF;
-		for (x = 0; x < CONFIG_MTD_SMART_SECTOR_CACHE_SIZE; x++) {
-			/* Never replace cache entries for system sectors. */
+	dev->mappend[dev->mappendsize - 1].next = 0xFFFF;
+	dev->mappendfree = 0;
 
-			if (dev->sCache[x].logical < dev->reservedsector) {
-				continue;
-			}
+	for (x = 0; x < CONFIG_MTD_SMART_MAP_CACHE_PAGES; x++) {
+		dev->mapcache[x].page = 0xFFFF;
+		dev->mapcache[x].prev = x - 1;
+		dev->mapcache[x].next = x + 1;
+		dev->mapcache[x].dirty = false;
+	}
 
-			/* If the hit count is zero, then choose this entry. */
+	dev->mapcache[0].prev = SMART_MAP_NONE;
+	dev->mapcache[CONFIG_MTD_SMART_MAP_CACHE_PAGES - 1].next = SMART_MAP_NONE;
+	dev->maphead = 0;
+	dev->maptail = CONFIG_MTD_SMART_MAP_CACHE_PAGES - 1;
+	dev->mapbusy = 0;
+	dev->mappendcount = 0;
+}
+#endif
 
-			if (dev->sCache[x].birth < oldest) {
-				oldest = dev->sCache[x].birth;
-				index = x;
-			}
-		}
-	}
+/****************************************************************************
+ * Name: smart_map_hash
+ *
+ * Description: Hash a logical to physical sector mapping.  The scan XORs the
+ *              hashes of all mappings in the range of each map page, which
+ *              is then compared with the contents of the map page to detect
+ *              map pages which were not written before a power loss.
+ *
+ ****************************************************************************/
 
-	/* Now add the sector at index. */
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static inline uint32_t smart_map_hash(uint32_t logical, uint16_t physical)
+{
+	return ((logical << 16) | physical) * 2654435761u;
+}
+#endif
 
-	dev->sCache[index].logical = logical;
-	dev->sCache[index].physical = physical;
-	dev->sCache[index].birth = dev->cache_nextbirth++;
-	dev->cache_lastlog = logical;
-	dev->cache_lastphys = physical;
-	if (dev->debuglevel > 1) {
-		dbg("Add Cache sector:  Log=%d, Phys=%d at index %d from line %d\n", logical, physical, index, line);
-	}
+/****************************************************************************
+ * Name: smart_map_validate
+ *
+ * Description: Compare each map page on the device with the signature of
+ *              the mappings found by the scan and mark the map pages which
+ *              are out of date.  Those are rebuilt when they are next used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static void smart_map_validate(FAR struct smart_struct_s *dev, FAR struct smart_mapsig_s *mapsig)
+{
+	FAR uint16_t *entries = (FAR uint16_t *)dev->rwbuffer;
+	uint32_t logical;
+	uint32_t hash;
+	uint16_t count;
+	uint16_t page;
+	uint16_t x;
+	int ret;
 
-	/* Test if the birthdays need to be adjusted. */
+	for (page = 0; page < dev->mappages; page++) {
+		hash = 0;
+		count = 0;
 
-	if (oldest >= CONFIG_MTD_SMART_SECTOR_CACHE_SIZE + 1024) {
-		for (x = 0; x < dev->cache_entries; x++) {
-			dev->sCache[x].birth -= 1024;
+		if (dev->mapdir[page].physical != 0xFFFF) {
+			ret = MTD_READ(dev->mtd, dev->mapdir[page].physical * dev->mtdBlksPerSector * dev->geo.blocksize + SMART_MAP_OFFSET, dev->mapentries * sizeof(uint16_t), (FAR uint8_t *)entries);
+			if (ret != dev->mapentries * sizeof(uint16_t)) {
+				fdbg("Error reading map page %d\n", page);
+				count = 0xFFFF;
+			} else {
+				logical = (uint32_t)page * dev->mapentries;
+				for (x = 0; x < dev->mapentries; x++, logical++) {
+					if (entries[x] != 0xFFFF) {
+						hash ^= smart_map_hash(logical, entries[x]);
+						count++;
+					}
+				}
+			}
 		}
 
-		dev->cache_nextbirth -= 1024;
+		if (hash != mapsig[page].hash || count != mapsig[page].count) {
+			fvdbg("Map page %d is out of date\n", page);
+			dev->mapdir[page].flags |= SMART_MAP_STALE;
+		}
 	}
-
-	return index;
 }
 #endif
 
 /****************************************************************************
- * Name: smart_cache_lookup
+ * Name: smart_map_rebuild
  *
- * Description: Perform a cache lookup for the requested logical sector.
- *              If the sector is in the cache, then update the hitcount and
- *              return the physical mapping.  If a cache miss occurs, then
- *              the routine will scan the volume to find the logical sector
- *              and add / replace a cache entry with the newly located sector.
+ * Description: Rebuild the entries of a map page from the sector headers.
+ *              This is only needed when the copy of the map page on the
+ *              device is out of date, after a power loss or when a
+ *              relocation changed more mappings than could be deferred.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
-static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logical)
+static int smart_map_rebuild(FAR struct smart_struct_s *dev, FAR uint16_t *entries, uint16_t page)
 {
-	int ret;
-	uint16_t block, sector;
-	uint16_t x, physical, logicalsector;
 	struct smart_sect_header_s header;
-	size_t readaddress;
-
-	physical = 0xFFFF;
+	uint32_t first;
+	uint16_t physical;
+	uint16_t logical;
+	int ret;
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+	FAR struct smart_allocsector_s *allocsect;
+#endif
 
-	/* Test if searching for the last sector used. */
+	fvdbg("Rebuilding map page %d\n", page);
 
-	if (logical == dev->cache_lastlog) {
-		return dev->cache_lastphys;
-	}
+	first = (uint32_t)page * dev->mapentries;
+	memset(entries, 0xFF, dev->mapentries * sizeof(uint16_t));
 
-	/* First search for the entry in the cache. */
+	for (physical = 0; physical < dev->totalsectors; physical++) {
+		ret = MTD_READ(dev->mtd, physical * dev->mtdBlksPerSector * dev->geo.blocksize, sizeof(struct smart_sect_header_s), (FAR uint8_t *)&header);
+		if (ret != sizeof(struct smart_sect_header_s)) {
+			return -EIO;
+		}
 
-	for (x = 0; x < dev->cache_entries; x++) {
-		if (dev->sCache[x].logical == logical) {
-			/* Entry found in the cache.  Grab the physical mapping. */
+		if (!SECTOR_IS_COMMITTED(header) || SECTOR_IS_RELEASED(header) || (header.status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION) {
+			continue;
+		}
 
-			physical = dev->sCache[x].physical;
-			break;
+		logical = UINT8TOUINT16(header.logicalsector);
+		if (logical >= first && logical - first < dev->mapentries && logical < dev->mapsector) {
+			entries[logical - first] = physical;
 		}
 	}
 
-	/* If the entry wasn't found in the cache, then we must search the volume
-	 * for it and add it to the cache.
-	 */
-
-	if (physical == 0xFFFF) {
-		/* Now scan the MTD device.  Instead of scanning start to end, we
-		 * span the erase blocks and read one sector from each at a time.
-		 * this helps speed up the search on volumes that aren't full
-		 * because sector allocation scheme will use the lower sector
-		 * numbers in each erase block first.
-		 */
-
-		for (sector = 0; sector < dev->sectorsPerBlk && physical == 0xFFFF; sector++) {
-			/* Now scan across each erase block. */
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+	/* Sectors which are allocated but not written yet are only in RAM. */
 
-			for (block = 0; block < dev->geo.neraseblocks; block++) {
-				/* Calculate the read address for this sector. */
+	for (allocsect = dev->allocsector; allocsect != NULL; allocsect = allocsect->next) {
+		if (allocsect->logical >= first && allocsect->logical - first < dev->mapentries) {
+			entries[allocsect->logical - first] = allocsect->physical;
+		}
+	}
+#endif
 
-				readaddress = block * dev->erasesize + sector * CONFIG_MTD_SMART_SECTOR_SIZE;
+	return OK;
+}
+#endif
 
-				/* Read the header for this sector. */
+/****************************************************************************
+ * Name: smart_map_writepage
+ *
+ * Description: Write a cached map page to a new physical sector and release
+ *              the previous copy.
+ *
+ ****************************************************************************/
 
-				ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s), (FAR uint8_t *)&header);
-				if (ret != sizeof(struct smart_sect_header_s)) {
-					goto err_out;
-				}
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static int smart_map_writepage(FAR struct smart_struct_s *dev, uint8_t index)
+{
+	FAR struct smart_mappage_s *mp = &dev->mapcache[index];
+	FAR struct smart_sect_header_s *header;
+	FAR char *rwbuffer;
+	uint16_t logical;
+	uint16_t oldsector;
+	uint16_t newsector;
+	uint8_t sectsize;
+	int ret;
 
-				/* Get the logical sector number for this physical sector. */
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	ret = smart_checkpoint_invalidate(dev);
+	if (ret < 0) {
+		return ret;
+	}
 
-				logicalsector = *((FAR uint16_t *)header.logicalsector);
-#if CONFIG_SMARTFS_ERASEDSTATE == 0x00
-				if (logicalsector == 0) {
-					continue;
-				}
 #endif
+	header = (FAR struct smart_sect_header_s *)mp->buffer;
+	logical = dev->mapsector + mp->page;
+	oldsector = dev->mapdir[mp->page].physical;
 
-				/* Test if this sector has been committed. */
+	if (oldsector != 0xFFFF) {
+		/* Start from the header on the device, the map page may have been
+		 * relocated with a new sequence number since it was read.
+		 */
 
-				if (!(SECTOR_IS_COMMITTED(header))) {
-					continue;
-				}
+		ret = MTD_READ(dev->mtd, oldsector * dev->mtdBlksPerSector * dev->geo.blocksize, sizeof(struct smart_sect_header_s), (FAR uint8_t *)header);
+		if (ret != sizeof(struct smart_sect_header_s)) {
+			return -EIO;
+		}
+	} else {
+		/* First write of this map page.  The sequence number is advanced
+		 * to zero by smart_relocate_sector.
+		 */
 
-				/* Test if this sector has been release and skip it if it has. */
+		header->logicalsector[0] = (uint8_t)(logical & 0x00FF);
+		header->logicalsector[1] = (uint8_t)(logical >> 8);
+		header->seq = 0xFF;
+#if SMART_STATUS_VERSION == 1
+		header->crc8 = 0xFF;
+#endif
+		sectsize = dev->sectorsize >> 7;
 
-				if (SECOR_IS_RELEASED(header)) {
-					continue;
-				}
+#if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
+		header->status = ~(SMART_STATUS_COMMITTED | SMART_STATUS_SIZEBITS | SMART_STATUS_VERBITS) | SMART_STATUS_VERSION | sectsize;
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+		header->status &= ~SMART_STATUS_CRC;
+#endif
+#else
+		header->status = SMART_STATUS_COMMITTED | SMART_STATUS_VERSION | sectsize;
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+		header->status |= SMART_STATUS_CRC;
+#endif
+#endif
+	}
 
-				if ((header.status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION) {
-					continue;
-				}
+	newsector = smart_findfreephyssector(dev, FALSE);
+	if (newsector == 0xFFFF) {
+		return -ENOSPC;
+	}
 
-				/* Test if this is the sector we are looking for. */
+	/* smart_relocate_sector writes the RW buffer, so point it at the map
+	 * page for the duration of the write.
+	 */
 
-				if (logicalsector == logical) {
-					/* This is the sector we are looking for!  Add it to the cache. */
+	rwbuffer = dev->rwbuffer;
+	dev->rwbuffer = (FAR char *)mp->buffer;
+	ret = smart_relocate_sector(dev, oldsector, newsector);
+	dev->rwbuffer = rwbuffer;
+	if (ret < 0) {
+		return ret;
+	}
 
-					physical = block * dev->sectorsPerBlk + sector;
-					smart_add_sector_to_cache(dev, logical, physical, __LINE__);
-					break;
-				}
-			}
-		}
+	if (dev->debuglevel > 1) {
+		dbg("Write map page %d: phys=%d, old=%d\n", mp->page, newsector, oldsector);
 	}
 
-	/* Update the last logical sector found variable. */
+	/* Update the free and release counts. */
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+	smart_add_count(dev, dev->freecount, newsector / dev->sectorsPerBlk, -1);
+#else
+	dev->freecount[newsector / dev->sectorsPerBlk]--;
+#endif
+	dev->freesectors--;
 
-	dev->cache_lastlog = logical;
-	dev->cache_lastphys = physical;
+	if (oldsector != 0xFFFF) {
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+		smart_add_count(dev, dev->releasecount, oldsector / dev->sectorsPerBlk, 1);
+#else
+		dev->releasecount[oldsector / dev->sectorsPerBlk]++;
+#endif
+		dev->releasesectors++;
+	}
 
-err_out:
-	return physical;
+	dev->mapdir[mp->page].physical = newsector;
+	mp->dirty = false;
+	return OK;
 }
 #endif
 
 /****************************************************************************
- * Name: smart_update_cache
+ * Name: smart_map_flush
  *
- * Description: Update a cache entry (if present) replacing the logical
- *              sector's physical sector mapping with the new one provided.
- *              This does not affect the hit count.
+ * Description: Write all modified cached map pages to the device.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
-static void smart_update_cache(FAR struct smart_struct_s *dev, uint16_t logical, uint16_t physical)
+static int smart_map_flush(FAR struct smart_struct_s *dev)
 {
-	uint16_t x;
-
-	/* Scan through all cache entries and find the logical sector entry */
-
-	for (x = 0; x < dev->cache_entries; x++) {
-		if (dev->sCache[x].logical == logical) {
-			/* Entry found.  Update it's physical mapping. */
-
-			dev->sCache[x].physical = physical;
+	uint8_t x;
+	int ret;
 
-			/* If we are freeing a sector, then remove the logical entry from
-			   the cache.
-			 */
+	if (dev->mapcache == NULL) {
+		return OK;
+	}
 
-			if (physical == 0xFFFF) {
-				dev->sCache[x].logical = dev->sCache[dev->cache_entries - 1].logical;
-				dev->sCache[x].physical = dev->sCache[dev->cache_entries - 1].physical;
-				dev->cache_entries--;
-			}
+	ret = smart_map_drain(dev, 0);
+	if (ret < 0) {
+		return ret;
+	}
 
-			if (dev->debuglevel > 1) {
-				dbg("Update Cache:  Log=%d, Phys=%d at index %d\n", logical, physical, x);
+	for (x = 0; x < CONFIG_MTD_SMART_MAP_CACHE_PAGES; x++) {
+		if (dev->mapcache[x].dirty) {
+			ret = smart_map_writepage(dev, x);
+			if (ret < 0) {
+				fdbg("Error %d writing map page %d\n", -ret, dev->mapcache[x].page);
+				return ret;
 			}
-
-			break;
 		}
 	}
 
-	if (dev->cache_lastlog == logical) {
-		dev->cache_lastphys = physical;
-	}
+	return OK;
 }
 #endif
 
 /****************************************************************************
- * Name: smart_get_wear_level
+ * Name: smart_map_getpage
+ *
+ * Description: Return the index of the cached copy of the specified map
+ *              page, reading it into the least recently used cache entry on
+ *              a miss.  Returns a negated errno if the page can't be read,
+ *              or -EBUSY if no cache entry can be taken during a relocation.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static int smart_map_getpage(FAR struct smart_struct_s *dev, uint16_t page)
+{
+	FAR struct smart_mappage_s *mp;
+	FAR struct smart_mapdir_s *dir = &dev->mapdir[page];
+	FAR struct smart_mapupdate_s *update;
+	uint16_t x;
+	uint8_t index;
+	int ret;
+
+	index = dir->cached;
+	if (index == SMART_MAP_NONE) {
+		/* Take the least recently used cache entry.  A modified map page
+		 * can't be written while sectors are being relocated because the
+		 * free sectors are spoken for, so only clean entries are taken then.
+		 */
+
+		index = dev->maptail;
+		if (dev->mapbusy) {
+			while (index != SMART_MAP_NONE && dev->mapcache[index].dirty) {
+				index = dev->mapcache[index].prev;
+			}
+
+			if (index == SMART_MAP_NONE) {
+				return -EBUSY;
+			}
+		}
+
+		mp = &dev->mapcache[index];
+		if (mp->dirty) {
+			ret = smart_map_writepage(dev, index);
+			if (ret < 0) {
+				fdbg("Error %d writing map page %d\n", -ret, mp->page);
+				return ret;
+			}
+		}
+
+		if (mp->page != 0xFFFF) {
+			dev->mapdir[mp->page].cached = SMART_MAP_NONE;
+			mp->page = 0xFFFF;
+		}
+
+		/* Now fill it with the requested map page. */
+
+		if (dir->flags & SMART_MAP_STALE) {
+			ret = smart_map_rebuild(dev, SMART_MAP_ENTRIES(mp->buffer), page);
+			mp->dirty = true;
+		} else if (dir->physical == 0xFFFF) {
+			/* Never written, nothing in its range is mapped. */
+
+			memset(SMART_MAP_ENTRIES(mp->buffer), 0xFF, dev->mapentries * sizeof(uint16_t));
+			ret = OK;
+		} else {
+			ret = MTD_READ(dev->mtd, dir->physical * dev->mtdBlksPerSector * dev->geo.blocksize + SMART_MAP_OFFSET, dev->mapentries * sizeof(uint16_t), (FAR uint8_t *)SMART_MAP_ENTRIES(mp->buffer));
+			ret = ret == dev->mapentries * sizeof(uint16_t) ? OK : -EIO;
+		}
+
+		if (ret < 0) {
+			fdbg("Error %d reading map page %d\n", -ret, page);
+			mp->dirty = false;
+			return ret;
+		}
+
+		/* Apply the updates deferred while the page wasn't cached. */
+
+		while ((x = dev->mappendhead[page]) != 0xFFFF) {
+			update = &dev->mappend[x];
+			SMART_MAP_ENTRIES(mp->buffer)[update->logical % dev->mapentries] = update->physical;
+			mp->dirty = true;
+			dev->mappendhead[page] = update->next;
+			update->next = dev->mappendfree;
+			dev->mappendfree = x;
+			dev->mappendcount--;
+		}
+
+		dir->flags &= ~SMART_MAP_STALE;
+		dir->cached = index;
+		mp->page = page;
+	}
+
+	/* Move the page to the head of the LRU list. */
+
+	if (index != dev->maphead) {
+		mp = &dev->mapcache[index];
+		dev->mapcache[mp->prev].next = mp->next;
+		if (mp->next != SMART_MAP_NONE) {
+			dev->mapcache[mp->next].prev = mp->prev;
+		} else {
+			dev->maptail = mp->prev;
+		}
+
+		mp->prev = SMART_MAP_NONE;
+		mp->next = dev->maphead;
+		dev->mapcache[dev->maphead].prev = index;
+		dev->maphead = index;
+	}
+
+	return index;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_map_drain
+ *
+ * Description: Cache the map pages with deferred updates, which applies
+ *              them, until no more than 'count' updates are deferred.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static int smart_map_drain(FAR struct smart_struct_s *dev, uint16_t count)
+{
+	uint16_t page;
+	int ret;
+
+	for (page = 0; page < dev->mappages && dev->mappendcount > count; page++) {
+		if (dev->mappendhead[page] != 0xFFFF) {
+			ret = smart_map_getpage(dev, page);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+	}
+
+	return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_cache_lookup
+ *
+ * Description: Return the physical sector mapped to a logical sector, or
+ *              0xFFFF if there is none.  The map entry is looked up in its
+ *              cached map page, which costs one read of the map page from
+ *              the device when it isn't cached.  The locations of the map
+ *              pages themselves are kept in the map page directory.
+ *              Returns a negated errno if the map page can't be cached.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static int smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logical)
+{
+	uint16_t page;
+	uint16_t x;
+	int index;
+
+	if (logical >= dev->totalsectors) {
+		return 0xFFFF;
+	}
+
+	if (logical >= dev->mapsector) {
+		return dev->mapdir[logical - dev->mapsector].physical;
+	}
+
+	/* Only a map page which isn't cached has deferred updates. */
+
+	page = logical / dev->mapentries;
+	for (x = dev->mappendhead[page]; x != 0xFFFF; x = dev->mappend[x].next) {
+		if (dev->mappend[x].logical == logical) {
+			return dev->mappend[x].physical;
+		}
+	}
+
+	index = smart_map_getpage(dev, page);
+	if (index < 0) {
+		return index;
+	}
+
+	return SMART_MAP_ENTRIES(dev->mapcache[index].buffer)[logical % dev->mapentries];
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_update_cache
+ *
+ * Description: Map a logical sector to a new physical sector, or unmap it
+ *              if the physical sector is 0xFFFF.  The map page is written
+ *              to the device when it leaves the cache.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static void smart_update_cache(FAR struct smart_struct_s *dev, uint16_t logical, uint16_t physical)
+{
+	FAR struct smart_mapupdate_s *update;
+	FAR uint16_t *entry;
+	uint16_t page;
+	uint16_t x;
+	int index;
+
+	if (logical >= dev->totalsectors) {
+		return;
+	}
+
+	if (logical >= dev->mapsector) {
+		/* A map page was relocated. */
+
+		dev->mapdir[logical - dev->mapsector].physical = physical;
+		return;
+	}
+
+	/* A deferred update is replaced rather than applied to the cache, it
+	 * would undo the newer mapping when it is applied.
+	 */
+
+	page = logical / dev->mapentries;
+	for (x = dev->mappendhead[page]; x != 0xFFFF; x = dev->mappend[x].next) {
+		if (dev->mappend[x].logical == logical) {
+			dev->mappend[x].physical = physical;
+			return;
+		}
+	}
+
+	index = smart_map_getpage(dev, page);
+	if (index < 0 && dev->mapbusy && dev->mappendfree != 0xFFFF) {
+		/* No clean cache entry is left during a relocation, apply the
+		 * update when the map page is cached again.
+		 */
+
+		x = dev->mappendfree;
+		update = &dev->mappend[x];
+		dev->mappendfree = update->next;
+		update->logical = logical;
+		update->physical = physical;
+		update->next = dev->mappendhead[page];
+		dev->mappendhead[page] = x;
+		dev->mappendcount++;
+		return;
+	}
+
+	if (index < 0) {
+		/* The map page on the device no longer has the right mapping.  It
+		 * is rebuilt from the sector headers when it is next needed.
+		 */
+
+		dev->mapdir[page].flags |= SMART_MAP_STALE;
+		return;
+	}
+
+	entry = &SMART_MAP_ENTRIES(dev->mapcache[index].buffer)[logical % dev->mapentries];
+	if (*entry != physical) {
+		*entry = physical;
+		dev->mapcache[index].dirty = true;
+	}
+
+	if (dev->debuglevel > 1) {
+		dbg("Update map:  Log=%d, Phys=%d in page %d\n", logical, physical, page);
+	}
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_map_release
+ *
+ * Description: End a relocation started by incrementing mapbusy.  Once no
+ *              relocation is in progress, the deferred map updates are
+ *              applied until there is room to defer those of the next
+ *              relocation.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static void smart_map_release(FAR struct smart_struct_s *dev)
+{
+	if (--dev->mapbusy == 0) {
+		(void)smart_map_drain(dev, dev->sectorsPerBlk << 1);
+	}
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_get_wear_level
  *
  * Description: Get the wear level of the specified block.  Wear levels are
  *              encoded to minimize the number of zero to one transitions,
@@ -1719,6 +2337,53 @@ static int smart_set_wear_level(FAR struct smart_struct_s *dev, uint16_t block,
 	return 0;
 }
 #endif
+/****************************************************************************
+ * Name: smart_register_rootdirs
+ *
+ * Description: Registers the block devices of the additional root
+ *              directory entries of the volume.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+static int smart_register_rootdirs(FAR struct smart_struct_s *dev)
+{
+	int x;
+	char devname[22];
+	FAR struct smart_multiroot_device_s *rootdirdev;
+
+	for (x = 1; x < dev->rootdirentries; x++) {
+		if (dev->partname[0] != '\0') {
+			snprintf(dev->rwbuffer, sizeof(devname), "/dev/smart%d%sd%d", dev->minor, dev->partname, x + 1);
+		} else {
+			snprintf(devname, sizeof(devname), "/dev/smart%dd%d", dev->minor, x + 1);
+		}
+
+		/* Inode private data is a reference to a struct containing
+		 * the SMART device structure and the root directory number.
+		 */
+
+		rootdirdev = (struct smart_multiroot_device_s *)smart_malloc(dev, sizeof(*rootdirdev), "Root Dir");
+		if (rootdirdev == NULL) {
+			fdbg("Memory alloc failed\n");
+			return -ENOMEM;
+		}
+
+		/* Populate the rootdirdev. */
+
+		rootdirdev->dev = dev;
+		rootdirdev->rootdirnum = x;
+		register_blockdriver(dev->rwbuffer, &g_bops, 0, rootdirdev);
+
+		/* Inode private data is a reference to the SMART device structure. */
+
+		register_blockdriver(devname, &g_bops, 0, rootdirdev);
+	}
+
+	return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_scan
  *
@@ -1748,11 +2413,7 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 #ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
 	int dupsector;
 	uint16_t duplogsector;
-#endif
-#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
-	int x;
-	char devname[22];
-	FAR struct smart_multiroot_device_s *rootdirdev;
+	FAR struct smart_mapsig_s *mapsig = NULL;
 #endif
 	int i;
 
@@ -1801,6 +2462,17 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 		goto err_out;
 	}
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	/* Give the checkpoint blocks back to a volume which wasn't formatted
+	 * to reserve them.
+	 */
+
+	ret = smart_checkpoint_check(dev);
+	if (ret < 0) {
+		goto err_out;
+	}
+#endif
+
 	/* Initialize the device variables. */
 
 	totalsectors = dev->totalsectors;
@@ -1841,9 +2513,19 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 		dev->sMap[sector] = -1;
 	}
 #else
-	/* Clear all logical sector used bits. */
+	/* Clear all logical sector used bits and forget the map pages.  The
+	 * signature of the mappings found in the range of each map page is
+	 * accumulated in mapsig to validate the map pages after the scan.
+	 */
 
 	memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
+	smart_map_reset(dev);
+
+	mapsig = (FAR struct smart_mapsig_s *)kmm_zalloc(dev->mappages * sizeof(struct smart_mapsig_s));
+	if (mapsig == NULL) {
+		ret = -ENOMEM;
+		goto err_out;
+	}
 #endif
 
 	/* Now scan the MTD device. */
@@ -1856,6 +2538,7 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 
 	for (sector = 0; sector < totalsectors; sector++) {
 		winner = sector;
+		loser = 0xFFFF;
 		corrupted = false;
 		fvdbg("Scan sector %d\n", sector);
 
@@ -1940,7 +2623,11 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 					int i, j, found_bad_physical_sector;
 
 					if (dev->bad_sector_rwbuffer != NULL) {
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 						bad_physical_sector_no = (uint16_t)(dev->sMap[SMART_BAD_SECTOR_NUMBER]);
+#else
+						bad_physical_sector_no = sector;
+#endif
 
 						if (bad_physical_sector_no == ERROR) {
 							fdbg("bad_physical_sector_no not found\n");
@@ -2054,6 +2741,17 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 			dev->namesize = dev->rwbuffer[SMART_FMT_NAMESIZE_POS];
 			dev->formatversion = dev->rwbuffer[SMART_FMT_VERSION_POS];
 
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+			/* The top logical sectors hold the map pages, which a volume
+			 * formatted without them may be using for data.
+			 */
+
+			if (dev->rwbuffer[SMART_FMT_MAP_POS] != SMART_FMT_MAP_SIG) {
+				fdbg("Volume was not formatted with the sector map in FLASH\n");
+				dev->formatstatus = SMART_FMT_STAT_NOFMT;
+			}
+#endif
+
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
 			dev->rootdirentries = dev->rwbuffer[SMART_FMT_ROOTDIRS_POS];
 
@@ -2061,33 +2759,9 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 			 * additional block devices.
 			 */
 
-			for (x = 1; x < dev->rootdirentries; x++) {
-				if (dev->partname[0] != '\0') {
-					snprintf(dev->rwbuffer, sizeof(devname), "/dev/smart%d%sd%d", dev->minor, dev->partname, x + 1);
-				} else {
-					snprintf(devname, sizeof(devname), "/dev/smart%dd%d", dev->minor, x + 1);
-				}
-
-				/* Inode private data is a reference to a struct containing
-				 * the SMART device structure and the root directory number.
-				 */
-
-				rootdirdev = (struct smart_multiroot_device_s *)smart_malloc(dev, sizeof(*rootdirdev), "Root Dir");
-				if (rootdirdev == NULL) {
-					fdbg("Memory alloc failed\n");
-					ret = -ENOMEM;
-					goto err_out;
-				}
-
-				/* Populate the rootdirdev. */
-
-				rootdirdev->dev = dev;
-				rootdirdev->rootdirnum = x;
-				ret = register_blockdriver(dev->rwbuffer, &g_bops, 0, rootdirdev);
-
-				/* Inode private data is a reference to the SMART device structure. */
-
-				ret = register_blockdriver(devname, &g_bops, 0, rootdirdev);
+			ret = smart_register_rootdirs(dev);
+			if (ret < 0) {
+				goto err_out;
 			}
 #endif
 		}
@@ -2139,7 +2813,7 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 
 				/* Get the logical sector number for this physical sector. */
 
-				duplogsector = *((FAR uint16_t *)header.logicalsector);
+				duplogsector = UINT8TOUINT16(header.logicalsector);
 #if CONFIG_SMARTFS_ERASEDSTATE == 0x00
 				if (duplogsector == 0) {
 					duplogsector = -1;
@@ -2203,7 +2877,7 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 				winner = dev->sMap[logicalsector];
 #else
-				winner = smart_cache_lookup(dev, logicalsector);
+				winner = dupsector;
 #endif
 			}
 
@@ -2234,12 +2908,29 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 		/* Mark the logical sector as used in the bitmap */
 		dev->sBitMap[logicalsector >> 3] |= 1 << (logicalsector & 0x07);
 
-		if (logicalsector < dev->reservedsector) {
-			smart_add_sector_to_cache(dev, logicalsector, winner, __LINE__);
+		if (logicalsector >= dev->mapsector) {
+			/* This is a map page, record where it is. */
+
+			dev->mapdir[logicalsector - dev->mapsector].physical = winner;
+		} else if (winner == sector) {
+			/* Replace the mapping of the loser, if any, in the signature. */
+
+			mapsig[logicalsector / dev->mapentries].hash ^= smart_map_hash(logicalsector, sector);
+			if (loser != 0xFFFF) {
+				mapsig[logicalsector / dev->mapentries].hash ^= smart_map_hash(logicalsector, loser);
+			} else {
+				mapsig[logicalsector / dev->mapentries].count++;
+			}
 		}
 #endif
 	}
 
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	/* Find the map pages which are out of date. */
+
+	smart_map_validate(dev, mapsig);
+#endif
+
 #if defined(CONFIG_MTD_SMART_WEAR_LEVEL) && (SMART_STATUS_VERSION == 1)
 #ifdef CONFIG_MTD_SMART_CONVERT_WEAR_FORMAT
 
@@ -2252,7 +2943,12 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 	sector = dev->sMap[0];
 #else
-	sector = smart_cache_lookup(dev, 0);
+	ret = smart_cache_lookup(dev, 0);
+	if (ret < 0) {
+		goto err_out;
+	}
+
+	sector = (uint16_t)ret;
 #endif
 
 	/* Validate the sector is valid ... may be an unformatted device. */
@@ -2295,8 +2991,13 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 			dev->releasecount[sector / dev->sectorsPerBlk]++;
 #else
 			smart_update_cache(dev, 0, newsector);
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
 			smart_add_count(dev, dev->freecount, newsector / dev->sectorsPerBlk, -1);
 			smart_add_count(dev, dev->releasecount, sector / dev->sectorsPerBlk, 1);
+#else
+			dev->freecount[newsector / dev->sectorsPerBlk]--;
+			dev->releasecount[sector / dev->sectorsPerBlk]++;
+#endif
 #endif
 
 		}
@@ -2330,6 +3031,11 @@ err_out:
 	if (sector_seq_log != NULL) {
 		kmm_free(sector_seq_log);
 	}
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	if (mapsig != NULL) {
+		kmm_free(mapsig);
+	}
+#endif
 	return ret;
 }
 
@@ -2377,7 +3083,7 @@ static inline int smart_getformat(FAR struct smart_struct_s *dev, FAR struct sma
 
 	fmt->sectorsize = dev->sectorsize;
 	fmt->availbytes = dev->sectorsize - sizeof(struct smart_sect_header_s);
-	fmt->nsectors = dev->totalsectors;
+	fmt->nsectors = SMART_NSECTORS(dev);
 
 	fmt->nfreesectors = dev->freesectors;
 	fmt->namesize = dev->namesize;
@@ -2393,6 +3099,9 @@ static inline int smart_getformat(FAR struct smart_struct_s *dev, FAR struct sma
 	/* Subtract the reserved sector count. */
 
 	fmt->nfreesectors -= dev->sectorsPerBlk + 4;
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	fmt->nfreesectors -= dev->mappages;
+#endif
 
 	ret = OK;
 
@@ -2512,6 +3221,14 @@ static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t b
 	ret = OK;
 	header = (FAR struct smart_sect_header_s *)dev->rwbuffer;
 
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	/* Sectors are taken from 'block' in order, so no map page may be
+	 * written until they are all relocated.
+	 */
+
+	dev->mapbusy++;
+#endif
+
 #ifdef CONFIG_SMART_LOCAL_CHECKFREE
 	if (smart_checkfree(dev, __LINE__) != OK) {
 		fdbg("   ...about to relocate static data %d\n", block);
@@ -2659,7 +3376,7 @@ static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t b
 			//dev->sMap[*((FAR uint16_t *)header->logicalsector)] = newsector;
 			dev->sMap[UINT8TOUINT16(header->logicalsector)] = newsector;
 #else
-			smart_update_cache(dev, *((FAR uint16_t *)header->logicalsector), newsector);
+			smart_update_cache(dev, UINT8TOUINT16(header->logicalsector), newsector);
 #endif
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
@@ -2686,6 +3403,9 @@ static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t b
 #endif
 
 errout:
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	smart_map_release(dev);
+#endif
 	return ret;
 }
 #endif
@@ -2768,7 +3488,17 @@ static int smart_write_bad_sector_info(FAR struct smart_struct_s *dev, int physi
 		return -1;
 	}
 
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 	bad_physical_sector_info = (uint16_t)(dev->sMap[SMART_BAD_SECTOR_NUMBER]);
+#else
+	ret = smart_cache_lookup(dev, SMART_BAD_SECTOR_NUMBER);
+	if (ret < 0) {
+		kmm_free(temp_rwbuffer);
+		return ret;
+	}
+
+	bad_physical_sector_info = (uint16_t)ret;
+#endif
 
 	if (bad_physical_sector_info == (uint16_t)-1) {
 		kmm_free(temp_rwbuffer);
@@ -2844,6 +3574,17 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
 
 	fvdbg("Entry\n");
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	/* Take the checkpoint blocks back if the previous format didn't
+	 * reserve them.
+	 */
+
+	if (dev->cpblocks == 0) {
+		smart_checkpoint_reserve(dev);
+		dev->sectorsize = 0;
+	}
+#endif
+
 	ret = smart_setsectorsize(dev, CONFIG_MTD_SMART_SECTOR_SIZE);
 	if (ret != OK) {
 		return ret;
@@ -2923,7 +3664,21 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
 
 	dev->rwbuffer[SMART_FMT_ROOTDIRS_POS] = (uint8_t)arg;
 
-#ifdef CONFIG_SMART_CRC_8
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	/* Mark the volume as having its sector map in the top logical sectors. */
+
+	dev->rwbuffer[SMART_FMT_MAP_POS] = SMART_FMT_MAP_SIG;
+#endif
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	/* Mark the volume as having the checkpoint blocks reserved. */
+
+	if (dev->cpblocks > 0) {
+		dev->rwbuffer[SMART_FMT_CP_POS] = SMART_FMT_CP_SIG;
+	}
+#endif
+
+#ifdef CONFIG_SMART_CRC_8
 	sectorheader->crc8 = smart_calc_sector_crc(dev);
 #elif defined(CONFIG_SMART_CRC_16)
 	*((uint16_t *)sectorheader->crc16) = smart_calc_sector_crc(dev);
@@ -2998,6 +3753,10 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
 
 		dev->sMap[x] = -1;
 	}
+#else
+	memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
+	dev->sBitMap[0] |= 0x01;
+	smart_map_reset(dev);
 #endif
 
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
@@ -3116,17 +3875,19 @@ static int smart_relocate_sector(FAR struct smart_struct_s *dev, uint16_t oldsec
 	}
 #endif							/* CONFIG_MTD_SMART_ENABLE_CRC */
 
-	/* Release the old physical sector. */
+	/* Release the old physical sector, if there is one. */
 
+	if (oldsector != 0xFFFF) {
 #if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
-	newstatus = header->status & ~(SMART_STATUS_RELEASED | SMART_STATUS_COMMITTED);
+		newstatus = header->status & ~(SMART_STATUS_RELEASED | SMART_STATUS_COMMITTED);
 #else
-	newstatus = header->status | SMART_STATUS_RELEASED | SMART_STATUS_COMMITTED;
+		newstatus = header->status | SMART_STATUS_RELEASED | SMART_STATUS_COMMITTED;
 #endif
-	offset = oldsector * dev->mtdBlksPerSector * dev->geo.blocksize + offsetof(struct smart_sect_header_s, status);
-	ret = smart_bytewrite(dev, offset, 1, &newstatus);
-	if (ret < 0) {
-		fdbg("Error %d releasing old sector %d\n" - ret, oldsector);
+		offset = oldsector * dev->mtdBlksPerSector * dev->geo.blocksize + offsetof(struct smart_sect_header_s, status);
+		ret = smart_bytewrite(dev, offset, 1, &newstatus);
+		if (ret < 0) {
+			fdbg("Error %d releasing old sector %d\n" - ret, oldsector);
+		}
 	}
 #ifndef CONFIG_MTD_SMART_ENABLE_CRC
 errout:
@@ -3161,6 +3922,14 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev, uint16_t block)
 
 	fvdbg("Entry\n");
 
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	/* Don't let a map page take a free sector while the block is being
+	 * relocated.
+	 */
+
+	dev->mapbusy++;
+#endif
+
 	/* Perform collection on block with the most released sectors.
 	 * First mark the block as having no free sectors so we don't
 	 * try to move sectors into the block we are trying to erase.
@@ -3301,7 +4070,7 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev, uint16_t block)
 		dev->sMap[UINT8TOUINT16(header->logicalsector)] = newsector;
 		//dev->sMap[*((FAR uint16_t *)header->logicalsector)] = newsector;
 #else
-		smart_update_cache(dev, *((FAR uint16_t *)header->logicalsector), newsector);
+		smart_update_cache(dev, UINT8TOUINT16(header->logicalsector), newsector);
 #endif
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
@@ -3372,6 +4141,9 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev, uint16_t block)
 	smart_relocate_static_data(dev, block);
 #endif
 
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	smart_map_release(dev);
+#endif
 	return OK;
 
 errout:
@@ -3381,6 +4153,9 @@ errout:
 	smart_set_count(dev, dev->freecount, block, freecount);
 #else
 	dev->freecount[block] = freecount;
+#endif
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	smart_map_release(dev);
 #endif
 	return ret;
 }
@@ -3650,6 +4425,53 @@ error:
 	return physicalsector;
 }
 
+/****************************************************************************
+ * Name: smart_gc_selectblock
+ *
+ * Description:  Return the erase block with the most released sectors, or
+ *               0xFFFF if no block has any.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_WRITABLE
+static uint16_t smart_gc_selectblock(FAR struct smart_struct_s *dev)
+{
+	uint16_t collectblock;
+	uint16_t releasemax;
+	int x;
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+	uint8_t count;
+#endif
+
+	collectblock = 0xFFFF;
+	releasemax = 0;
+	for (x = 0; x < dev->neraseblocks; x++) {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+		/* Don't collect blocks that have been worn completely. */
+
+		if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD) {
+			continue;
+		}
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+		count = smart_get_count(dev, dev->releasecount, x);
+		if (count > releasemax) {
+			releasemax = count;
+			collectblock = x;
+		}
+#else
+		if (dev->releasecount[x] > releasemax) {
+			releasemax = dev->releasecount[x];
+			collectblock = x;
+		}
+#endif
+	}
+
+	return collectblock;
+}
+#endif							/* CONFIG_FS_WRITABLE */
+
 /****************************************************************************
  * Name: smart_garbagecollect
  *
@@ -3657,18 +4479,21 @@ error:
  *               by the count of released sectors relative to free and
  *               total sectors.
  *
+ *               With CONFIG_MTD_SMART_BACKGROUND_GC, a write collects at
+ *               most CONFIG_MTD_SMART_GC_WRITE_BUDGET blocks unless the
+ *               free sectors fall to the reserve, the rest is left to the
+ *               GC worker.
+ *
  ****************************************************************************/
 
 #ifdef CONFIG_FS_WRITABLE
 static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 {
 	uint16_t collectblock;
-	uint16_t releasemax;
 	bool collect = TRUE;
-	int x;
 	int ret;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-	uint8_t count;
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+	uint16_t collected = 0;
 #endif
 
 	while (collect) {
@@ -3682,6 +4507,14 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 			collect = TRUE;
 		}
 
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+		/* Leave the rest to the GC worker once the budget is spent. */
+
+		if (collected >= CONFIG_MTD_SMART_GC_WRITE_BUDGET) {
+			collect = FALSE;
+		}
+#endif
+
 		/* Test if we have more reached our reserved free sector limit. */
 
 		if (dev->freesectors <= (dev->sectorsPerBlk << 0) + 4) {
@@ -3693,32 +4526,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 		if (collect) {
 			/* Find the block with the most released sectors. */
 
-			collectblock = 0xFFFF;
-			releasemax = 0;
-			for (x = 0; x < dev->neraseblocks; x++) {
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-				/* Don't collect blocks that have been worn completely. */
-
-				if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD) {
-					continue;
-				}
-#endif
-
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-				count = smart_get_count(dev, dev->releasecount, x);
-				if (count > releasemax) {
-					releasemax = count;
-					collectblock = x;
-				}
-#else
-				if (dev->releasecount[x] > releasemax) {
-					releasemax = dev->releasecount[x];
-					collectblock = x;
-				}
-#endif
-			}
-			//releasemax = smart_get_count(dev, dev->releasecount, collectblock);
-
+			collectblock = smart_gc_selectblock(dev);
 			if (collectblock == 0xFFFF) {
 				/* Need to collect, but no sectors with released blocks! */
 
@@ -3750,16 +4558,122 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
 			if (ret != OK) {
 				goto errout;
 			}
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+			collected++;
+#endif
 		}
 	}
 
-	return OK;
+	ret = OK;
 
 errout:
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+	dev->gcfgblocks += collected;
+	if (collected > dev->gcfgmax) {
+		dev->gcfgmax = collected;
+	}
+
+	smart_gc_schedule(dev, 0);
+#endif
 	return ret;
 }
 #endif							/* CONFIG_FS_WRITABLE */
 
+/****************************************************************************
+ * Name: smart_gc_needed
+ *
+ * Description:  Test if the GC worker should collect a block: there is a
+ *               block worth of released sectors and the free sectors are
+ *               below CONFIG_MTD_SMART_GC_FREE_THRESHOLD percent of the
+ *               volume.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static bool smart_gc_needed(FAR struct smart_struct_s *dev)
+{
+	if (dev->formatstatus != SMART_FMT_STAT_FORMATTED || dev->releasesectors < dev->availSectPerBlk) {
+		return false;
+	}
+
+	return (uint32_t)dev->freesectors * 100 < (uint32_t)dev->totalsectors * CONFIG_MTD_SMART_GC_FREE_THRESHOLD;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_gc_worker
+ *
+ * Description:  Collect one erase block on the low priority work queue,
+ *               and queue itself again if more are needed.  One block at
+ *               a time keeps the time a write waits for the worker short.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void smart_gc_worker(FAR void *arg)
+{
+	FAR struct smart_struct_s *dev = (FAR struct smart_struct_s *)arg;
+	uint16_t collectblock;
+	int ret;
+
+	smart_semtake(dev);
+
+	if (dev->gcclosed || !smart_gc_needed(dev)) {
+		goto out;
+	}
+
+	collectblock = smart_gc_selectblock(dev);
+	if (collectblock == 0xFFFF) {
+		goto out;
+	}
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	if (smart_checkpoint_invalidate(dev) < 0) {
+		goto out;
+	}
+#endif
+
+	fvdbg("Collecting block %d in the background\n", collectblock);
+	ret = smart_relocate_block(dev, collectblock);
+	if (ret != OK) {
+		fdbg("Error %d collecting block %d\n", -ret, collectblock);
+		goto out;
+	}
+
+	dev->gcbgblocks++;
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+	if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED) {
+		/* Write new wear status bits to the device. */
+
+		smart_write_wearstatus(dev);
+	}
+#endif
+
+	smart_gc_schedule(dev, MSEC2TICK(CONFIG_MTD_SMART_GC_DELAY));
+
+out:
+	smart_semgive(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_gc_schedule
+ *
+ * Description:  Queue the GC worker if it is needed and not queued yet.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+static void smart_gc_schedule(FAR struct smart_struct_s *dev, uint32_t delay)
+{
+	if (!dev->gcclosed && work_available(&dev->gcwork) && smart_gc_needed(dev)) {
+		work_queue(LPWORK, &dev->gcwork, smart_gc_worker, dev, delay);
+	}
+}
+#endif
+
 /****************************************************************************
  * Name: smart_write_wearstatus
  *
@@ -4131,7 +5045,7 @@ relocate_good_sector:
 
 	/* Ensure the logical sector has been allocated. */
 
-	if (req->logsector >= dev->totalsectors) {
+	if (req->logsector >= SMART_NSECTORS(dev)) {
 		fdbg("Logical sector %d too large\n", req->logsector);
 
 		ret = -EINVAL;
@@ -4164,7 +5078,12 @@ relocate_good_sector:
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 	physsector = dev->sMap[req->logsector];
 #else
-	physsector = smart_cache_lookup(dev, req->logsector);
+	ret = smart_cache_lookup(dev, req->logsector);
+	if (ret < 0) {
+		goto errout;
+	}
+
+	physsector = (uint16_t)ret;
 #endif
 	if (physsector == 0xFFFF) {
 		fdbg("Logical sector %d not allocated\n", req->logsector);
@@ -4614,7 +5533,7 @@ static int smart_readsector(FAR struct smart_struct_s *dev, unsigned long arg)
 
 	/* Ensure the logical sector has been allocated. */
 
-	if (req->logsector >= dev->totalsectors) {
+	if (req->logsector >= SMART_NSECTORS(dev)) {
 		fdbg("Logical sector %d too large\n", req->logsector);
 
 		ret = -EINVAL;
@@ -4623,7 +5542,12 @@ static int smart_readsector(FAR struct smart_struct_s *dev, unsigned long arg)
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 	physsector = dev->sMap[req->logsector];
 #else
-	physsector = smart_cache_lookup(dev, req->logsector);
+	ret = smart_cache_lookup(dev, req->logsector);
+	if (ret < 0) {
+		goto errout;
+	}
+
+	physsector = (uint16_t)ret;
 #endif
 	if (physsector == 0xFFFF) {
 		fdbg("Logical sector %d not allocated\n", req->logsector);
@@ -4762,7 +5686,7 @@ static inline int smart_allocsector(FAR struct smart_struct_s *dev, unsigned lon
 	/* Check if a specific sector is being requested and allocate that
 	 * sector if it isn't already in use. */
 
-	if ((requested > 2) && (requested < dev->totalsectors)) {
+	if ((requested > 2) && (requested < SMART_NSECTORS(dev))) {
 		/* Validate the sector is not already allocated. */
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
@@ -4795,7 +5719,7 @@ static inline int smart_allocsector(FAR struct smart_struct_s *dev, unsigned lon
 
 	if (logsector == 0xFFFF) {
 		/* Loop through all sectors and find one to allocate. */
-		for (x = dev->reservedsector; x < dev->totalsectors; x++) {
+		for (x = dev->reservedsector; x < SMART_NSECTORS(dev); x++) {
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 			if (dev->sMap[x] == (uint16_t)-1)
 #else
@@ -4898,14 +5822,9 @@ static inline int smart_allocsector(FAR struct smart_struct_s *dev, unsigned lon
 	}
 #endif							/* CONFIG_MTD_SMART_ENABLE_CRC */
 
-	/* Map the sector and update the free sector counts. */
-
-#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
-	dev->sMap[logsector] = physicalsector;
-#else
-	dev->sBitMap[logsector >> 3] |= (1 << (logsector & 0x07));
-	smart_add_sector_to_cache(dev, logsector, physicalsector, __LINE__);
-#endif
+	/* Update the free sector counts and map the sector.  The counts come
+	 * first, updating the map may write a map page.
+	 */
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
 	smart_add_count(dev, dev->freecount, physicalsector / dev->sectorsPerBlk, -1);
@@ -4914,6 +5833,13 @@ static inline int smart_allocsector(FAR struct smart_struct_s *dev, unsigned lon
 #endif
 	dev->freesectors--;
 
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+	dev->sMap[logsector] = physicalsector;
+#else
+	dev->sBitMap[logsector >> 3] |= (1 << (logsector & 0x07));
+	smart_update_cache(dev, logsector, physicalsector);
+#endif
+
 	/* Return the logical sector number. */
 
 	return logsector;
@@ -4941,7 +5867,7 @@ static inline int smart_freesector(FAR struct smart_struct_s *dev, unsigned long
 
 	/* Check if the logical sector is within bounds. */
 
-	if ((logicalsector > 2) && (logicalsector < dev->totalsectors)) {
+	if ((logicalsector > 2) && (logicalsector < SMART_NSECTORS(dev))) {
 		/* Validate the sector is actually allocated. */
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
@@ -4956,12 +5882,25 @@ static inline int smart_freesector(FAR struct smart_struct_s *dev, unsigned long
 		}
 	}
 
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	if (logicalsector >= dev->mapsector) {
+		fdbg("Invalid release - sector %d is a map page\n", logicalsector);
+		ret = -EINVAL;
+		goto errout;
+	}
+#endif
+
 	/* Okay to release the sector.  Read the sector header info. */
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 	physsector = dev->sMap[logicalsector];
 #else
-	physsector = smart_cache_lookup(dev, logicalsector);
+	ret = smart_cache_lookup(dev, logicalsector);
+	if (ret < 0) {
+		goto errout;
+	}
+
+	physsector = (uint16_t)ret;
 #endif
 	readaddr = physsector * dev->mtdBlksPerSector * dev->geo.blocksize;
 	ret = MTD_READ(dev->mtd, readaddr, sizeof(struct smart_sect_header_s), (FAR uint8_t *)&header);
@@ -5026,87 +5965,681 @@ errout:
 #endif							/* CONFIG_FS_WRITABLE */
 
 /****************************************************************************
- * Name: smart_ioctl
+ * Name: smart_checkpoint_layout
  *
- * Description: Return device geometry.
+ * Description: Returns the options which change the layout of the state
+ *              saved in a checkpoint.
  *
  ****************************************************************************/
 
-static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static uint8_t smart_checkpoint_layout(void)
 {
-	FAR struct smart_struct_s *dev;
-	int ret;
-#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
-	FAR struct mtd_smart_procfs_data_s *procfs_data;
-	FAR struct mtd_smart_debug_data_s *debug_data;
-#endif
-	fvdbg("Entry cmd : %08x\n", cmd);
-	DEBUGASSERT(inode && inode->i_private);
+	uint8_t layout = 0;
 
-#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
-	dev = ((FAR struct smart_multiroot_device_s *)inode->i_private)->dev;
-#else
-	dev = (FAR struct smart_struct_s *)inode->i_private;
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	layout |= 0x01;
+#endif
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+	layout |= 0x02;
+#endif
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+	layout |= 0x04;
+#endif
+#ifdef CONFIG_SMARTFS_BAD_SECTOR
+	layout |= 0x08;
 #endif
 
-	/* Process the ioctl's we care about first, pass any we don't respond
-	 * to directly to the underlying MTD device.
-	 */
-
-	switch (cmd) {
-	case BIOC_XIPBASE:
-		/* The argument accompanying the BIOC_XIPBASE should be non-NULL.  If
-		 * DEBUG is enabled, we will catch it here instead of in the MTD
-		 * driver.
-		 */
-
-#ifdef CONFIG_DEBUG
-		if (arg == 0) {
-			fdbg("ERROR: BIOC_XIPBASE argument is NULL\n");
-			return -EINVAL;
-		}
+	return layout;
+}
 #endif
 
-		/* Just change the BIOC_XIPBASE command to the MTDIOC_XIPBASE command. */
+/****************************************************************************
+ * Name: smart_checkpoint_segments
+ *
+ * Description: Describes the RAM state saved in a checkpoint as a list of
+ *              segments, the scalar state first.  Returns the number of
+ *              segments and their total size in *size.
+ *
+ ****************************************************************************/
 
-		cmd = MTDIOC_XIPBASE;
-		break;
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_checkpoint_segments(FAR struct smart_struct_s *dev, FAR struct smart_cpstate_s *state, FAR struct smart_cpseg_s *segs, FAR uint32_t *size)
+{
+	int nsegs = 0;
+	int x;
 
-	case BIOC_GETFORMAT:
+	segs[nsegs].ptr = (FAR uint8_t *)state;
+	segs[nsegs++].len = sizeof(struct smart_cpstate_s);
 
-		/* Return the format information for the device. */
+	/* The release and free counts are allocated together. */
 
-#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
-		ret = smart_getformat(dev, (FAR struct smart_format_s *)arg, ((FAR struct smart_multiroot_device_s *)inode->i_private)->rootdirnum);
+	segs[nsegs].ptr = dev->releasecount;
+	segs[nsegs++].len = dev->countsize;
+
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+	segs[nsegs].ptr = (FAR uint8_t *)dev->sMap;
+	segs[nsegs++].len = dev->totalsectors * sizeof(uint16_t);
 #else
-		ret = smart_getformat(dev, (FAR struct smart_format_s *)arg);
+	segs[nsegs].ptr = dev->sBitMap;
+	segs[nsegs++].len = (dev->totalsectors + 7) >> 3;
+	segs[nsegs].ptr = (FAR uint8_t *)dev->mapdir;
+	segs[nsegs++].len = dev->mappages * sizeof(struct smart_mapdir_s);
 #endif
-		goto ok_out;
 
-	case BIOC_READSECT:
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+	segs[nsegs].ptr = dev->wearstatus;
+	segs[nsegs++].len = dev->neraseblocks >> SMART_WEAR_BIT_DIVIDE;
+#endif
 
-		/* Do a logical sector read and return the data. */
-		ret = smart_readsector(dev, arg);
-		goto ok_out;
+#ifdef CONFIG_SMARTFS_BAD_SECTOR
+	segs[nsegs].ptr = (FAR uint8_t *)dev->badSectorList;
+	segs[nsegs++].len = dev->totalsectors * sizeof(bool);
+#endif
 
-#ifdef CONFIG_FS_WRITABLE
-	case BIOC_LLFORMAT:
+	DEBUGASSERT(nsegs <= SMART_CP_MAXSEGS);
 
-		/* Perform a low-level format on the flash. */
+	*size = 0;
+	for (x = 0; x < nsegs; x++) {
+		*size += segs[x].len;
+	}
 
-		ret = smart_llformat(dev, arg);
-		goto ok_out;
+	return nsegs;
+}
+#endif
 
-	case BIOC_ALLOCSECT:
+/****************************************************************************
+ * Name: smart_checkpoint_reserve
+ *
+ * Description: Takes the erase blocks of the checkpoint from the end of the
+ *              device.  They are sized for the largest state the device can
+ *              have with the configured sector size, so that they stay in
+ *              place when the volume is formatted again.  The caller must
+ *              set the sector size again afterwards.
+ *
+ ****************************************************************************/
 
-		/* Allocate a logical sector for the upper layer file system. */
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_checkpoint_reserve(FAR struct smart_struct_s *dev)
+{
+	uint32_t sectors;
+	uint32_t size;
 
-		ret = smart_allocsector(dev, arg);
-		goto ok_out;
+	sectors = dev->geo.neraseblocks * (dev->geo.erasesize / CONFIG_MTD_SMART_SECTOR_SIZE);
+	size = dev->geo.blocksize + sizeof(struct smart_cpstate_s) + (dev->geo.neraseblocks << 1);
 
-	case BIOC_FREESECT:
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+	size += sectors * sizeof(uint16_t);
+#else
+	size += ((sectors + 7) >> 3) + (sectors / ((CONFIG_MTD_SMART_SECTOR_SIZE - SMART_MAP_OFFSET) / sizeof(uint16_t)) + 1) * sizeof(struct smart_mapdir_s);
+#endif
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+	size += dev->geo.neraseblocks >> SMART_WEAR_BIT_DIVIDE;
+#endif
+#ifdef CONFIG_SMARTFS_BAD_SECTOR
+	size += sectors * sizeof(bool);
+#endif
 
-		/* Free the specified logical sector. */
+	dev->cpblocks = (size + dev->geo.erasesize - 1) / dev->geo.erasesize;
+	if (dev->cpblocks + 4 > dev->geo.neraseblocks) {
+		fdbg("Device too small for a checkpoint\n");
+		dev->cpblocks = 0;
+	}
+
+	dev->geo.neraseblocks -= dev->cpblocks;
+	dev->cpblock = dev->geo.neraseblocks;
+	dev->cpwrites = 0;
+	dev->cpvalid = false;
+	dev->cpcurrent = false;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_signed
+ *
+ * Description: Tells if a physical sector is the format sector, and if so
+ *              whether the format reserved the checkpoint blocks.
+ *
+ * Returned Value:
+ *   1 if it is the format sector with the checkpoint signature, 0 if it is
+ *   the format sector without it, -ENOENT if it isn't the format sector or
+ *   a negated errno on a read error.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_checkpoint_signed(FAR struct smart_struct_s *dev, uint16_t sector)
+{
+	struct smart_sect_header_s header;
+	uint16_t logicalsector;
+	uint32_t readaddress;
+	uint8_t signature;
+	int ret;
+
+	if (sector >= dev->totalsectors) {
+		return -ENOENT;
+	}
+
+	readaddress = sector * dev->mtdBlksPerSector * dev->geo.blocksize;
+	ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s), (FAR uint8_t *)&header);
+	if (ret != sizeof(struct smart_sect_header_s)) {
+		return -EIO;
+	}
+
+	/* The format sector is written with logical sector 0xFFFF when the
+	 * erased state is 0x00.
+	 */
+
+	logicalsector = UINT8TOUINT16(header.logicalsector);
+#if CONFIG_SMARTFS_ERASEDSTATE == 0x00
+	logicalsector = ~logicalsector;
+#endif
+	if (logicalsector != 0 || header.status == CONFIG_SMARTFS_ERASEDSTATE || !SECTOR_IS_COMMITTED(header) || SECTOR_IS_RELEASED(header) || (header.status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION) {
+		return -ENOENT;
+	}
+
+	ret = MTD_READ(dev->mtd, readaddress + SMART_FMT_CP_POS, 1, &signature);
+	if (ret != 1) {
+		return -EIO;
+	}
+
+	return signature == SMART_FMT_CP_SIG ? 1 : 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_check
+ *
+ * Description: Looks for the checkpoint signature in the format sector.
+ *              A volume formatted without it may have live sectors in the
+ *              checkpoint blocks, so they are given back to the volume and
+ *              no checkpoint is loaded or written until the next format.
+ *              The sector size must be set.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_checkpoint_check(FAR struct smart_struct_s *dev)
+{
+	uint16_t sectorsize;
+	int sector;
+	int ret;
+
+	if (dev->cpblocks == 0) {
+		return OK;
+	}
+
+	/* Find the format sector.  It is never in the checkpoint blocks of a
+	 * volume which reserves them.
+	 */
+
+	ret = -ENOENT;
+	for (sector = 0; sector < dev->totalsectors && ret == -ENOENT; sector++) {
+		ret = smart_checkpoint_signed(dev, sector);
+	}
+
+	if (ret == 1) {
+		return OK;
+	} else if (ret < 0 && ret != -ENOENT) {
+		return ret;
+	}
+
+	fdbg("Volume was not formatted with the checkpoint blocks\n");
+	dev->geo.neraseblocks += dev->cpblocks;
+	dev->cpblocks = 0;
+	dev->cpvalid = false;
+	dev->cpcurrent = false;
+
+	sectorsize = dev->sectorsize;
+	dev->sectorsize = 0;
+	return smart_setsectorsize(dev, sectorsize);
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_invalidate
+ *
+ * Description: Marks the checkpoint invalid before the volume is modified,
+ *              so that the next mount scans the device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_checkpoint_invalidate(FAR struct smart_struct_s *dev)
+{
+	uint8_t invalid = SMART_CP_INVALID;
+	int ret;
+
+	dev->cpcurrent = false;
+	if (dev->cpwrites < 0xFFFF) {
+		dev->cpwrites++;
+	}
+
+	if (dev->cpvalid) {
+		ret = smart_bytewrite(dev, dev->cpblock * dev->geo.erasesize + offsetof(struct smart_cphdr_s, valid), 1, &invalid);
+		if (ret < 0) {
+			fdbg("Error %d invalidating the checkpoint\n", -ret);
+			return ret;
+		}
+
+		dev->cpvalid = false;
+	}
+
+	return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_write
+ *
+ * Description: Saves the RAM state of the volume in the checkpoint blocks.
+ *              The state is written first and the header last, so a torn
+ *              checkpoint fails its CRC.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_checkpoint_write(FAR struct smart_struct_s *dev)
+{
+	struct smart_cpstate_s state;
+	struct smart_cpseg_s segs[SMART_CP_MAXSEGS];
+	FAR struct smart_cphdr_s *header;
+	uint32_t block;
+	uint32_t nblocks;
+	uint32_t size;
+	uint32_t offset;
+	uint32_t fill;
+	uint32_t len;
+	uint32_t crc;
+	int nsegs;
+	int x;
+	int ret;
+
+	/* No checkpoint blocks means the volume wasn't formatted to reserve
+	 * them, and they may hold live sectors.
+	 */
+
+	if (dev->cpblocks == 0 || dev->cpcurrent || dev->formatstatus != SMART_FMT_STAT_FORMATTED) {
+		return OK;
+	}
+
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+	/* Sectors which are allocated but not written yet are only in RAM. */
+
+	if (dev->allocsector != NULL) {
+		return OK;
+	}
+#endif
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	ret = smart_map_flush(dev);
+	if (ret < 0) {
+		return ret;
+	}
+#endif
+
+	ret = smart_checkpoint_invalidate(dev);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* Collect the scalar state. */
+
+	memset(&state, 0, sizeof(state));
+	state.freesectors = dev->freesectors;
+	state.releasesectors = dev->releasesectors;
+	state.reservedsector = dev->reservedsector;
+	state.formatversion = dev->formatversion;
+	state.namesize = dev->namesize;
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+	state.rootdirentries = dev->rootdirentries;
+#endif
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+	state.wearflags = dev->wearflags;
+	state.minwearlevel = dev->minwearlevel;
+	state.maxwearlevel = dev->maxwearlevel;
+	state.uneven_wearcount = dev->uneven_wearcount;
+#endif
+
+	nsegs = smart_checkpoint_segments(dev, &state, segs, &size);
+	if (dev->geo.blocksize + size > dev->cpblocks * dev->geo.erasesize) {
+		fdbg("Checkpoint of %d bytes doesn't fit\n", size);
+		return OK;
+	}
+
+	ret = MTD_ERASE(dev->mtd, dev->cpblock, dev->cpblocks);
+	if (ret < 0) {
+		fdbg("Error %d erasing the checkpoint\n", -ret);
+		return ret;
+	}
+
+	/* Write the state behind the header block, a sector at a time. */
+
+	block = dev->cpblock * (dev->geo.erasesize / dev->geo.blocksize) + 1;
+	fill = 0;
+	crc = 0;
+	for (x = 0; x < nsegs; x++) {
+		for (offset = 0; offset < segs[x].len; offset += len) {
+			len = segs[x].len - offset;
+			if (len > dev->sectorsize - fill) {
+				len = dev->sectorsize - fill;
+			}
+
+			memcpy(&dev->rwbuffer[fill], &segs[x].ptr[offset], len);
+			fill += len;
+
+			if (fill == dev->sectorsize || (x == nsegs - 1 && offset + len == segs[x].len)) {
+				crc = crc32part((FAR uint8_t *)dev->rwbuffer, fill, crc);
+				memset(&dev->rwbuffer[fill], CONFIG_SMARTFS_ERASEDSTATE, dev->sectorsize - fill);
+				nblocks = (fill + dev->geo.blocksize - 1) / dev->geo.blocksize;
+				ret = MTD_BWRITE(dev->mtd, block, nblocks, (FAR uint8_t *)dev->rwbuffer);
+				if (ret != nblocks) {
+					fdbg("Error writing the checkpoint\n");
+					return -EIO;
+				}
+
+				block += nblocks;
+				fill = 0;
+			}
+		}
+	}
+
+	/* Now write the header, which makes the checkpoint valid. */
+
+	header = (FAR struct smart_cphdr_s *)dev->rwbuffer;
+	memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->geo.blocksize);
+	memcpy(header->magic, SMART_CP_MAGIC, sizeof(header->magic));
+	header->valid = SMART_CP_VALID;
+	header->layout = smart_checkpoint_layout();
+	header->sectorsize = dev->sectorsize;
+	header->totalsectors = dev->totalsectors;
+	header->neraseblocks = dev->neraseblocks;
+	header->length = size;
+	header->crc = crc32part((FAR uint8_t *)header, offsetof(struct smart_cphdr_s, crc), crc);
+
+	ret = MTD_BWRITE(dev->mtd, dev->cpblock * (dev->geo.erasesize / dev->geo.blocksize), 1, (FAR uint8_t *)dev->rwbuffer);
+	if (ret != 1) {
+		fdbg("Error writing the checkpoint header\n");
+		return -EIO;
+	}
+
+	dev->cpvalid = true;
+	dev->cpcurrent = true;
+	dev->cpwrites = 0;
+	fvdbg("Wrote a checkpoint of %d bytes\n", size);
+	return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_load
+ *
+ * Description: Restores the RAM state of the volume from the checkpoint
+ *              blocks instead of scanning the device.  Fails if there is
+ *              no checkpoint, or if it is stale, torn, was saved with a
+ *              different geometry or configuration, or if the format
+ *              sector it maps doesn't have the checkpoint signature.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_checkpoint_load(FAR struct smart_struct_s *dev)
+{
+	struct smart_cphdr_s header;
+	struct smart_cpstate_s state;
+	struct smart_cpseg_s segs[SMART_CP_MAXSEGS];
+	uint32_t address;
+	uint32_t offset;
+	uint32_t size;
+	uint32_t len;
+	uint32_t crc;
+	int nsegs;
+	int x;
+	int ret;
+
+	if (dev->cpblocks == 0) {
+		return -ENOENT;
+	}
+
+	address = dev->cpblock * dev->geo.erasesize;
+	ret = MTD_READ(dev->mtd, address, sizeof(header), (FAR uint8_t *)&header);
+	if (ret != sizeof(header)) {
+		return -EIO;
+	}
+
+	if (memcmp(header.magic, SMART_CP_MAGIC, sizeof(header.magic)) != 0) {
+		return -ENOENT;
+	}
+
+	if (header.valid != SMART_CP_VALID) {
+		fvdbg("Checkpoint is stale\n");
+		return -ESTALE;
+	}
+
+	if (header.layout != smart_checkpoint_layout()) {
+		fdbg("Checkpoint was saved with different options\n");
+		ret = -EINVAL;
+		goto errout;
+	}
+
+	if (header.sectorsize != dev->sectorsize) {
+		ret = smart_setsectorsize(dev, header.sectorsize);
+		if (ret != OK) {
+			goto errout;
+		}
+	}
+
+	nsegs = smart_checkpoint_segments(dev, &state, segs, &size);
+	if (header.totalsectors != dev->totalsectors || header.neraseblocks != dev->neraseblocks || header.length != size) {
+		fdbg("Checkpoint doesn't match the geometry\n");
+		ret = -EINVAL;
+		goto errout;
+	}
+
+	/* Check the CRC before any of the RAM state is replaced. */
+
+	address += dev->geo.blocksize;
+	crc = 0;
+	for (offset = 0; offset < size; offset += len) {
+		len = size - offset;
+		if (len > dev->sectorsize) {
+			len = dev->sectorsize;
+		}
+
+		ret = MTD_READ(dev->mtd, address + offset, len, (FAR uint8_t *)dev->rwbuffer);
+		if (ret != len) {
+			ret = -EIO;
+			goto errout;
+		}
+
+		crc = crc32part((FAR uint8_t *)dev->rwbuffer, len, crc);
+	}
+
+	if (crc32part((FAR uint8_t *)&header, offsetof(struct smart_cphdr_s, crc), crc) != header.crc) {
+		fdbg("Checkpoint is torn\n");
+		ret = -EINVAL;
+		goto errout;
+	}
+
+	/* Load the state. */
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	smart_map_reset(dev);
+#endif
+
+	for (x = 0; x < nsegs; x++) {
+		ret = MTD_READ(dev->mtd, address, segs[x].len, segs[x].ptr);
+		if (ret != segs[x].len) {
+			ret = -EIO;
+			goto errout;
+		}
+
+		address += segs[x].len;
+	}
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	/* The map page cache is empty. */
+
+	for (x = 0; x < dev->mappages; x++) {
+		dev->mapdir[x].cached = SMART_MAP_NONE;
+	}
+#endif
+
+	/* The format sector the checkpoint maps must say that the volume was
+	 * formatted to reserve the checkpoint blocks.
+	 */
+
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+	ret = smart_checkpoint_signed(dev, dev->sMap[0]);
+#else
+	ret = smart_cache_lookup(dev, 0);
+	if (ret >= 0) {
+		ret = smart_checkpoint_signed(dev, (uint16_t)ret);
+	}
+#endif
+	if (ret != 1) {
+		fdbg("Checkpoint doesn't map a format sector with its signature\n");
+		ret = ret < 0 ? ret : -ENOENT;
+		goto errout;
+	}
+
+	dev->freesectors = state.freesectors;
+	dev->releasesectors = state.releasesectors;
+	dev->reservedsector = state.reservedsector;
+	dev->formatversion = state.formatversion;
+	dev->namesize = state.namesize;
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+	dev->wearflags = state.wearflags;
+	dev->minwearlevel = state.minwearlevel;
+	dev->maxwearlevel = state.maxwearlevel;
+	dev->uneven_wearcount = state.uneven_wearcount;
+#endif
+	dev->formatstatus = SMART_FMT_STAT_FORMATTED;
+	dev->cpvalid = true;
+	dev->cpcurrent = true;
+
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+	dev->rootdirentries = state.rootdirentries;
+	ret = smart_register_rootdirs(dev);
+	if (ret < 0) {
+		return ret;
+	}
+#endif
+
+	fvdbg("Loaded a checkpoint of %d bytes\n", size);
+	return OK;
+
+errout:
+	/* A checkpoint which can't be used must be invalidated before the
+	 * volume is modified, unless its blocks belong to the volume.
+	 */
+
+	if (smart_checkpoint_check(dev) == OK && dev->cpblocks > 0) {
+		dev->cpvalid = true;
+	}
+
+	return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ioctl
+ *
+ * Description: Return device geometry.
+ *
+ ****************************************************************************/
+
+static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+	FAR struct smart_struct_s *dev;
+	int ret;
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
+	FAR struct mtd_smart_procfs_data_s *procfs_data;
+	FAR struct mtd_smart_debug_data_s *debug_data;
+#endif
+	fvdbg("Entry cmd : %08x\n", cmd);
+	DEBUGASSERT(inode && inode->i_private);
+
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+	dev = ((FAR struct smart_multiroot_device_s *)inode->i_private)->dev;
+#else
+	dev = (FAR struct smart_struct_s *)inode->i_private;
+#endif
+
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+	smart_semtake(dev);
+#endif
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+	/* The checkpoint no longer describes the volume once it is modified. */
+
+	if (cmd == BIOC_LLFORMAT || cmd == BIOC_ALLOCSECT || cmd == BIOC_FREESECT || cmd == BIOC_WRITESECT) {
+		ret = smart_checkpoint_invalidate(dev);
+		if (ret < 0) {
+			goto ok_out;
+		}
+	}
+#endif
+
+	/* Process the ioctl's we care about first, pass any we don't respond
+	 * to directly to the underlying MTD device.
+	 */
+
+	switch (cmd) {
+	case BIOC_XIPBASE:
+		/* The argument accompanying the BIOC_XIPBASE should be non-NULL.  If
+		 * DEBUG is enabled, we will catch it here instead of in the MTD
+		 * driver.
+		 */
+
+#ifdef CONFIG_DEBUG
+		if (arg == 0) {
+			fdbg("ERROR: BIOC_XIPBASE argument is NULL\n");
+			ret = -EINVAL;
+			goto ok_out;
+		}
+#endif
+
+		/* Just change the BIOC_XIPBASE command to the MTDIOC_XIPBASE command. */
+
+		cmd = MTDIOC_XIPBASE;
+		break;
+
+	case BIOC_GETFORMAT:
+
+		/* Return the format information for the device. */
+
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+		ret = smart_getformat(dev, (FAR struct smart_format_s *)arg, ((FAR struct smart_multiroot_device_s *)inode->i_private)->rootdirnum);
+#else
+		ret = smart_getformat(dev, (FAR struct smart_format_s *)arg);
+#endif
+		goto ok_out;
+
+	case BIOC_READSECT:
+
+		/* Do a logical sector read and return the data. */
+		ret = smart_readsector(dev, arg);
+		goto ok_out;
+
+#ifdef CONFIG_FS_WRITABLE
+	case BIOC_LLFORMAT:
+
+		/* Perform a low-level format on the flash. */
+
+		ret = smart_llformat(dev, arg);
+		goto ok_out;
+
+	case BIOC_ALLOCSECT:
+
+		/* Allocate a logical sector for the upper layer file system. */
+
+		ret = smart_allocsector(dev, arg);
+		goto ok_out;
+
+	case BIOC_FREESECT:
+
+		/* Free the specified logical sector. */
 
 		ret = smart_freesector(dev, arg);
 		goto ok_out;
@@ -5126,6 +6659,22 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #endif
 
 		goto ok_out;
+
+	case BIOC_FLUSH:
+
+		/* Save the state of the volume at a sync point. */
+
+		ret = OK;
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+		if (CONFIG_MTD_SMART_CHECKPOINT_INTERVAL > 0 && dev->cpwrites >= CONFIG_MTD_SMART_CHECKPOINT_INTERVAL) {
+			ret = smart_checkpoint_write(dev);
+			goto ok_out;
+		}
+#endif
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+		ret = smart_map_flush(dev);
+#endif
+		goto ok_out;
 #endif							/* CONFIG_FS_WRITABLE */
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
@@ -5148,8 +6697,18 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 		procfs_data->formatsector = dev->sMap[0];
 		procfs_data->dirsector = dev->sMap[3];
 #else
-		procfs_data->formatsector = smart_cache_lookup(dev, 0);
-		procfs_data->dirsector = smart_cache_lookup(dev, 3);
+		ret = smart_cache_lookup(dev, 0);
+		if (ret < 0) {
+			goto ok_out;
+		}
+
+		procfs_data->formatsector = (uint16_t)ret;
+		ret = smart_cache_lookup(dev, 3);
+		if (ret < 0) {
+			goto ok_out;
+		}
+
+		procfs_data->dirsector = (uint16_t)ret;
 #endif
 
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
@@ -5162,6 +6721,11 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #endif
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
 		procfs_data->uneven_wearcount = dev->uneven_wearcount;
+#endif
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+		procfs_data->gcbgblocks = dev->gcbgblocks;
+		procfs_data->gcfgblocks = dev->gcfgblocks;
+		procfs_data->gcfgmax = dev->gcfgmax;
 #endif
 		ret = OK;
 		goto ok_out;
@@ -5195,6 +6759,9 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 	}
 
 ok_out:
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+	smart_semgive(dev);
+#endif
 	return ret;
 }
 
@@ -5251,6 +6818,14 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 			dev->alloc[totalsectors].ptr = NULL;
 		}
 #endif
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+		sem_init(&dev->exclsem, 0, 1);
+		memset(&dev->gcwork, 0, sizeof(struct work_s));
+		dev->gcclosed = false;
+		dev->gcbgblocks = 0;
+		dev->gcfgblocks = 0;
+		dev->gcfgmax = 0;
+#endif
 
 		/* Get the device geometry. (casting to uintptr_t first eliminates
 		 * complaints on some architectures where the sizeof long is different
@@ -5265,6 +6840,10 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 			goto errout;
 		}
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+		smart_checkpoint_reserve(dev);
+#endif
+
 		/* Set the sector size to the default for now. */
 
 #ifdef CONFIG_SMARTFS_BAD_SECTOR
@@ -5275,7 +6854,7 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 		dev->sMap = NULL;
 #else
-		dev->sCache = NULL;
+		dev->mapcache = NULL;
 		dev->sBitMap = NULL;
 #endif
 		dev->rwbuffer = NULL;
@@ -5371,9 +6950,21 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
 			goto errout;
 		}
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+		/* Restore the volume from the checkpoint if it is current, else
+		 * do a scan of the device.
+		 */
+
+		ret = smart_checkpoint_load(dev);
+		if (ret != OK) {
+			smart_checkpoint_invalidate(dev);
+			smart_scan(dev);
+		}
+#else
 		/* Do a scan of the device. */
 
 		smart_scan(dev);
+#endif
 	}
 
 	return OK;
@@ -5385,7 +6976,9 @@ errout:
 	}
 #else
 	smart_free(dev, dev->sBitMap);
-	smart_free(dev, dev->sCache);
+	if (dev->mapcache != NULL) {
+		smart_free(dev, dev->mapcache);
+	}
 #endif
 	if (dev->rwbuffer != NULL) {
 		smart_free(dev, dev->rwbuffer);
@@ -5425,6 +7018,9 @@ int smart_validatesector(FAR struct inode *inode, uint16_t logsector, char *vali
 {
 	FAR struct smart_struct_s *dev;
 	uint16_t physsector;
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+	int ret;
+#endif
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
 	dev = ((FAR struct smart_multiroot_device_s *)inode->i_private)->dev;
 #else
@@ -5438,7 +7034,12 @@ int smart_validatesector(FAR struct inode *inode, uint16_t logsector, char *vali
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 	physsector = dev->sMap[logsector];
 #else
-	physsector = smart_cache_lookup(dev, logsector);
+	ret = smart_cache_lookup(dev, logsector);
+	if (ret < 0) {
+		return ret;
+	}
+
+	physsector = (uint16_t)ret;
 #endif
 	if (physsector != 0xFFFF) {
 		SET_TO_TRUE(validsectors, physsector);
@@ -5495,10 +7096,21 @@ int smart_recoversectors(FAR struct inode *inode, char *validsectors, int *nobso
 			/* No logical sector info. Sector must be unallocated. */
 			continue;
 		}
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+		if (logicalsector >= dev->mapsector) {
+			/* Map pages belong to the MTD layer, not the file system. */
+			continue;
+		}
+#endif
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
 		physsector = dev->sMap[logicalsector];
 #else
-		physsector = smart_cache_lookup(dev, logicalsector);
+		ret = smart_cache_lookup(dev, logicalsector);
+		if (ret < 0) {
+			goto err_out;
+		}
+
+		physsector = (uint16_t)ret;
 #endif
 
 		status_released = SECTOR_IS_RELEASED(header);
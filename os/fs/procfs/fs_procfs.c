@@ -104,9 +104,13 @@ extern const struct procfs_operations version_operations;
 extern const struct procfs_operations mtd_procfsoperations;
 extern const struct procfs_operations part_procfsoperations;
 extern const struct procfs_operations smartfs_procfsoperations;
+extern const struct procfs_operations bch_procfsoperations;
+extern const struct procfs_operations binmgr_operations;
+extern const struct procfs_operations lpwork_operations;
 extern const struct procfs_operations power_procfsoperations;
 extern const struct procfs_operations cm_operations;
 extern const struct procfs_operations irqs_operations;
+extern const struct procfs_operations pools_operations;
 extern const struct procfs_operations ereport_operations;
 
 /* And even worse, this one is specific to the STM32.  The solution to
@@ -129,6 +133,18 @@ static const struct procfs_entry_s g_procfsentries[] = {
 	{"cpuload", &cpuload_operations},
 #endif
 
+#if defined(CONFIG_BINMGR_LOAD_STATS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BINMGR)
+	{"binmgr", &binmgr_operations},
+#endif
+
+#if defined(CONFIG_SCHED_LPWORK_POOL) && !defined(CONFIG_FS_PROCFS_EXCLUDE_LPWORK)
+	{"lpwork", &lpwork_operations},
+#endif
+
+#if defined(CONFIG_BCH) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BCH)
+	{"bch", &bch_procfsoperations},
+#endif
+
 #if defined(CONFIG_FS_SMARTFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
 	{"fs/smartfs**", &smartfs_procfsoperations},
 #endif
@@ -137,6 +153,10 @@ static const struct procfs_entry_s g_procfsentries[] = {
 	{"irqs", &irqs_operations},
 #endif
 
+#if defined(CONFIG_MM_POOL) && !defined(CONFIG_FS_PROCFS_EXCLUDE_POOLS)
+	{"pools", &pools_operations},
+#endif
+
 #if defined(CONFIG_MTD) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MTD)
 	{"mtd", &mtd_procfsoperations},
 #endif
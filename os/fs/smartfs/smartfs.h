@@ -218,10 +218,11 @@
 #define CONFIG_SMARTFS_DIRDEPTH 8
 #endif
 
-/* Buffer flags (when CRC enabled) */
+/* Buffer flags (when the sector buffer is used) */
 
 #define SMARTFS_BFLAG_DIRTY       0x01	/* Set if data changed in the sector */
 #define SMARTFS_BFLAG_NEWALLOC    0x02	/* Set if sector not written since alloc */
+#define SMARTFS_BFLAG_VALID       0x04	/* Set if the buffer holds currsector */
 
 #define SMARTFS_ERASEDSTATE_16BIT (uint16_t)((CONFIG_SMARTFS_ERASEDSTATE << 8) | \
 								  CONFIG_SMARTFS_ERASEDSTATE)
@@ -232,7 +233,7 @@
 #define UINT8_TO_UINT16(UINT8_ARRAY)                    ((uint16_t)(((uint16_t)UINT8_ARRAY[1] << 8) & 0xFF00) | UINT8_ARRAY[0])
 #define SMARTFS_NEXTSECTOR(h)   (UINT8_TO_UINT16(h->nextsector))
 #define SMARTFS_USED(h)                 (UINT8_TO_UINT16(h->used))
-#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+#if defined(CONFIG_MTD_SMART_ENABLE_CRC) || defined(CONFIG_SMARTFS_WRITEBACK_BUFFER)
 #define CONFIG_SMARTFS_USE_SECTOR_BUFFER
 #endif
 #ifdef CONFIG_SMARTFS_BAD_SECTOR
@@ -359,6 +360,29 @@ struct smartfs_ofile_s {
 								 * causes the sector to change. */
 };
 
+#ifdef CONFIG_SMARTFS_DIRINDEX
+/* This structure describes one directory entry in a directory name index.
+ * Only a hash of the name is kept, the entry is confirmed by reading the
+ * directory sector.
+ */
+
+struct smartfs_dirindex_entry_s {
+	uint16_t hash;				/* Hash of the entry name */
+	uint16_t sector;			/* Directory sector holding the entry */
+};
+
+/* This structure is the name index of one directory.  It is built by a scan
+ * of the directory on the first lookup and dropped when the directory changes.
+ */
+
+struct smartfs_dirindex_s {
+	uint16_t dirsector;			/* First sector of the directory */
+	uint16_t nentries;			/* Number of entries, sorted by hash */
+	uint32_t lastused;			/* LRU stamp, 0 if the slot is unused */
+	FAR struct smartfs_dirindex_entry_s *entries;
+};
+#endif
+
 /* This structure represents the overall mountpoint state.  An instance of this
  * structure is retained as inode private data on each mountpoint that is
  * mounted with a smartfs filesystem.
@@ -381,6 +405,10 @@ struct smartfs_mountpt_s {
 #endif
 #ifdef CONFIG_SMARTFS_JOURNALING
 	struct journal_transaction_manager_s *journal;
+#endif
+#ifdef CONFIG_SMARTFS_DIRINDEX
+	struct smartfs_dirindex_s fs_dirindex[CONFIG_SMARTFS_DIRINDEX_DIRS];
+	uint32_t fs_dirindex_stamp;	/* Last LRU stamp given to a directory index */
 #endif
 	uint8_t fs_rootsector;		/* Root directory sector num */
 };
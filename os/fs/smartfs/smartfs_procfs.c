@@ -752,6 +752,14 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer, size
 		if (ret == OK) {
 			/* Format and return data in the buffer */
 			len = snprintf(buffer, buflen, "Total Sectors    %d\nFree Sectors     %d\n" "Released Sectors %d\n", procfs_data.totalsectors, procfs_data.freesectors, procfs_data.releasesectors);
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+			if (len < buflen) {
+				len += snprintf(&buffer[len], buflen - len, "GC Background    %u\nGC Inline        %u\n" "GC Inline Max    %u\n", procfs_data.gcbgblocks, procfs_data.gcfgblocks, procfs_data.gcfgmax);
+				if (len >= buflen) {
+					len = buflen - 1;
+				}
+			}
+#endif
 #ifdef CONFIG_DEBUG_FS
 			/* Calculate the sector utilization percentage */
 			if (procfs_data.blockerases == 0) {
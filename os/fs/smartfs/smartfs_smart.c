@@ -117,6 +117,10 @@ static void smartfs_stat_common(FAR struct smartfs_mountpt_s *fs, FAR struct sma
 static int smartfs_stat(struct inode *mountpt, const char *relpath, struct stat *buf);
 
 static off_t smartfs_seek_internal(struct smartfs_mountpt_s *fs, struct smartfs_ofile_s *sf, off_t offset, int whence);
+static int smartfs_sync_internal(struct smartfs_mountpt_s *fs, struct smartfs_ofile_s *sf);
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+static int smartfs_loadbuffer(struct smartfs_mountpt_s *fs, struct smartfs_ofile_s *sf);
+#endif
 
 /****************************************************************************
  * Private Variables
@@ -209,7 +213,9 @@ static int smartfs_open(FAR struct file *filep, const char *relpath, int oflags,
 		goto errout_with_semaphore;
 	}
 
-	/* Allocate a sector buffer if CRC enabled in the MTD layer */
+	/* Allocate a sector buffer if CRC enabled in the MTD layer or if writes
+	 * are buffered.
+	 */
 
 #ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
 	sf->buffer = (uint8_t *)kmm_malloc(fs->fs_llformat.availbytes);
@@ -476,6 +482,9 @@ static ssize_t smartfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 	uint32_t bytesread;
 	uint16_t bytestoread;
 	uint16_t bytesinsector;
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+	uint16_t sector;
+#endif
 
 	/* Sanity checks */
 
@@ -493,6 +502,16 @@ static ssize_t smartfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 
 	smartfs_semtake(fs);
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+	/* The data is read from FLASH, so write out the buffered sector first */
+
+	sector = sf->currsector;
+	ret = smartfs_sync_internal(fs, sf);
+	if (ret < 0) {
+		goto errout_with_semaphore;
+	}
+#endif
+
 	/* Loop until all byte read or error */
 
 	bytesread = 0;
@@ -556,18 +575,20 @@ static ssize_t smartfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 		/* Test if we are at the end of the data in this sector */
 
 		if ((bytestoread == 0) || (sf->curroffset == fs->fs_llformat.availbytes)) {
-			/* Set the next sector as the current sector */
-
-			sf->currsector = SMARTFS_NEXTSECTOR(header);
-			sf->curroffset = sizeof(struct smartfs_chain_header_s);
-
-			/* Test if at end of data */
+			/* Test if at end of data.  Stay on the last sector so that a
+			 * following write appends to it.
+			 */
 
-			if (sf->currsector == SMARTFS_ERASEDSTATE_16BIT) {
+			if (SMARTFS_NEXTSECTOR(header) == SMARTFS_ERASEDSTATE_16BIT) {
 				/* No more data!  Return what we have */
 
 				break;
 			}
+
+			/* Set the next sector as the current sector */
+
+			sf->currsector = SMARTFS_NEXTSECTOR(header);
+			sf->curroffset = sizeof(struct smartfs_chain_header_s);
 		}
 	}
 
@@ -576,6 +597,11 @@ static ssize_t smartfs_read(FAR struct file *filep, char *buffer, size_t buflen)
 	ret = bytesread;
 
 errout_with_semaphore:
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+	if (sf->currsector != sector) {
+		sf->bflags &= ~SMARTFS_BFLAG_VALID;
+	}
+#endif
 	smartfs_semgive(fs);
 	return ret;
 }
@@ -597,10 +623,12 @@ static int smartfs_sync_internal(struct smartfs_mountpt_s *fs, struct smartfs_of
 	int used_value;
 #endif
 
-#if defined(CONFIG_SMARTFS_JOURNALING) && !defined(CONFIG_SMARTFS_USE_SECTOR_BUFFER)
+#ifdef CONFIG_SMARTFS_JOURNALING
 	int retj;
-	uint16_t used_bytes;
 	uint16_t t_sector, t_offset;
+#ifndef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+	uint16_t used_bytes;
+#endif
 #endif
 
 #ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
@@ -609,11 +637,11 @@ static int smartfs_sync_internal(struct smartfs_mountpt_s *fs, struct smartfs_of
 
 		header = (struct smartfs_chain_header_s *)sf->buffer;
 #ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
-		used_value = get_leftover_used_byte_count((uint8_t *)sf.buffer, get_used_byte_count((uint8_t *)header->used));
+		used_value = get_leftover_used_byte_count((uint8_t *)sf->buffer, get_used_byte_count((uint8_t *)header->used));
 		if (used_value == 0) {
 			set_used_byte_count((uint8_t *)header->used, sf->byteswritten);
 #else
-		if (header->used[0] == CONFIG_SMARTFS_ERASEDSTATE) {
+		if (SMARTFS_USED(header) == SMARTFS_ERASEDSTATE_16BIT) {
 			*((uint16_t *)header->used) = sf->byteswritten;
 #endif
 		} else {
@@ -624,21 +652,37 @@ static int smartfs_sync_internal(struct smartfs_mountpt_s *fs, struct smartfs_of
 #endif
 		}
 
-		/* Write the entire sector to FLASH */
+		/* Write the entire sector to FLASH.  All the writes merged in the
+		 * buffer since it was last written are one journal transaction.
+		 */
 
 		readwrite.logsector = sf->currsector;
 		readwrite.offset = 0;
 		readwrite.count = fs->fs_llformat.availbytes;
 		readwrite.buffer = sf->buffer;
-
+#ifdef CONFIG_SMARTFS_JOURNALING
+		ret = smartfs_create_journalentry(fs, T_WRITE, readwrite.logsector, readwrite.offset, readwrite.count, 0, 0, readwrite.buffer, &t_sector, &t_offset);
+		if (ret != OK) {
+			fdbg("Journal entry creation failed.\n");
+			goto errout;
+		}
+#endif
 		ret = FS_IOCTL(fs, BIOC_WRITESECT, (unsigned long)&readwrite);
+#ifdef CONFIG_SMARTFS_JOURNALING
+		retj = smartfs_finish_journalentry(fs, 0, t_sector, t_offset, T_WRITE);
+		if (retj != OK) {
+			fdbg("Error finishing transaction\n");
+			ret = retj;
+			goto errout;
+		}
+#endif
 		if (ret < 0) {
 			fdbg("Error %d writing used bytes for sector %d\n", ret, sf->currsector);
 			goto errout;
 		}
 
 		sf->byteswritten = 0;
-		sf->bflags = 0;
+		sf->bflags &= ~(SMARTFS_BFLAG_DIRTY | SMARTFS_BFLAG_NEWALLOC);
 	}
 #else							/* CONFIG_SMARTFS_USE_SECTOR_BUFFER */
 
@@ -801,6 +845,15 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer, size_t
 		/* Now perform the write. */
 
 		if (readwrite.count > 0) {
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+			ret = smartfs_loadbuffer(fs, sf);
+			if (ret < 0) {
+				goto errout_with_semaphore;
+			}
+
+			memcpy(&sf->buffer[sf->curroffset], readwrite.buffer, readwrite.count);
+			sf->bflags |= SMARTFS_BFLAG_DIRTY;
+#else							/* CONFIG_SMARTFS_USE_SECTOR_BUFFER */
 #ifdef CONFIG_SMARTFS_JOURNALING
 			ret = smartfs_create_journalentry(fs, T_WRITE, readwrite.logsector, readwrite.offset, readwrite.count, 0, 0, readwrite.buffer, &t_sector, &t_offset);
 			if (ret != OK) {
@@ -822,6 +875,7 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer, size_t
 				fdbg("Error %d writing sector %d data\n", ret, sf->currsector);
 				goto errout_with_semaphore;
 			}
+#endif							/* CONFIG_SMARTFS_USE_SECTOR_BUFFER */
 
 			/* Update our control variables */
 
@@ -833,6 +887,29 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer, size_t
 
 		/* Test if we wrote to the end of the current sector */
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+		if (sf->curroffset == fs->fs_llformat.availbytes && sf->filepos < sf->entry.datlen) {
+			/* Write the buffer out and move to the next sector in the chain.
+			 * At the EOF we stay at the end of this sector and the append
+			 * below chains a new one.
+			 */
+
+			ret = smartfs_loadbuffer(fs, sf);
+			if (ret < 0) {
+				goto errout_with_semaphore;
+			}
+
+			ret = smartfs_sync_internal(fs, sf);
+			if (ret != OK) {
+				goto errout_with_semaphore;
+			}
+
+			header = (struct smartfs_chain_header_s *)sf->buffer;
+			sf->bflags = 0;
+			sf->curroffset = sizeof(struct smartfs_chain_header_s);
+			sf->currsector = SMARTFS_NEXTSECTOR(header);
+		}
+#else							/* CONFIG_SMARTFS_USE_SECTOR_BUFFER */
 		if (sf->curroffset == fs->fs_llformat.availbytes) {
 			/* Wrote to the end of the sector.  Update to point to the
 			 * next sector for additional writes.  First read the sector
@@ -853,6 +930,7 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer, size_t
 			sf->curroffset = sizeof(struct smartfs_chain_header_s);
 			sf->currsector = SMARTFS_NEXTSECTOR(header);
 		}
+#endif							/* CONFIG_SMARTFS_USE_SECTOR_BUFFER */
 	}
 
 	/* Now append data to end of the file. */
@@ -863,6 +941,11 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer, size_t
 		 */
 
 #ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+		ret = smartfs_loadbuffer(fs, sf);
+		if (ret < 0) {
+			goto errout_with_semaphore;
+		}
+
 		readwrite.count = fs->fs_llformat.availbytes - sf->curroffset;
 		if (readwrite.count > buflen) {
 			readwrite.count = buflen;
@@ -944,7 +1027,7 @@ static ssize_t smartfs_write(FAR struct file *filep, const char *buffer, size_t
 				fdbg("Error - duplicate logical sector %d\n", sf->currsector);
 			}
 
-			sf->bflags = SMARTFS_BFLAG_DIRTY;
+			sf->bflags = SMARTFS_BFLAG_DIRTY | SMARTFS_BFLAG_VALID;
 			sf->currsector = SMARTFS_NEXTSECTOR(header);
 			sf->curroffset = sizeof(struct smartfs_chain_header_s);
 			memset(sf->buffer, CONFIG_SMARTFS_ERASEDSTATE, fs->fs_llformat.availbytes);
@@ -1026,6 +1109,39 @@ errout_with_semaphore:
 	return ret;
 }
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+/****************************************************************************
+ * Name: smartfs_loadbuffer
+ *
+ * Description: Reads the current sector of the file into its sector buffer,
+ *              unless the buffer already holds it.
+ *
+ ****************************************************************************/
+
+static int smartfs_loadbuffer(struct smartfs_mountpt_s *fs, struct smartfs_ofile_s *sf)
+{
+	struct smart_read_write_s readwrite;
+	int ret;
+
+	if ((sf->bflags & SMARTFS_BFLAG_VALID) || sf->currsector == SMARTFS_ERASEDSTATE_16BIT) {
+		return OK;
+	}
+
+	readwrite.logsector = sf->currsector;
+	readwrite.offset = 0;
+	readwrite.count = fs->fs_llformat.availbytes;
+	readwrite.buffer = (uint8_t *)sf->buffer;
+	ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
+	if (ret < 0) {
+		fdbg("Error %d reading sector %d\n", ret, sf->currsector);
+		return ret;
+	}
+
+	sf->bflags |= SMARTFS_BFLAG_VALID;
+	return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: smartfs_seek_internal
  *
@@ -1054,7 +1170,11 @@ static off_t smartfs_seek_internal(struct smartfs_mountpt_s *fs, struct smartfs_
 
 	/* Test if we need to sync the file */
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+	if (sf->byteswritten > 0 || (sf->bflags & SMARTFS_BFLAG_DIRTY)) {
+#else
 	if (sf->byteswritten > 0) {
+#endif
 		/* Perform a sync */
 
 		smartfs_sync_internal(fs, sf);
@@ -1114,6 +1234,10 @@ static off_t smartfs_seek_internal(struct smartfs_mountpt_s *fs, struct smartfs_
 		sf->filepos = 0;
 	}
 
+#ifdef CONFIG_SMARTFS_USE_SECTOR_BUFFER
+	sf->bflags &= ~SMARTFS_BFLAG_VALID;
+#endif
+
 	header = (struct smartfs_chain_header_s *)fs->fs_rwbuffer;
 	while ((sf->currsector != SMARTFS_ERASEDSTATE_16BIT) && (sf->filepos + fs->fs_llformat.availbytes - sizeof(struct smartfs_chain_header_s) < newpos)) {
 		/* Read the sector's header */
@@ -1146,16 +1270,9 @@ static off_t smartfs_seek_internal(struct smartfs_mountpt_s *fs, struct smartfs_
 	 * sf->buffer in case any changes are made.
 	 */
 
-	if (sf->currsector != SMARTFS_ERASEDSTATE_16BIT) {
-		readwrite.logsector = sf->currsector;
-		readwrite.offset = 0;
-		readwrite.count = fs->fs_llformat.availbytes;
-		readwrite.buffer = (uint8_t *)sf->buffer;
-		ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
-		if (ret < 0) {
-			fdbg("Error %d reading sector %d header\n", ret, sf->currsector);
-			goto errout;
-		}
+	ret = smartfs_loadbuffer(fs, sf);
+	if (ret < 0) {
+		goto errout;
 	}
 #endif
 
@@ -1251,6 +1368,11 @@ static int smartfs_sync(FAR struct file *filep)
 	smartfs_semtake(fs);
 
 	ret = smartfs_sync_internal(fs, sf);
+	if (ret == OK) {
+		/* Let the block device save the state it keeps in RAM. */
+
+		ret = FS_IOCTL(fs, BIOC_FLUSH, 0);
+	}
 
 	smartfs_semgive(fs);
 	return ret;
@@ -95,6 +95,13 @@
  * Private Function Prototypes
  ****************************************************************************/
 
+#ifdef CONFIG_SMARTFS_DIRINDEX
+static uint16_t smartfs_dirindex_hash(const char *name, uint16_t namesize);
+static FAR struct smartfs_dirindex_s *smartfs_dirindex_get(struct smartfs_mountpt_s *fs, uint16_t dirsector);
+static uint16_t smartfs_dirindex_next(FAR struct smartfs_dirindex_s *index, uint16_t hash, uint16_t *pos);
+static void smartfs_dirindex_invalidate(struct smartfs_mountpt_s *fs, uint16_t dirsector);
+#endif
+
 /****************************************************************************
  * Private Variables
  ****************************************************************************/
@@ -191,6 +198,228 @@ static uint8_t smartfs_calc_crc_data(struct journal_transaction_manager_s *j_mgr
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_SMARTFS_DIRINDEX
+/****************************************************************************
+ * Name: smartfs_dirindex_hash
+ *
+ * Description: Hashes a name the way the directory entries compare it, up
+ *              to the first NUL or namesize characters.
+ *
+ ****************************************************************************/
+
+static uint16_t smartfs_dirindex_hash(const char *name, uint16_t namesize)
+{
+	uint32_t hash = 2166136261u;
+
+	while (namesize-- > 0 && *name != '\0') {
+		hash = (hash ^ (uint8_t)*name++) * 16777619u;
+	}
+
+	return (uint16_t)(hash ^ (hash >> 16));
+}
+
+/****************************************************************************
+ * Name: smartfs_dirindex_compare
+ ****************************************************************************/
+
+static int smartfs_dirindex_compare(const void *a, const void *b)
+{
+	return (int)((const struct smartfs_dirindex_entry_s *)a)->hash - (int)((const struct smartfs_dirindex_entry_s *)b)->hash;
+}
+
+/****************************************************************************
+ * Name: smartfs_dirindex_build
+ *
+ * Description: Scans the sector chain of a directory and records the name
+ *              hash and sector of each valid entry.  Uses fs_rwbuffer.
+ *
+ ****************************************************************************/
+
+static int smartfs_dirindex_build(struct smartfs_mountpt_s *fs, FAR struct smartfs_dirindex_s *index, uint16_t dirsector)
+{
+	struct smart_read_write_s readwrite;
+	struct smartfs_chain_header_s *header;
+	struct smartfs_entry_header_s *entry;
+	FAR struct smartfs_dirindex_entry_s *entries = NULL;
+	FAR struct smartfs_dirindex_entry_s *newentries;
+	uint16_t nentries = 0;
+	uint16_t size = 0;
+	uint16_t entrysize;
+	uint16_t offset;
+	int ret;
+
+	entrysize = sizeof(struct smartfs_entry_header_s) + fs->fs_llformat.namesize;
+	index->dirsector = dirsector;
+
+#if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
+	while (dirsector != 0xFFFF)
+#else
+	while (dirsector != 0)
+#endif
+	{
+		readwrite.logsector = dirsector;
+		readwrite.count = fs->fs_llformat.availbytes;
+		readwrite.buffer = (uint8_t *)fs->fs_rwbuffer;
+		readwrite.offset = 0;
+		ret = FS_IOCTL(fs, BIOC_READSECT, (unsigned long)&readwrite);
+		if (ret < 0) {
+			goto errout;
+		}
+
+		header = (struct smartfs_chain_header_s *)fs->fs_rwbuffer;
+		offset = sizeof(struct smartfs_chain_header_s);
+		while (offset + entrysize <= readwrite.count) {
+			entry = (struct smartfs_entry_header_s *)&fs->fs_rwbuffer[offset];
+			if (ENTRY_VALID(entry)) {
+				if (nentries == size) {
+					size = size ? size * 2 : 16;
+					newentries = (FAR struct smartfs_dirindex_entry_s *)kmm_realloc(entries, size * sizeof(struct smartfs_dirindex_entry_s));
+					if (newentries == NULL) {
+						ret = -ENOMEM;
+						goto errout;
+					}
+
+					entries = newentries;
+				}
+
+				entries[nentries].hash = smartfs_dirindex_hash(entry->name, fs->fs_llformat.namesize);
+				entries[nentries].sector = dirsector;
+				nentries++;
+			}
+
+			offset += entrysize;
+		}
+
+		dirsector = SMARTFS_NEXTSECTOR(header);
+	}
+
+	if (nentries > 1) {
+		qsort(entries, nentries, sizeof(struct smartfs_dirindex_entry_s), smartfs_dirindex_compare);
+	}
+
+	index->entries = entries;
+	index->nentries = nentries;
+	return OK;
+
+errout:
+	if (entries != NULL) {
+		kmm_free(entries);
+	}
+
+	return ret;
+}
+
+/****************************************************************************
+ * Name: smartfs_dirindex_get
+ *
+ * Description: Returns the name index of a directory, building it in the
+ *              least recently used slot if the directory has none.  Returns
+ *              NULL if the index can't be built, the directory is then
+ *              searched without it.
+ *
+ ****************************************************************************/
+
+static FAR struct smartfs_dirindex_s *smartfs_dirindex_get(struct smartfs_mountpt_s *fs, uint16_t dirsector)
+{
+	FAR struct smartfs_dirindex_s *index;
+	FAR struct smartfs_dirindex_s *victim;
+	int i;
+
+	victim = &fs->fs_dirindex[0];
+	for (i = 0; i < CONFIG_SMARTFS_DIRINDEX_DIRS; i++) {
+		index = &fs->fs_dirindex[i];
+		if (index->lastused != 0 && index->dirsector == dirsector) {
+			index->lastused = ++fs->fs_dirindex_stamp;
+			return index;
+		}
+
+		if (index->lastused < victim->lastused) {
+			victim = index;
+		}
+	}
+
+	/* Not indexed yet, replace the least recently used index */
+
+	if (victim->lastused != 0) {
+		smartfs_dirindex_invalidate(fs, victim->dirsector);
+	}
+
+	if (smartfs_dirindex_build(fs, victim, dirsector) != OK) {
+		return NULL;
+	}
+
+	victim->lastused = ++fs->fs_dirindex_stamp;
+	return victim;
+}
+
+/****************************************************************************
+ * Name: smartfs_dirindex_next
+ *
+ * Description: Returns the next directory sector that may hold an entry
+ *              with the given name hash, or the erased state when there is
+ *              none.  *pos must be 0xFFFF for the first call.
+ *
+ ****************************************************************************/
+
+static uint16_t smartfs_dirindex_next(FAR struct smartfs_dirindex_s *index, uint16_t hash, uint16_t *pos)
+{
+	uint16_t low;
+	uint16_t high;
+	uint16_t mid;
+
+	if (*pos == 0xFFFF) {
+		/* Find the first entry with this hash */
+
+		low = 0;
+		high = index->nentries;
+		while (low < high) {
+			mid = (low + high) / 2;
+			if (index->entries[mid].hash < hash) {
+				low = mid + 1;
+			} else {
+				high = mid;
+			}
+		}
+
+		*pos = low;
+	} else {
+		(*pos)++;
+	}
+
+	if (*pos < index->nentries && index->entries[*pos].hash == hash) {
+		return index->entries[*pos].sector;
+	}
+
+	return SMARTFS_ERASEDSTATE_16BIT;
+}
+
+/****************************************************************************
+ * Name: smartfs_dirindex_invalidate
+ *
+ * Description: Drops the name index of a directory, if it has one.
+ *
+ ****************************************************************************/
+
+static void smartfs_dirindex_invalidate(struct smartfs_mountpt_s *fs, uint16_t dirsector)
+{
+	FAR struct smartfs_dirindex_s *index;
+	int i;
+
+	for (i = 0; i < CONFIG_SMARTFS_DIRINDEX_DIRS; i++) {
+		index = &fs->fs_dirindex[i];
+		if (index->lastused != 0 && index->dirsector == dirsector) {
+			if (index->entries != NULL) {
+				kmm_free(index->entries);
+			}
+
+			index->entries = NULL;
+			index->nentries = 0;
+			index->lastused = 0;
+		}
+	}
+}
+#endif							/* CONFIG_SMARTFS_DIRINDEX */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -646,6 +875,15 @@ int smartfs_unmount(struct smartfs_mountpt_s *fs)
 	int count = 0;
 	int found = FALSE;
 #endif
+#ifdef CONFIG_SMARTFS_DIRINDEX
+	int i;
+
+	/* Free the directory name indexes */
+
+	for (i = 0; i < CONFIG_SMARTFS_DIRINDEX_DIRS; i++) {
+		smartfs_dirindex_invalidate(fs, fs->fs_dirindex[i].dirsector);
+	}
+#endif
 
 #if defined(CONFIG_SMARTFS_MULTI_ROOT_DIRS) || \
 	(defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS))
@@ -783,6 +1021,11 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 #ifdef CONFIG_SMARTFS_DYNAMIC_HEADER
 	int used_value;
 #endif
+#ifdef CONFIG_SMARTFS_DIRINDEX
+	FAR struct smartfs_dirindex_s *index;
+	uint16_t hash;
+	uint16_t pos;
+#endif
 
 	/* Initialize directory level zero as the root sector */
 
@@ -859,6 +1102,19 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 
 			offset = 0xFFFF;
 
+#ifdef CONFIG_SMARTFS_DIRINDEX
+			/* With a name index, only read the sectors holding an entry
+			 * with the same name hash.
+			 */
+
+			hash = smartfs_dirindex_hash(fs->fs_workbuffer, fs->fs_llformat.namesize);
+			pos = 0xFFFF;
+			index = smartfs_dirindex_get(fs, dirsector);
+			if (index != NULL) {
+				dirsector = smartfs_dirindex_next(index, hash, &pos);
+			}
+#endif
+
 #if CONFIG_SMARTFS_ERASEDSTATE == 0xFF
 			while (dirsector != 0xFFFF)
 #else
@@ -879,7 +1135,14 @@ int smartfs_finddirentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *d
 				/* Point to next sector in chain */
 
 				header = (struct smartfs_chain_header_s *)fs->fs_rwbuffer;
-				dirsector = SMARTFS_NEXTSECTOR(header);
+#ifdef CONFIG_SMARTFS_DIRINDEX
+				if (index != NULL) {
+					dirsector = smartfs_dirindex_next(index, hash, &pos);
+				} else
+#endif
+				{
+					dirsector = SMARTFS_NEXTSECTOR(header);
+				}
 
 				/* Search for the entry */
 
@@ -1110,6 +1373,10 @@ int smartfs_createentry(struct smartfs_mountpt_s *fs, uint16_t parentdirsector,
 		return -ENAMETOOLONG;
 	}
 
+#ifdef CONFIG_SMARTFS_DIRINDEX
+	smartfs_dirindex_invalidate(fs, parentdirsector);
+#endif
+
 	/* Read the parent directory sector and find a place to insert
 	 * the new entry.
 	 */
@@ -1233,7 +1500,7 @@ int smartfs_createentry(struct smartfs_mountpt_s *fs, uint16_t parentdirsector,
 			memset(sf->buffer, CONFIG_SMARTFS_ERASEDSTATE, fs->fs_llformat.availbytes);
 			chainheader = (struct smartfs_chain_header_s *)sf->buffer;
 			chainheader->type = SMARTFS_SECTOR_TYPE_FILE;
-			sf->bflags = SMARTFS_BFLAG_DIRTY | SMARTFS_BFLAG_NEWALLOC;
+			sf->bflags = SMARTFS_BFLAG_DIRTY | SMARTFS_BFLAG_NEWALLOC | SMARTFS_BFLAG_VALID;
 		} else
 #endif
 		{
@@ -1349,6 +1616,15 @@ int smartfs_deleteentry(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *en
 	 *        bytes of the buffer to read in header info.
 	 */
 
+#ifdef CONFIG_SMARTFS_DIRINDEX
+	/* Drop the index of the parent directory, and of the entry itself if
+	 * it is a directory, as its sectors may be reused by another one.
+	 */
+
+	smartfs_dirindex_invalidate(fs, entry->dfirst);
+	smartfs_dirindex_invalidate(fs, entry->firstsector);
+#endif
+
 	nextsector = entry->firstsector;
 	header = (struct smartfs_chain_header_s *)fs->fs_rwbuffer;
 	readwrite.offset = 0;
@@ -1684,7 +1960,7 @@ int smartfs_truncatefile(struct smartfs_mountpt_s *fs, struct smartfs_entry_s *e
 		memset(sf->buffer, CONFIG_SMARTFS_ERASEDSTATE, fs->fs_llformat.availbytes);
 		header = (struct smartfs_chain_header_s *)sf->buffer;
 		header->type = SMARTFS_SECTOR_TYPE_FILE;
-		sf->bflags = SMARTFS_BFLAG_DIRTY;
+		sf->bflags = SMARTFS_BFLAG_DIRTY | SMARTFS_BFLAG_VALID;
 		entry->datlen = 0;
 	}
 #endif
@@ -150,6 +150,16 @@ struct binary_s {
 	size_t offset;                  /* Offset of binary from partition start*/
 	uint8_t compression_type;		/* Binary Compression type */
 
+#ifdef CONFIG_BINMGR_LOAD_STATS
+	/* Time taken by the loading phases, in clock ticks */
+
+	clock_t load_ticks;			/* Reading and decompressing the sections */
+	clock_t bind_ticks;			/* Relocating the sections */
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+	clock_t ctor_ticks;			/* Running the static constructors */
+#endif
+#endif
+
 	/* Unload module callback */
 
 	CODE int (*unload)(FAR struct binary_s *bin);
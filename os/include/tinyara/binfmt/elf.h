@@ -168,6 +168,7 @@ struct elf_loadinfo_s {
 	uint16_t offset;             /* elf offset when binary header is included */
 	uint8_t compression_type;		/* Binary Compression type */
 	uintptr_t symtab;			/* Copy of symbol table */
+	uintptr_t strtab;			/* Copy of symbol string table */
 	uintptr_t reltab;			/* Copy of relocation table */
 };
 
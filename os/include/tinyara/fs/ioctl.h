@@ -242,6 +242,12 @@
 										 *      the block with specific debug
 										 *      command and data.
 										 * OUT: None.  */
+#define BIOC_FLUSH      _BIOC(0x000C)	/* Tell the block device that the file
+										 * system is at a sync point, so that it
+										 * can save any state it caches in RAM.
+										 * IN:  None
+										 * OUT: None (ioctl return value provides
+										 *      success/failure indication). */
 
 /* TinyAra MTD driver ioctl definitions ***************************************/
 
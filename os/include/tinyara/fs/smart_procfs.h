@@ -111,6 +111,11 @@ struct mtd_smart_procfs_data_s {
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
 	uint32_t uneven_wearcount;	/* Number of uneven block erases */
 #endif
+#ifdef CONFIG_MTD_SMART_BACKGROUND_GC
+	uint32_t gcbgblocks;		/* Blocks collected by the GC worker */
+	uint32_t gcfgblocks;		/* Blocks collected inline by writes */
+	uint16_t gcfgmax;			/* Most blocks collected inline by one write */
+#endif
 };
 
 /* The following defines debug command data passed from the procfs layer to
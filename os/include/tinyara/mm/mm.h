@@ -64,6 +64,7 @@
 #include <debug.h>
 #include <stdint.h>
 #include <tinyara/mm/heap_regioninfo.h>
+#include <tinyara/mm/tcache.h>
 #ifdef CONFIG_HEAPINFO_USER_GROUP
 #include <tinyara/mm/heapinfo_internal.h>
 #endif
@@ -195,6 +196,23 @@
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
 
+#ifdef CONFIG_MM_TLSF
+/* TLSF free list definitions
+ *
+ * Free chunks are segregated by a first level index, the power of two range
+ * of the size, and a second level index which splits each range linearly
+ * into MM_TLSF_SL_COUNT lists.  Chunks smaller than MM_TLSF_SMALL_CHUNK all
+ * go into the first level list 0 with a granule of MM_MIN_CHUNK, and chunks
+ * of MM_MAX_CHUNK or more share the single list of the last first level.
+ */
+
+#define MM_TLSF_SL_SHIFT    3
+#define MM_TLSF_SL_COUNT    (1 << MM_TLSF_SL_SHIFT)
+#define MM_TLSF_FL_SHIFT    (MM_MIN_SHIFT + MM_TLSF_SL_SHIFT)
+#define MM_TLSF_SMALL_CHUNK (1 << MM_TLSF_FL_SHIFT)
+#define MM_TLSF_FL_COUNT    (MM_MAX_SHIFT - MM_TLSF_FL_SHIFT + 2)
+#endif
+
 /* An allocated chunk is distinguished from a free chunk by bit 31 (or 15)
  * of the 'preceding' chunk size.  If set, then this is an allocated chunk.
  */
@@ -217,6 +235,7 @@
 #define HEAPINFO_DETAIL_SPECIFIC_HEAP 5
 #define HEAPINFO_INIT_PEAK 6
 #define HEAPINFO_PID_ALL -1
+#define HEAPINFO_TCACHE (INT16_MAX - 2)	/* pid of chunks held in small allocation cache */
 
 #define HEAPINFO_INIT_INFO -1
 #define HEAPINFO_ADD_INFO 1
@@ -400,12 +419,31 @@ struct mm_heap_s {
 	size_t elf_sections_size;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+	/* Free nodes are kept in segregated lists indexed by size class.  A bit
+	 * is set in mm_fl_bitmap for each first level with a non-empty list and
+	 * in mm_sl_bitmap[fl] for each non-empty list of that first level.
+	 */
+
+	uint32_t mm_fl_bitmap;
+	uint32_t mm_sl_bitmap[MM_TLSF_FL_COUNT];
+	FAR struct mm_freenode_s *mm_freelist[MM_TLSF_FL_COUNT][MM_TLSF_SL_COUNT];
+#else
 	/* All free nodes are maintained in a doubly linked list.  This
 	 * array provides some hooks into the list at various points to
 	 * speed searches for free nodes.
 	 */
 
 	struct mm_freenode_s mm_nodelist[MM_NNODES + 1];
+#endif
+
+#ifdef CONFIG_MM_TCACHE
+	/* Small chunks freed recently, they are handed out again without
+	 * taking the semaphore and searching the nodelist.
+	 */
+
+	struct mm_tcache_s mm_tcache;
+#endif
 };
 
 /****************************************************************************
@@ -526,6 +564,7 @@ FAR void *kmm_malloc(size_t size);
 /* Functions contained in mm_free.c *****************************************/
 
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_freechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node);
 
 /* Functions contained in kmm_free.c ****************************************/
 
@@ -678,13 +717,38 @@ struct mm_heap_s *kmm_get_heap(void);
 
 void mm_shrinkchunk(FAR struct mm_heap_s *heap, FAR struct mm_allocnode_s *node, size_t size);
 
-/* Functions contained in mm_addfreechunk.c *********************************/
+/* Functions contained in mm_addfreechunk.c or mm_tlsf.c *******************/
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node);
 
+#ifdef CONFIG_MM_TLSF
+/* Functions contained in mm_tlsf.c *****************************************/
+
+void mm_removefreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node);
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap, size_t size);
+#endif
+
+/* Functions contained in mm_tcache.c ***************************************/
+
+#ifdef CONFIG_MM_TCACHE
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+FAR void *mm_tcache_alloc(FAR struct mm_heap_s *heap, size_t size, mmaddress_t caller_retaddr);
+#else
+FAR void *mm_tcache_alloc(FAR struct mm_heap_s *heap, size_t size);
+#endif
+bool mm_tcache_free(FAR struct mm_heap_s *heap, FAR struct mm_allocnode_s *node);
+size_t mm_tcache_flush(FAR struct mm_heap_s *heap);
+void mm_tcache_getstat(FAR struct mm_heap_s *heap, FAR size_t *hits, FAR size_t *misses, FAR size_t *retained);
+#ifdef CONFIG_MM_TCACHE_PERTHREAD
+void mm_tcache_release(FAR struct tcb_s *tcb);
+#endif
+#endif
+
+#ifndef CONFIG_MM_TLSF
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
 int mm_size2ndx(size_t size);
+#endif
 
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 /* Functions contained in kmm_mallinfo.c . Used to display memory allocation details */
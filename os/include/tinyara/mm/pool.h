@@ -0,0 +1,183 @@
+/****************************************************************************
+ *
+ * Copyright 2026 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+#ifndef __INCLUDE_MM_POOL_H
+#define __INCLUDE_MM_POOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_MM_POOL
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/* Flags of mm_pool_create() */
+
+#define MM_POOL_HEAP        (1 << 0)	/* Take objects from the kernel heap when the pool is empty */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The storage of a pool is a list of slabs taken from the pool granule
+ * heap.  The objects of a slab follow this header.
+ */
+
+struct mm_pool_slab_s {
+	FAR struct mm_pool_slab_s *flink;	/* Next slab of the pool */
+	size_t size;					/* Size of the slab, given back to gran_free() */
+};
+
+/* Objects taken from the kernel heap follow this header, which links them
+ * so that mm_pool_free() can tell them from objects the pool did not
+ * allocate.
+ */
+
+struct mm_pool_heapobj_s {
+	FAR struct mm_pool_heapobj_s *flink;	/* Next object taken from the heap */
+};
+
+/* This describes one pool of fixed-size objects.  Free objects are linked
+ * through their first word, so allocation and free are a pop and a push
+ * with interrupts disabled, from task or interrupt context.
+ */
+
+struct mm_pool_s {
+	FAR struct mm_pool_s *flink;		/* Next pool in the list of all pools */
+	FAR const char *name;			/* Name shown in /proc/pools */
+	FAR void *freelist;			/* Free objects of the pool */
+	FAR struct mm_pool_slab_s *slabs;	/* Storage of the objects */
+	FAR struct mm_pool_heapobj_s *heapobjs;	/* Objects in use taken from the heap */
+	size_t objsize;				/* Object size, rounded up to the alignment */
+	size_t align;				/* Object alignment */
+	uint16_t nobjs;				/* Number of objects in the slabs */
+	uint16_t nfree;				/* Number of free objects in the slabs */
+	uint16_t minfree;			/* Lowest number of free objects seen */
+	uint16_t reserve;			/* Objects only given to interrupt handlers */
+	uint16_t nheap;				/* Objects in use taken from the heap */
+	uint8_t flags;				/* See MM_POOL_* definitions */
+	uint32_t nalloc;			/* Number of successful allocations */
+	uint32_t nfail;				/* Number of failed allocations */
+};
+
+/* Callback of mm_pool_foreach() */
+
+typedef void (*mm_pool_handler_t)(FAR struct mm_pool_s *pool, FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: mm_pool_initialize
+ *
+ * Description:
+ *   Set up the granule heap the storage of all pools is taken from.  This
+ *   is called once, right after the kernel heap is initialized.
+ *
+ ****************************************************************************/
+
+void mm_pool_initialize(void);
+
+/****************************************************************************
+ * Name: mm_pool_create
+ *
+ * Description:
+ *   Create a pool of 'nobjs' objects of 'objsize' bytes aligned to 'align'
+ *   bytes, which must be a power of two no larger than the granule size.
+ *   An alignment of zero selects the pointer alignment.
+ *
+ *   The last 'reserve' free objects are only given to interrupt handlers.
+ *   Once they are reached, allocations from task context take objects
+ *   from the kernel heap if MM_POOL_HEAP is set, or fail otherwise.
+ *
+ *   If the granule heap runs short, the pool gets fewer objects than
+ *   requested.  This must be called from task context.
+ *
+ * Returned Value:
+ *   The new pool, or NULL if it has no object and MM_POOL_HEAP is not set.
+ *
+ ****************************************************************************/
+
+FAR struct mm_pool_s *mm_pool_create(FAR const char *name, size_t objsize, size_t align, uint16_t nobjs, uint16_t reserve, uint8_t flags);
+
+/****************************************************************************
+ * Name: mm_pool_destroy
+ *
+ * Description:
+ *   Give the storage of a pool back to the granule heap.  All objects must
+ *   have been freed.  This must be called from task context.
+ *
+ ****************************************************************************/
+
+void mm_pool_destroy(FAR struct mm_pool_s *pool);
+
+/****************************************************************************
+ * Name: mm_pool_alloc
+ *
+ * Description:
+ *   Take an object from a pool.  The content of the object is undefined.
+ *   This may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+FAR void *mm_pool_alloc(FAR struct mm_pool_s *pool);
+
+/****************************************************************************
+ * Name: mm_pool_free
+ *
+ * Description:
+ *   Give an object back to the pool it was taken from.  Objects which were
+ *   taken from the heap, or not allocated by the pool at all, are freed with
+ *   sched_kfree().  This may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+void mm_pool_free(FAR struct mm_pool_s *pool, FAR void *obj);
+
+/****************************************************************************
+ * Name: mm_pool_foreach
+ *
+ * Description:
+ *   Call 'handler' for each pool with the scheduler locked.
+ *
+ ****************************************************************************/
+
+void mm_pool_foreach(mm_pool_handler_t handler, FAR void *arg);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_MM_POOL */
+#endif /* __INCLUDE_MM_POOL_H */
@@ -0,0 +1,69 @@
+/****************************************************************************
+ *
+ * Copyright 2026 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+#ifndef __INCLUDE_MM_TCACHE_H
+#define __INCLUDE_MM_TCACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <sys/types.h>
+#include <stdint.h>
+
+#ifdef CONFIG_MM_TCACHE
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/* Cached chunks are binned by chunk size in units of (1 << MM_TCACHE_SHIFT)
+ * bytes.  The chunk size includes the allocation node header, which is 16
+ * bytes at most, so MM_TCACHE_NBINS bins cover every chunk of an allocation
+ * of up to CONFIG_MM_TCACHE_MAXSIZE bytes.
+ */
+
+#define MM_TCACHE_SHIFT     4
+#define MM_TCACHE_NBINS     ((CONFIG_MM_TCACHE_MAXSIZE + 31) >> MM_TCACHE_SHIFT)
+#define MM_TCACHE_MAXCHUNK  (MM_TCACHE_NBINS << MM_TCACHE_SHIFT)
+#define MM_TCACHE_NDX(size) (((size) >> MM_TCACHE_SHIFT) - 1)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct mm_heap_s;
+struct mm_freenode_s;
+
+/* This describes one small allocation cache.  Each heap has one, and each
+ * thread has one more if CONFIG_MM_TCACHE_PERTHREAD is selected.
+ * Cached chunks stay marked as allocated in the heap, they are linked in
+ * their bin by the flink field.
+ */
+
+struct mm_tcache_s {
+	FAR struct mm_heap_s *heap;			/* Heap of the chunks in a per-thread cache */
+	FAR struct mm_freenode_s *bin[MM_TCACHE_NBINS];	/* Cached chunks of each size class */
+	uint16_t count[MM_TCACHE_NBINS];		/* Number of chunks in each bin */
+	size_t hits;					/* Allocations served by the cache */
+	size_t misses;					/* Allocations which went to the heap */
+	size_t retained;				/* Bytes held in the cache */
+};
+
+#endif /* CONFIG_MM_TCACHE */
+#endif /* __INCLUDE_MM_TCACHE_H */
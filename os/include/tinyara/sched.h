@@ -78,6 +78,7 @@
 
 #include <tinyara/irq.h>
 #include <tinyara/mm/shm.h>
+#include <tinyara/mm/tcache.h>
 #include <tinyara/fs/fs.h>
 #include <tinyara/net/net.h>
 
@@ -606,6 +607,10 @@ struct tcb_s {
 
 	int pterrno;				/* Current per-thread errno            */
 
+#ifdef CONFIG_MM_TCACHE_PERTHREAD
+	struct mm_tcache_s tcache;	/* Per-thread small allocation cache   */
+#endif
+
 	/* State save areas ********************************************************** */
 	/* The form and content of these fields are platform-specific.                */
 
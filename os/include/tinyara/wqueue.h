@@ -86,6 +86,8 @@
  *   thread.  Default: 2048.
  * CONFIG_SIG_SIGWORK - The signal number that will be used to wake-up
  *   the worker thread.  Default: 17
+ * CONFIG_SCHED_WORKQUEUE_DELAYHEAP - Keep delayed work in a heap apart
+ *   from the work which is ready to run.
  *
  * CONFIG_SCHED_LPWORK. If CONFIG_SCHED_LPWORK is selected then a lower-
  *   priority work queue will be created.  This lower priority work queue
@@ -97,6 +99,9 @@
  *   priority worker thread.  Default: 50
  * CONFIG_SCHED_LPWORKPRIOMAX - The maximum execution priority of the lower
  *   priority worker thread.  Default: 176
+ * CONFIG_SCHED_LPWORK_POOL - Give each low-priority worker thread its own
+ *   queues of ready work, one per priority class, and let idle threads
+ *   steal work from the busy ones.
  *
  * The user-mode work queue is only available in the protected or kernel
  * builds.  This those configurations, the user-mode work queue provides the
@@ -263,6 +268,17 @@
 
 #endif							/* CONFIG_SCHED_USRWORK && !__KERNEL__ */
 
+/* Priority classes of the work in the low priority work queue pool.  Ready
+ * work of a higher class is always performed before that of a lower class.
+ */
+
+#ifdef CONFIG_SCHED_LPWORK_POOL
+#define WORK_CLASS_HIGH    0	/* Latency sensitive work */
+#define WORK_CLASS_NORMAL  1	/* Default class of work_queue() */
+#define WORK_CLASS_LOW     2	/* Background work */
+#define WORK_NCLASSES      3
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -284,6 +300,14 @@ struct work_s {
 	FAR void *arg;				/* Callback argument */
 	clock_t qtime;			/* Time work queued */
 	clock_t delay;			/* Delay until work performed */
+#ifdef CONFIG_SCHED_WORKQUEUE_DELAYHEAP
+	FAR struct work_s *child;	/* Left child in the delayed work heap */
+	uint8_t rank;				/* Right spine length in the delayed work heap */
+	FAR void *wqueue;			/* The work queue holding the work */
+#endif
+#ifdef CONFIG_SCHED_LPWORK_POOL
+	uint8_t wclass;				/* Priority class, see WORK_CLASS_* */
+#endif
 };
 
 /****************************************************************************
@@ -389,6 +413,32 @@ int work_lpstart(void);
 
 int work_queue(int qid, FAR struct work_s *work, worker_t worker, FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_queue_class
+ *
+ * Description:
+ *   Queue work like work_queue(), with a priority class.  The class only
+ *   matters for the low priority work queue pool; work for other queues is
+ *   passed to work_queue().
+ *
+ * Input parameters:
+ *   qid    - The work queue ID (index)
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   wclass - The priority class of the work, WORK_CLASS_*
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_SCHED_LPWORK_POOL)
+int work_queue_class(int qid, FAR struct work_s *work, worker_t worker, FAR void *arg, clock_t delay, int wclass);
+#endif
+
 /****************************************************************************
  * Name: work_cancel
  *
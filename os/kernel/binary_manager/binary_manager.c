@@ -29,6 +29,11 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <tinyara/binary_manager.h>
+#ifdef CONFIG_BINMGR_LOAD_STATS
+#include <tinyara/clock.h>
+#include <tinyara/sched.h>
+#include <tinyara/binfmt/binfmt.h>
+#endif
 
 #include "binary_manager.h"
 
@@ -126,6 +131,9 @@ void binary_manager_register_partition(int part_num, int part_type, char *name,
 void binary_manager_update_running_state(int bin_id)
 {
 	int bin_idx;
+#if defined(CONFIG_BINMGR_LOAD_STATS) && defined(CONFIG_BINFMT_CONSTRUCTORS)
+	struct tcb_s *tcb;
+#endif
 
 	if (bin_id <= 0) {
 		bmdbg("Invalid parameter: bin id %d\n", bin_id);
@@ -141,6 +149,17 @@ void binary_manager_update_running_state(int bin_id)
 	BIN_STATE(bin_idx) = BINARY_RUNNING;
 	bmvdbg("binary '%s' state is changed, state = %d.\n", BIN_NAME(bin_idx), BIN_STATE(bin_idx));
 
+#ifdef CONFIG_BINMGR_LOAD_STATS
+	/* The constructors ran in the binary before it reported that it started */
+	BIN_LOADSTAT(bin_idx).started = clock_systimer();
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+	tcb = sched_gettcb(bin_id);
+	if (tcb != NULL && tcb->group != NULL && tcb->group->tg_bininfo != NULL) {
+		BIN_LOADSTAT(bin_idx).ctors = tcb->group->tg_bininfo->ctor_ticks;
+	}
+#endif
+#endif
+
 	/* Notify that binary is started. */
 	binary_manager_notify_state_changed(bin_idx, BINARY_STARTED);
 }
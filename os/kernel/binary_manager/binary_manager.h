@@ -24,6 +24,7 @@
  ****************************************************************************/
 
 #include <tinyara/config.h>
+#include <sys/types.h>
 #include <queue.h>
 
 #include <tinyara/binary_manager.h>
@@ -70,6 +71,7 @@ enum loading_thread_cmd {
 	LOADCMD_LOAD_ALL = 1,
 	LOADCMD_RELOAD = 2,
 	LOADCMD_UPDATE = 3,          /* Reload on update request */
+	LOADCMD_LOAD_DEFERRED = 4,   /* Load binaries left to the background by LOADCMD_LOAD_ALL */
 	LOADCMD_LOAD_MAX,
 };
 
@@ -84,6 +86,18 @@ enum binary_state_e {
 	BINARY_STATE_MAX,
 };
 
+#ifdef CONFIG_BINMGR_LOAD_STATS
+/* Time taken by each phase of the last loading of a binary, in clock ticks */
+struct binmgr_loadstat_s {
+	clock_t header;              /* Reading and verifying the binary headers */
+	clock_t load;                /* Reading and decompressing the ELF sections */
+	clock_t bind;                /* Relocating the ELF sections */
+	clock_t ctors;               /* Running the static constructors */
+	clock_t started;             /* System time at which the binary reported that it started */
+};
+typedef struct binmgr_loadstat_s binmgr_loadstat_t;
+#endif
+
 /* Binary data type in binary table */
 struct binmgr_bininfo_s {
 	pid_t bin_id;
@@ -94,6 +108,9 @@ struct binmgr_bininfo_s {
 	char bin_ver[BIN_VER_MAX];
 	char kernel_ver[KERNEL_VER_MAX];
 	sq_queue_t cb_list; // list node type : statecb_node_t
+#ifdef CONFIG_BINMGR_LOAD_STATS
+	binmgr_loadstat_t loadstat;
+#endif
 };
 typedef struct binmgr_bininfo_s binmgr_bininfo_t;
 
@@ -124,6 +141,10 @@ binmgr_bininfo_t *binary_manager_get_binary_data(uint32_t bin_idx);
 #define BIN_PRIORITY(bin_idx)                           binary_manager_get_binary_data(bin_idx)->load_attr.priority
 #define BIN_COMPRESSION_TYPE(bin_idx)                   binary_manager_get_binary_data(bin_idx)->load_attr.compression_type
 
+#ifdef CONFIG_BINMGR_LOAD_STATS
+#define BIN_LOADSTAT(bin_idx)                           binary_manager_get_binary_data(bin_idx)->loadstat
+#endif
+
 /****************************************************************************
  * Function Prototypes
  ****************************************************************************/
@@ -30,11 +30,14 @@
 #include <sched.h>
 #include <stdint.h>
 #include <string.h>
+#include <semaphore.h>
+#include <assert.h>
 #include <sys/types.h>
 
 #include <tinyara/mm/mm.h>
 #include <tinyara/sched.h>
 #include <tinyara/init.h>
+#include <tinyara/clock.h>
 
 #include "task/task.h"
 #include "binary_manager.h"
@@ -57,11 +60,22 @@ struct binary_header_s {
 } __attribute__((__packed__));
 typedef struct binary_header_s binary_header_t;
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+static int loading_thread(int argc, char *argv[]);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+/* Serializes loading of binaries, the ELF loader and decompression are not reentrant */
+static sem_t g_binmgr_loadsem = SEM_INITIALIZER(1);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
-/* Read header and Check whether header data is valid or not */
-static int binary_manager_read_header(int bin_idx, int part_idx, binary_header_t *header_data)
+/* Read header and Check whether header data is valid or not, verifying the checksum of the binary if 'crc_check' */
+static int binary_manager_read_header(int bin_idx, int part_idx, binary_header_t *header_data, bool crc_check)
 {
 	int fd;
 	int ret;
@@ -101,6 +115,11 @@ static int binary_manager_read_header(int bin_idx, int part_idx, binary_header_t
 		goto errout_with_fd;
 	}
 
+	if (!crc_check) {
+		close(fd);
+		return OK;
+	}
+
 	/* Caculate checksum and Verify it */
 	check_crc = crc32part((uint8_t *)header_data, header_data->header_size, check_crc);
 	file_size = header_data->bin_size;
@@ -149,7 +168,7 @@ static int binary_manager_check_update_binary(char *bin_name)
 		return BINMGR_NOT_FOUND;
 	}
 
-	ret = binary_manager_read_header(bin_idx, BIN_USEIDX(bin_idx) ^ 1, &header_data);
+	ret = binary_manager_read_header(bin_idx, BIN_USEIDX(bin_idx) ^ 1, &header_data, true);
 	if (ret == OK) {
 		version = (int)atoi(header_data.bin_ver);
 		/* Update if it have new version */
@@ -176,6 +195,9 @@ int binary_manager_load_binary(int bin_idx)
 	load_attr_t load_attr;
 	char devname[BINMGR_DEVNAME_LEN];
 	binary_header_t header_data[PARTS_PER_BIN];
+#ifdef CONFIG_BINMGR_LOAD_STATS
+	clock_t start_time;
+#endif
 
 	latest_ver = -1;
 	latest_idx = -1;
@@ -192,12 +214,17 @@ int binary_manager_load_binary(int bin_idx)
 		return ERROR;
 	}
 
+#ifdef CONFIG_BINMGR_LOAD_STATS
+	memset(&BIN_LOADSTAT(bin_idx), 0, sizeof(binmgr_loadstat_t));
+	start_time = clock_systimer();
+#endif
+
 	/* Read header data of binary partitions */
 	for (part_idx = 0; part_idx < PARTS_PER_BIN; part_idx++) {
 		if (BIN_PARTNUM(bin_idx, part_idx) < 0) {
 			continue;
 		}
-		ret = binary_manager_read_header(bin_idx, part_idx, &header_data[part_idx]);
+		ret = binary_manager_read_header(bin_idx, part_idx, &header_data[part_idx], true);
 		if (ret == OK) {
 			valid_bin_count++;
 			version = (int)atoi(header_data[part_idx].bin_ver);
@@ -209,11 +236,26 @@ int binary_manager_load_binary(int bin_idx)
 		}
 	}
 
+#ifdef CONFIG_BINMGR_LOAD_STATS
+	BIN_LOADSTAT(bin_idx).header = clock_systimer() - start_time;
+#endif
+
 	if (valid_bin_count == 0) {
 		bmdbg("Failed to find valid header of binary %s\n", BIN_NAME(bin_idx));
 		return ERROR;
 	}
 
+	while (sem_wait(&g_binmgr_loadsem) != OK) {
+		ASSERT(get_errno() == EINTR);
+	}
+
+	/* Another loading thread may have loaded it while we were waiting */
+	if (BIN_STATE(bin_idx) != BINARY_INACTIVE) {
+		bmdbg("Invalid binary state %d\n", BIN_STATE(bin_idx));
+		sem_post(&g_binmgr_loadsem);
+		return ERROR;
+	}
+
 	/* Load binary */
 	do {
 		strncpy(load_attr.bin_name, header_data[latest_idx].bin_name, BIN_NAME_MAX);
@@ -240,6 +282,7 @@ int binary_manager_load_binary(int bin_idx)
 				strncpy(BIN_KERNEL_VER(bin_idx), header_data[latest_idx].kernel_ver, KERNEL_VER_MAX);
 				strncpy(BIN_NAME(bin_idx), header_data[latest_idx].bin_name, BIN_NAME_MAX);
 				bmvdbg("BIN TABLE[%d] %d %d %s %s %s\n", bin_idx, BIN_SIZE(bin_idx), BIN_RAMSIZE(bin_idx), BIN_VER(bin_idx), BIN_KERNEL_VER(bin_idx), BIN_NAME(bin_idx));
+				sem_post(&g_binmgr_loadsem);
 				return OK;
 			} else if (errno == ENOMEM) {
 				/* Sleep for a moment to get available memory */
@@ -255,27 +298,139 @@ int binary_manager_load_binary(int bin_idx)
 		}
 	} while (valid_bin_count > 0);
 
+	sem_post(&g_binmgr_loadsem);
 	return ERROR;
 }
 
-static int binary_manager_load_all(void)
+/* Get the priority in the header of the latest valid partition of a binary, without verifying the checksum */
+static int binary_manager_get_load_priority(int bin_idx)
 {
 	int ret;
+	int version;
+	int part_idx;
+	int latest_ver;
+	int priority;
+	binary_header_t header_data;
+
+	latest_ver = -1;
+	priority = ERROR;
+
+	for (part_idx = 0; part_idx < PARTS_PER_BIN; part_idx++) {
+		if (BIN_PARTNUM(bin_idx, part_idx) < 0) {
+			continue;
+		}
+		ret = binary_manager_read_header(bin_idx, part_idx, &header_data, false);
+		if (ret == OK) {
+			version = (int)atoi(header_data.bin_ver);
+			if (version > latest_ver) {
+				latest_ver = version;
+				priority = header_data.bin_priority;
+			}
+		}
+	}
+
+	return priority;
+}
+
+#ifdef CONFIG_BINMGR_DEFERRED_LOAD
+/* Create a loading thread which loads the binaries left to the background at low priority */
+static int binary_manager_load_deferred(void)
+{
+	int ret;
+	char type_str[4];
+	char *loading_data[LOADTHD_ARGC + 1];
+
+	loading_data[0] = itoa(LOADCMD_LOAD_DEFERRED, type_str, 10);
+	loading_data[1] = NULL;
+
+	ret = kernel_thread(LOADINGTHD_NAME, CONFIG_BINMGR_DEFERRED_LOADER_PRIORITY, LOADINGTHD_STACKSIZE, loading_thread, (char * const *)loading_data);
+	if (ret > 0) {
+		bmvdbg("Execute deferred loading thread with pid %d\n", ret);
+	} else {
+		bmdbg("Failed to create deferred loading thread, errno %d\n", errno);
+	}
+
+	return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: binary_manager_load_all
+ *
+ * Description:
+ *   This function loads the registered binaries in order of the priority in
+ *   their headers, highest first, so that the time until the most important
+ *   binaries run does not depend on the other ones.  Only the headers are
+ *   read to find this order, the checksums are verified when each binary is
+ *   loaded.
+ *
+ *   With CONFIG_BINMGR_DEFERRED_LOAD, the binaries with a priority below
+ *   CONFIG_BINMGR_DEFERRED_PRIORITY are skipped and left to a loading thread
+ *   of lower priority, which calls this function with 'deferred' set to load
+ *   only them.
+ *
+ * Returned Value:
+ *   The number of binaries loaded, or BINMGR_OPERATION_FAIL if none could
+ *   be loaded or left to the background.
+ *
+ ****************************************************************************/
+static int binary_manager_load_all(bool deferred)
+{
+	int ret;
+	int idx;
+	int pos;
 	int bin_idx;
 	int load_cnt;
+	int defer_cnt;
 	uint32_t bin_count;
+	int priority[BINARY_COUNT];
+	uint8_t order[BINARY_COUNT];
 
 	load_cnt = 0;
+	defer_cnt = 0;
 	bin_count = binary_manager_get_binary_count();
 
-	for (bin_idx = 1; bin_idx <= bin_count; bin_idx++) {
+	/* Sort binaries by priority, keeping the registration order of binaries with the same priority */
+	for (idx = 0; idx < bin_count; idx++) {
+		bin_idx = idx + 1;
+		priority[bin_idx] = binary_manager_get_load_priority(bin_idx);
+		for (pos = idx; pos > 0 && priority[order[pos - 1]] < priority[bin_idx]; pos--) {
+			order[pos] = order[pos - 1];
+		}
+		order[pos] = bin_idx;
+	}
+
+	for (idx = 0; idx < bin_count; idx++) {
+		bin_idx = order[idx];
+#ifdef CONFIG_BINMGR_DEFERRED_LOAD
+		if ((priority[bin_idx] < CONFIG_BINMGR_DEFERRED_PRIORITY) != deferred) {
+			if (!deferred) {
+				bmvdbg("Loading of %s is deferred, priority %d\n", BIN_NAME(bin_idx), priority[bin_idx]);
+				defer_cnt++;
+			}
+			continue;
+		}
+#endif
 		ret = binary_manager_load_binary(bin_idx);
 		if (ret == OK) {
 			load_cnt++;
 		}
 	}
 
-	if (load_cnt > 0) {
+#ifdef CONFIG_BINMGR_DEFERRED_LOAD
+	if (defer_cnt > 0 && binary_manager_load_deferred() <= 0) {
+		/* Load them here if they cannot be left to the background */
+		defer_cnt = 0;
+		for (idx = 0; idx < bin_count; idx++) {
+			bin_idx = order[idx];
+			if (priority[bin_idx] < CONFIG_BINMGR_DEFERRED_PRIORITY && binary_manager_load_binary(bin_idx) == OK) {
+				load_cnt++;
+			}
+		}
+	}
+#endif
+
+	if (load_cnt > 0 || defer_cnt > 0) {
 		return load_cnt;
 	}
 
@@ -415,8 +570,13 @@ static int loading_thread(int argc, char *argv[])
 	ret = BINMGR_INVALID_PARAM;
 	switch (load_cmd) {
 	case LOADCMD_LOAD_ALL:
-		ret = binary_manager_load_all();
+		ret = binary_manager_load_all(false);
+		break;
+#ifdef CONFIG_BINMGR_DEFERRED_LOAD
+	case LOADCMD_LOAD_DEFERRED:
+		ret = binary_manager_load_all(true);
 		break;
+#endif
 	case LOADCMD_UPDATE:
 		if (argc <= 2) {
 			bmdbg("Invalid arguments for reloading, argc %d\n", argc);
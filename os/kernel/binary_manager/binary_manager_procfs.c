@@ -0,0 +1,305 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/clock.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+
+#include "binary_manager.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BINMGR)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BINMGR_LINELEN 96
+
+#define BINMGR_INFO_TITLE_FMT " %-16s | %5s | %4s | %8s | %8s | %8s | %8s | %10s \n"
+#define BINMGR_INFO_LINE " -----------------|-------|------|----------|----------|----------|----------|------------\n"
+#define BINMGR_INFO_TITLE "NAME", "STATE", "PRIO", "HEADER", "LOAD", "BIND", "CTORS", "STARTED"
+#define BINMGR_INFO_FMT " %-16s | %5d | %4d | %8lu | %8lu | %8lu | %8lu | %10lu \n"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+/* This structure describes one open "file" */
+
+struct binmgr_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	char line[BINMGR_LINELEN];	/* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+/* File system methods */
+
+static int binmgr_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int binmgr_close(FAR struct file *filep);
+static ssize_t binmgr_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int binmgr_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int binmgr_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations binmgr_operations = {
+	binmgr_open,				/* open */
+	binmgr_close,				/* close */
+	binmgr_read,				/* read */
+	NULL,						/* write */
+
+	binmgr_dup,					/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	binmgr_stat					/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: binmgr_open
+ ****************************************************************************/
+
+static int binmgr_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct binmgr_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only.  Any attempt to open with any kind of write
+	 * access is not permitted.
+	 */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	/* "binmgr" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "binmgr") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* Allocate a container to hold the file attributes */
+
+	attr = (FAR struct binmgr_file_s *)kmm_zalloc(sizeof(struct binmgr_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Save the attributes as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: binmgr_close
+ ****************************************************************************/
+
+static int binmgr_close(FAR struct file *filep)
+{
+	FAR struct binmgr_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct binmgr_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: binmgr_read
+ *
+ * Description:
+ *   Show the state, priority and time taken by each loading phase of every
+ *   user binary, in msec.  STARTED is the system time at which the binary
+ *   reported that it started.
+ *
+ ****************************************************************************/
+
+static ssize_t binmgr_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct binmgr_file_s *attr;
+	FAR binmgr_loadstat_t *stat;
+	uint32_t bin_count;
+	int bin_idx;
+	size_t linesize;
+	size_t copysize;
+	size_t totalsize;
+	off_t offset;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct binmgr_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	offset = filep->f_pos;
+	totalsize = 0;
+
+	linesize = snprintf(attr->line, BINMGR_LINELEN, BINMGR_INFO_TITLE_FMT, BINMGR_INFO_TITLE);
+	copysize = procfs_memcpy(attr->line, linesize, buffer, buflen - totalsize, &offset);
+	totalsize += copysize;
+	buffer += copysize;
+
+	if (totalsize >= buflen) {
+		goto end;
+	}
+
+	linesize = snprintf(attr->line, BINMGR_LINELEN, BINMGR_INFO_LINE);
+	copysize = procfs_memcpy(attr->line, linesize, buffer, buflen - totalsize, &offset);
+	totalsize += copysize;
+	buffer += copysize;
+
+	if (totalsize >= buflen) {
+		goto end;
+	}
+
+	bin_count = binary_manager_get_binary_count();
+	for (bin_idx = 1; bin_idx <= bin_count; bin_idx++) {
+		stat = &BIN_LOADSTAT(bin_idx);
+		linesize = snprintf(attr->line, BINMGR_LINELEN, BINMGR_INFO_FMT, BIN_NAME(bin_idx), BIN_STATE(bin_idx), BIN_PRIORITY(bin_idx),
+							(unsigned long)TICK2MSEC(stat->header), (unsigned long)TICK2MSEC(stat->load), (unsigned long)TICK2MSEC(stat->bind),
+							(unsigned long)TICK2MSEC(stat->ctors), (unsigned long)TICK2MSEC(stat->started));
+		copysize = procfs_memcpy(attr->line, linesize, buffer, buflen - totalsize, &offset);
+		totalsize += copysize;
+		buffer += copysize;
+
+		if (totalsize >= buflen) {
+			goto end;
+		}
+	}
+
+end:
+	/* Update the file position */
+	if (totalsize > 0) {
+		filep->f_pos += totalsize;
+	}
+
+	return totalsize;
+}
+
+/****************************************************************************
+ * Name: binmgr_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int binmgr_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct binmgr_file_s *oldattr;
+	FAR struct binmgr_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct binmgr_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the task and attribute selection */
+
+	newattr = (FAR struct binmgr_file_s *)kmm_malloc(sizeof(struct binmgr_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* The copy the file attributes from the old attributes to the new */
+
+	memcpy(newattr, oldattr, sizeof(struct binmgr_file_s));
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: binmgr_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int binmgr_stat(const char *relpath, struct stat *buf)
+{
+	/* "binmgr" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "binmgr") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* "binmgr" is the name for a read-only file */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && !CONFIG_FS_PROCFS_EXCLUDE_BINMGR */
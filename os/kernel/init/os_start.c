@@ -69,6 +69,7 @@
 #include  <tinyara/lib.h>
 #include  <tinyara/mm/mm.h>
 #include  <tinyara/mm/shm.h>
+#include  <tinyara/mm/pool.h>
 #include  <tinyara/kmalloc.h>
 #include  <tinyara/init.h>
 
@@ -368,6 +369,7 @@ void os_start(void)
 	/* Then add the idle task's TCB to the head of the ready to run list */
 
 	dq_addfirst((FAR dq_entry_t *)&g_idletcb, (FAR dq_queue_t *)&g_readytorun);
+	sched_rtrbitmap_add(&g_idletcb.cmn);
 
 	/* Initialize the processor-specific portion of the TCB */
 
@@ -419,6 +421,13 @@ void os_start(void)
 
 	up_addregion();
 
+#ifdef CONFIG_MM_POOL
+	/* Set up the storage of the object pools, and the pools of TCBs */
+
+	mm_pool_initialize();
+	sched_tcbinitialize();
+#endif
+
 #ifdef CONFIG_APP_BINARY_SEPARATION
 	/* If app binary separation is enabled, then each application will have its own RAM
 	 * area called as the ram partition. The app's text, data, stack and heap will all be
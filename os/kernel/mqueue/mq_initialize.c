@@ -57,6 +57,7 @@
 #include <tinyara/config.h>
 
 #include <stdint.h>
+#include <assert.h>
 #include <queue.h>
 #include <tinyara/kmalloc.h>
 
@@ -81,6 +82,13 @@ struct mq_des_block_s {
  * Public Variables
  ************************************************************************/
 
+#ifdef CONFIG_MM_POOL
+/* The g_msgpool is the pool of messages.  It holds the messages for
+ * general use followed by the messages reserved for interrupt handlers.
+ */
+
+FAR struct mm_pool_s *g_msgpool;
+#else
 /* The g_msgfree is a list of messages that are available for general
  * use.  The number of messages in this list is a system configuration
  * item.
@@ -93,6 +101,7 @@ sq_queue_t g_msgfree;
  */
 
 sq_queue_t g_msgfreeirq;
+#endif
 
 /* The g_desfree data structure is a list of message descriptors available
  * to the operating system for general use. The number of messages in the
@@ -105,6 +114,7 @@ sq_queue_t g_desfree;
  * Private Variables
  ************************************************************************/
 
+#ifndef CONFIG_MM_POOL
 /* g_msgalloc is a pointer to the start of the allocated block of
  * messages.
  */
@@ -116,6 +126,7 @@ static struct mqueue_msg_s *g_msgalloc;
  */
 
 static struct mqueue_msg_s *g_msgfreeirqalloc;
+#endif
 
 /* g_desalloc is a list of allocated block of message queue descriptors. */
 
@@ -136,6 +147,7 @@ static sq_queue_t g_desalloc;
  *
  ************************************************************************/
 
+#ifndef CONFIG_MM_POOL
 static struct mqueue_msg_s *mq_msgblockalloc(FAR sq_queue_t *queue, uint16_t nmsgs, uint8_t alloc_type)
 {
 	struct mqueue_msg_s *mqmsgblock;
@@ -158,6 +170,7 @@ static struct mqueue_msg_s *mq_msgblockalloc(FAR sq_queue_t *queue, uint16_t nms
 
 	return mqmsgblock;
 }
+#endif
 
 /************************************************************************
  * Public Functions
@@ -181,11 +194,21 @@ static struct mqueue_msg_s *mq_msgblockalloc(FAR sq_queue_t *queue, uint16_t nms
 
 void mq_initialize(void)
 {
+	sq_init(&g_desalloc);
+
+#ifdef CONFIG_MM_POOL
+	/* Create the pool of messages.  The last NUM_INTERRUPT_MSGS messages
+	 * are reserved for interrupt handlers, tasks get messages from the
+	 * heap once the others are used up.
+	 */
+
+	g_msgpool = mm_pool_create("mq msg", sizeof(struct mqueue_msg_s), 0, CONFIG_PREALLOC_MQ_MSGS + NUM_INTERRUPT_MSGS, NUM_INTERRUPT_MSGS, MM_POOL_HEAP);
+	DEBUGASSERT(g_msgpool);
+#else
 	/* Initialize the message free lists */
 
 	sq_init(&g_msgfree);
 	sq_init(&g_msgfreeirq);
-	sq_init(&g_desalloc);
 
 	/* Allocate a block of messages for general use */
 
@@ -196,6 +219,7 @@ void mq_initialize(void)
 	 */
 
 	g_msgfreeirqalloc = mq_msgblockalloc(&g_msgfreeirq, NUM_INTERRUPT_MSGS, MQ_ALLOC_IRQ);
+#endif
 
 	/* Allocate a block of message queue descriptors */
 
@@ -105,6 +105,13 @@
 
 void mq_msgfree(FAR struct mqueue_msg_s *mqmsg)
 {
+#ifdef CONFIG_MM_POOL
+	/* The pool tells the pre-allocated messages from the ones which were
+	 * taken from the heap.
+	 */
+
+	mm_pool_free(g_msgpool, mqmsg);
+#else
 	irqstate_t saved_state;
 
 	/* If this is a generally available pre-allocated message,
@@ -145,4 +152,5 @@ void mq_msgfree(FAR struct mqueue_msg_s *mqmsg)
 	} else {
 		PANIC();
 	}
+#endif
 }
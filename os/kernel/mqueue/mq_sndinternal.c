@@ -179,6 +179,14 @@ int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
 FAR struct mqueue_msg_s *mq_msgalloc(void)
 {
 	FAR struct mqueue_msg_s *mqmsg;
+#ifdef CONFIG_MM_POOL
+	/* Interrupt handlers may use the messages reserved for them, tasks
+	 * fall back to the heap when the pool is empty.
+	 */
+
+	mqmsg = (FAR struct mqueue_msg_s *)mm_pool_alloc(g_msgpool);
+	ASSERT(mqmsg || up_interrupt_context());
+#else
 	irqstate_t saved_state;
 
 	/* If we were called from an interrupt handler, then try to get the message
@@ -219,6 +227,7 @@ FAR struct mqueue_msg_s *mq_msgalloc(void)
 			mqmsg->type = MQ_ALLOC_DYN;
 		}
 	}
+#endif
 
 	return mqmsg;
 }
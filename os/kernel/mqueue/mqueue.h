@@ -69,6 +69,7 @@
 #include <signal.h>
 
 #include <tinyara/mqueue.h>
+#include <tinyara/mm/pool.h>
 
 #if !defined(CONFIG_DISABLE_MQUEUE) && CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -127,6 +128,13 @@ extern "C" {
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_MM_POOL
+/* The g_msgpool is the pool of messages.  Its last messages are reserved
+ * for use by interrupt handlers.
+ */
+
+EXTERN FAR struct mm_pool_s *g_msgpool;
+#else
 /* The g_msgfree is a list of messages that are available for general use.
  * The number of messages in this list is a system configuration item.
  */
@@ -138,6 +146,7 @@ EXTERN sq_queue_t g_msgfree;
  */
 
 EXTERN sq_queue_t g_msgfreeirq;
+#endif
 
 /* The g_desfree data structure is a list of message descriptors available
  * to the operating system for general use. The number of messages in the
@@ -273,7 +273,7 @@ int pthread_create(FAR pthread_t *thread, FAR const pthread_attr_t *attr, pthrea
 
 	/* Allocate a TCB for the new task. */
 
-	ptcb = (FAR struct pthread_tcb_s *)kmm_zalloc(sizeof(struct pthread_tcb_s));
+	ptcb = (FAR struct pthread_tcb_s *)sched_tcballoc(TCB_FLAG_TTYPE_PTHREAD);
 	if (!ptcb) {
 		sdbg("ERROR: Failed to allocate TCB\n");
 		return ENOMEM;
@@ -254,6 +254,15 @@ int sched_reprioritize(FAR struct tcb_s *tcb, int sched_priority);
 		sched_setpriority(tcb, sched_priority)
 #endif
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+FAR struct tcb_s *sched_rtrbitmap_search(uint8_t sched_priority);
+void sched_rtrbitmap_add(FAR struct tcb_s *tcb);
+void sched_rtrbitmap_remove(FAR struct tcb_s *tcb);
+#else
+#define sched_rtrbitmap_add(tcb)
+#define sched_rtrbitmap_remove(tcb)
+#endif
+
 #ifdef CONFIG_SCHED_TICKLESS
 unsigned int sched_timer_cancel(void);
 void sched_timer_resume(void);
@@ -273,5 +282,10 @@ void sched_clear_cpuload(pid_t pid);
 
 bool sched_verifytcb(FAR struct tcb_s *tcb);
 int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype);
+#ifdef CONFIG_MM_POOL
+void sched_tcbinitialize(void);
+#endif
+FAR struct tcb_s *sched_tcballoc(uint8_t ttype);
+void sched_tcbfree(FAR struct tcb_s *tcb, uint8_t ttype);
 
 #endif							/* __SCHED_SCHED_SCHED_H */
@@ -127,7 +127,17 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 	 * Each is list is maintained in ascending sched_priority order.
 	 */
 
-	for (next = (FAR struct tcb_s *)list->head; (next && sched_priority <= next->sched_priority); next = next->flink) ;
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+	if (list == (FAR dq_queue_t *)&g_readytorun) {
+		/* The ready-to-run list is indexed, so there is no need to walk it */
+
+		prev = sched_rtrbitmap_search(sched_priority);
+		next = prev ? prev->flink : (FAR struct tcb_s *)list->head;
+	} else
+#endif
+	{
+		for (next = (FAR struct tcb_s *)list->head; (next && sched_priority <= next->sched_priority); next = next->flink) ;
+	}
 
 	/* Add the tcb to the spot found in the list.  Check if the tcb
 	 * goes at the end of the list. NOTE:  This could only happen if list
@@ -176,5 +186,11 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 		}
 	}
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+	if (list == (FAR dq_queue_t *)&g_readytorun) {
+		sched_rtrbitmap_add(tcb);
+	}
+#endif
+
 	return ret;
 }
@@ -114,9 +114,31 @@ bool sched_mergepending(void)
 	FAR struct tcb_s *pndtcb;
 	FAR struct tcb_s *pndnext;
 	FAR struct tcb_s *rtrtcb;
+#ifndef CONFIG_SCHED_READYTORUN_BITMAP
 	FAR struct tcb_s *rtrprev;
+#endif
 	bool ret = false;
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+	/* Each pending TCB can be placed directly through the ready-to-run
+	 * index.  The pending list is in priority order, so TCBs of the same
+	 * priority keep their FIFO order.
+	 */
+
+	for (pndtcb = (FAR struct tcb_s *)g_pendingtasks.head; pndtcb; pndtcb = pndnext) {
+		pndnext = pndtcb->flink;
+		rtrtcb = this_task();
+
+		if (sched_addprioritized(pndtcb, (FAR dq_queue_t *)&g_readytorun)) {
+			rtrtcb->task_state = TSTATE_TASK_READYTORUN;
+			pndtcb->task_state = TSTATE_TASK_RUNNING;
+			ret = true;
+		} else {
+			pndtcb->task_state = TSTATE_TASK_READYTORUN;
+		}
+	}
+#else
+
 	/* Initialize the inner search loop */
 
 	rtrtcb = this_task();
@@ -169,6 +191,7 @@ bool sched_mergepending(void)
 
 		rtrtcb = pndtcb;
 	}
+#endif
 
 	/* Mark the input list empty */
 
@@ -159,6 +159,12 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 #endif
 #endif
 
+#ifdef CONFIG_MM_TCACHE_PERTHREAD
+		/* Hand over chunks in the cache of the thread to the heap */
+
+		mm_tcache_release(tcb);
+#endif
+
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
 		/* Release any timers that the task might hold.  We do this
 		 * before release the PID because it may still be trying to
@@ -236,7 +242,7 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
 		/* And, finally, release the TCB itself */
 
-		sched_kfree(tcb);
+		sched_tcbfree(tcb, ttype);
 	}
 
 	return ret;
@@ -0,0 +1,172 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/************************************************************************
+ * kernel/sched/sched_rtrbitmap.c
+ *
+ * The ready-to-run list is kept as a prioritized list so that this_task()
+ * and everything else walking g_readytorun keeps working.  This file
+ * maintains an index over that list: one bit per occupied priority and a
+ * pointer to the last TCB of each priority.  A new TCB always goes just
+ * after the last TCB at the nearest equal or higher priority, so the spot
+ * can be found with a couple of CLZ instructions instead of a list walk.
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Included Files
+ ************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <sched.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+
+/************************************************************************
+ * Pre-processor Definitions
+ ************************************************************************/
+
+#define RTRBITMAP_NWORDS    ((SCHED_PRIORITY_MAX >> 5) + 1)
+
+/* Priority 0 of each word is kept in the MSB so that CLZ returns the
+ * lowest occupied priority above a given one.
+ */
+
+#define RTRBITMAP_WORD(p)   ((p) >> 5)
+#define RTRBITMAP_BIT(p)    (0x80000000u >> ((p) & 31))
+
+/************************************************************************
+ * Private Variables
+ ************************************************************************/
+
+/* Bit set for every priority having at least one TCB in g_readytorun */
+
+static uint32_t g_rtrbitmap[RTRBITMAP_NWORDS];
+
+/* The last (most recently added) TCB of each priority in g_readytorun */
+
+static FAR struct tcb_s *g_rtrlast[SCHED_PRIORITY_MAX + 1];
+
+/************************************************************************
+ * Public Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name: sched_rtrbitmap_search
+ *
+ * Description:
+ *   Find the TCB in g_readytorun after which a new TCB at sched_priority
+ *   must be inserted, that is the last TCB with an equal or the nearest
+ *   higher priority.
+ *
+ * Return Value:
+ *   The TCB to insert after, or NULL if the new TCB goes at the head of
+ *   g_readytorun.
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ************************************************************************/
+
+FAR struct tcb_s *sched_rtrbitmap_search(uint8_t sched_priority)
+{
+	uint32_t word;
+	int idx;
+
+	if (g_rtrlast[sched_priority]) {
+		return g_rtrlast[sched_priority];
+	}
+
+	/* Look for higher priorities in the same word first */
+
+	idx = RTRBITMAP_WORD(sched_priority);
+	word = g_rtrbitmap[idx] & (RTRBITMAP_BIT(sched_priority) - 1);
+
+	while (!word) {
+		if (++idx >= RTRBITMAP_NWORDS) {
+			return NULL;
+		}
+
+		word = g_rtrbitmap[idx];
+	}
+
+	return g_rtrlast[(idx << 5) + __builtin_clz(word)];
+}
+
+/************************************************************************
+ * Name: sched_rtrbitmap_add
+ *
+ * Description:
+ *   Register a TCB which has just been linked into g_readytorun as the
+ *   last TCB of its priority.
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ************************************************************************/
+
+void sched_rtrbitmap_add(FAR struct tcb_s *tcb)
+{
+	uint8_t sched_priority = tcb->sched_priority;
+
+	DEBUGASSERT(tcb->flink == NULL || tcb->flink->sched_priority < sched_priority);
+
+	g_rtrlast[sched_priority] = tcb;
+	g_rtrbitmap[RTRBITMAP_WORD(sched_priority)] |= RTRBITMAP_BIT(sched_priority);
+}
+
+/************************************************************************
+ * Name: sched_rtrbitmap_remove
+ *
+ * Description:
+ *   Drop a TCB from the index.  This must be called while the TCB is still
+ *   linked in its list and before its priority is changed.  Nothing is
+ *   done if the TCB is not in g_readytorun.
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ************************************************************************/
+
+void sched_rtrbitmap_remove(FAR struct tcb_s *tcb)
+{
+	uint8_t sched_priority = tcb->sched_priority;
+	FAR struct tcb_s *prev;
+
+	if (tcb->task_state != TSTATE_TASK_RUNNING && tcb->task_state != TSTATE_TASK_READYTORUN) {
+		return;
+	}
+
+	if (g_rtrlast[sched_priority] != tcb) {
+		return;
+	}
+
+	prev = tcb->blink;
+	if (prev && prev->sched_priority == sched_priority) {
+		g_rtrlast[sched_priority] = prev;
+	} else {
+		g_rtrlast[sched_priority] = NULL;
+		g_rtrbitmap[RTRBITMAP_WORD(sched_priority)] &= ~RTRBITMAP_BIT(sched_priority);
+	}
+}
+
+#endif							/* CONFIG_SCHED_READYTORUN_BITMAP */
@@ -161,9 +161,13 @@ int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority)
 		/* Otherwise, we can just change priority since it has no effect */
 
 		else {
-			/* Change the task priority */
+			/* Change the task priority.  The task stays at the head of
+			 * the list and is the only one left at its new priority.
+			 */
 
+			sched_rtrbitmap_remove(tcb);
 			tcb->sched_priority = (uint8_t)sched_priority;
+			sched_rtrbitmap_add(tcb);
 		}
 		break;
 
@@ -0,0 +1,142 @@
+/****************************************************************************
+ *
+ * Copyright 2026 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <string.h>
+#include <assert.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/sched.h>
+#include <tinyara/mm/pool.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_POOL
+static FAR struct mm_pool_s *g_tcbpool;
+#ifndef CONFIG_DISABLE_PTHREAD
+static FAR struct mm_pool_s *g_ptcbpool;
+#endif
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_POOL
+/****************************************************************************
+ * Name: sched_tcbpool
+ *
+ * Description:
+ *   Return the pool of the TCBs of a thread type.
+ *
+ ****************************************************************************/
+static inline FAR struct mm_pool_s *sched_tcbpool(uint8_t ttype)
+{
+#ifndef CONFIG_DISABLE_PTHREAD
+	if ((ttype & TCB_FLAG_TTYPE_MASK) == TCB_FLAG_TTYPE_PTHREAD) {
+		return g_ptcbpool;
+	}
+#endif
+
+	return g_tcbpool;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_POOL
+/****************************************************************************
+ * Name: sched_tcbinitialize
+ *
+ * Description:
+ *   Create the pools of TCBs.  The TCBs are taken from the heap once the
+ *   pools are exhausted.
+ *
+ ****************************************************************************/
+void sched_tcbinitialize(void)
+{
+	g_tcbpool = mm_pool_create("task tcb", sizeof(struct task_tcb_s), 0, CONFIG_PREALLOC_TCBS, 0, MM_POOL_HEAP);
+#ifndef CONFIG_DISABLE_PTHREAD
+	g_ptcbpool = mm_pool_create("pthread tcb", sizeof(struct pthread_tcb_s), 0, CONFIG_PREALLOC_TCBS, 0, MM_POOL_HEAP);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: sched_tcballoc
+ *
+ * Description:
+ *   Allocate a zeroed TCB for a thread of type 'ttype', that is a
+ *   struct pthread_tcb_s for TCB_FLAG_TTYPE_PTHREAD or a struct task_tcb_s
+ *   otherwise.
+ *
+ ****************************************************************************/
+FAR struct tcb_s *sched_tcballoc(uint8_t ttype)
+{
+	FAR struct tcb_s *tcb;
+	size_t size = sizeof(struct task_tcb_s);
+
+#ifndef CONFIG_DISABLE_PTHREAD
+	if ((ttype & TCB_FLAG_TTYPE_MASK) == TCB_FLAG_TTYPE_PTHREAD) {
+		size = sizeof(struct pthread_tcb_s);
+	}
+#endif
+
+#ifdef CONFIG_MM_POOL
+	if (sched_tcbpool(ttype)) {
+		tcb = (FAR struct tcb_s *)mm_pool_alloc(sched_tcbpool(ttype));
+		if (tcb) {
+			memset(tcb, 0, size);
+		}
+
+		return tcb;
+	}
+#endif
+
+	tcb = (FAR struct tcb_s *)kmm_zalloc(size);
+	return tcb;
+}
+
+/****************************************************************************
+ * Name: sched_tcbfree
+ *
+ * Description:
+ *   Free a TCB allocated by sched_tcballoc() with the same 'ttype'.
+ *
+ ****************************************************************************/
+void sched_tcbfree(FAR struct tcb_s *tcb, uint8_t ttype)
+{
+#ifdef CONFIG_MM_POOL
+	if (sched_tcbpool(ttype)) {
+		mm_pool_free(sched_tcbpool(ttype), tcb);
+		return;
+	}
+#endif
+
+	sched_kfree(tcb);
+}
@@ -130,6 +130,7 @@ int sched_yield(void)
 		switch_needed = true;
 
 		/* Remove the TCB from the ready-to-run list */
+		sched_rtrbitmap_remove(rtcb);
 		dq_rem((FAR dq_entry_t *)rtcb, (FAR dq_queue_t *)&g_readytorun);
 
 		/* Since the current TCB is not in any list, it is now invalid */
@@ -97,6 +97,13 @@
 FAR sigq_t *sig_allocatependingsigaction(void)
 {
 	FAR sigq_t *sigq;
+#ifdef CONFIG_MM_POOL
+	/* Interrupt handlers may use the structures reserved for them, tasks
+	 * fall back to the heap when the pool is empty.
+	 */
+
+	sigq = (FAR sigq_t *)mm_pool_alloc(g_sigactionpool);
+#else
 	irqstate_t saved_state;
 
 	/* Check if we were called from an interrupt handler. */
@@ -139,6 +146,7 @@ FAR sigq_t *sig_allocatependingsigaction(void)
 			}
 		}
 	}
+#endif
 
 	return sigq;
 }
@@ -157,6 +157,13 @@ static int sig_queueaction(FAR struct tcb_s *stcb, siginfo_t *info)
 static FAR sigpendq_t *sig_allocatependingsignal(void)
 {
 	FAR sigpendq_t *sigpend;
+#ifdef CONFIG_MM_POOL
+	/* Interrupt handlers may use the structures reserved for them, tasks
+	 * fall back to the heap when the pool is empty.
+	 */
+
+	sigpend = (FAR sigpendq_t *)mm_pool_alloc(g_sigpendingpool);
+#else
 	irqstate_t saved_state;
 
 	/* Check if we were called from an interrupt handler. */
@@ -199,6 +206,7 @@ static FAR sigpendq_t *sig_allocatependingsignal(void)
 			}
 		}
 	}
+#endif
 
 	return sigpend;
 }
@@ -57,6 +57,7 @@
 #include <tinyara/config.h>
 
 #include <stdint.h>
+#include <assert.h>
 #include <queue.h>
 #include <tinyara/kmalloc.h>
 
@@ -80,6 +81,15 @@
 
 sq_queue_t g_sigfreeaction;
 
+#ifdef CONFIG_MM_POOL
+/* The g_sigactionpool is the pool of pending signal action structures. */
+
+FAR struct mm_pool_s *g_sigactionpool;
+
+/* The g_sigpendingpool is the pool of pending signal structures. */
+
+FAR struct mm_pool_s *g_sigpendingpool;
+#else
 /* The g_sigpendingaction data structure is a list of available pending
  * signal action structures.
  */
@@ -104,6 +114,7 @@ sq_queue_t g_sigpendingsignal;
  */
 
 sq_queue_t g_sigpendingirqsignal;
+#endif
 
 /************************************************************************
  * Private Variables
@@ -115,6 +126,7 @@ sq_queue_t g_sigpendingirqsignal;
 
 static sigactq_t *g_sigactionalloc;
 
+#ifndef CONFIG_MM_POOL
 /* g_sigpendingactionalloc is a pointer to the start of the allocated
  * blocks of pending signal actions.
  */
@@ -138,13 +150,16 @@ static sigpendq_t *g_sigpendingsignalalloc;
  */
 
 static sigpendq_t *g_sigpendingirqsignalalloc;
+#endif
 
 /************************************************************************
  * Private Function Prototypes
  ************************************************************************/
 
+#ifndef CONFIG_MM_POOL
 static sigq_t *sig_allocateblock(sq_queue_t *siglist, uint16_t nsigs, uint8_t sigtype);
 static sigpendq_t *sig_allocatependingsignalblock(sq_queue_t *siglist, uint16_t nsigs, uint8_t sigtype);
+#endif
 
 /************************************************************************
  * Private Functions
@@ -159,6 +174,7 @@ static sigpendq_t *sig_allocatependingsignalblock(sq_queue_t *siglist, uint16_t
  *
  ************************************************************************/
 
+#ifndef CONFIG_MM_POOL
 static sigq_t *sig_allocateblock(sq_queue_t *siglist, uint16_t nsigs, uint8_t sigtype)
 {
 	sigq_t *sigqalloc;
@@ -211,6 +227,7 @@ static sigpendq_t *sig_allocatependingsignalblock(sq_queue_t *siglist, uint16_t
 
 	return sigpendalloc;
 }
+#endif
 
 /************************************************************************
  * Public Functions
@@ -229,6 +246,20 @@ void sig_initialize(void)
 	/* Initialize free lists */
 
 	sq_init(&g_sigfreeaction);
+
+#ifdef CONFIG_MM_POOL
+	/* Create the pools of pending signal actions and pending signals, with
+	 * the structures reserved for interrupt handlers at their end.
+	 */
+
+	g_sigactionpool = mm_pool_create("sig action", sizeof(sigq_t), 0, NUM_PENDING_ACTIONS + NUM_PENDING_INT_ACTIONS, NUM_PENDING_INT_ACTIONS, MM_POOL_HEAP);
+	DEBUGASSERT(g_sigactionpool);
+
+	sig_allocateactionblock();
+
+	g_sigpendingpool = mm_pool_create("sig pending", sizeof(sigpendq_t), 0, NUM_SIGNALS_PENDING + NUM_INT_SIGNALS_PENDING, NUM_INT_SIGNALS_PENDING, MM_POOL_HEAP);
+	DEBUGASSERT(g_sigpendingpool);
+#else
 	sq_init(&g_sigpendingaction);
 	sq_init(&g_sigpendingirqaction);
 	sq_init(&g_sigpendingsignal);
@@ -245,6 +276,7 @@ void sig_initialize(void)
 	g_sigpendingsignalalloc = sig_allocatependingsignalblock(&g_sigpendingsignal, NUM_SIGNALS_PENDING, SIG_ALLOC_FIXED);
 
 	g_sigpendingirqsignalalloc = sig_allocatependingsignalblock(&g_sigpendingirqsignal, NUM_INT_SIGNALS_PENDING, SIG_ALLOC_IRQ);
+#endif
 }
 
 /************************************************************************
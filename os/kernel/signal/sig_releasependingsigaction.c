@@ -94,6 +94,9 @@
 
 void sig_releasependingsigaction(FAR sigq_t *sigq)
 {
+#ifdef CONFIG_MM_POOL
+	mm_pool_free(g_sigactionpool, sigq);
+#else
 	irqstate_t saved_state;
 
 	/* If this is a generally available pre-allocated structyre,
@@ -130,4 +133,5 @@ void sig_releasependingsigaction(FAR sigq_t *sigq)
 	else if (sigq->type == SIG_ALLOC_DYN) {
 		sched_kfree(sigq);
 	}
+#endif
 }
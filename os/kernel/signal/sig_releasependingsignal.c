@@ -103,6 +103,9 @@
 
 void sig_releasependingsignal(FAR sigpendq_t *sigpend)
 {
+#ifdef CONFIG_MM_POOL
+	mm_pool_free(g_sigpendingpool, sigpend);
+#else
 	irqstate_t saved_state;
 
 	/* If this is a generally available pre-allocated structyre,
@@ -141,4 +144,5 @@ void sig_releasependingsignal(FAR sigpendq_t *sigpend)
 	else if (sigpend->type == SIG_ALLOC_DYN) {
 		sched_kfree(sigpend);
 	}
+#endif
 }
@@ -64,6 +64,7 @@
 #include <sched.h>
 
 #include <tinyara/kmalloc.h>
+#include <tinyara/mm/pool.h>
 
 /****************************************************************************
  * Definitions
@@ -138,6 +139,21 @@ typedef struct sigq_s sigq_t;
 
 extern sq_queue_t g_sigfreeaction;
 
+#ifdef CONFIG_MM_POOL
+/* The g_sigactionpool is the pool of pending signal action structures.
+ * Its last NUM_PENDING_INT_ACTIONS structures are reserved for use by
+ * interrupt handlers.
+ */
+
+extern FAR struct mm_pool_s *g_sigactionpool;
+
+/* The g_sigpendingpool is the pool of pending signal structures.  Its
+ * last NUM_INT_SIGNALS_PENDING structures are reserved for use by
+ * interrupt handlers.
+ */
+
+extern FAR struct mm_pool_s *g_sigpendingpool;
+#else
 /* The g_sigpendingaction data structure is a list of available pending
  * signal action structures.
  */
@@ -161,6 +177,7 @@ extern sq_queue_t g_sigpendingsignal;
  */
 
 extern sq_queue_t g_sigpendingirqsignal;
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
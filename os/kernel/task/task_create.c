@@ -145,7 +145,7 @@ static int thread_create(FAR const char *name, uint8_t ttype, int priority, int
 
 	/* Allocate a TCB for the new task. */
 
-	tcb = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+	tcb = (FAR struct task_tcb_s *)sched_tcballoc(ttype);
 	if (!tcb) {
 		sdbg("ERROR: Failed to allocate TCB\n");
 		errcode = ENOMEM;
@@ -195,6 +195,7 @@ int task_restart(pid_t pid)
 		 */
 
 		state = irqsave();
+		sched_rtrbitmap_remove((FAR struct tcb_s *)tcb);
 		dq_rem((FAR dq_entry_t *)tcb, (dq_queue_t *)g_tasklisttable[tcb->cmn.task_state].list);
 		tcb->cmn.task_state = TSTATE_TASK_INVALID;
 		irqrestore(state);
@@ -198,6 +198,7 @@ int task_terminate(pid_t pid, bool nonblocking)
 	/* Remove the task from the OS's tasks lists. */
 
 	saved_state = irqsave();
+	sched_rtrbitmap_remove(dtcb);
 	dq_rem((FAR dq_entry_t *)dtcb, (dq_queue_t *)g_tasklisttable[dtcb->task_state].list);
 	dtcb->task_state = TSTATE_TASK_INVALID;
 #ifdef CONFIG_TASK_MONITOR
@@ -273,7 +273,7 @@ FAR struct task_tcb_s *task_vforksetup(start_t retaddr)
 
 	/* Allocate a TCB for the child task. */
 
-	child = (FAR struct task_tcb_s *)kmm_zalloc(sizeof(struct task_tcb_s));
+	child = (FAR struct task_tcb_s *)sched_tcballoc(ttype);
 	if (!child) {
 		sdbg("ERROR: Failed to allocate TCB\n");
 		set_errno(ENOMEM);
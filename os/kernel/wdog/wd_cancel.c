@@ -108,8 +108,10 @@
 
 int wd_cancel(WDOG_ID wdog)
 {
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 	FAR struct wdog_s *curr;
 	FAR struct wdog_s *prev;
+#endif
 	irqstate_t state;
 	int ret = ERROR;
 
@@ -124,6 +126,15 @@ int wd_cancel(WDOG_ID wdog)
 	 */
 
 	if (wdog && WDOG_ISACTIVE(wdog)) {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+		/* Take the watchdog off its wheel slot.  The interval timer only
+		 * has to be reassessed if this moved the next timer event.
+		 */
+
+		if (wd_wheel_remove(wdog)) {
+			sched_timer_reassess();
+		}
+#else
 		/* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
 		 * to do this because there are additional operations that need to be
 		 * done.
@@ -172,6 +183,7 @@ int wd_cancel(WDOG_ID wdog)
 		/* Mark the watchdog inactive */
 
 		wdog->next = NULL;
+#endif
 		WDOG_CLRACTIVE(wdog);
 
 		/* Return success */
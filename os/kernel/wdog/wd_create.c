@@ -110,6 +110,17 @@
 WDOG_ID wd_create(void)
 {
 	FAR struct wdog_s *wdog;
+#ifdef CONFIG_MM_POOL
+	/* The pool keeps the reserve for interrupt handlers and falls back to
+	 * the kernel heap in a normal tasking context.
+	 */
+
+	wdog = (FAR struct wdog_s *)mm_pool_alloc(g_wdogpool);
+	if (wdog) {
+		wdog->next = NULL;
+		wdog->flags = 0;
+	}
+#else
 	irqstate_t state;
 
 	/* These actions must be atomic with respect to other tasks and also with
@@ -168,6 +179,7 @@ WDOG_ID wd_create(void)
 			wdog->flags = WDOGF_ALLOCED;
 		}
 	}
+#endif
 
 	return (WDOG_ID)wdog;
 }
@@ -130,6 +130,16 @@ int wd_delete(WDOG_ID wdog)
 		wd_cancel(wdog);
 	}
 
+#ifdef CONFIG_MM_POOL
+	/* Statically allocated timers do not belong to the pool.  The pool
+	 * knows whether the others were pre-allocated or taken from the heap.
+	 */
+
+	irqrestore(state);
+	if (!WDOG_ISSTATIC(wdog)) {
+		mm_pool_free(g_wdogpool, wdog);
+	}
+#else
 	/* Did this watchdog come from the pool of pre-allocated timers?  Or, was
 	 * it allocated from the heap?
 	 */
@@ -167,6 +177,7 @@ int wd_delete(WDOG_ID wdog)
 
 		irqrestore(state);
 	}
+#endif
 
 	/* Return success */
 
@@ -110,6 +110,14 @@ int wd_gettime(WDOG_ID wdog)
 
 	flags = irqsave();
 	if (wdog && WDOG_ISACTIVE(wdog)) {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+		/* The wheel keeps the expiration tick of each watchdog */
+
+		int delay = wd_wheel_gettime(wdog);
+
+		irqrestore(flags);
+		return delay;
+#else
 		/* Traverse the watchdog list accumulating lag times until we find the wdog
 		 * that we are looking for
 		 */
@@ -124,6 +132,7 @@ int wd_gettime(WDOG_ID wdog)
 				return delay;
 			}
 		}
+#endif
 	}
 
 	irqrestore(flags);
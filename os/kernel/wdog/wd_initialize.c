@@ -57,6 +57,7 @@
 #include <tinyara/config.h>
 
 #include <queue.h>
+#include <assert.h>
 
 #include "wdog/wdog.h"
 
@@ -72,19 +73,30 @@
  * Public Variables
  ************************************************************************/
 
+#ifdef CONFIG_MM_POOL
+/* The g_wdogpool is the pool of watchdogs available to the system for
+ * delayed function use.
+ */
+
+FAR struct mm_pool_s *g_wdogpool;
+#else
 /* The g_wdfreelist data structure is a singly linked list of watchdogs
  * available to the system for delayed function use.
  */
 
 sq_queue_t g_wdfreelist;
+#endif
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 sq_queue_t g_wdactivelist;
+#endif
 
+#ifndef CONFIG_MM_POOL
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
  * handlers.
@@ -101,6 +113,7 @@ uint16_t g_wdnfree;
  */
 
 static struct wdog_s g_wdpool[CONFIG_PREALLOC_WDOGS];
+#endif
 
 /************************************************************************
  * Private Functions
@@ -131,13 +144,29 @@ static struct wdog_s g_wdpool[CONFIG_PREALLOC_WDOGS];
 
 void wd_initialize(void)
 {
+#ifdef CONFIG_MM_POOL
+	/* Initialize the active list and create the pool of watchdogs */
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	wd_wheel_initialize();
+#else
+	sq_init(&g_wdactivelist);
+#endif
+
+	g_wdogpool = mm_pool_create("wdog", sizeof(struct wdog_s), 0, CONFIG_PREALLOC_WDOGS, CONFIG_WDOG_INTRESERVE, MM_POOL_HEAP);
+	DEBUGASSERT(g_wdogpool);
+#else
 	FAR struct wdog_s *wdog = g_wdpool;
 	int i;
 
 	/* Initialize watchdog lists */
 
 	sq_init(&g_wdfreelist);
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	wd_wheel_initialize();
+#else
 	sq_init(&g_wdactivelist);
+#endif
 
 	/* The g_wdfreelist must be loaded at initialization time to hold the
 	 * configured number of watchdogs.
@@ -150,4 +179,5 @@ void wd_initialize(void)
 	/* All watchdogs are free */
 
 	g_wdnfree = CONFIG_PREALLOC_WDOGS;
+#endif
 }
@@ -111,6 +111,50 @@ typedef void (*wdentry4_t)(int argc, uint32_t arg1, uint32_t arg2, uint32_t arg3
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
+/****************************************************************************
+ * Name: wd_dispatch
+ *
+ * Description:
+ *   Call the function of an expired watchdog with its parameters.
+ *
+ ****************************************************************************/
+
+static inline void wd_dispatch(FAR struct wdog_s *wdog)
+{
+	up_setpicbase(wdog->picbase);
+	switch (wdog->argc) {
+	default:
+		DEBUGPANIC();
+		break;
+
+	case 0:
+		(*((wdentry0_t)(wdog->func)))(0);
+		break;
+
+#if CONFIG_MAX_WDOGPARMS > 0
+	case 1:
+		(*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
+		break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 1
+	case 2:
+		(*((wdentry2_t)(wdog->func)))(2, wdog->parm[0], wdog->parm[1]);
+		break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 2
+	case 3:
+		(*((wdentry3_t)(wdog->func)))(3, wdog->parm[0], wdog->parm[1], wdog->parm[2]);
+		break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 3
+	case 4:
+		(*((wdentry4_t)(wdog->func)))(4, wdog->parm[0], wdog->parm[1], wdog->parm[2], wdog->parm[3]);
+		break;
+#endif
+	}
+}
+
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -158,40 +202,11 @@ static inline void wd_expiration(void)
 
 			/* Execute the watchdog function */
 
-			up_setpicbase(wdog->picbase);
-			switch (wdog->argc) {
-			default:
-				DEBUGPANIC();
-				break;
-
-			case 0:
-				(*((wdentry0_t)(wdog->func)))(0);
-				break;
-
-#if CONFIG_MAX_WDOGPARMS > 0
-			case 1:
-				(*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
-				break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 1
-			case 2:
-				(*((wdentry2_t)(wdog->func)))(2, wdog->parm[0], wdog->parm[1]);
-				break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 2
-			case 3:
-				(*((wdentry3_t)(wdog->func)))(3, wdog->parm[0], wdog->parm[1], wdog->parm[2]);
-				break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 3
-			case 4:
-				(*((wdentry4_t)(wdog->func)))(4, wdog->parm[0], wdog->parm[1], wdog->parm[2], wdog->parm[3]);
-				break;
-#endif
-			}
+			wd_dispatch(wdog);
 		}
 	}
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -233,10 +248,12 @@ static inline void wd_expiration(void)
 int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
 {
 	va_list ap;
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 	FAR struct wdog_s *curr;
 	FAR struct wdog_s *prev;
 	FAR struct wdog_s *next;
 	int32_t now;
+#endif
 	irqstate_t state;
 	int i;
 
@@ -292,6 +309,11 @@ int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
 	(void)sched_timer_cancel();
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	/* Hash the watchdog onto the timer wheel and mark it as active. */
+
+	wd_wheel_add(wdog, delay);
+#else
 	/* Do the easy case first -- when the watchdog timer queue is empty. */
 
 	if (g_wdactivelist.head == NULL) {
@@ -366,6 +388,7 @@ int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
 	/* Put the lag into the watchdog structure and mark it as active. */
 
 	wdog->lag = delay;
+#endif
 	WDOG_SETACTIVE(wdog);
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -406,7 +429,33 @@ int wd_start(WDOG_ID wdog, int delay, wdentry_t wdentry, int argc, ...)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+#ifdef CONFIG_SCHED_TICKLESS
+unsigned int wd_timer(int ticks)
+#else
+void wd_timer(void)
+#endif
+{
+	FAR struct wdog_s *wdog;
+#ifndef CONFIG_SCHED_TICKLESS
+	int ticks = 1;
+#endif
+
+	/* Run the watchdogs which expired in the elapsed ticks, in order */
+
+	while ((wdog = wd_wheel_expire(&ticks)) != NULL) {
+		WDOG_CLRACTIVE(wdog);
+		wd_dispatch(wdog);
+	}
+
 #ifdef CONFIG_SCHED_TICKLESS
+	/* Return the delay for the next timer event */
+
+	return wd_wheel_next();
+#endif
+}
+
+#elif defined(CONFIG_SCHED_TICKLESS)
 unsigned int wd_timer(int ticks)
 {
 	FAR struct wdog_s *wdog;
@@ -461,4 +510,4 @@ void wd_timer(void)
 		wd_expiration();
 	}
 }
-#endif							/* CONFIG_SCHED_TICKLESS */
+#endif							/* CONFIG_WDOG_TIMER_WHEEL */
@@ -0,0 +1,428 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/wdog/wd_wheel.c
+ *
+ * Hashed hierarchical timing wheel holding the active watchdogs.
+ *
+ * Level 0 has one slot per tick for the next WDOG_WHEEL_SLOTS ticks.  Each
+ * slot of level N covers WDOG_WHEEL_SLOTS times the span of a level N-1
+ * slot.  When the tick count wraps a level, the next slot of the level
+ * above is cascaded, i.e. its watchdogs are hashed again into the lower
+ * levels.  The expiration tick of an active watchdog is kept in its lag
+ * field.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <tinyara/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WDOG_WHEEL_BITS        5
+#define WDOG_WHEEL_SLOTS       (1 << WDOG_WHEEL_BITS)
+#define WDOG_WHEEL_MASK        (WDOG_WHEEL_SLOTS - 1)
+#define WDOG_WHEEL_LEVELS      6
+
+/* Watchdogs further away than this are parked on the last level and
+ * hashed again each time their slot is cascaded.
+ */
+
+#define WDOG_WHEEL_RANGE       (1ul << (WDOG_WHEEL_BITS * WDOG_WHEEL_LEVELS))
+
+#define WDOG_WHEEL_SHIFT(l)    ((l) * WDOG_WHEEL_BITS)
+#define WDOG_WHEEL_INDEX(t, l) (((t) >> WDOG_WHEEL_SHIFT(l)) & WDOG_WHEEL_MASK)
+
+#define WDOG_WHEEL_NONE        UINT32_MAX
+
+/****************************************************************************
+ * Private Type Declarations
+ ****************************************************************************/
+
+struct wd_wheel_s {
+	uint32_t base;				/* Next tick to be processed */
+	uint32_t map[WDOG_WHEEL_LEVELS];	/* Non-empty slots of each level */
+	FAR struct wdog_s *slot[WDOG_WHEEL_LEVELS][WDOG_WHEEL_SLOTS];
+	FAR struct wdog_s *expired;	/* Watchdogs due on the last processed tick */
+};
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+static struct wd_wheel_s g_wdwheel;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_ffs
+ *
+ * Description:
+ *   Return the distance from start to the first non-empty slot in map,
+ *   wrapping around the end of the level.  map must not be zero.
+ *
+ ****************************************************************************/
+
+static inline int wd_wheel_ffs(uint32_t map, int start)
+{
+	if (start) {
+		map = (map >> start) | (map << (WDOG_WHEEL_SLOTS - start));
+	}
+
+	return __builtin_ctz(map);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_link
+ ****************************************************************************/
+
+static inline void wd_wheel_link(FAR struct wdog_s **head, FAR struct wdog_s *wdog)
+{
+	wdog->next = *head;
+	if (wdog->next) {
+		wdog->next->pprev = &wdog->next;
+	}
+
+	wdog->pprev = head;
+	*head = wdog;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_unlink
+ ****************************************************************************/
+
+static void wd_wheel_unlink(FAR struct wdog_s *wdog)
+{
+	FAR struct wdog_s **pprev = wdog->pprev;
+	FAR struct wdog_s **first = &g_wdwheel.slot[0][0];
+	int idx;
+
+	*pprev = wdog->next;
+	if (wdog->next) {
+		wdog->next->pprev = pprev;
+	}
+
+	wdog->next = NULL;
+	wdog->pprev = NULL;
+
+	/* Clear the slot bit if this was the last watchdog of a wheel slot */
+
+	if (*pprev == NULL && pprev >= first && pprev < first + WDOG_WHEEL_LEVELS * WDOG_WHEEL_SLOTS) {
+		idx = pprev - first;
+		g_wdwheel.map[idx >> WDOG_WHEEL_BITS] &= ~(1ul << (idx & WDOG_WHEEL_MASK));
+	}
+}
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Hash a watchdog into the slot matching its expiration tick relative to
+ *   the current position of the wheel.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_insert(FAR struct wdog_s *wdog)
+{
+	uint32_t expire = (uint32_t)wdog->lag;
+	uint32_t delta = expire - g_wdwheel.base;
+	int level;
+	int index;
+
+	if (delta >= WDOG_WHEEL_RANGE) {
+		delta = WDOG_WHEEL_RANGE - 1;
+		expire = g_wdwheel.base + delta;
+	}
+
+	for (level = 0; delta >= (1ul << WDOG_WHEEL_SHIFT(level + 1)); level++) ;
+
+	index = WDOG_WHEEL_INDEX(expire, level);
+	wd_wheel_link(&g_wdwheel.slot[level][index], wdog);
+	g_wdwheel.map[level] |= 1ul << index;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Hash again the watchdogs of the current slot of a level into the lower
+ *   levels.  Returns the index of that slot.
+ *
+ ****************************************************************************/
+
+static int wd_wheel_cascade(int level)
+{
+	FAR struct wdog_s *wdog;
+	FAR struct wdog_s *next;
+	int index;
+
+	index = WDOG_WHEEL_INDEX(g_wdwheel.base, level);
+	wdog = g_wdwheel.slot[level][index];
+	g_wdwheel.slot[level][index] = NULL;
+	g_wdwheel.map[level] &= ~(1ul << index);
+
+	for (; wdog; wdog = next) {
+		next = wdog->next;
+		wd_wheel_insert(wdog);
+	}
+
+	return index;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_tick
+ *
+ * Description:
+ *   Process one tick: cascade the upper levels if level 0 wrapped and move
+ *   the watchdogs expiring on this tick to the expired list.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_tick(void)
+{
+	FAR struct wdog_s *wdog;
+	int index;
+	int level;
+
+	index = WDOG_WHEEL_INDEX(g_wdwheel.base, 0);
+	if (index == 0) {
+		for (level = 1; level < WDOG_WHEEL_LEVELS && wd_wheel_cascade(level) == 0; level++) ;
+	}
+
+	wdog = g_wdwheel.slot[0][index];
+	if (wdog) {
+		g_wdwheel.slot[0][index] = NULL;
+		g_wdwheel.map[0] &= ~(1ul << index);
+
+		g_wdwheel.expired = wdog;
+		wdog->pprev = &g_wdwheel.expired;
+	}
+
+	g_wdwheel.base++;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_distance
+ *
+ * Description:
+ *   Return the number of ticks to skip before the next tick with work to
+ *   do, or WDOG_WHEEL_NONE if the wheel is empty.  For the upper levels
+ *   this is the tick on which their first non-empty slot is cascaded,
+ *   which is as early as any watchdog in that slot can expire.
+ *
+ ****************************************************************************/
+
+static uint32_t wd_wheel_distance(void)
+{
+	uint32_t base = g_wdwheel.base;
+	uint32_t best = WDOG_WHEEL_NONE;
+	uint32_t dist;
+	int level;
+	int index;
+	int k;
+
+	for (level = 0; level < WDOG_WHEEL_LEVELS; level++) {
+		if (!g_wdwheel.map[level]) {
+			continue;
+		}
+
+		index = WDOG_WHEEL_INDEX(base, level);
+		if (level == 0) {
+			dist = wd_wheel_ffs(g_wdwheel.map[0], index);
+		} else {
+			/* The current slot is still to be cascaded if base is on its
+			 * boundary.  Otherwise it was already cascaded and only comes
+			 * back after a full turn of the level.
+			 */
+
+			k = (base & ((1ul << WDOG_WHEEL_SHIFT(level)) - 1)) ? 1 : 0;
+			k += wd_wheel_ffs(g_wdwheel.map[level], (index + k) & WDOG_WHEEL_MASK);
+			dist = (((base >> WDOG_WHEEL_SHIFT(level)) + k) << WDOG_WHEEL_SHIFT(level)) - base;
+		}
+
+		if (dist < best) {
+			best = dist;
+		}
+	}
+
+	return best;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_initialize
+ *
+ * Description:
+ *   Empty the timer wheel.
+ *
+ ****************************************************************************/
+
+void wd_wheel_initialize(void)
+{
+	memset(&g_wdwheel, 0, sizeof(struct wd_wheel_s));
+}
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Put a watchdog on the wheel so that it expires on the delay'th call to
+ *   wd_timer() (counting ticks in the tickless case).
+ *
+ * Assumptions:
+ *   Interrupts are disabled and delay is at least one.
+ *
+ ****************************************************************************/
+
+void wd_wheel_add(FAR struct wdog_s *wdog, int delay)
+{
+	wdog->lag = (int)(g_wdwheel.base + delay - 1);
+	wd_wheel_insert(wdog);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Take an active watchdog off the wheel.
+ *
+ * Return Value:
+ *   true if the time of the next timer event changed.  This is only
+ *   tracked when CONFIG_SCHED_TICKLESS is defined.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+#ifdef CONFIG_SCHED_TICKLESS
+	uint32_t next = wd_wheel_distance();
+
+	wd_wheel_unlink(wdog);
+	return wd_wheel_distance() != next;
+#else
+	wd_wheel_unlink(wdog);
+	return false;
+#endif
+}
+
+/****************************************************************************
+ * Name: wd_wheel_gettime
+ *
+ * Description:
+ *   Return the number of ticks remaining before an active watchdog
+ *   expires.
+ *
+ ****************************************************************************/
+
+int wd_wheel_gettime(FAR struct wdog_s *wdog)
+{
+	return (int)((uint32_t)wdog->lag - g_wdwheel.base) + 1;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expire
+ *
+ * Description:
+ *   Advance the wheel by up to *ticks ticks and return the next watchdog
+ *   which expired, already removed from the wheel.  *ticks is decremented
+ *   by the number of ticks processed.  The wheel stops at the tick of the
+ *   returned watchdog so that the caller can run it before anything which
+ *   expires later.
+ *
+ * Return Value:
+ *   The expired watchdog, or NULL once all the ticks have been processed.
+ *
+ * Assumptions:
+ *   Called from wd_timer() with interrupts disabled.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expire(FAR int *ticks)
+{
+	FAR struct wdog_s *wdog;
+#ifdef CONFIG_SCHED_TICKLESS
+	uint32_t skip;
+#endif
+
+	while (!g_wdwheel.expired) {
+		if (*ticks <= 0) {
+			return NULL;
+		}
+#ifdef CONFIG_SCHED_TICKLESS
+		/* Nothing happens before the next event, skip those ticks at once */
+
+		skip = wd_wheel_distance();
+		if (skip >= (uint32_t)*ticks) {
+			g_wdwheel.base += *ticks;
+			*ticks = 0;
+			return NULL;
+		}
+
+		g_wdwheel.base += skip;
+		*ticks -= skip;
+#endif
+		wd_wheel_tick();
+		(*ticks)--;
+	}
+
+	wdog = g_wdwheel.expired;
+	wd_wheel_unlink(wdog);
+	return wdog;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the number of ticks until the next timer event, zero if no
+ *   watchdog is active.  The event may be a cascade of an upper level
+ *   rather than an actual expiration.
+ *
+ ****************************************************************************/
+
+unsigned int wd_wheel_next(void)
+{
+	uint32_t dist = wd_wheel_distance();
+
+	return dist == WDOG_WHEEL_NONE ? 0 : dist + 1;
+}
+
+#endif							/* CONFIG_WDOG_TIMER_WHEEL */
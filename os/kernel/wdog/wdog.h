@@ -64,6 +64,7 @@
 
 #include <tinyara/compiler.h>
 #include <tinyara/wdog.h>
+#include <tinyara/mm/pool.h>
 
 /************************************************************************
  * Pre-processor Definitions
@@ -84,25 +85,38 @@ extern "C" {
 #define EXTERN extern
 #endif
 
+#ifdef CONFIG_MM_POOL
+/* The g_wdogpool is the pool of watchdogs available to the system for
+ * delayed function use.  Its last CONFIG_WDOG_INTRESERVE watchdogs are
+ * reserved for interrupt handlers.
+ */
+
+extern FAR struct mm_pool_s *g_wdogpool;
+#else
 /* The g_wdfreelist data structure is a singly linked list of watchdogs
  * available to the system for delayed function use.
  */
 
 extern sq_queue_t g_wdfreelist;
+#endif
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern sq_queue_t g_wdactivelist;
+#endif
 
+#ifndef CONFIG_MM_POOL
 /* This is the number of free, pre-allocated watchdog structures in the
  * g_wdfreelist.  This value is used to enforce a reserve for interrupt
  * handlers.
  */
 
 extern uint16_t g_wdnfree;
+#endif
 
 /************************************************************************
  * Public Function Prototypes
@@ -182,6 +196,20 @@ void wd_timer(void);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/****************************************************************************
+ * Timer wheel backend, see wd_wheel.c.  All of these must be called with
+ * interrupts disabled.
+ ****************************************************************************/
+
+void wd_wheel_initialize(void);
+void wd_wheel_add(FAR struct wdog_s *wdog, int delay);
+bool wd_wheel_remove(FAR struct wdog_s *wdog);
+int wd_wheel_gettime(FAR struct wdog_s *wdog);
+FAR struct wdog_s *wd_wheel_expire(FAR int *ticks);
+unsigned int wd_wheel_next(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
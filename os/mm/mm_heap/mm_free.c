@@ -78,6 +78,70 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: mm_freechunk
+ *
+ * Description:
+ *   Add a chunk, which is not marked as allocated any more, to the list of
+ *   free nodes, merging with adjacent free chunks if possible.
+ *   The caller must hold the MM semaphore.
+ *
+ ****************************************************************************/
+void mm_freechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
+{
+	FAR struct mm_freenode_s *prev;
+	FAR struct mm_freenode_s *next;
+
+	/* Check if the following node is free and, if so, merge it */
+
+	next = (FAR struct mm_freenode_s *)((char *)node + node->size);
+	if ((next->preceding & MM_ALLOC_BIT) == 0) {
+		FAR struct mm_allocnode_s *andbeyond;
+
+		/* Get the node following the next node (which will
+		 * become the new next node). We know that we can never
+		 * index past the tail chunk because it is always allocated.
+		 */
+
+		andbeyond = (FAR struct mm_allocnode_s *)((char *)next + next->size);
+
+		/* Remove the next node.  There must be a predecessor,
+		 * but there may not be a successor node.
+		 */
+
+		REMOVE_NODE_FROM_LIST(heap, next);
+
+		/* Then merge the two chunks */
+
+		node->size          += next->size;
+		andbeyond->preceding = node->size | (andbeyond->preceding & MM_ALLOC_BIT);
+		next                 = (FAR struct mm_freenode_s *)andbeyond;
+	}
+
+	/* Check if the preceding node is also free and, if so, merge
+	 * it with this node
+	 */
+
+	prev = (FAR struct mm_freenode_s *)((char *)node - node->preceding);
+	if ((prev->preceding & MM_ALLOC_BIT) == 0) {
+		/* Remove the node.  There must be a predecessor, but there may
+		 * not be a successor node.
+		 */
+
+		REMOVE_NODE_FROM_LIST(heap, prev);
+
+		/* Then merge the two chunks */
+
+		prev->size     += node->size;
+		next->preceding = prev->size | (next->preceding & MM_ALLOC_BIT);
+		node            = prev;
+	}
+
+	/* Add the merged node to the nodelist */
+
+	mm_addfreechunk(heap, node);
+}
+
 /****************************************************************************
  * Name: mm_free
  *
@@ -89,8 +153,6 @@
 void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 {
 	FAR struct mm_freenode_s *node;
-	FAR struct mm_freenode_s *prev;
-	FAR struct mm_freenode_s *next;
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 	struct mm_allocnode_s *alloc_node;
 #endif
@@ -113,15 +175,25 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 		return;
 	}
 
+	/* Map the memory chunk into a free node */
+
+	node = (FAR struct mm_freenode_s *)((char *)mem - SIZEOF_MM_ALLOCNODE);
+
+#ifdef CONFIG_MM_TCACHE
+	/* A small chunk may be kept in the cache for the next allocation of the
+	 * same size.  It's merged when the cache is flushed.
+	 */
+
+	if (mm_tcache_free(heap, (FAR struct mm_allocnode_s *)node)) {
+		return;
+	}
+#endif
+
 	/* We need to hold the MM semaphore while we muck with the
 	 * nodelist.
 	 */
 
 	mm_takesemaphore(heap);
-
-	/* Map the memory chunk into a free node */
-
-	node = (FAR struct mm_freenode_s *)((char *)mem - SIZEOF_MM_ALLOCNODE);
 #ifdef CONFIG_DEBUG_DOUBLE_FREE
 	/* Assert on following logical error scenarios
 	 * 1) Attempt to free an unallocated memory or
@@ -147,54 +219,6 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 	}
 #endif
 	node->preceding &= ~MM_ALLOC_BIT;
-
-	/* Check if the following node is free and, if so, merge it */
-
-	next = (FAR struct mm_freenode_s *)((char *)node + node->size);
-	if ((next->preceding & MM_ALLOC_BIT) == 0) {
-		FAR struct mm_allocnode_s *andbeyond;
-
-		/* Get the node following the next node (which will
-		 * become the new next node). We know that we can never
-		 * index past the tail chunk because it is always allocated.
-		 */
-
-		andbeyond = (FAR struct mm_allocnode_s *)((char *)next + next->size);
-
-		/* Remove the next node.  There must be a predecessor,
-		 * but there may not be a successor node.
-		 */
-
-		REMOVE_NODE_FROM_LIST(next);
-
-		/* Then merge the two chunks */
-
-		node->size          += next->size;
-		andbeyond->preceding = node->size | (andbeyond->preceding & MM_ALLOC_BIT);
-		next                 = (FAR struct mm_freenode_s *)andbeyond;
-	}
-
-	/* Check if the preceding node is also free and, if so, merge
-	 * it with this node
-	 */
-
-	prev = (FAR struct mm_freenode_s *)((char *)node - node->preceding);
-	if ((prev->preceding & MM_ALLOC_BIT) == 0) {
-		/* Remove the node.  There must be a predecessor, but there may
-		 * not be a successor node.
-		 */
-
-		REMOVE_NODE_FROM_LIST(prev);
-
-		/* Then merge the two chunks */
-
-		prev->size     += node->size;
-		next->preceding = prev->size | (next->preceding & MM_ALLOC_BIT);
-		node            = prev;
-	}
-
-	/* Add the merged node to the nodelist */
-
-	mm_addfreechunk(heap, node);
+	mm_freechunk(heap, node);
 	mm_givesemaphore(heap);
 }
@@ -103,6 +103,11 @@ void heapinfo_parse(FAR struct mm_heap_s *heap, int mode, pid_t pid)
 	int nonsched_idx;
 	struct sched_param sched_data;
 	size_t heap_size;
+#ifdef CONFIG_MM_TCACHE
+	size_t cache_hits;
+	size_t cache_misses;
+	size_t cache_retained;
+#endif
 
 	/* This nonsched can be 3 types : group resources, freed when child task finished, leak */
 	pid_t nonsched_list[CONFIG_MAX_TASKS];
@@ -116,8 +121,14 @@ void heapinfo_parse(FAR struct mm_heap_s *heap, int mode, pid_t pid)
 
 #ifdef CONFIG_DEBUG_CHECK_FRAGMENTATION
 	int ndx;
+#ifdef CONFIG_MM_TLSF
+	int sl;
+	int nodelist_cnt[MM_TLSF_FL_COUNT] = {0, };
+	size_t nodelist_size[MM_TLSF_FL_COUNT] = {0, };
+#else
 	int nodelist_cnt[MM_NNODES] = {0, };
 	size_t nodelist_size[MM_NNODES] = {0, };
+#endif
 	FAR struct mm_freenode_s *fnode;
 #endif
 
@@ -157,6 +168,15 @@ void heapinfo_parse(FAR struct mm_heap_s *heap, int mode, pid_t pid)
 
 			/* Check if the node corresponds to an allocated memory chunk */
 			if ((pid == HEAPINFO_PID_ALL || node->pid == pid) && (node->preceding & MM_ALLOC_BIT) != 0) {
+#ifdef CONFIG_MM_TCACHE
+				if (node->pid == HEAPINFO_TCACHE) {
+					/* Chunk kept in small allocation cache, it's not owned by anyone */
+					if (mode == HEAPINFO_DETAIL_ALL || mode == HEAPINFO_DETAIL_FREE || mode == HEAPINFO_DETAIL_SPECIFIC_HEAP) {
+						printf("0x%x | %8u |   %c    |            |       |\n", node, node->size, 'C');
+					}
+					continue;
+				}
+#endif
 				if (mode == HEAPINFO_DETAIL_ALL || mode == HEAPINFO_DETAIL_PID || mode == HEAPINFO_DETAIL_SPECIFIC_HEAP) {
 					if (node->pid >= 0) {
 						printf("0x%x | %8u |   %c    | 0x%8x | %3d   |\n", node, node->size, 'A', node->alloc_call_addr, node->pid);
@@ -247,23 +267,50 @@ void heapinfo_parse(FAR struct mm_heap_s *heap, int mode, pid_t pid)
 	printf("(**) Only Idle task has a separate stack region,\n");
 	printf("  rest are all allocated on the heap region.\n");
 
+#ifdef CONFIG_MM_TCACHE
+	mm_tcache_getstat(heap, &cache_hits, &cache_misses, &cache_retained);
+	printf("\n< Small Allocation Cache >\n");
+	printf("  - Hits / Misses                     : %u / %u\n", cache_hits, cache_misses);
+	printf("  - Hit Rate                          : %u%%\n", (cache_hits + cache_misses) ? (size_t)((uint64_t)cache_hits * 100 / (cache_hits + cache_misses)) : 0);
+	printf("  - Retained Size (C)                 : %u\n", cache_retained);
+#endif
+
 #ifdef CONFIG_DEBUG_CHECK_FRAGMENTATION
 	printf("\nAvailable fragmented memory segments in heap memory\n");
 
 	mm_takesemaphore(heap);
 
+#ifdef CONFIG_MM_TLSF
+	for (ndx = 0; ndx < MM_TLSF_FL_COUNT; ++ndx) {
+		for (sl = 0; sl < MM_TLSF_SL_COUNT; ++sl) {
+			for (fnode = heap->mm_freelist[ndx][sl]; fnode; fnode = fnode->flink) {
+				++nodelist_cnt[ndx];
+				nodelist_size[ndx] += fnode->size;
+			}
+		}
+	}
+#else
 	for (ndx = 0; ndx < MM_NNODES; ++ndx) {
 		for (fnode = heap->mm_nodelist[ndx].flink; fnode && fnode->size; fnode = fnode->flink) {
 			++nodelist_cnt[ndx];
 			nodelist_size[ndx] += fnode->size;
 		}
 	}
+#endif
 
 	mm_givesemaphore(heap);
 
+#ifdef CONFIG_MM_TLSF
+	printf("Freelist[0] ranging [%u, %u] : num %d, size %u [Bytes]\n", MM_MIN_CHUNK, MM_TLSF_SMALL_CHUNK - 1, nodelist_cnt[0], nodelist_size[0]);
+	for (ndx = 1; ndx < MM_TLSF_FL_COUNT - 1; ++ndx) {
+		printf("Freelist[%d] ranging [%u, %u] : num %d, size %u [Bytes]\n", ndx, 1 << (ndx + MM_TLSF_FL_SHIFT - 1), (1 << (ndx + MM_TLSF_FL_SHIFT)) - 1, nodelist_cnt[ndx], nodelist_size[ndx]);
+	}
+	printf("Freelist[%d] ranging [%u, ...] : num %d, size %u [Bytes]\n", ndx, MM_MAX_CHUNK, nodelist_cnt[ndx], nodelist_size[ndx]);
+#else
 	for (ndx = 0; ndx < MM_NNODES; ++ndx) {
 		printf("Nodelist[%d] ranging [%u, %u] : num %d, size %u [Bytes]\n", ndx, ((ndx > 0 ? (1 << (ndx + MM_MIN_SHIFT)) : 0) + 1), 1 << (ndx + MM_MIN_SHIFT + 1), nodelist_cnt[ndx], nodelist_size[ndx]);
 	}
+#endif
 #endif
 
 	if (mode != HEAPINFO_SIMPLE) {
@@ -218,9 +218,23 @@ void mm_initialize(FAR struct mm_heap_s *heap, FAR void *heapstart, size_t heaps
 	heap->mm_nregions = 0;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+	/* All free lists are empty */
+
+	heap->mm_fl_bitmap = 0;
+	memset(heap->mm_sl_bitmap, 0, sizeof(heap->mm_sl_bitmap));
+	memset(heap->mm_freelist, 0, sizeof(heap->mm_freelist));
+#else
 	/* Initialize the node array */
 
 	memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * (MM_NNODES + 1));
+#endif
+
+#ifdef CONFIG_MM_TCACHE
+	/* The small allocation cache is empty */
+
+	memset(&heap->mm_tcache, 0, sizeof(struct mm_tcache_s));
+#endif
 
 	/* Initialize the malloc semaphore to one (to support one-at-
 	 * a-time access to private data sets).
@@ -111,7 +111,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 {
 	FAR struct mm_freenode_s *node;
 	void *ret = NULL;
+#ifndef CONFIG_MM_TLSF
 	int ndx;
+#endif
 
 	/* Handle bad sizes */
 
@@ -132,10 +134,33 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
 	size = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
 
+#ifdef CONFIG_MM_TCACHE
+	/* Try the small allocation cache first, it doesn't need the semaphore. */
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	ret = mm_tcache_alloc(heap, size, caller_retaddr);
+#else
+	ret = mm_tcache_alloc(heap, size);
+#endif
+	if (ret) {
+		return ret;
+	}
+
+retry:
+#endif
+
 	/* We need to hold the MM semaphore while we muck with the nodelist. */
 
 	mm_takesemaphore(heap);
 
+#ifdef CONFIG_MM_TLSF
+	/* Take the first chunk of the smallest non-empty size class which is
+	 * large enough.  It is found with two bitmap scans, whatever the
+	 * number of free chunks.
+	 */
+
+	node = mm_findfreechunk(heap, size);
+#else
 	/* Get the location in the node list to start the search
 	 * by converting the request size into a nodelist index.
 	 */
@@ -160,12 +185,17 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 		node = prev;
 	}
 
-	/* If we found a node with non-zero size, then this is one to use. Since
-	 * the list is ordered, we know that is must be best fitting chunk
+	/* If we found a node with non-zero size, then it is the one to use.
+	 * Since the list is ordered, we know that is must be best fitting chunk
 	 * available.
 	 */
 
-	if (node->size) {
+	if (!node->size) {
+		node = NULL;
+	}
+#endif
+
+	if (node) {
 		FAR struct mm_freenode_s *remainder;
 		FAR struct mm_freenode_s *next;
 		size_t remaining;
@@ -174,7 +204,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 		 * a successor node.
 		 */
 
-		REMOVE_NODE_FROM_LIST(node);
+		REMOVE_NODE_FROM_LIST(heap, node);
 
 		/* Check if we have to split the free node into one of the allocated
 		 * size and another smaller freenode.  In some cases, the remaining
@@ -224,6 +254,14 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
 	mm_givesemaphore(heap);
 
+#ifdef CONFIG_MM_TCACHE
+	/* Cached chunks may be merged into a large enough free chunk */
+
+	if (!ret && mm_tcache_flush(heap) > 0) {
+		goto retry;
+	}
+#endif
+
 	/* If CONFIG_DEBUG_MM is defined, then output the result of the allocation
 	 * to the SYSLOG.
 	 */
@@ -0,0 +1,467 @@
+/****************************************************************************
+ *
+ * Copyright 2026 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/sched.h>
+#include <tinyara/mm/mm.h>
+
+#include "mm_node.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Heap information of a chunk is updated when it goes into or out of the
+ * cache, and it is protected by the MM semaphore.  So the semaphore is held
+ * while using the cache in that debug configuration.
+ */
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+#define mm_tcache_lock(heap)   mm_takesemaphore(heap)
+#define mm_tcache_unlock(heap) mm_givesemaphore(heap)
+#else
+#define mm_tcache_lock(heap)
+#define mm_tcache_unlock(heap)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct mm_tcache_stat_s {
+	FAR struct mm_heap_s *heap;
+	size_t hits;
+	size_t retained;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tcache_push
+ *
+ * Description:
+ *   Put a chunk into the bin of the cache.  The caller is responsible for
+ *   the exclusive access to the cache.
+ *
+ ****************************************************************************/
+static inline void mm_tcache_push(FAR struct mm_tcache_s *cache, int ndx, FAR struct mm_freenode_s *node)
+{
+#ifdef CONFIG_DEBUG_DOUBLE_FREE
+	FAR struct mm_freenode_s *cached;
+
+	for (cached = cache->bin[ndx]; cached; cached = cached->flink) {
+		if (cached == node) {
+			dbg("Attempt for double freeing a pointer\n");
+			PANIC();
+		}
+	}
+#endif
+	node->flink = cache->bin[ndx];
+	cache->bin[ndx] = node;
+	cache->count[ndx]++;
+	cache->retained += node->size;
+}
+
+/****************************************************************************
+ * Name: mm_tcache_pop
+ *
+ * Description:
+ *   Take a chunk from the bin of the cache.  The caller is responsible for
+ *   the exclusive access to the cache.
+ *
+ ****************************************************************************/
+static inline FAR struct mm_freenode_s *mm_tcache_pop(FAR struct mm_tcache_s *cache, int ndx)
+{
+	FAR struct mm_freenode_s *node = cache->bin[ndx];
+
+	if (node) {
+		cache->bin[ndx] = node->flink;
+		cache->count[ndx]--;
+		cache->retained -= node->size;
+	}
+
+	return node;
+}
+
+#ifdef CONFIG_MM_TCACHE_PERTHREAD
+/****************************************************************************
+ * Name: mm_tcache_self
+ *
+ * Description:
+ *   Get the cache of the running thread if it caches chunks of the heap.
+ *   A thread caches chunks of only one heap, it's the heap of the first
+ *   chunk freed by the thread if 'claim' is true.
+ *
+ ****************************************************************************/
+static inline FAR struct mm_tcache_s *mm_tcache_self(FAR struct mm_heap_s *heap, bool claim)
+{
+	FAR struct tcb_s *tcb = sched_self();
+
+	if (!tcb) {
+		/* The heap is used before the scheduler gets started */
+
+		return NULL;
+	}
+
+	if (claim && !tcb->tcache.heap) {
+		tcb->tcache.heap = heap;
+	}
+
+	return tcb->tcache.heap == heap ? &tcb->tcache : NULL;
+}
+
+/****************************************************************************
+ * Name: mm_tcache_thread_stat
+ *
+ * Description:
+ *   sched_foreach() callback to sum up statistics of per-thread caches.
+ *
+ ****************************************************************************/
+static void mm_tcache_thread_stat(FAR struct tcb_s *tcb, FAR void *arg)
+{
+	FAR struct mm_tcache_stat_s *stat = (FAR struct mm_tcache_stat_s *)arg;
+
+	if (tcb->tcache.heap == stat->heap) {
+		stat->hits += tcb->tcache.hits;
+		stat->retained += tcb->tcache.retained;
+	}
+}
+
+/****************************************************************************
+ * Name: mm_tcache_reclaim
+ *
+ * Description:
+ *   Move all chunks in the cache of a thread to the cache of the heap.
+ *   Interrupts must be disabled.
+ *
+ ****************************************************************************/
+static void mm_tcache_reclaim(FAR struct mm_tcache_s *self, FAR struct mm_heap_s *heap)
+{
+	FAR struct mm_freenode_s *node;
+	int ndx;
+
+	for (ndx = 0; ndx < MM_TCACHE_NBINS; ndx++) {
+		while ((node = mm_tcache_pop(self, ndx)) != NULL) {
+			mm_tcache_push(&heap->mm_tcache, ndx, node);
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: mm_tcache_thread_reclaim
+ *
+ * Description:
+ *   sched_foreach() callback to move chunks in per-thread caches of the
+ *   heap to the cache of the heap.
+ *
+ ****************************************************************************/
+static void mm_tcache_thread_reclaim(FAR struct tcb_s *tcb, FAR void *arg)
+{
+	FAR struct mm_heap_s *heap = (FAR struct mm_heap_s *)arg;
+
+	if (tcb->tcache.heap == heap) {
+		mm_tcache_reclaim(&tcb->tcache, heap);
+	}
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_tcache_drain
+ *
+ * Description:
+ *   Give all chunks in the cache back to the list of free nodes.
+ *   The caller must hold the MM semaphore.
+ *
+ ****************************************************************************/
+static size_t mm_tcache_drain(FAR struct mm_heap_s *heap, FAR struct mm_tcache_s *cache)
+{
+	FAR struct mm_freenode_s *node;
+	irqstate_t flags;
+	size_t drained = 0;
+	int ndx;
+
+	for (ndx = 0; ndx < MM_TCACHE_NBINS; ndx++) {
+		while (1) {
+			flags = irqsave();
+			node = mm_tcache_pop(cache, ndx);
+			irqrestore(flags);
+			if (!node) {
+				break;
+			}
+
+			drained += node->size;
+			node->preceding &= ~MM_ALLOC_BIT;
+			mm_freechunk(heap, node);
+		}
+	}
+
+	return drained;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tcache_alloc
+ *
+ * Description:
+ *   Take a cached chunk of exactly the given chunk size, without taking the
+ *   MM semaphore or searching the nodelist.  The per-thread cache is tried
+ *   first.  Both caches are protected by disabling interrupts shortly, as
+ *   the cache of a thread is also emptied by mm_tcache_flush() in others.
+ *
+ * Input Parameters:
+ *   heap - The heap to allocate from
+ *   size - The chunk size, including the allocation node and the alignment
+ *
+ * Returned Value:
+ *   The allocated memory, or NULL if there's no cached chunk of the size.
+ *
+ ****************************************************************************/
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+FAR void *mm_tcache_alloc(FAR struct mm_heap_s *heap, size_t size, mmaddress_t caller_retaddr)
+#else
+FAR void *mm_tcache_alloc(FAR struct mm_heap_s *heap, size_t size)
+#endif
+{
+	FAR struct mm_freenode_s *node = NULL;
+#ifdef CONFIG_MM_TCACHE_PERTHREAD
+	FAR struct mm_tcache_s *self;
+#endif
+	irqstate_t flags;
+	int ndx;
+
+	if (size > MM_TCACHE_MAXCHUNK) {
+		return NULL;
+	}
+
+	ndx = MM_TCACHE_NDX(size);
+
+	mm_tcache_lock(heap);
+
+#ifdef CONFIG_MM_TCACHE_PERTHREAD
+	self = mm_tcache_self(heap, false);
+	if (self) {
+		flags = irqsave();
+		node = mm_tcache_pop(self, ndx);
+		if (node) {
+			self->hits++;
+		}
+		irqrestore(flags);
+	}
+
+	if (!node)
+#endif
+	{
+		flags = irqsave();
+		node = mm_tcache_pop(&heap->mm_tcache, ndx);
+		if (node) {
+			heap->mm_tcache.hits++;
+		} else {
+			heap->mm_tcache.misses++;
+		}
+		irqrestore(flags);
+	}
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	if (node) {
+		heapinfo_update_node((FAR struct mm_allocnode_s *)node, caller_retaddr);
+		heapinfo_add_size(heap, ((FAR struct mm_allocnode_s *)node)->pid, node->size);
+		heapinfo_update_total_size(heap, node->size, ((FAR struct mm_allocnode_s *)node)->pid);
+	}
+#endif
+
+	mm_tcache_unlock(heap);
+
+	if (!node) {
+		return NULL;
+	}
+
+	mvdbg("Allocated %p from cache, size %u\n", (char *)node + SIZEOF_MM_ALLOCNODE, size);
+	return (FAR void *)((char *)node + SIZEOF_MM_ALLOCNODE);
+}
+
+/****************************************************************************
+ * Name: mm_tcache_free
+ *
+ * Description:
+ *   Keep a small chunk in the cache instead of returning it to the list of
+ *   free nodes.  The chunk is still marked as allocated in the heap.
+ *
+ * Returned Value:
+ *   true if the chunk is kept in the cache, false if the caller should free
+ *   the chunk to the heap (the chunk is large, or the bin is full).
+ *
+ ****************************************************************************/
+bool mm_tcache_free(FAR struct mm_heap_s *heap, FAR struct mm_allocnode_s *node)
+{
+	FAR struct mm_tcache_s *cache = &heap->mm_tcache;
+#ifdef CONFIG_MM_TCACHE_PERTHREAD
+	FAR struct mm_tcache_s *self;
+#endif
+	irqstate_t flags;
+	bool cached = false;
+	int ndx;
+
+	if (node->size > MM_TCACHE_MAXCHUNK) {
+		return false;
+	}
+
+#ifdef CONFIG_DEBUG_DOUBLE_FREE
+	if ((node->preceding & MM_ALLOC_BIT) != MM_ALLOC_BIT) {
+		/* Let mm_free() report it */
+
+		return false;
+	}
+#endif
+
+	ndx = MM_TCACHE_NDX(node->size);
+
+	mm_tcache_lock(heap);
+
+#ifdef CONFIG_MM_TCACHE_PERTHREAD
+	self = mm_tcache_self(heap, true);
+	flags = irqsave();
+	if (self && self->count[ndx] < CONFIG_MM_TCACHE_NCHUNKS) {
+		mm_tcache_push(self, ndx, (FAR struct mm_freenode_s *)node);
+		cached = true;
+	}
+	irqrestore(flags);
+
+	if (!cached)
+#endif
+	{
+		flags = irqsave();
+		if (cache->count[ndx] < CONFIG_MM_TCACHE_NCHUNKS) {
+			mm_tcache_push(cache, ndx, (FAR struct mm_freenode_s *)node);
+			cached = true;
+		}
+		irqrestore(flags);
+	}
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	if (cached) {
+		heapinfo_subtract_size(heap, node->pid, node->size);
+		heapinfo_update_total_size(heap, ((-1) * node->size), node->pid);
+		node->pid = HEAPINFO_TCACHE;
+	}
+#endif
+
+	mm_tcache_unlock(heap);
+
+	return cached;
+}
+
+/****************************************************************************
+ * Name: mm_tcache_flush
+ *
+ * Description:
+ *   Give chunks in the cache of the heap and the caches of all threads
+ *   back to the list of free nodes, so that they can be merged with
+ *   adjacent free chunks.  It's called when an allocation fails.
+ *
+ * Returned Value:
+ *   Number of bytes given back to the heap.
+ *
+ ****************************************************************************/
+size_t mm_tcache_flush(FAR struct mm_heap_s *heap)
+{
+	size_t flushed;
+
+	mm_takesemaphore(heap);
+
+#ifdef CONFIG_MM_TCACHE_PERTHREAD
+	/* Chunks of other threads are gathered in the cache of the heap first,
+	 * with interrupts disabled, and they are freed with interrupts enabled.
+	 */
+
+	sched_foreach(mm_tcache_thread_reclaim, heap);
+#endif
+
+	flushed = mm_tcache_drain(heap, &heap->mm_tcache);
+
+	mm_givesemaphore(heap);
+
+	mvdbg("Flushed %u bytes from cache\n", flushed);
+	return flushed;
+}
+
+#ifdef CONFIG_MM_TCACHE_PERTHREAD
+/****************************************************************************
+ * Name: mm_tcache_release
+ *
+ * Description:
+ *   Move chunks in the cache of an exiting thread to the cache of the heap.
+ *   It doesn't take the MM semaphore, so it's safe in sched_releasetcb().
+ *   The bins of the heap may go over CONFIG_MM_TCACHE_NCHUNKS for a while.
+ *
+ ****************************************************************************/
+void mm_tcache_release(FAR struct tcb_s *tcb)
+{
+	FAR struct mm_tcache_s *self = &tcb->tcache;
+	FAR struct mm_heap_s *heap = self->heap;
+	irqstate_t flags;
+
+	if (!heap) {
+		return;
+	}
+
+	flags = irqsave();
+	mm_tcache_reclaim(self, heap);
+	heap->mm_tcache.hits += self->hits;
+	irqrestore(flags);
+
+	self->heap = NULL;
+	self->hits = 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_tcache_getstat
+ *
+ * Description:
+ *   Get statistics of the cache of the heap, including per-thread caches.
+ *
+ ****************************************************************************/
+void mm_tcache_getstat(FAR struct mm_heap_s *heap, FAR size_t *hits, FAR size_t *misses, FAR size_t *retained)
+{
+	struct mm_tcache_stat_s stat;
+
+	stat.heap = heap;
+	stat.hits = heap->mm_tcache.hits;
+	stat.retained = heap->mm_tcache.retained;
+
+#ifdef CONFIG_MM_TCACHE_PERTHREAD
+	sched_foreach(mm_tcache_thread_stat, &stat);
+#endif
+
+	*hits = stat.hits;
+	*misses = heap->mm_tcache.misses;
+	*retained = stat.retained;
+}
@@ -0,0 +1,236 @@
+/****************************************************************************
+ *
+ * Copyright 2026 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <tinyara/mm/mm.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MM_TLSF_LAST_FL (MM_TLSF_FL_COUNT - 1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tlsf_fls
+ *
+ * Description:
+ *   Return the index of the most significant bit set in a non-zero value.
+ *
+ ****************************************************************************/
+static inline int mm_tlsf_fls(uint32_t value)
+{
+	return 31 - __builtin_clz(value);
+}
+
+/****************************************************************************
+ * Name: mm_tlsf_ffs
+ *
+ * Description:
+ *   Return the index of the least significant bit set in a non-zero value.
+ *
+ ****************************************************************************/
+static inline int mm_tlsf_ffs(uint32_t value)
+{
+	return __builtin_ctz(value);
+}
+
+/****************************************************************************
+ * Name: mm_tlsf_mapping
+ *
+ * Description:
+ *   Convert a chunk size into the first and second level indexes of the
+ *   free list which holds the chunks of that size.
+ *
+ ****************************************************************************/
+static inline void mm_tlsf_mapping(size_t size, FAR int *fl, FAR int *sl)
+{
+	int msb;
+
+	if (size < MM_TLSF_SMALL_CHUNK) {
+		*fl = 0;
+		*sl = size >> MM_MIN_SHIFT;
+	} else if (size >= MM_MAX_CHUNK) {
+		*fl = MM_TLSF_LAST_FL;
+		*sl = 0;
+	} else {
+		msb = mm_tlsf_fls((uint32_t)size);
+		*fl = msb - MM_TLSF_FL_SHIFT + 1;
+		*sl = (size >> (msb - MM_TLSF_SL_SHIFT)) & (MM_TLSF_SL_COUNT - 1);
+	}
+}
+
+/****************************************************************************
+ * Name: mm_tlsf_firstfit
+ *
+ * Description:
+ *   Walk a free list for the first chunk of 'size' bytes or more.  This is
+ *   only needed for the last list, which has no upper bound.  All of its
+ *   chunks are MM_MAX_CHUNK or more, so it holds only a few of them.
+ *
+ ****************************************************************************/
+static FAR struct mm_freenode_s *mm_tlsf_firstfit(FAR struct mm_freenode_s *node, size_t size)
+{
+	while (node && node->size < size) {
+		node = node->flink;
+	}
+
+	return node;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_addfreechunk
+ *
+ * Description:
+ *   Add a free chunk to the head of the free list of its size class.
+ *
+ ****************************************************************************/
+void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
+{
+	FAR struct mm_freenode_s *next;
+	int fl;
+	int sl;
+
+	mm_tlsf_mapping(node->size, &fl, &sl);
+
+	next = heap->mm_freelist[fl][sl];
+	node->blink = NULL;
+	node->flink = next;
+	if (next) {
+		next->blink = node;
+	}
+
+	heap->mm_freelist[fl][sl] = node;
+	heap->mm_sl_bitmap[fl] |= (1 << sl);
+	heap->mm_fl_bitmap |= (1 << fl);
+}
+
+/****************************************************************************
+ * Name: mm_removefreechunk
+ *
+ * Description:
+ *   Remove a free chunk from its free list.  The size of the chunk must be
+ *   the one it was added with.
+ *
+ ****************************************************************************/
+void mm_removefreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
+{
+	int fl;
+	int sl;
+
+	mm_tlsf_mapping(node->size, &fl, &sl);
+
+	if (node->flink) {
+		node->flink->blink = node->blink;
+	}
+
+	if (node->blink) {
+		node->blink->flink = node->flink;
+		return;
+	}
+
+	/* The node was the head of the list */
+
+	DEBUGASSERT(heap->mm_freelist[fl][sl] == node);
+
+	heap->mm_freelist[fl][sl] = node->flink;
+	if (!node->flink) {
+		heap->mm_sl_bitmap[fl] &= ~(1 << sl);
+		if (!heap->mm_sl_bitmap[fl]) {
+			heap->mm_fl_bitmap &= ~(1 << fl);
+		}
+	}
+}
+
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *   Find a free chunk of 'size' bytes or more without removing it.
+ *
+ *   The size is rounded up to the next size class, so that every chunk in
+ *   the lists found by the bitmap scans is large enough and the head of the
+ *   first non-empty one can be taken.  When there is none, only the head
+ *   of the list of the class of the size itself is tried, which finds the
+ *   single chunk left by a fully coalesced heap.  That list is never
+ *   walked, so the time taken doesn't depend on the number of chunks.
+ *
+ ****************************************************************************/
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap, size_t size)
+{
+	FAR struct mm_freenode_s *node;
+	uint32_t bitmap;
+	size_t round;
+	int fl;
+	int sl;
+
+	if (size < MM_TLSF_SMALL_CHUNK || size >= MM_MAX_CHUNK) {
+		/* The classes of small chunks have the width of the granule, and
+		 * the last class has no upper bound.  There is nothing to round.
+		 */
+
+		round = size;
+	} else {
+		round = size + (1 << (mm_tlsf_fls((uint32_t)size) - MM_TLSF_SL_SHIFT)) - 1;
+	}
+
+	mm_tlsf_mapping(round, &fl, &sl);
+
+	bitmap = heap->mm_sl_bitmap[fl] & (~0U << sl);
+	if (!bitmap) {
+		bitmap = heap->mm_fl_bitmap & (~0U << (fl + 1));
+		if (!bitmap) {
+			goto tryhead;
+		}
+
+		fl = mm_tlsf_ffs(bitmap);
+		bitmap = heap->mm_sl_bitmap[fl];
+	}
+
+	sl = mm_tlsf_ffs(bitmap);
+	node = heap->mm_freelist[fl][sl];
+
+	if (fl == MM_TLSF_LAST_FL && size >= MM_MAX_CHUNK) {
+		node = mm_tlsf_firstfit(node, size);
+	}
+
+	return node;
+
+tryhead:
+	if (round == size) {
+		return NULL;
+	}
+
+	mm_tlsf_mapping(size, &fl, &sl);
+	node = heap->mm_freelist[fl][sl];
+	return node && node->size >= size ? node : NULL;
+}
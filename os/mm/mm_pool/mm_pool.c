@@ -0,0 +1,344 @@
+/****************************************************************************
+ *
+ * Copyright 2026 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+#include <sched.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/irq.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/mm/gran.h>
+#include <tinyara/mm/pool.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A slab is one granule allocation, which is 32 granules at most */
+
+#define MM_POOL_GRANSIZE    (1 << CONFIG_MM_POOL_LOG2GRAN)
+#define MM_POOL_MAXSLAB     (32 * MM_POOL_GRANSIZE)
+
+#define MM_POOL_ALIGN(s, a) (((s) + (a) - 1) & ~((a) - 1))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The granule heap which holds the storage of all pools */
+
+static GRAN_HANDLE g_poolgran;
+static FAR uint8_t *g_poolheap;
+
+/* The list of all pools, protected by the scheduler lock */
+
+static FAR struct mm_pool_s *g_pools;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_pool_isslab
+ *
+ * Description:
+ *   Return true if the object lies in the granule heap, that is it was taken
+ *   from the slabs of a pool and not from the kernel heap.
+ *
+ ****************************************************************************/
+static inline bool mm_pool_isslab(FAR void *obj)
+{
+	return (FAR uint8_t *)obj >= g_poolheap && (FAR uint8_t *)obj < g_poolheap + CONFIG_MM_POOL_HEAPSIZE;
+}
+
+/****************************************************************************
+ * Name: mm_pool_heaphdrsize
+ *
+ * Description:
+ *   Return the size of the header in front of an object taken from the
+ *   kernel heap, which keeps the object aligned.
+ *
+ ****************************************************************************/
+static inline size_t mm_pool_heaphdrsize(FAR struct mm_pool_s *pool)
+{
+	return MM_POOL_ALIGN(sizeof(struct mm_pool_heapobj_s), pool->align);
+}
+
+/****************************************************************************
+ * Name: mm_pool_addslab
+ *
+ * Description:
+ *   Take a slab of up to 'nobjs' objects from the granule heap and put its
+ *   objects into the free list of the pool.  Return the number of objects
+ *   added.
+ *
+ ****************************************************************************/
+static uint16_t mm_pool_addslab(FAR struct mm_pool_s *pool, uint16_t nobjs)
+{
+	FAR struct mm_pool_slab_s *slab;
+	FAR uint8_t *obj;
+	size_t hdrsize;
+	size_t maxobjs;
+	size_t size;
+	uint16_t i;
+
+	hdrsize = MM_POOL_ALIGN(sizeof(struct mm_pool_slab_s), pool->align);
+	if (hdrsize + pool->objsize > MM_POOL_MAXSLAB) {
+		return 0;
+	}
+
+	maxobjs = (MM_POOL_MAXSLAB - hdrsize) / pool->objsize;
+	if (nobjs > maxobjs) {
+		nobjs = maxobjs;
+	}
+
+	size = hdrsize + nobjs * pool->objsize;
+	slab = (FAR struct mm_pool_slab_s *)gran_alloc(g_poolgran, size);
+	if (!slab) {
+		return 0;
+	}
+
+	slab->size = size;
+	slab->flink = pool->slabs;
+	pool->slabs = slab;
+
+	obj = (FAR uint8_t *)slab + hdrsize;
+	for (i = 0; i < nobjs; i++, obj += pool->objsize) {
+		*(FAR void **)obj = pool->freelist;
+		pool->freelist = obj;
+	}
+
+	return nobjs;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_pool_initialize
+ ****************************************************************************/
+void mm_pool_initialize(void)
+{
+	g_poolheap = (FAR uint8_t *)kmm_malloc(CONFIG_MM_POOL_HEAPSIZE);
+	if (!g_poolheap) {
+		mdbg("Failed to allocate %d bytes for the pools\n", CONFIG_MM_POOL_HEAPSIZE);
+		return;
+	}
+
+	/* Slabs are aligned to the granule size, so that objects can be too */
+
+	g_poolgran = gran_initialize(g_poolheap, CONFIG_MM_POOL_HEAPSIZE, CONFIG_MM_POOL_LOG2GRAN, CONFIG_MM_POOL_LOG2GRAN);
+	if (!g_poolgran) {
+		mdbg("Failed to initialize the pool granule heap\n");
+		kmm_free(g_poolheap);
+		g_poolheap = NULL;
+	}
+}
+
+/****************************************************************************
+ * Name: mm_pool_create
+ ****************************************************************************/
+FAR struct mm_pool_s *mm_pool_create(FAR const char *name, size_t objsize, size_t align, uint16_t nobjs, uint16_t reserve, uint8_t flags)
+{
+	FAR struct mm_pool_s *pool;
+	uint16_t added;
+
+	if (align < sizeof(FAR void *)) {
+		align = sizeof(FAR void *);
+	}
+
+	DEBUGASSERT((align & (align - 1)) == 0 && align <= MM_POOL_GRANSIZE);
+
+	pool = (FAR struct mm_pool_s *)kmm_zalloc(sizeof(struct mm_pool_s));
+	if (!pool) {
+		return NULL;
+	}
+
+	pool->name = name;
+	pool->objsize = MM_POOL_ALIGN(objsize, align);
+	pool->align = align;
+	pool->reserve = reserve;
+	pool->flags = flags;
+
+	while (g_poolgran && pool->nobjs < nobjs) {
+		added = mm_pool_addslab(pool, nobjs - pool->nobjs);
+		if (!added) {
+			break;
+		}
+
+		pool->nobjs += added;
+	}
+
+	if (pool->nobjs < nobjs) {
+		mdbg("Pool %s has %u of %u objects\n", name, pool->nobjs, nobjs);
+		if (pool->nobjs == 0 && !(flags & MM_POOL_HEAP)) {
+			kmm_free(pool);
+			return NULL;
+		}
+	}
+
+	pool->nfree = pool->nobjs;
+	pool->minfree = pool->nobjs;
+
+	sched_lock();
+	pool->flink = g_pools;
+	g_pools = pool;
+	sched_unlock();
+
+	return pool;
+}
+
+/****************************************************************************
+ * Name: mm_pool_destroy
+ ****************************************************************************/
+void mm_pool_destroy(FAR struct mm_pool_s *pool)
+{
+	FAR struct mm_pool_s **prev;
+	FAR struct mm_pool_slab_s *slab;
+
+	DEBUGASSERT(pool->nfree == pool->nobjs && pool->nheap == 0);
+
+	sched_lock();
+	for (prev = &g_pools; *prev && *prev != pool; prev = &(*prev)->flink) ;
+	if (*prev) {
+		*prev = pool->flink;
+	}
+	sched_unlock();
+
+	while ((slab = pool->slabs) != NULL) {
+		pool->slabs = slab->flink;
+		gran_free(g_poolgran, slab, slab->size);
+	}
+
+	kmm_free(pool);
+}
+
+/****************************************************************************
+ * Name: mm_pool_alloc
+ ****************************************************************************/
+FAR void *mm_pool_alloc(FAR struct mm_pool_s *pool)
+{
+	FAR struct mm_pool_heapobj_s *hdr;
+	FAR void **obj;
+	irqstate_t flags;
+
+	flags = irqsave();
+
+	if (pool->nfree > pool->reserve || (pool->nfree > 0 && up_interrupt_context())) {
+		obj = (FAR void **)pool->freelist;
+		pool->freelist = *obj;
+		if (--pool->nfree < pool->minfree) {
+			pool->minfree = pool->nfree;
+		}
+
+		pool->nalloc++;
+		irqrestore(flags);
+		return obj;
+	}
+
+	irqrestore(flags);
+
+	/* Only the objects reserved for interrupt handlers are left.  Interrupt
+	 * handlers cannot use the heap.
+	 */
+
+	hdr = NULL;
+	if ((pool->flags & MM_POOL_HEAP) && !up_interrupt_context()) {
+		hdr = (FAR struct mm_pool_heapobj_s *)kmm_memalign(pool->align, mm_pool_heaphdrsize(pool) + pool->objsize);
+	}
+
+	flags = irqsave();
+	if (hdr) {
+		hdr->flink = pool->heapobjs;
+		pool->heapobjs = hdr;
+		pool->nheap++;
+		pool->nalloc++;
+	} else {
+		pool->nfail++;
+	}
+	irqrestore(flags);
+
+	if (!hdr) {
+		return NULL;
+	}
+
+	return (FAR uint8_t *)hdr + mm_pool_heaphdrsize(pool);
+}
+
+/****************************************************************************
+ * Name: mm_pool_free
+ ****************************************************************************/
+void mm_pool_free(FAR struct mm_pool_s *pool, FAR void *obj)
+{
+	FAR struct mm_pool_heapobj_s **prev;
+	FAR struct mm_pool_heapobj_s *hdr;
+	irqstate_t flags;
+
+	flags = irqsave();
+
+	if (!mm_pool_isslab(obj)) {
+		/* The object was either taken from the heap by the pool, or
+		 * allocated out of the pool by the user, like a TCB given to
+		 * task_init().  Only the former are counted in nheap.
+		 */
+
+		hdr = (FAR struct mm_pool_heapobj_s *)((FAR uint8_t *)obj - mm_pool_heaphdrsize(pool));
+		for (prev = &pool->heapobjs; *prev && *prev != hdr; prev = &(*prev)->flink) ;
+		if (*prev) {
+			*prev = hdr->flink;
+			pool->nheap--;
+			obj = hdr;
+		}
+		irqrestore(flags);
+
+		/* sched_kfree() defers the free if called from an interrupt handler */
+
+		sched_kfree(obj);
+		return;
+	}
+
+	DEBUGASSERT(pool->nfree < pool->nobjs);
+
+	*(FAR void **)obj = pool->freelist;
+	pool->freelist = obj;
+	pool->nfree++;
+
+	irqrestore(flags);
+}
+
+/****************************************************************************
+ * Name: mm_pool_foreach
+ ****************************************************************************/
+void mm_pool_foreach(mm_pool_handler_t handler, FAR void *arg)
+{
+	FAR struct mm_pool_s *pool;
+
+	sched_lock();
+	for (pool = g_pools; pool; pool = pool->flink) {
+		handler(pool, arg);
+	}
+	sched_unlock();
+}
@@ -0,0 +1,309 @@
+/****************************************************************************
+ *
+ * Copyright 2026 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+#include <tinyara/mm/pool.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define POOLS_LINELEN 80
+
+#define POOLS_TITLE_FMT " %-12s | %5s | %5s | %5s | %7s | %5s | %10s | %5s\n"
+#define POOLS_TITLE     "NAME", "SIZE", "TOTAL", "FREE", "MINFREE", "HEAP", "ALLOCS", "FAILS"
+#define POOLS_LINE      " -------------|-------|-------|-------|---------|-------|------------|------\n"
+#define POOLS_FMT       " %-12s | %5u | %5u | %5u | %7u | %5u | %10u | %5u\n"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct pools_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	char line[POOLS_LINELEN];	/* Pre-allocated buffer for formatted lines */
+};
+
+/* State of one read, passed to the mm_pool_foreach() handler */
+
+struct pools_read_s {
+	FAR struct pools_file_s *attr;
+	FAR char *buffer;
+	size_t buflen;
+	size_t totalsize;
+	off_t offset;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int pools_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int pools_close(FAR struct file *filep);
+static ssize_t pools_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int pools_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int pools_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations pools_operations = {
+	pools_open,					/* open */
+	pools_close,				/* close */
+	pools_read,					/* read */
+	NULL,						/* write */
+
+	pools_dup,					/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	pools_stat					/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pools_copyline
+ ****************************************************************************/
+
+static void pools_copyline(FAR struct pools_read_s *info, size_t linesize)
+{
+	size_t copysize;
+
+	if (info->totalsize >= info->buflen) {
+		return;
+	}
+
+	copysize = procfs_memcpy(info->attr->line, linesize, info->buffer, info->buflen - info->totalsize, &info->offset);
+	info->totalsize += copysize;
+	info->buffer += copysize;
+}
+
+/****************************************************************************
+ * Name: pools_readpool
+ ****************************************************************************/
+
+static void pools_readpool(FAR struct mm_pool_s *pool, FAR void *arg)
+{
+	FAR struct pools_read_s *info = (FAR struct pools_read_s *)arg;
+	size_t linesize;
+
+	linesize = snprintf(info->attr->line, POOLS_LINELEN, POOLS_FMT, pool->name, pool->objsize, pool->nobjs, pool->nfree, pool->minfree, pool->nheap, pool->nalloc, pool->nfail);
+	pools_copyline(info, linesize);
+}
+
+/****************************************************************************
+ * Name: pools_open
+ ****************************************************************************/
+
+static int pools_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct pools_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only.  Any attempt to open with any kind of write
+	 * access is not permitted.
+	 */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	/* "pools" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "pools") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* Allocate a container to hold the file attributes */
+
+	attr = (FAR struct pools_file_s *)kmm_zalloc(sizeof(struct pools_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Save the attributes as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: pools_close
+ ****************************************************************************/
+
+static int pools_close(FAR struct file *filep)
+{
+	FAR struct pools_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct pools_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: pools_read
+ ****************************************************************************/
+
+static ssize_t pools_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	struct pools_read_s info;
+	size_t linesize;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	info.attr = (FAR struct pools_file_s *)filep->f_priv;
+	DEBUGASSERT(info.attr);
+
+	info.buffer = buffer;
+	info.buflen = buflen;
+	info.totalsize = 0;
+	info.offset = filep->f_pos;
+
+	linesize = snprintf(info.attr->line, POOLS_LINELEN, POOLS_TITLE_FMT, POOLS_TITLE);
+	pools_copyline(&info, linesize);
+
+	linesize = snprintf(info.attr->line, POOLS_LINELEN, POOLS_LINE);
+	pools_copyline(&info, linesize);
+
+	mm_pool_foreach(pools_readpool, &info);
+
+	/* Update the file position */
+
+	filep->f_pos += info.totalsize;
+	return info.totalsize;
+}
+
+/****************************************************************************
+ * Name: pools_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int pools_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct pools_file_s *oldattr;
+	FAR struct pools_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct pools_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the task and attribute selection */
+
+	newattr = (FAR struct pools_file_s *)kmm_malloc(sizeof(struct pools_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* The copy the file attributes from the old attributes to the new */
+
+	memcpy(newattr, oldattr, sizeof(struct pools_file_s));
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: pools_stat
+ *
+ * Description:
+ *   Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int pools_stat(const char *relpath, struct stat *buf)
+{
+	/* "pools" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "pools") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* "pools" is the name for a read-only file */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -74,6 +74,11 @@
  * Private Types
  ****************************************************************************/
 
+struct symbol_s {
+	const char *name;
+	const char *cond;
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -81,6 +86,10 @@
 static const char *g_hdrfiles[MAX_HEADER_FILES];
 static int nhdrfiles;
 
+static struct symbol_s *g_symbols;
+static int nsymbols;
+static int nallocated;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -91,7 +100,9 @@ static void show_usage(const char *progname)
 	fprintf(stderr, "Where:\n\n");
 	fprintf(stderr, "  <cvs-file>   : The path to the input CSV file\n");
 	fprintf(stderr, "  <symtab-file>: The path to the output symbol table file\n");
-	fprintf(stderr, "  -d           : Enable debug output\n");
+	fprintf(stderr, "  -d           : Enable debug output\n\n");
+	fprintf(stderr, "The symbol table is sorted by name, so that it can be searched with\n");
+	fprintf(stderr, "CONFIG_SYMTAB_ORDEREDBYNAME\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -122,6 +133,30 @@ static void add_hdrfile(const char *hdrfile)
 	}
 }
 
+static void add_symbol(const char *name, const char *cond)
+{
+	if (nsymbols >= nallocated) {
+		nallocated = nallocated > 0 ? 2 * nallocated : 256;
+		g_symbols = (struct symbol_s *)realloc(g_symbols, nallocated * sizeof(struct symbol_s));
+		if (!g_symbols) {
+			fprintf(stderr, "ERROR:  Failed to allocate the symbol list\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	g_symbols[nsymbols].name = strdup(name);
+	g_symbols[nsymbols].cond = (cond && strlen(cond) > 0) ? strdup(cond) : NULL;
+	nsymbols++;
+}
+
+static int compare_symbols(const void *arg1, const void *arg2)
+{
+	const struct symbol_s *sym1 = (const struct symbol_s *)arg1;
+	const struct symbol_s *sym2 = (const struct symbol_s *)arg2;
+
+	return strcmp(sym1->name, sym2->name);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -133,7 +168,6 @@ int main(int argc, char **argv, char **envp)
 	char *nextterm;
 	char *finalterm;
 	char *ptr;
-	bool cond;
 	FILE *instream;
 	FILE *outstream;
 	int ch;
@@ -200,7 +234,7 @@ int main(int argc, char **argv, char **envp)
 		exit(EXIT_FAILURE);
 	}
 
-	/* Get all of the header files that we need to include */
+	/* Get all of the header files that we need to include and all of the symbols */
 
 	while ((ptr = read_line(instream)) != NULL) {
 		/* Parse the line from the CVS file */
@@ -214,11 +248,15 @@ int main(int argc, char **argv, char **envp)
 		/* Add the header file to the list of header files we need to include */
 
 		add_hdrfile(get_parm(HEADER_INDEX));
+
+		add_symbol(get_parm(NAME_INDEX), get_parm(COND_INDEX));
 	}
 
-	/* Back to the beginning */
+	/* Sort the symbols by name so that they can be found with a binary search */
 
-	rewind(instream);
+	if (nsymbols > 0) {
+		qsort(g_symbols, nsymbols, sizeof(struct symbol_s), compare_symbols);
+	}
 
 	/* Output up-front file boilerplate */
 
@@ -236,33 +274,24 @@ int main(int argc, char **argv, char **envp)
 	fprintf(outstream, "\nstruct symtab_s %s[] =\n", SYMTAB_NAME);
 	fprintf(outstream, "{\n");
 
-	/* Parse each line in the CVS file */
+	/* Output each symbol */
 
 	nextterm = "";
 	finalterm = "";
 
-	while ((ptr = read_line(instream)) != NULL) {
-		/* Parse the line from the CVS file */
-
-		int nargs = parse_csvline(ptr);
-		if (nargs < PARM1_INDEX) {
-			fprintf(stderr, "Only %d arguments found: %s\n", nargs, get_line());
-			exit(EXIT_FAILURE);
-		}
-
+	for (i = 0; i < nsymbols; i++) {
 		/* Output any conditional compilation */
 
-		cond = (get_parm(COND_INDEX) && strlen(get_parm(COND_INDEX)) > 0);
-		if (cond) {
-			fprintf(outstream, "%s#if %s\n", nextterm, get_parm(COND_INDEX));
+		if (g_symbols[i].cond) {
+			fprintf(outstream, "%s#if %s\n", nextterm, g_symbols[i].cond);
 			nextterm = "";
 		}
 
 		/* Output the symbol table entry */
 
-		fprintf(outstream, "%s  { \"%s\", (FAR const void *)%s }", nextterm, get_parm(NAME_INDEX), get_parm(NAME_INDEX));
+		fprintf(outstream, "%s  { \"%s\", (FAR const void *)%s }", nextterm, g_symbols[i].name, g_symbols[i].name);
 
-		if (cond) {
+		if (g_symbols[i].cond) {
 			nextterm = ",\n#endif\n";
 			finalterm = "\n#endif\n";
 		} else {
@@ -123,7 +123,11 @@ int work_cancel(int qid, FAR struct work_s *work)
 		if (qid == LPWORK) {
 			/* Cancel low priority work */
 
+#ifdef CONFIG_SCHED_LPWORK_POOL
+			return work_lpcancel(work);
+#else
 			return work_qcancel((FAR struct wqueue_s *)&g_lpwork, work);
+#endif
 		} else
 #endif
 		{
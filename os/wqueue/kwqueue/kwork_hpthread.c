@@ -174,6 +174,9 @@ int work_hpstart(void)
 	/* Initialize work queue data structures */
 
 	dq_init(&g_hpwork.q);
+#ifdef CONFIG_SCHED_WORKQUEUE_DELAYHEAP
+	g_hpwork.delayed = NULL;
+#endif
 
 	/* Start the high-priority, kernel mode worker thread */
 
@@ -0,0 +1,369 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * wqueue/kwqueue/kwork_lppool.c
+ *
+ * The low priority work queue pool.  Instead of one list shared by all of
+ * the low priority worker threads, each thread owns one queue of ready work
+ * per priority class.  New work is given to an idle thread when there is
+ * one, else to the thread with the least queued work.  A thread performs
+ * its own work first and, when it has none left in a class, takes the
+ * oldest work of that class queued to another thread.  Delayed work is
+ * kept in the shared heap of the work queue and goes to the thread which
+ * finds it due.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <unistd.h>
+#include <signal.h>
+#include <queue.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
+
+#include <arch/irq.h>
+
+#include "wqueue.h"
+
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_SCHED_LPWORK_POOL)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_lpowner
+ *
+ * Description:
+ *   Return the index of the thread whose ready work holds the work, or -1
+ *   if the work is not in the ready work of any thread.
+ *
+ ****************************************************************************/
+
+static int work_lpowner(FAR struct work_s *work)
+{
+	FAR struct lp_worker_s *pw = (FAR struct lp_worker_s *)work->wqueue;
+
+	if (pw >= &g_lpwork.pool[0] && pw < &g_lpwork.pool[CONFIG_SCHED_LPNTHREADS]) {
+		return pw - &g_lpwork.pool[0];
+	}
+
+	return -1;
+}
+
+/****************************************************************************
+ * Name: work_lpselect
+ *
+ * Description:
+ *   Select the thread to give new ready work to: the first idle thread
+ *   with no queued work, else the thread with the least queued work.
+ *
+ ****************************************************************************/
+
+static int work_lpselect(void)
+{
+	int wndx = 0;
+	int i;
+
+	for (i = 0; i < CONFIG_SCHED_LPNTHREADS; i++) {
+		if (!g_lpwork.worker[i].busy && g_lpwork.pool[i].nqueued == 0) {
+			return i;
+		}
+
+		if (g_lpwork.pool[i].nqueued < g_lpwork.pool[wndx].nqueued) {
+			wndx = i;
+		}
+	}
+
+	return wndx;
+}
+
+/****************************************************************************
+ * Name: work_lpready
+ *
+ * Description:
+ *   Add ready work to the tail of a thread's queue of its class.
+ *
+ ****************************************************************************/
+
+static void work_lpready(FAR struct work_s *work, int wndx)
+{
+	FAR struct lp_worker_s *pw = &g_lpwork.pool[wndx];
+
+	work->wqueue = pw;
+	dq_addlast((FAR dq_entry_t *)work, &pw->q[work->wclass]);
+	pw->nqueued++;
+}
+
+/****************************************************************************
+ * Name: work_lpunready
+ *
+ * Description:
+ *   Remove ready work from the queue of a thread.
+ *
+ ****************************************************************************/
+
+static void work_lpunready(FAR struct work_s *work, int wndx)
+{
+	FAR struct lp_worker_s *pw = &g_lpwork.pool[wndx];
+
+	dq_rem((FAR dq_entry_t *)work, &pw->q[work->wclass]);
+	pw->nqueued--;
+}
+
+/****************************************************************************
+ * Name: work_lpnext
+ *
+ * Description:
+ *   Take the next work for a thread: the oldest work of the highest class
+ *   it has queued, unless another thread has work of a higher class.
+ *
+ ****************************************************************************/
+
+static FAR struct work_s *work_lpnext(int wndx, FAR bool *stolen)
+{
+	FAR struct work_s *work;
+	int wclass;
+	int i;
+
+	for (wclass = 0; wclass < WORK_NCLASSES; wclass++) {
+		for (i = 0; i < CONFIG_SCHED_LPNTHREADS; i++) {
+			/* Start with our own queue, then look at the others in turn */
+
+			int victim = (wndx + i) % CONFIG_SCHED_LPNTHREADS;
+
+			work = (FAR struct work_s *)g_lpwork.pool[victim].q[wclass].head;
+			if (work != NULL) {
+				work_lpunready(work, victim);
+				*stolen = (victim != wndx);
+				return work;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_lpqueue
+ *
+ * Description:
+ *   Queue work to the low priority work queue pool and signal the thread
+ *   which should take it.
+ *
+ * Input parameters:
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   wclass - The priority class of the work
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno on failure.
+ *
+ ****************************************************************************/
+
+int work_lpqueue(FAR struct work_s *work, worker_t worker, FAR void *arg, clock_t delay, int wclass)
+{
+	irqstate_t flags;
+	clock_t ctick;
+	int wndx;
+	int i;
+
+	DEBUGASSERT(work != NULL);
+
+	if (wclass < 0 || wclass >= WORK_NCLASSES) {
+		return -EINVAL;
+	}
+
+	ctick = clock();
+	flags = irqsave();
+
+	if (work->worker != NULL && (work->wqueue == &g_lpwork || work_lpowner(work) >= 0)) {
+		irqrestore(flags);
+		return -EALREADY;
+	}
+
+	work->worker = worker;
+	work->arg = arg;
+	work->delay = delay;
+	work->qtime = ctick;
+	work->wclass = wclass;
+
+	if (delay == 0) {
+		wndx = work_lpselect();
+		work_lpready(work, wndx);
+	} else {
+		/* Wake up an idle thread so that it sleeps no longer than needed */
+
+		work->wqueue = &g_lpwork;
+		work_delay_add((FAR struct wqueue_s *)&g_lpwork, work);
+
+		for (wndx = 0, i = 0; i < CONFIG_SCHED_LPNTHREADS; i++) {
+			if (!g_lpwork.worker[i].busy) {
+				wndx = i;
+				break;
+			}
+		}
+	}
+
+	/* A busy thread will find the work before it goes to sleep */
+
+	if (g_lpwork.worker[wndx].busy) {
+		irqrestore(flags);
+		return OK;
+	}
+
+	irqrestore(flags);
+	return work_qsignal(g_lpwork.worker[wndx].pid);
+}
+
+/****************************************************************************
+ * Name: work_lpcancel
+ *
+ * Description:
+ *   Cancel work queued to the low priority work queue pool.
+ *
+ * Input parameters:
+ *   work   - The previously queued work structure to cancel
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOENT if there is no such work queued.
+ *
+ ****************************************************************************/
+
+int work_lpcancel(FAR struct work_s *work)
+{
+	irqstate_t flags;
+	int ret = -ENOENT;
+	int wndx;
+
+	DEBUGASSERT(work != NULL);
+
+	flags = irqsave();
+	if (work->worker != NULL) {
+		if (work->wqueue == &g_lpwork) {
+			work_delay_remove((FAR struct wqueue_s *)&g_lpwork, work);
+			ret = OK;
+		} else if ((wndx = work_lpowner(work)) >= 0) {
+			work_lpunready(work, wndx);
+			ret = OK;
+		}
+
+		if (ret == OK) {
+			work->worker = NULL;
+			work->wqueue = NULL;
+		}
+	}
+
+	irqrestore(flags);
+	return ret;
+}
+
+/****************************************************************************
+ * Name: work_lpprocess
+ *
+ * Description:
+ *   Perform the work of one thread of the low priority work queue pool
+ *   until there is none left to take, then wait for more.
+ *
+ * Input parameters:
+ *   wndx - The index of the calling thread in the pool
+ *
+ ****************************************************************************/
+
+void work_lpprocess(int wndx)
+{
+	FAR struct lp_worker_s *pw = &g_lpwork.pool[wndx];
+	FAR struct work_s *work;
+	irqstate_t flags;
+	worker_t worker;
+	FAR void *arg;
+	clock_t next;
+	bool stolen;
+
+	flags = irqsave();
+
+	for (;;) {
+		/* Take the delayed work which has become due */
+
+		next = work_delay_expire((FAR struct wqueue_s *)&g_lpwork, clock());
+		while ((work = (FAR struct work_s *)dq_remfirst(&g_lpwork.q)) != NULL) {
+			work_lpready(work, wndx);
+		}
+
+		work = work_lpnext(wndx, &stolen);
+		if (work == NULL) {
+			break;
+		}
+
+		worker = work->worker;
+		arg = work->arg;
+		work->worker = NULL;
+		work->wqueue = NULL;
+
+		pw->running = true;
+		pw->start = clock();
+		irqrestore(flags);
+
+		worker(arg);
+
+		flags = irqsave();
+		pw->busytime += clock() - pw->start;
+		pw->running = false;
+		pw->nperformed++;
+		if (stolen) {
+			pw->nstolen++;
+		}
+	}
+
+	g_lpwork.worker[wndx].busy = false;
+	if (next == 0) {
+		sigset_t set;
+		sigemptyset(&set);
+		sigaddset(&set, SIGWORK);
+
+		/* No delayed work, wait until signalled with SIGWORK */
+
+		DEBUGVERIFY(sigwaitinfo(&set, NULL));
+	} else {
+		/* Wait until the earliest delayed work is due */
+
+		usleep(next * USEC_PER_TICK);
+	}
+	g_lpwork.worker[wndx].busy = true;
+
+	irqrestore(flags);
+}
+
+#endif							/* CONFIG_SCHED_LPWORK && CONFIG_SCHED_LPWORK_POOL */
@@ -152,7 +152,11 @@ static int work_lpthread(int argc, char *argv[])
 			 * to wait indefinitely until a signal is received.
 			 */
 
+#ifdef CONFIG_SCHED_LPWORK_POOL
+			work_lpprocess(wndx);
+#else
 			work_process((FAR struct wqueue_s *)&g_lpwork, wndx);
+#endif
 		} else
 #endif
 		{
@@ -173,7 +177,11 @@ static int work_lpthread(int argc, char *argv[])
 			 * period provided by g_lpwork.delay expires.
 			 */
 
+#ifdef CONFIG_SCHED_LPWORK_POOL
+			work_lpprocess(0);
+#else
 			work_process((FAR struct wqueue_s *)&g_lpwork, 0);
+#endif
 		}
 	}
 
@@ -209,6 +217,26 @@ int work_lpstart(void)
 	memset(&g_lpwork, 0, sizeof(struct wqueue_s));
 
 	dq_init(&g_lpwork.q);
+#ifdef CONFIG_SCHED_WORKQUEUE_DELAYHEAP
+	g_lpwork.delayed = NULL;
+#endif
+#ifdef CONFIG_SCHED_LPWORK_POOL
+	for (wndx = 0; wndx < CONFIG_SCHED_LPNTHREADS; wndx++) {
+		int wclass;
+
+		for (wclass = 0; wclass < WORK_NCLASSES; wclass++) {
+			dq_init(&g_lpwork.pool[wndx].q[wclass]);
+		}
+
+		g_lpwork.pool[wndx].nqueued = 0;
+		g_lpwork.pool[wndx].running = false;
+		g_lpwork.pool[wndx].busytime = 0;
+		g_lpwork.pool[wndx].nperformed = 0;
+		g_lpwork.pool[wndx].nstolen = 0;
+	}
+
+	g_lpwork.since = clock();
+#endif
 
 	/* Don't permit any of the threads to run until we have fully initialized
 	 * g_lpwork.
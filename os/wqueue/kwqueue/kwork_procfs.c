@@ -0,0 +1,322 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/clock.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+#include <tinyara/wqueue.h>
+
+#include <arch/irq.h>
+
+#include "wqueue.h"
+
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_SCHED_LPWORK_POOL) && \
+	!defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_LPWORK)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define LPWORK_LINELEN 80
+
+#define LPWORK_INFO_TITLE_FMT " %6s | %5s | %6s | %10s | %10s | %10s | %4s \n"
+#define LPWORK_INFO_LINE " -------|-------|--------|------------|------------|------------|------\n"
+#define LPWORK_INFO_TITLE "WORKER", "PID", "QUEUED", "PERFORMED", "STOLEN", "BUSY(ms)", "LOAD"
+#define LPWORK_INFO_FMT " %6d | %5d | %6u | %10lu | %10lu | %10lu | %3lu%% \n"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+/* This structure describes one open "file" */
+
+struct lpwork_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	char line[LPWORK_LINELEN];	/* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+/* File system methods */
+
+static int lpwork_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int lpwork_close(FAR struct file *filep);
+static ssize_t lpwork_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int lpwork_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int lpwork_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations lpwork_operations = {
+	lpwork_open,				/* open */
+	lpwork_close,				/* close */
+	lpwork_read,				/* read */
+	NULL,						/* write */
+
+	lpwork_dup,					/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	lpwork_stat					/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lpwork_open
+ ****************************************************************************/
+
+static int lpwork_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct lpwork_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only.  Any attempt to open with any kind of write
+	 * access is not permitted.
+	 */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	/* "lpwork" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "lpwork") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* Allocate a container to hold the file attributes */
+
+	attr = (FAR struct lpwork_file_s *)kmm_zalloc(sizeof(struct lpwork_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Save the attributes as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: lpwork_close
+ ****************************************************************************/
+
+static int lpwork_close(FAR struct file *filep)
+{
+	FAR struct lpwork_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct lpwork_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: lpwork_read
+ *
+ * Description:
+ *   Show, for each thread of the low priority work queue pool, the work
+ *   queued to it, the work it performed and how many of them it stole from
+ *   another thread, the time it spent on work in msec, and its load since
+ *   the pool was started.
+ *
+ ****************************************************************************/
+
+static ssize_t lpwork_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	FAR struct lpwork_file_s *attr;
+	struct lp_worker_s stat;
+	irqstate_t flags;
+	clock_t elapsed;
+	clock_t now;
+	int wndx;
+	size_t linesize;
+	size_t copysize;
+	size_t totalsize;
+	off_t offset;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct lpwork_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	offset = filep->f_pos;
+	totalsize = 0;
+
+	linesize = snprintf(attr->line, LPWORK_LINELEN, LPWORK_INFO_TITLE_FMT, LPWORK_INFO_TITLE);
+	copysize = procfs_memcpy(attr->line, linesize, buffer, buflen - totalsize, &offset);
+	totalsize += copysize;
+	buffer += copysize;
+
+	if (totalsize >= buflen) {
+		goto end;
+	}
+
+	linesize = snprintf(attr->line, LPWORK_LINELEN, LPWORK_INFO_LINE);
+	copysize = procfs_memcpy(attr->line, linesize, buffer, buflen - totalsize, &offset);
+	totalsize += copysize;
+	buffer += copysize;
+
+	if (totalsize >= buflen) {
+		goto end;
+	}
+
+	for (wndx = 0; wndx < CONFIG_SCHED_LPNTHREADS; wndx++) {
+		/* Take a consistent copy, counting the work being performed */
+
+		flags = irqsave();
+		now = clock();
+		stat = g_lpwork.pool[wndx];
+		if (stat.running) {
+			stat.busytime += now - stat.start;
+		}
+
+		irqrestore(flags);
+
+		elapsed = now - g_lpwork.since;
+		linesize = snprintf(attr->line, LPWORK_LINELEN, LPWORK_INFO_FMT, wndx, g_lpwork.worker[wndx].pid, stat.nqueued,
+							(unsigned long)stat.nperformed, (unsigned long)stat.nstolen, (unsigned long)TICK2MSEC(stat.busytime),
+							elapsed > 0 ? (unsigned long)((uint64_t)stat.busytime * 100 / elapsed) : 0ul);
+		copysize = procfs_memcpy(attr->line, linesize, buffer, buflen - totalsize, &offset);
+		totalsize += copysize;
+		buffer += copysize;
+
+		if (totalsize >= buflen) {
+			goto end;
+		}
+	}
+
+end:
+	/* Update the file position */
+	if (totalsize > 0) {
+		filep->f_pos += totalsize;
+	}
+
+	return totalsize;
+}
+
+/****************************************************************************
+ * Name: lpwork_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int lpwork_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct lpwork_file_s *oldattr;
+	FAR struct lpwork_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct lpwork_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the task and attribute selection */
+
+	newattr = (FAR struct lpwork_file_s *)kmm_malloc(sizeof(struct lpwork_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* The copy the file attributes from the old attributes to the new */
+
+	memcpy(newattr, oldattr, sizeof(struct lpwork_file_s));
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: lpwork_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int lpwork_stat(const char *relpath, struct stat *buf)
+{
+	/* "lpwork" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "lpwork") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* "lpwork" is the name for a read-only file */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+#endif							/* CONFIG_SCHED_LPWORK_POOL && CONFIG_FS_PROCFS && !CONFIG_FS_PROCFS_EXCLUDE_LPWORK */
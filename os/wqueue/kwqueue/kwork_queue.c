@@ -123,7 +123,7 @@
 
 int work_queue(int qid, FAR struct work_s *work, worker_t worker, FAR void *arg, clock_t delay)
 {
-#if defined(CONFIG_SCHED_HPWORK) || defined(CONFIG_SCHED_LPWORK)
+#if defined(CONFIG_SCHED_HPWORK) || (defined(CONFIG_SCHED_LPWORK) && !defined(CONFIG_SCHED_LPWORK_POOL))
 	int result;
 #endif
 #ifdef CONFIG_SCHED_HPWORK
@@ -139,6 +139,9 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker, FAR void *arg,
 #endif
 #ifdef CONFIG_SCHED_LPWORK
 		if (qid == LPWORK) {
+#ifdef CONFIG_SCHED_LPWORK_POOL
+			return work_lpqueue(work, worker, arg, delay, WORK_CLASS_NORMAL);
+#else
 			/* Cancel low priority work */
 
 			result = work_qqueue((FAR struct wqueue_s *)&g_lpwork, work, worker, arg, delay);
@@ -146,9 +149,43 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker, FAR void *arg,
 				return result;
 			}
 			return work_signal(LPWORK);
+#endif
 		} else
 #endif
 		{
 			return -EINVAL;
 		}
 }
+
+/****************************************************************************
+ * Name: work_queue_class
+ *
+ * Description:
+ *   Queue work like work_queue(), with a priority class.  The class only
+ *   matters for the low priority work queue pool; work for other queues is
+ *   passed to work_queue().
+ *
+ * Input parameters:
+ *   qid    - The work queue ID (index)
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   wclass - The priority class of the work, WORK_CLASS_*
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_SCHED_LPWORK_POOL)
+int work_queue_class(int qid, FAR struct work_s *work, worker_t worker, FAR void *arg, clock_t delay, int wclass)
+{
+	if (qid == LPWORK) {
+		return work_lpqueue(work, worker, arg, delay, wclass);
+	}
+
+	return work_queue(qid, work, worker, arg, delay);
+}
+#endif
@@ -168,6 +168,9 @@ int work_usrstart(void)
 	/* Initialize work queue data structures */
 
 	dq_init(&g_usrwork.q);
+#ifdef CONFIG_SCHED_WORKQUEUE_DELAYHEAP
+	g_usrwork.delayed = NULL;
+#endif
 
 #ifdef CONFIG_BUILD_PROTECTED
 	{
@@ -112,7 +112,9 @@
 
 int work_qcancel(FAR struct wqueue_s *wqueue, FAR struct work_s *work)
 {
+#ifndef CONFIG_SCHED_WORKQUEUE_DELAYHEAP
 	struct work_s *cur_work;
+#endif
 	int ret = -ENOENT;
 
 	DEBUGASSERT(work != NULL);
@@ -128,6 +130,21 @@ int work_qcancel(FAR struct wqueue_s *wqueue, FAR struct work_s *work)
 	irqstate_t flags;
 	flags = irqsave();
 #endif
+#ifdef CONFIG_SCHED_WORKQUEUE_DELAYHEAP
+	if (work->worker != NULL && work->wqueue == wqueue) {
+		/* Ready work has no delay, the rest is still in the heap */
+
+		if (work->delay == 0) {
+			dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+		} else {
+			work_delay_remove(wqueue, work);
+		}
+
+		work->worker = NULL;
+		work->wqueue = NULL;
+		ret = OK;
+	}
+#else
 	if (work->worker != NULL) {
 		/* A little test of the integrity of the work queue */
 
@@ -159,6 +176,7 @@ int work_qcancel(FAR struct wqueue_s *wqueue, FAR struct work_s *work)
 		work->worker = NULL;
 		ret = OK;
 	}
+#endif
 
 #if defined(CONFIG_SCHED_USRWORK) && !defined(__KERNEL__)
 	work_unlock();
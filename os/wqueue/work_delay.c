@@ -0,0 +1,272 @@
+/****************************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * wqueue/work_delay.c
+ *
+ * Delayed work is kept apart from the ready work of a work queue, in a
+ * leftist heap ordered by expiration time.  The heap is intrusive: while
+ * the work is delayed, its dq links are free and hold the right child
+ * (flink) and the parent (blink), 'child' holds the left child and 'rank'
+ * the length of the right spine.  The right spines are at most log2(n + 1)
+ * long, so adding, removing any work and taking the earliest one are all
+ * O(log n) in the worst case.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <tinyara/clock.h>
+#include <tinyara/wqueue.h>
+
+#include "wqueue.h"
+
+#if defined(CONFIG_SCHED_WORKQUEUE) && defined(CONFIG_SCHED_WORKQUEUE_DELAYHEAP)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WORK_RIGHT(w)         ((FAR struct work_s *)(w)->dq.flink)
+#define WORK_PARENT(w)        ((FAR struct work_s *)(w)->dq.blink)
+#define WORK_SETRIGHT(w, r)   ((w)->dq.flink = (FAR dq_entry_t *)(r))
+#define WORK_SETPARENT(w, p)  ((w)->dq.blink = (FAR dq_entry_t *)(p))
+#define WORK_RANK(w)          ((w) != NULL ? (w)->rank : 0)
+
+/* Compare expiration times, allowing the system timer to wrap around */
+
+#ifdef CONFIG_SYSTEM_TIME64
+#define WORK_BEFORE(a, b)     ((int64_t)(((a)->qtime + (a)->delay) - ((b)->qtime + (b)->delay)) < 0)
+#else
+#define WORK_BEFORE(a, b)     ((int32_t)(((a)->qtime + (a)->delay) - ((b)->qtime + (b)->delay)) < 0)
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_delay_fixup
+ *
+ * Description:
+ *   Restore the leftist property of a node whose right child changed, by
+ *   swapping its children if needed, and update its rank.
+ *
+ * Returned Value:
+ *   True if the rank of the node changed.
+ *
+ ****************************************************************************/
+
+static bool work_delay_fixup(FAR struct work_s *work)
+{
+	FAR struct work_s *right = WORK_RIGHT(work);
+	uint8_t rank;
+
+	if (WORK_RANK(work->child) < WORK_RANK(right)) {
+		WORK_SETRIGHT(work, work->child);
+		work->child = right;
+	}
+
+	rank = WORK_RANK(WORK_RIGHT(work)) + 1;
+	if (rank == work->rank) {
+		return false;
+	}
+
+	work->rank = rank;
+	return true;
+}
+
+/****************************************************************************
+ * Name: work_delay_meld
+ *
+ * Description:
+ *   Merge two heaps, either of which may be empty, and return the root of
+ *   the result.  The right spines are merged going down, then the nodes
+ *   along the merged spine are fixed up going back up, so the loops run
+ *   for at most the length of both right spines.
+ *
+ ****************************************************************************/
+
+static FAR struct work_s *work_delay_meld(FAR struct work_s *a, FAR struct work_s *b)
+{
+	FAR struct work_s *root;
+	FAR struct work_s *right;
+
+	if (a == NULL) {
+		root = b;
+	} else if (b == NULL) {
+		root = a;
+	} else {
+		if (WORK_BEFORE(b, a)) {
+			root = b;
+			b = a;
+			a = root;
+		}
+
+		root = a;
+		WORK_SETPARENT(root, NULL);
+
+		/* 'a' always expires first, merge 'b' into its right subtree */
+
+		while (b != NULL) {
+			right = WORK_RIGHT(a);
+			if (right != NULL && !WORK_BEFORE(b, right)) {
+				a = right;
+				continue;
+			}
+
+			WORK_SETRIGHT(a, b);
+			WORK_SETPARENT(b, a);
+			a = b;
+			b = right;
+		}
+
+		for (; a != NULL; a = WORK_PARENT(a)) {
+			(void)work_delay_fixup(a);
+		}
+	}
+
+	if (root != NULL) {
+		WORK_SETPARENT(root, NULL);
+	}
+
+	return root;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_delay_add
+ *
+ * Description:
+ *   Add work, whose qtime and delay are already set, to the delayed work
+ *   of a work queue.
+ *
+ * Assumptions:
+ *   The caller holds the work queue lock.
+ *
+ ****************************************************************************/
+
+void work_delay_add(FAR struct wqueue_s *wqueue, FAR struct work_s *work)
+{
+	WORK_SETRIGHT(work, NULL);
+	WORK_SETPARENT(work, NULL);
+	work->child = NULL;
+	work->rank = 1;
+
+	wqueue->delayed = work_delay_meld(wqueue->delayed, work);
+}
+
+/****************************************************************************
+ * Name: work_delay_remove
+ *
+ * Description:
+ *   Remove work from the delayed work of a work queue.
+ *
+ * Assumptions:
+ *   The caller holds the work queue lock and the work is in the delayed
+ *   work of this work queue.
+ *
+ ****************************************************************************/
+
+void work_delay_remove(FAR struct wqueue_s *wqueue, FAR struct work_s *work)
+{
+	FAR struct work_s *parent;
+	FAR struct work_s *sub;
+
+	/* Put the subtrees of the work in its place */
+
+	parent = WORK_PARENT(work);
+	sub = work_delay_meld(work->child, WORK_RIGHT(work));
+	if (parent == NULL) {
+		DEBUGASSERT(work == wqueue->delayed);
+		wqueue->delayed = sub;
+		return;
+	}
+
+	if (parent->child == work) {
+		parent->child = sub;
+	} else {
+		WORK_SETRIGHT(parent, sub);
+	}
+
+	if (sub != NULL) {
+		WORK_SETPARENT(sub, parent);
+	}
+
+	/* Then fix up the ancestors as long as their rank changes.  The smaller
+	 * of the old and new rank grows by one at each of them, so this stops
+	 * within log2(n + 1) steps.
+	 */
+
+	while (parent != NULL && work_delay_fixup(parent)) {
+		parent = WORK_PARENT(parent);
+	}
+}
+
+/****************************************************************************
+ * Name: work_delay_expire
+ *
+ * Description:
+ *   Move the delayed work which is now due to the tail of the ready work,
+ *   earliest first.  The delay of the moved work is cleared, which tells
+ *   ready work from delayed work.
+ *
+ * Input parameters:
+ *   wqueue - The work queue
+ *   ctick  - The current system time
+ *
+ * Returned Value:
+ *   The number of ticks until the next delayed work is due, or zero if
+ *   there is no delayed work left.
+ *
+ * Assumptions:
+ *   The caller holds the work queue lock.
+ *
+ ****************************************************************************/
+
+clock_t work_delay_expire(FAR struct wqueue_s *wqueue, clock_t ctick)
+{
+	FAR struct work_s *work;
+	clock_t elapsed;
+
+	while ((work = wqueue->delayed) != NULL) {
+		elapsed = ctick - work->qtime;
+		if (elapsed < work->delay) {
+			return work->delay - elapsed;
+		}
+
+		wqueue->delayed = work_delay_meld(work->child, WORK_RIGHT(work));
+		work->delay = 0;
+		dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+	}
+
+	return 0;
+}
+
+#endif							/* CONFIG_SCHED_WORKQUEUE && CONFIG_SCHED_WORKQUEUE_DELAYHEAP */
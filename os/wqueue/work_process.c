@@ -109,6 +109,91 @@
  *   None
  *
  ****************************************************************************/
+#ifdef CONFIG_SCHED_WORKQUEUE_DELAYHEAP
+void work_process(FAR struct wqueue_s *wqueue, int wndx)
+{
+	FAR struct work_s *work;
+	worker_t worker;
+	FAR void *arg;
+	clock_t next;
+
+#if defined(CONFIG_SCHED_USRWORK) && !defined(__KERNEL__)
+	while (work_lock() < 0);
+#else
+	irqstate_t flags;
+	flags = irqsave();
+#endif
+
+	for (;;) {
+		/* Move the delayed work which has become due behind the ready work.
+		 * Only the earliest delayed work is looked at when nothing is due.
+		 */
+
+		next = work_delay_expire(wqueue, clock());
+
+		/* Then take the oldest ready work, if any */
+
+		work = (FAR struct work_s *)dq_remfirst(&wqueue->q);
+		if (work == NULL) {
+			break;
+		}
+
+		worker = work->worker;
+		if (worker != NULL) {
+			/* Extract the work argument and mark the work as no longer
+			 * queued before re-enabling interrupts.
+			 */
+
+			arg = work->arg;
+			work->worker = NULL;
+			work->wqueue = NULL;
+
+			/* Do the work with interrupts enabled.  The queue may change
+			 * meanwhile but the next work is always at its head.
+			 */
+
+#if defined(CONFIG_SCHED_USRWORK) && !defined(__KERNEL__)
+			work_unlock();
+#else
+			irqrestore(flags);
+#endif
+			worker(arg);
+
+#if defined(CONFIG_SCHED_USRWORK) && !defined(__KERNEL__)
+			while (work_lock() < 0);
+#else
+			flags = irqsave();
+#endif
+		}
+	}
+
+#if defined(CONFIG_SCHED_USRWORK) && !defined(__KERNEL__)
+	work_unlock();
+#endif
+
+	wqueue->worker[wndx].busy = false;
+	if (next == 0) {
+		sigset_t set;
+		sigemptyset(&set);
+		sigaddset(&set, SIGWORK);
+
+		/* No work at all, wait indefinitely until signalled with SIGWORK */
+
+		DEBUGVERIFY(sigwaitinfo(&set, NULL));
+	} else {
+		/* Wait until the earliest delayed work is due or until we are
+		 * awakened by a signal.
+		 */
+
+		usleep(next * USEC_PER_TICK);
+	}
+	wqueue->worker[wndx].busy = true;
+
+#if !defined(CONFIG_SCHED_USRWORK) || defined(__KERNEL__)
+	irqrestore(flags);
+#endif
+}
+#else
 void work_process(FAR struct wqueue_s *wqueue, int wndx)
 {
 	volatile FAR struct work_s *work;
@@ -245,3 +330,4 @@ void work_process(FAR struct wqueue_s *wqueue, int wndx)
 #endif
 
 }
+#endif
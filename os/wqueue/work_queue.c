@@ -120,9 +120,11 @@ int work_qqueue(FAR struct wqueue_s *wqueue, FAR struct work_s *work, worker_t w
 {
 	DEBUGASSERT(work != NULL);
 
+#ifndef CONFIG_SCHED_WORKQUEUE_DELAYHEAP
 	struct work_s *next_work = NULL;
 	struct work_s *cur_work;
 	clock_t elapsed;
+#endif
 	clock_t ctick;
 	ctick = clock();
 
@@ -133,6 +135,34 @@ int work_qqueue(FAR struct wqueue_s *wqueue, FAR struct work_s *work, worker_t w
 	flags = irqsave();
 #endif
 
+#ifdef CONFIG_SCHED_WORKQUEUE_DELAYHEAP
+	/* Work still queued here has its worker set and points to this queue */
+
+	if (work->worker != NULL && work->wqueue == wqueue) {
+#if defined(CONFIG_SCHED_USRWORK) && !defined(__KERNEL__)
+		work_unlock();
+#else
+		irqrestore(flags);
+#endif
+		return -EALREADY;
+	}
+
+	work->worker = worker;		/* Work callback */
+	work->arg = arg;		/* Callback argument */
+	work->delay = delay;		/* Delay until work performed */
+	work->qtime = ctick;		/* Time work queued */
+	work->wqueue = wqueue;		/* Queue holding the work */
+
+	/* Work to be performed immediately goes straight to the tail of the
+	 * queue, the rest waits in the heap of delayed work.
+	 */
+
+	if (delay == 0) {
+		dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+	} else {
+		work_delay_add(wqueue, work);
+	}
+#else
 	/* check whether requested work is in queue list or not */
 	cur_work = (struct work_s *)wqueue->q.head;
 	while (cur_work != NULL) {
@@ -165,6 +195,7 @@ int work_qqueue(FAR struct wqueue_s *wqueue, FAR struct work_s *work, worker_t w
 	} else {
 		dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
 	}
+#endif
 #if defined(CONFIG_SCHED_USRWORK) && !defined(__KERNEL__)
 	work_unlock();
 #else
@@ -90,6 +90,9 @@ struct worker_s {
 
 struct wqueue_s {
 	struct dq_queue_s q;		/* The queue of pending work */
+#ifdef CONFIG_SCHED_WORKQUEUE_DELAYHEAP
+	FAR struct work_s *delayed;	/* Heap of delayed work, earliest first */
+#endif
 	struct worker_s worker[1];	/* Describes a worker thread */
 };
 
@@ -100,6 +103,9 @@ struct wqueue_s {
 #ifdef CONFIG_SCHED_HPWORK
 struct hp_wqueue_s {
 	struct dq_queue_s q;		/* The queue of pending work */
+#ifdef CONFIG_SCHED_WORKQUEUE_DELAYHEAP
+	FAR struct work_s *delayed;	/* Heap of delayed work, earliest first */
+#endif
 	struct worker_s worker[1];	/* Describes the single high priority worker */
 };
 #endif
@@ -109,11 +115,39 @@ struct hp_wqueue_s {
  */
 
 #ifdef CONFIG_SCHED_LPWORK
+#ifdef CONFIG_SCHED_LPWORK_POOL
+/* The ready work of one thread of the low priority work queue pool and how
+ * much that thread has been used.
+ */
+
+struct lp_worker_s {
+	struct dq_queue_s q[WORK_NCLASSES];	/* Ready work, by priority class */
+	uint16_t nqueued;			/* Number of work in q[] */
+	bool running;				/* True: Performing a work */
+	clock_t start;				/* Time the running work started */
+	clock_t busytime;			/* Ticks spent performing work */
+	uint32_t nperformed;		/* Number of work performed */
+	uint32_t nstolen;			/* Number of them taken from another thread */
+};
+#endif
+
 struct lp_wqueue_s {
 	struct dq_queue_s q;		/* The queue of pending work */
+#ifdef CONFIG_SCHED_WORKQUEUE_DELAYHEAP
+	FAR struct work_s *delayed;	/* Heap of delayed work, earliest first */
+#endif
 
 	/* Describes each thread in the low priority queue's thread pool */
 	struct worker_s worker[CONFIG_SCHED_LPNTHREADS];
+
+#ifdef CONFIG_SCHED_LPWORK_POOL
+	/* With the pool, ready work goes to the threads' own queues and 'q' only
+	 * collects the delayed work when it becomes due.
+	 */
+
+	struct lp_worker_s pool[CONFIG_SCHED_LPNTHREADS];
+	clock_t since;				/* Time the pool was started */
+#endif
 };
 #endif
 
@@ -239,6 +273,23 @@ int work_qcancel(FAR struct wqueue_s *wqueue, FAR struct work_s *work);
 
 int work_qqueue(FAR struct wqueue_s *wqueue, FAR struct work_s *work, worker_t worker, FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_delay_add, work_delay_remove and work_delay_expire
+ *
+ * Description:
+ *   Manage the delayed work of a work queue.  The work queue lock must be
+ *   held.  work_delay_expire() moves the work which is due to the queue of
+ *   pending work and returns the ticks until the next delayed work is due,
+ *   or zero if there is none.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_DELAYHEAP
+void work_delay_add(FAR struct wqueue_s *wqueue, FAR struct work_s *work);
+void work_delay_remove(FAR struct wqueue_s *wqueue, FAR struct work_s *work);
+clock_t work_delay_expire(FAR struct wqueue_s *wqueue, clock_t ctick);
+#endif
+
 /****************************************************************************
  * Name: work_process
  *
@@ -276,5 +327,23 @@ void work_process(FAR struct wqueue_s *wqueue, int wdx);
 
 int work_qsignal(pid_t pid);
 
+/****************************************************************************
+ * Name: work_lpqueue, work_lpcancel and work_lpprocess
+ *
+ * Description:
+ *   Queue, cancel and perform the work of the low priority work queue pool.
+ *   These take the place of work_qqueue(), work_qcancel() and
+ *   work_process() for the low priority work queue when
+ *   CONFIG_SCHED_LPWORK_POOL is selected.  work_lpqueue() also signals the
+ *   thread which should take the work.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_LPWORK) && defined(CONFIG_SCHED_LPWORK_POOL)
+int work_lpqueue(FAR struct work_s *work, worker_t worker, FAR void *arg, clock_t delay, int wclass);
+int work_lpcancel(FAR struct work_s *work);
+void work_lpprocess(int wndx);
+#endif
+
 #endif							/* CONFIG_SCHED_WORKQUEUE */
 #endif							/* __OS_WQUEUE_WQUEUE_H */
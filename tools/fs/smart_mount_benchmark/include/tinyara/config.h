@@ -0,0 +1,43 @@
+/****************************************************************************
+ *
+ * Copyright 2026 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/* Host build configuration of the SMART MTD layer for
+ * smart_mount_benchmark.  CONFIG_MTD_SMART_CHECKPOINT is given on the
+ * command line.
+ */
+
+#ifndef __TOOLS_SMART_MOUNT_BENCHMARK_CONFIG_H
+#define __TOOLS_SMART_MOUNT_BENCHMARK_CONFIG_H
+
+#define CONFIG_MTD_SMART 1
+#define CONFIG_MTD_SMART_SECTOR_SIZE 1024
+#define CONFIG_MTD_SMART_WEAR_LEVEL 1
+#define CONFIG_MTD_SMART_CHECKPOINT_INTERVAL 64
+#define CONFIG_SMARTFS_ERASEDSTATE 0xff
+#define CONFIG_SMARTFS_MAXNAMLEN 32
+#define CONFIG_FS_WRITABLE 1
+
+#define FAR
+#define NEAR
+#define CODE
+#define OK 0
+#define ERROR -1
+#define DEBUGASSERT(f)
+#define TRUE 1
+#define FALSE 0
+
+#endif
@@ -0,0 +1,316 @@
+/****************************************************************************
+ *
+ * Copyright 2026 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/*
+ * Host benchmark for the mount of a SMART volume (os/fs/driver/mtd/smart.c).
+ * Volumes of several sizes are formatted on a RAM NOR flash and filled, then
+ * mounted by a full scan of the sector headers and from the checkpoint of
+ * CONFIG_MTD_SMART_CHECKPOINT.  The time of a mount, the number of reads and
+ * the bytes read from the flash are reported.
+ */
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/types.h>
+
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/ioctl.h>
+#include <tinyara/fs/mtd.h>
+#include <tinyara/fs/smart.h>
+
+#define BLOCK_SIZE          (256)
+#define ERASE_SIZE          (4096)
+#define MAX_ERASE_BLOCKS    (4096)
+// Part of the free sectors which is filled before the volume is mounted
+#define FILL_PERCENT        (75)
+#define DATA_SIZE           (512)
+// Number of mounts of which the fastest one is kept
+#define REPEAT              (5)
+
+struct impl_s {
+	const char *name;
+	int (*initialize)(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partname);
+};
+
+int scan_smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partname);
+int ckpt_smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partname);
+
+static const struct impl_s g_impls[] = {
+	{"scan", scan_smart_initialize},
+	{"checkpoint", ckpt_smart_initialize},
+};
+
+#define NIMPLS              (sizeof(g_impls) / sizeof(g_impls[0]))
+
+static uint8_t *g_flash;
+static size_t g_neraseblocks;
+static unsigned long g_nreads;
+static unsigned long g_nbytes;
+
+static struct mtd_dev_s g_mtd;
+static const struct block_operations *g_bops;
+static struct inode g_inode;
+
+/* RAM NOR flash: programming can only clear bits */
+
+static int flash_erase(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks)
+{
+	memset(&g_flash[startblock * ERASE_SIZE], 0xff, nblocks * ERASE_SIZE);
+	return nblocks;
+}
+
+static void flash_program(off_t offset, const uint8_t *buf, size_t nbytes)
+{
+	size_t i;
+
+	for (i = 0; i < nbytes; i++) {
+		g_flash[offset + i] &= buf[i];
+	}
+}
+
+static ssize_t flash_bread(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks, FAR uint8_t *buf)
+{
+	memcpy(buf, &g_flash[startblock * BLOCK_SIZE], nblocks * BLOCK_SIZE);
+	g_nreads++;
+	g_nbytes += nblocks * BLOCK_SIZE;
+	return nblocks;
+}
+
+static ssize_t flash_bwrite(FAR struct mtd_dev_s *dev, off_t startblock, size_t nblocks, FAR const uint8_t *buf)
+{
+	flash_program(startblock * BLOCK_SIZE, buf, nblocks * BLOCK_SIZE);
+	return nblocks;
+}
+
+static ssize_t flash_read(FAR struct mtd_dev_s *dev, off_t offset, size_t nbytes, FAR uint8_t *buf)
+{
+	memcpy(buf, &g_flash[offset], nbytes);
+	g_nreads++;
+	g_nbytes += nbytes;
+	return nbytes;
+}
+
+static int flash_ioctl(FAR struct mtd_dev_s *dev, int cmd, unsigned long arg)
+{
+	FAR struct mtd_geometry_s *geo;
+
+	switch (cmd) {
+	case MTDIOC_GEOMETRY:
+		geo = (FAR struct mtd_geometry_s *)arg;
+		geo->blocksize = BLOCK_SIZE;
+		geo->erasesize = ERASE_SIZE;
+		geo->neraseblocks = g_neraseblocks;
+		return OK;
+
+	case MTDIOC_BULKERASE:
+		memset(g_flash, 0xff, g_neraseblocks * ERASE_SIZE);
+		return OK;
+	}
+
+	return -ENOTTY;
+}
+
+/* The SMART layer registers its block driver here */
+
+int register_blockdriver(FAR const char *path, FAR const struct block_operations *bops, mode_t mode, FAR void *priv)
+{
+	g_bops = bops;
+	g_inode.i_private = priv;
+	return OK;
+}
+
+static int smart_ioctl(int cmd, unsigned long arg)
+{
+	return g_bops->ioctl(&g_inode, cmd, arg);
+}
+
+static void fill(uint8_t *buf, size_t n, uint32_t seed)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = (uint8_t)(seed >> 16);
+	}
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/* Mount the volume, the previous mount is closed first like an unmount */
+
+static int mount(const struct impl_s *impl, struct smart_format_s *fmt)
+{
+	int ret;
+
+	if (g_bops != NULL) {
+		g_bops->close(&g_inode);
+	}
+
+	ret = impl->initialize(0, &g_mtd, NULL);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = smart_ioctl(BIOC_GETFORMAT, (unsigned long)fmt);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return (fmt->flags & SMART_FMT_ISFORMATTED) ? OK : -ENODEV;
+}
+
+/* Format and fill the volume, return the number of the last sector written
+ * and the format of the filled volume in fmt
+ */
+
+static int populate(const struct impl_s *impl, struct smart_format_s *fmt)
+{
+	struct smart_read_write_s req;
+	uint8_t buf[DATA_SIZE];
+	int nfill;
+	int sector = -1;
+	int i;
+
+	g_bops = NULL;
+	memset(g_flash, 0xff, g_neraseblocks * ERASE_SIZE);
+	if (impl->initialize(0, &g_mtd, NULL) < 0 || smart_ioctl(BIOC_LLFORMAT, 0) < 0 || mount(impl, fmt) < 0) {
+		return -EIO;
+	}
+
+	nfill = fmt->nfreesectors * FILL_PERCENT / 100;
+	for (i = 0; i < nfill; i++) {
+		sector = smart_ioctl(BIOC_ALLOCSECT, 0xffff);
+		if (sector < 0) {
+			return sector;
+		}
+
+		fill(buf, sizeof(buf), sector);
+		req.logsector = sector;
+		req.offset = 0;
+		req.count = sizeof(buf);
+		req.buffer = buf;
+		if (smart_ioctl(BIOC_WRITESECT, (unsigned long)&req) < 0) {
+			return -EIO;
+		}
+	}
+
+	if (smart_ioctl(BIOC_GETFORMAT, (unsigned long)fmt) < 0) {
+		return -EIO;
+	}
+
+	return sector;
+}
+
+/* Check that the mounted volume has the data written by populate() */
+
+static int check(int sector, const struct smart_format_s *expected, const struct smart_format_s *fmt)
+{
+	struct smart_read_write_s req;
+	uint8_t buf[DATA_SIZE];
+	uint8_t ref[DATA_SIZE];
+
+	if (fmt->nfreesectors != expected->nfreesectors || fmt->nsectors != expected->nsectors) {
+		return -EINVAL;
+	}
+
+	fill(ref, sizeof(ref), sector);
+	req.logsector = sector;
+	req.offset = 0;
+	req.count = sizeof(buf);
+	req.buffer = buf;
+	if (smart_ioctl(BIOC_READSECT, (unsigned long)&req) != sizeof(buf) || memcmp(buf, ref, sizeof(buf)) != 0) {
+		return -EINVAL;
+	}
+
+	return OK;
+}
+
+int main(void)
+{
+	static const size_t sizes[] = {64, 256, 1024, 4096};
+	struct smart_format_s expected;
+	struct smart_format_s fmt;
+	uint64_t best;
+	uint64_t start;
+	uint64_t t;
+	size_t s;
+	size_t k;
+	int sector;
+	int r;
+
+	g_flash = malloc(MAX_ERASE_BLOCKS * ERASE_SIZE);
+	if (g_flash == NULL) {
+		return 1;
+	}
+
+	g_mtd.erase = flash_erase;
+	g_mtd.bread = flash_bread;
+	g_mtd.bwrite = flash_bwrite;
+	g_mtd.read = flash_read;
+	g_mtd.ioctl = flash_ioctl;
+
+	printf("%d byte sectors, %d%% of the volume filled, fastest of %d mounts\n\n", CONFIG_MTD_SMART_SECTOR_SIZE, FILL_PERCENT, REPEAT);
+	printf("%8s %8s %-10s %10s %8s %10s\n", "size KB", "sectors", "mount", "us", "reads", "KB read");
+
+	for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+		g_neraseblocks = sizes[s];
+		for (k = 0; k < NIMPLS; k++) {
+			sector = populate(&g_impls[k], &expected);
+			if (sector < 0) {
+				printf("FAIL: %s populate of %zu blocks: %d\n", g_impls[k].name, sizes[s], sector);
+				return 1;
+			}
+
+			best = UINT64_MAX;
+			for (r = 0; r < REPEAT; r++) {
+				g_nreads = 0;
+				g_nbytes = 0;
+				start = now_ns();
+				if (mount(&g_impls[k], &fmt) < 0) {
+					printf("FAIL: %s mount of %zu blocks\n", g_impls[k].name, sizes[s]);
+					return 1;
+				}
+
+				t = now_ns() - start;
+				if (t < best) {
+					best = t;
+				}
+
+				if (check(sector, &expected, &fmt) < 0) {
+					printf("FAIL: %s volume of %zu blocks differs after mount\n", g_impls[k].name, sizes[s]);
+					return 1;
+				}
+			}
+
+			printf("%8zu %8u %-10s %10.1f %8lu %10.1f\n", sizes[s] * ERASE_SIZE / 1024, expected.nsectors, g_impls[k].name, best / 1000.0, g_nreads, g_nbytes / 1024.0);
+		}
+	}
+
+	return 0;
+}
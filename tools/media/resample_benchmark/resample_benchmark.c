@@ -0,0 +1,188 @@
+/******************************************************************
+ *
+ * Copyright 2019 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/*
+ * Host benchmark for the media framework sample rate converter.
+ * It measures throughput (frames/sec) and THD+N of each converter type
+ * for the conversions used in voice capture.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "samplerate.h"
+#include "remix.h"
+
+#define TEST_SECONDS        (20)
+#define TONE_HZ             (1000.0)
+#define TONE_AMPLITUDE      (16384.0)
+#define CHUNK_FRAMES        (512)
+#define RESAMPLER_BUFSIZE   (4096)
+// src_process() only needs a small sliding window
+#define PROCESS_BUFSIZE     (512)
+// Frames skipped at the beginning of output before measuring THD+N
+#define SETTLE_FRAMES       (256)
+// Frames used to measure THD+N. Keep it short, so that the small rate error of
+// the 16.16 fixed point step in linear converter doesn't show up as distortion.
+#define MEASURE_FRAMES      (4096)
+
+/* Minimal rechannel() for mono/stereo, so that samplerate.c builds without the media framework. */
+uint32_t ch2layout(uint32_t nb_chs)
+{
+	return nb_chs;
+}
+
+uint32_t layout2ch(uint32_t layout)
+{
+	return layout;
+}
+
+int32_t rechannel(uint32_t in_layout, uint32_t out_layout, const int16_t *input, uint32_t in_frames, int16_t *output, uint32_t max_frames)
+{
+	uint32_t frames = in_frames < max_frames ? in_frames : max_frames;
+	uint32_t i;
+
+	if (in_layout == out_layout) {
+		memmove(output, input, frames * in_layout * sizeof(int16_t));
+		return frames;
+	}
+
+	for (i = 0; i < frames; i++) {
+		if (in_layout == 2) {
+			output[i] = (int16_t)((input[2 * i] + input[2 * i + 1]) / 2);
+		} else {
+			output[2 * i] = input[i];
+			output[2 * i + 1] = input[i];
+		}
+	}
+	return frames;
+}
+
+/* THD+N in dB: residual after removing the best fitting tone, relative to the tone. */
+static double thd_n(const int16_t *pcm, int frames, int channels, int rate)
+{
+	double w = 2.0 * M_PI * TONE_HZ / rate;
+	double ss = 0, sc = 0, cc = 0, xs = 0, xc = 0;
+	double signal = 0, noise = 0;
+	int i;
+
+	for (i = 0; i < frames; i++) {
+		double s = sin(w * i);
+		double c = cos(w * i);
+		double x = pcm[i * channels];
+		ss += s * s;
+		cc += c * c;
+		sc += s * c;
+		xs += x * s;
+		xc += x * c;
+	}
+
+	double det = ss * cc - sc * sc;
+	double a = (xs * cc - xc * sc) / det;
+	double b = (xc * ss - xs * sc) / det;
+
+	for (i = 0; i < frames; i++) {
+		double fit = a * sin(w * i) + b * cos(w * i);
+		double err = pcm[i * channels] - fit;
+		signal += fit * fit;
+		noise += err * err;
+	}
+
+	return 10.0 * log10(noise / signal);
+}
+
+static int run(const char *name, int converter, int fused, int in_rate, int out_rate, int channels)
+{
+	int in_frames = in_rate * TEST_SECONDS;
+	int out_max = (int)((double)in_frames * out_rate / in_rate) + CHUNK_FRAMES;
+	int16_t *in = malloc(in_frames * channels * sizeof(int16_t));
+	int16_t *out = malloc(out_max * channels * sizeof(int16_t));
+	int i, j;
+
+	if (!in || !out) {
+		free(in);
+		free(out);
+		return -1;
+	}
+
+	for (i = 0; i < in_frames; i++) {
+		for (j = 0; j < channels; j++) {
+			in[i * channels + j] = (int16_t)lrint(TONE_AMPLITUDE * sin(2.0 * M_PI * TONE_HZ * i / in_rate));
+		}
+	}
+
+	src_handle_t handle = src_init_ext(fused ? PROCESS_BUFSIZE : RESAMPLER_BUFSIZE, converter);
+	src_data_t data = { 0, };
+	data.origin_sample_rate = in_rate;
+	data.origin_sample_width = SAMPLE_WIDTH_16BITS;
+	data.origin_channel_num = channels;
+	data.desired_sample_rate = out_rate;
+	data.desired_sample_width = SAMPLE_WIDTH_16BITS;
+	data.desired_channel_num = channels;
+
+	int used = 0;
+	int gen = 0;
+	clock_t start = clock();
+	while (used < in_frames && gen < out_max - CHUNK_FRAMES) {
+		data.data_in = in + used * channels;
+		data.input_frames = (in_frames - used) < CHUNK_FRAMES ? (in_frames - used) : CHUNK_FRAMES;
+		data.data_out = out + gen * channels;
+		data.out_buf_length = CHUNK_FRAMES * channels * sizeof(int16_t);
+		if ((fused ? src_process(handle, &data) : src_simple(handle, &data)) != SRC_ERR_NO_ERROR) {
+			printf("%s: converting failed\n", name);
+			break;
+		}
+		used += data.input_frames_used;
+		gen += data.output_frames_gen;
+	}
+	double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+	src_destroy(handle);
+
+	printf("%-10s %-7s %6d -> %-6d %s  %10.0f frames/sec  THD+N %7.1f dB\n", name, fused ? "process" : "simple", in_rate, out_rate,
+		   channels == 1 ? "mono  " : "stereo", secs > 0 ? used / secs : 0.0,
+		   thd_n(out + SETTLE_FRAMES * channels, MEASURE_FRAMES, channels, out_rate));
+
+	free(in);
+	free(out);
+	return 0;
+}
+
+int main(void)
+{
+	static const int rates[][2] = {
+		{ 44100, 16000 },
+		{ 48000, 16000 },
+		{ 16000, 48000 },
+	};
+	unsigned int i;
+	int channels;
+
+	for (i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+		for (channels = 1; channels <= 2; channels++) {
+			run("linear", SRC_CONVERTER_LINEAR, 0, rates[i][0], rates[i][1], channels);
+			run("linear", SRC_CONVERTER_LINEAR, 1, rates[i][0], rates[i][1], channels);
+			run("polyphase", SRC_CONVERTER_POLYPHASE, 0, rates[i][0], rates[i][1], channels);
+			run("polyphase", SRC_CONVERTER_POLYPHASE, 1, rates[i][0], rates[i][1], channels);
+		}
+	}
+
+	return 0;
+}
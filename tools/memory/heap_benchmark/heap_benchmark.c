@@ -0,0 +1,287 @@
+/****************************************************************************
+ *
+ * Copyright 2026 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/*
+ * Host benchmark for the heap allocator of os/mm/mm_heap.
+ * It runs the same allocation traces against the heap built with the
+ * size-ordered free lists or with TLSF, and reports average, 99th percentile
+ * and worst-case latency of mm_malloc() and mm_free().
+ */
+
+#include <tinyara/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <tinyara/mm/mm.h>
+
+#define HEAP_SIZE           (2 * 1024 * 1024)
+#define MAX_LIVE            (32768)
+// Live chunks kept by the random trace
+#define RANDOM_LIVE         (4096)
+#define TEST_OPS            (1000000)
+#define WARMUP_OPS          (50000)
+// The trace is replayed and the fastest run of each operation is kept, to
+// filter out the preemptions of the host
+#define REPEAT              (5)
+// Latency histogram, in ns. Slower operations go into the last bucket.
+#define HIST_BUCKETS        (100000)
+
+#ifdef CONFIG_MM_TLSF
+#define ALLOCATOR_NAME      "tlsf"
+#else
+#define ALLOCATOR_NAME      "nodelist"
+#endif
+
+struct latency_s {
+	uint64_t total;
+	uint64_t max;
+	uint32_t count;
+	uint32_t hist[HIST_BUCKETS];
+};
+
+struct mm_heap_s g_mmheap[CONFIG_MM_NHEAPS];
+
+static uint8_t g_heapmem[HEAP_SIZE] __attribute__((aligned(16)));
+static void *g_live[MAX_LIVE];
+static int g_nlive;
+static struct latency_s g_malloc_lat;
+static struct latency_s g_free_lat;
+static uint64_t g_oplat[TEST_OPS];
+static uint8_t g_opfree[TEST_OPS];
+static int g_nops;
+static uint32_t g_seed;
+
+/* The semaphore is not needed in this single threaded benchmark */
+
+void mm_seminitialize(struct mm_heap_s *heap)
+{
+}
+
+void mm_takesemaphore(struct mm_heap_s *heap)
+{
+}
+
+void mm_givesemaphore(struct mm_heap_s *heap)
+{
+}
+
+static uint32_t rand32(void)
+{
+	g_seed = g_seed * 1664525 + 1013904223;
+	return g_seed >> 8;
+}
+
+static inline uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void measure_op(int is_free, uint64_t ns)
+{
+	if (g_nops < TEST_OPS) {
+		if (ns < g_oplat[g_nops]) {
+			g_oplat[g_nops] = ns;
+		}
+		g_opfree[g_nops++] = is_free;
+	}
+}
+
+static void record(struct latency_s *lat, uint64_t ns)
+{
+	lat->total += ns;
+	lat->count++;
+	if (ns > lat->max) {
+		lat->max = ns;
+	}
+	lat->hist[ns < HIST_BUCKETS ? ns : HIST_BUCKETS - 1]++;
+}
+
+static uint64_t percentile(const struct latency_s *lat, double pct)
+{
+	uint64_t target = (uint64_t)(lat->count * pct / 100.0);
+	uint64_t seen = 0;
+	int i;
+
+	for (i = 0; i < HIST_BUCKETS; i++) {
+		seen += lat->hist[i];
+		if (seen > target) {
+			return i;
+		}
+	}
+	return HIST_BUCKETS;
+}
+
+/* 75% of 16..256 bytes, 20% of 256..2K, 5% of 2K..16K */
+static size_t mixed_size(void)
+{
+	uint32_t r = rand32() % 100;
+
+	if (r < 75) {
+		return 16 + rand32() % 240;
+	} else if (r < 95) {
+		return 256 + rand32() % 1792;
+	}
+	return 2048 + rand32() % 14336;
+}
+
+static void do_malloc(size_t size, int measure)
+{
+	uint64_t start;
+	uint64_t end;
+	void *mem;
+
+	start = now_ns();
+	mem = mm_malloc(&g_mmheap[0], size);
+	end = now_ns();
+
+	if (!mem) {
+		return;
+	}
+	if (measure) {
+		measure_op(0, end - start);
+	}
+	*(volatile uint8_t *)mem = 0;
+	g_live[g_nlive++] = mem;
+}
+
+static void do_free(int index, int measure)
+{
+	uint64_t start;
+	uint64_t end;
+	void *mem = g_live[index];
+
+	g_live[index] = g_live[--g_nlive];
+
+	start = now_ns();
+	mm_free(&g_mmheap[0], mem);
+	end = now_ns();
+
+	if (measure) {
+		measure_op(1, end - start);
+	}
+}
+
+static void release_all(void)
+{
+	while (g_nlive > 0) {
+		do_free(g_nlive - 1, 0);
+	}
+}
+
+/* Check that every chunk of the heap is free again and merged into one */
+
+static int check_heap(void)
+{
+	struct mm_allocnode_s *node;
+	int nfree = 0;
+
+	for (node = g_mmheap[0].mm_heapstart[0]; node < g_mmheap[0].mm_heapend[0]; node = (struct mm_allocnode_s *)((char *)node + node->size)) {
+		if (node != g_mmheap[0].mm_heapstart[0] && (node->preceding & MM_ALLOC_BIT)) {
+			return -1;
+		}
+		if (!(node->preceding & MM_ALLOC_BIT)) {
+			nfree++;
+		}
+	}
+	return nfree == 1 ? 0 : -1;
+}
+
+/* Random mix of allocations and frees, with a bounded number of live chunks */
+
+static void trace_random(int ops, int measure)
+{
+	int i;
+
+	for (i = 0; i < ops; i++) {
+		if (g_nlive < RANDOM_LIVE && (g_nlive == 0 || rand32() % 2)) {
+			do_malloc(mixed_size(), measure);
+		} else {
+			do_free(rand32() % g_nlive, measure);
+		}
+	}
+}
+
+/* Fill the heap with small chunks and free every other one, so that there
+ * are thousands of free chunks of similar sizes, then run the random trace
+ * on that fragmented heap.
+ */
+
+static void trace_fragmented(int ops, int measure)
+{
+	void *mem;
+	int nsmall = 0;
+	int i;
+
+	while (g_nlive < MAX_LIVE && (mem = mm_malloc(&g_mmheap[0], 32 + (rand32() % 4) * 16))) {
+		g_live[g_nlive++] = mem;
+		nsmall++;
+	}
+
+	for (i = nsmall - 1; i >= 0; i -= 2) {
+		do_free(i, 0);
+	}
+
+	trace_random(ops, measure);
+}
+
+static void run(const char *name, void (*trace)(int ops, int measure))
+{
+	int corrupted = 0;
+	int i;
+
+	memset(&g_malloc_lat, 0, sizeof(g_malloc_lat));
+	memset(&g_free_lat, 0, sizeof(g_free_lat));
+	memset(g_oplat, 0xff, sizeof(g_oplat));
+
+	for (i = 0; i < REPEAT; i++) {
+		g_seed = 1;
+		g_nops = 0;
+		mm_initialize(&g_mmheap[0], g_heapmem, sizeof(g_heapmem));
+
+		trace(WARMUP_OPS, 0);
+		trace(TEST_OPS, 1);
+		release_all();
+		corrupted |= check_heap();
+	}
+
+	for (i = 0; i < g_nops; i++) {
+		record(g_opfree[i] ? &g_free_lat : &g_malloc_lat, g_oplat[i]);
+	}
+
+	printf("%-8s  %-10s  malloc avg %5.0f p99.9 %6llu max %7llu  |  free avg %5.0f p99.9 %6llu max %7llu  [ns]%s\n",
+		   ALLOCATOR_NAME, name,
+		   g_malloc_lat.count ? (double)g_malloc_lat.total / g_malloc_lat.count : 0.0,
+		   (unsigned long long)percentile(&g_malloc_lat, 99.9), (unsigned long long)g_malloc_lat.max,
+		   g_free_lat.count ? (double)g_free_lat.total / g_free_lat.count : 0.0,
+		   (unsigned long long)percentile(&g_free_lat, 99.9), (unsigned long long)g_free_lat.max,
+		   corrupted ? "  HEAP CORRUPTED" : "");
+}
+
+int main(void)
+{
+	run("random", trace_random);
+	run("fragmented", trace_fragmented);
+	return 0;
+}
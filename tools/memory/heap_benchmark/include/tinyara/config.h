@@ -0,0 +1,33 @@
+/****************************************************************************
+ *
+ * Copyright 2026 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/* Host build configuration of the heap allocator for heap_benchmark.
+ * CONFIG_MM_TLSF is given on the command line.
+ */
+
+#ifndef __TOOLS_HEAP_BENCHMARK_CONFIG_H
+#define __TOOLS_HEAP_BENCHMARK_CONFIG_H
+
+#define CONFIG_HAVE_LONG_LONG 1
+#define CONFIG_MM_REGIONS 1
+#define CONFIG_MM_REGION_NUM 1
+#define CONFIG_MM_NHEAPS 1
+#define CONFIG_MAX_TASKS 8
+
+#define FAR
+
+#endif
@@ -0,0 +1,286 @@
+/****************************************************************************
+ *
+ * Copyright 2026 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/*
+ * Host benchmark for the string functions of lib/libc/string.
+ * It checks the byte-by-byte and word-at-a-time builds of memcpy(),
+ * memmove(), memset(), memcmp() and strlen() against each other over all
+ * small sizes and alignments, then reports their speed, with the host C
+ * library as a reference.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#define BUF_SIZE            (64 * 1024)
+// Every size up to CHECK_SIZE is checked at every alignment
+#define CHECK_SIZE          (300)
+#define CHECK_ALIGN         (8)
+#define GUARD               (32)
+// Bytes processed by each measurement, and number of measurements of which
+// the fastest one is kept
+#define BENCH_BYTES         (64 * 1024 * 1024)
+#define REPEAT              (5)
+
+struct impl_s {
+	const char *name;
+	void *(*memcpy)(void *dest, const void *src, size_t n);
+	void *(*memmove)(void *dest, const void *src, size_t n);
+	void *(*memset)(void *s, int c, size_t n);
+	int (*memcmp)(const void *s1, const void *s2, size_t n);
+	size_t (*strlen)(const char *s);
+};
+
+#define DECLARE_IMPL(p) \
+	void *p##_memcpy(void *dest, const void *src, size_t n); \
+	void *p##_memmove(void *dest, const void *src, size_t n); \
+	void *p##_memset(void *s, int c, size_t n); \
+	int p##_memcmp(const void *s1, const void *s2, size_t n); \
+	size_t p##_strlen(const char *s);
+
+DECLARE_IMPL(byte)
+DECLARE_IMPL(word)
+
+static const struct impl_s g_impls[] = {
+	{"byte", byte_memcpy, byte_memmove, byte_memset, byte_memcmp, byte_strlen},
+	{"word", word_memcpy, word_memmove, word_memset, word_memcmp, word_strlen},
+	{"host", memcpy, memmove, memset, memcmp, strlen},
+};
+
+#define NIMPLS              (sizeof(g_impls) / sizeof(g_impls[0]))
+// The host C library is only a reference, it is not checked
+#define NCHECKED            (2)
+
+static uint8_t g_src[BUF_SIZE + 2 * GUARD] __attribute__((aligned(64)));
+static uint8_t g_dst[BUF_SIZE + 2 * GUARD] __attribute__((aligned(64)));
+static uint8_t g_ref[BUF_SIZE + 2 * GUARD] __attribute__((aligned(64)));
+static int g_errors;
+
+static void fill(uint8_t *buf, size_t n, uint32_t seed)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = (uint8_t)(seed >> 16);
+	}
+}
+
+static void fail(const char *impl, const char *func, size_t n, int a1, int a2)
+{
+	if (g_errors++ < 10) {
+		printf("FAIL: %s %s n=%zu align=%d/%d\n", impl, func, n, a1, a2);
+	}
+}
+
+static int sign(int v)
+{
+	return (v > 0) - (v < 0);
+}
+
+static void check_impl(const struct impl_s *impl)
+{
+	size_t n;
+	size_t i;
+	int a1;
+	int a2;
+	int d;
+
+	for (n = 0; n <= CHECK_SIZE; n++) {
+		for (a1 = 0; a1 < CHECK_ALIGN; a1++) {
+			for (a2 = 0; a2 < CHECK_ALIGN; a2++) {
+				/* memcpy: a2 is the source alignment */
+
+				fill(g_src, sizeof(g_src), n * 64 + a1 * 8 + a2);
+				fill(g_dst, sizeof(g_dst), 1);
+				memcpy(g_ref, g_dst, sizeof(g_ref));
+				for (i = 0; i < n; i++) {
+					g_ref[GUARD + a1 + i] = g_src[GUARD + a2 + i];
+				}
+
+				if (impl->memcpy(g_dst + GUARD + a1, g_src + GUARD + a2, n) != g_dst + GUARD + a1 || memcmp(g_dst, g_ref, sizeof(g_ref)) != 0) {
+					fail(impl->name, "memcpy", n, a1, a2);
+				}
+
+				/* memcmp: equal buffers, then one differing byte */
+
+				memcpy(g_dst + GUARD + a1, g_src + GUARD + a2, n);
+				if (impl->memcmp(g_dst + GUARD + a1, g_src + GUARD + a2, n) != 0) {
+					fail(impl->name, "memcmp", n, a1, a2);
+				}
+
+				if (n > 0) {
+					i = (n * 7 + a1) % n;
+					g_dst[GUARD + a1 + i] ^= 0x80;
+					if (sign(impl->memcmp(g_dst + GUARD + a1, g_src + GUARD + a2, n)) != sign((int)g_dst[GUARD + a1 + i] - (int)g_src[GUARD + a2 + i])) {
+						fail(impl->name, "memcmp", n, a1, a2);
+					}
+				}
+
+				/* memmove: both directions, the buffers overlap */
+
+				for (d = -(int)CHECK_ALIGN * 2; d <= (int)CHECK_ALIGN * 2; d += 3) {
+					uint8_t *base = g_dst + GUARD + CHECK_ALIGN * 2;
+
+					fill(g_dst, sizeof(g_dst), n + d);
+					memcpy(g_ref, g_dst, sizeof(g_ref));
+					memmove(g_ref + GUARD + CHECK_ALIGN * 2 + a1 + d, g_ref + GUARD + CHECK_ALIGN * 2 + a1, n);
+
+					impl->memmove(base + a1 + d, base + a1, n);
+					if (memcmp(g_dst, g_ref, sizeof(g_ref)) != 0) {
+						fail(impl->name, "memmove", n, a1, d);
+					}
+				}
+			}
+
+			/* memset */
+
+			fill(g_dst, sizeof(g_dst), 2);
+			memcpy(g_ref, g_dst, sizeof(g_ref));
+			for (i = 0; i < n; i++) {
+				g_ref[GUARD + a1 + i] = 0xa5;
+			}
+
+			if (impl->memset(g_dst + GUARD + a1, 0x1a5, n) != g_dst + GUARD + a1 || memcmp(g_dst, g_ref, sizeof(g_ref)) != 0) {
+				fail(impl->name, "memset", n, a1, 0);
+			}
+
+			/* strlen: the terminator is followed by more characters */
+
+			memset(g_src, 'x', sizeof(g_src));
+			g_src[GUARD + a1 + n] = '\0';
+			if (impl->strlen((const char *)g_src + GUARD + a1) != n) {
+				fail(impl->name, "strlen", n, a1, 0);
+			}
+		}
+	}
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/* Return the fastest time of one call, in ns */
+
+static double bench(const struct impl_s *impl, const char *func, size_t n, int dalign, int salign)
+{
+	uint8_t *dst = g_dst + GUARD + dalign;
+	uint8_t *src = g_src + GUARD + salign;
+	size_t loops = BENCH_BYTES / (n + 16);
+	uint64_t best = UINT64_MAX;
+	uint64_t start;
+	uint64_t t;
+	size_t i;
+	int r;
+	volatile size_t sink = 0;
+
+	memset(src, 'x', n);
+	src[n] = '\0';
+	memcpy(dst, src, n);
+
+	for (r = 0; r < REPEAT; r++) {
+		start = now_ns();
+		if (!strcmp(func, "memcpy")) {
+			for (i = 0; i < loops; i++) {
+				impl->memcpy(dst, src, n);
+			}
+		} else if (!strcmp(func, "memmove")) {
+			for (i = 0; i < loops; i++) {
+				impl->memmove(dst, src, n);
+			}
+		} else if (!strcmp(func, "memset")) {
+			for (i = 0; i < loops; i++) {
+				impl->memset(dst, (int)i, n);
+			}
+		} else if (!strcmp(func, "memcmp")) {
+			for (i = 0; i < loops; i++) {
+				sink += impl->memcmp(dst, src, n);
+			}
+		} else {
+			for (i = 0; i < loops; i++) {
+				sink += impl->strlen((const char *)src);
+			}
+		}
+
+		t = now_ns() - start;
+		if (t < best) {
+			best = t;
+		}
+	}
+
+	(void)sink;
+	return (double)best / loops;
+}
+
+int main(void)
+{
+	static const char *funcs[] = {"memcpy", "memmove", "memset", "memcmp", "strlen"};
+	static const size_t sizes[] = {8, 32, 128, 512, 1500, 4096, 32768};
+	static const int aligns[][2] = {{0, 0}, {1, 1}, {0, 1}, {3, 2}};
+	size_t f;
+	size_t s;
+	size_t a;
+	size_t k;
+
+	for (k = 0; k < NCHECKED; k++) {
+		check_impl(&g_impls[k]);
+	}
+
+	if (g_errors) {
+		printf("%d errors\n", g_errors);
+		return 1;
+	}
+
+	printf("Checked sizes 0-%d at all alignments: OK\n", CHECK_SIZE);
+	printf("ns per call (MB/s), alignment is dst/src\n");
+
+	for (f = 0; f < sizeof(funcs) / sizeof(funcs[0]); f++) {
+		printf("\n%-8s %6s %5s", funcs[f], "size", "align");
+		for (k = 0; k < NIMPLS; k++) {
+			printf(" %20s", g_impls[k].name);
+		}
+
+		printf("\n");
+		for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+			for (a = 0; a < sizeof(aligns) / sizeof(aligns[0]); a++) {
+				/* memset and strlen only use one of the pointers */
+
+				if ((f == 2 || f == 4) && aligns[a][0] != aligns[a][1]) {
+					continue;
+				}
+
+				printf("%-8s %6zu %3d/%d", "", sizes[s], aligns[a][0], aligns[a][1]);
+				for (k = 0; k < NIMPLS; k++) {
+					double ns = bench(&g_impls[k], funcs[f], sizes[s], aligns[a][0], aligns[a][1]);
+
+					printf(" %10.1f (%7.0f)", ns, sizes[s] * 1000.0 / ns);
+				}
+
+				printf("\n");
+			}
+		}
+	}
+
+	return 0;
+}